@@ -6,6 +6,23 @@ LOCAL_MODULE := Oboe
 LOCAL_SRC_FILES := $(OBOE_SDK_ROOT)/prefab/modules/oboe/libs/android.$(TARGET_ARCH_ABI)/liboboe.so
 include $(PREBUILT_SHARED_LIBRARY)
 
+ifeq ($(CXR_STANDIN),1)
+# CloudXR receiver stand-in with a simulated server and network impairment, see cloudxr_standin/
+include $(CLEAR_VARS)
+LOCAL_MODULE := CloudXRClient
+LOCAL_CFLAGS += -DXR_USE_PLATFORM_ANDROID=1 -DXR_USE_GRAPHICS_API_OPENGL_ES=1
+LOCAL_C_INCLUDES := $(CLOUDXR_SDK_ROOT)/include \
+                    $(LOCAL_PATH) \
+                    $(LOCAL_PATH)/openxr_loader/include
+LOCAL_SRC_FILES := cloudxr_standin/cxr_standin.cpp \
+                   cloudxr_standin/netimpair.cpp \
+                   frametrace.cpp \
+                   logger.cpp
+LOCAL_LDLIBS := -llog -lGLESv3 -lEGL
+include $(BUILD_SHARED_LIBRARY)
+
+CLOUDXR_SHARED_LIBRARIES := CloudXRClient
+else
 # Add prebuilt CloudXR client library
 include $(CLEAR_VARS)
 LOCAL_MODULE := CloudXRClient
@@ -27,6 +44,9 @@ LOCAL_MODULE := GsAudioWebRTC
 LOCAL_SRC_FILES := $(CLOUDXR_SDK_ROOT)/jni/$(TARGET_ARCH_ABI)/libGsAudioWebRTC.so
 include $(PREBUILT_SHARED_LIBRARY)
 
+CLOUDXR_SHARED_LIBRARIES := CloudXRClient Grid Poco GsAudioWebRTC
+endif
+
 # Add prebuilt pxr_api library
 include $(CLEAR_VARS)
 LOCAL_MODULE := openxr_loader
@@ -38,6 +58,12 @@ include $(CLEAR_VARS)
 LOCAL_MODULE := CloudXRClientPXR
 
 LOCAL_CFLAGS += -DXR_USE_PLATFORM_ANDROID=1 -DXR_USE_GRAPHICS_API_OPENGL_ES=1
+# Frame records for the hitch monitor's stack sampling, see hitch_monitor.h
+LOCAL_CFLAGS += -fno-omit-frame-pointer
+ifeq ($(GL_EAGER),1)
+# Looks up every GL entry point at context creation instead of on first use, see gfxwrapper_opengl.h
+LOCAL_CFLAGS += -DGFXWRAPPER_EAGER_GL_ENTRY_POINTS=1
+endif
 
 LOCAL_C_INCLUDES := $(PXR_SDK_ROOT)/include \
                     $(OBOE_SDK_ROOT)/prefab/modules/oboe/include \
@@ -51,15 +77,62 @@ LOCAL_SRC_FILES := main.cpp \
                    platformplugin_android.cpp \
                    graphicsplugin_factory.cpp \
                    graphicsplugin_opengles.cpp \
+                   gl_program_cache.cpp \
+                   egl_context.cpp \
                    openxr_loader/include/common/gfxwrapper_opengl.c \
                    cloudXRClient.cpp \
+                   blit_worker.cpp \
+                   decoder_selection.cpp \
+                   frame_drain.cpp \
+                   frametrace.cpp \
+                   metrics.cpp \
+                   xr_call_budget.cpp \
+                   frame_pacer.cpp \
+                   view_resolution.cpp \
+                   swapchain_policy.cpp \
+                   foveation.cpp \
+                   latch_scheduler.cpp \
+                   hitch_monitor.cpp \
+                   memory_monitor.cpp \
+                   click_to_photon.cpp \
+                   mirror_window.cpp \
+                   callback_dispatch.cpp \
+                   session_columns.cpp \
+                   session_export.cpp \
+                   stream_throttle.cpp \
                    openxr_program.cpp
 
-LOCAL_LDLIBS := -llog -landroid -lGLESv3 -lEGL
+LOCAL_LDLIBS := -llog -landroid -lGLESv3 -lEGL -ldl
 LOCAL_STATIC_LIBRARIES	:= android_native_app_glue
-LOCAL_SHARED_LIBRARIES := Oboe CloudXRClient Grid Poco GsAudioWebRTC openxr_loader
+LOCAL_SHARED_LIBRARIES := Oboe $(CLOUDXR_SHARED_LIBRARIES) openxr_loader
 
 include $(BUILD_SHARED_LIBRARY)
 
+ifeq ($(CXR_LOADGEN),1)
+# Multi-client load generator for server capacity planning, see loadgen/loadgen.cpp
+include $(CLEAR_VARS)
+LOCAL_MODULE := cloudxr_loadgen
+LOCAL_CFLAGS += -DXR_USE_PLATFORM_ANDROID=1 -DXR_USE_GRAPHICS_API_OPENGL_ES=1
+LOCAL_C_INCLUDES := $(OBOE_SDK_ROOT)/prefab/modules/oboe/include \
+                    $(CLOUDXR_SDK_ROOT)/include \
+                    $(LOCAL_PATH) \
+                    $(LOCAL_PATH)/openxr_loader/include
+LOCAL_SRC_FILES := loadgen/loadgen.cpp \
+                   cloudXRClient.cpp \
+                   callback_dispatch.cpp \
+                   blit_worker.cpp \
+                   decoder_selection.cpp \
+                   frame_drain.cpp \
+                   hitch_monitor.cpp \
+                   memory_monitor.cpp \
+                   egl_context.cpp \
+                   frametrace.cpp \
+                   metrics.cpp \
+                   logger.cpp
+LOCAL_LDLIBS := -llog -landroid -lGLESv3 -lEGL -ldl
+LOCAL_SHARED_LIBRARIES := Oboe $(CLOUDXR_SHARED_LIBRARIES) openxr_loader
+include $(BUILD_EXECUTABLE)
+endif
+
 $(call import-module, android/native_app_glue)
 $(call import-add-path, $(PXR_SDK_ROOT))
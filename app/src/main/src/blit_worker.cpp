@@ -0,0 +1,297 @@
+/*
+    optional blit worker for CloudXR frames.
+*/
+#include "pch.h"
+#include "common.h"
+#include "blit_worker.h"
+#include "frametrace.h"
+#include "metrics.h"
+#include "hitch_monitor.h"
+#include "memory_monitor.h"
+
+#include <chrono>
+
+namespace {
+// Short enough for Stop() to return promptly, the worker just latches again on a timeout.
+const uint32_t kLatchTimeoutMs = 50;
+}  // namespace
+
+BlitWorker::~BlitWorker() { Stop(); }
+
+bool BlitWorker::CreateContext() {
+    mCreateSync = (PFNEGLCREATESYNCKHRPROC)eglGetProcAddress("eglCreateSyncKHR");
+    mDestroySync = (PFNEGLDESTROYSYNCKHRPROC)eglGetProcAddress("eglDestroySyncKHR");
+    mClientWaitSync = (PFNEGLCLIENTWAITSYNCKHRPROC)eglGetProcAddress("eglClientWaitSyncKHR");
+    mWaitSync = (PFNEGLWAITSYNCKHRPROC)eglGetProcAddress("eglWaitSyncKHR");
+    if (mCreateSync == nullptr || mDestroySync == nullptr || mClientWaitSync == nullptr) {
+        Log::Write(Log::Level::Error, "blit worker: EGL_KHR_fence_sync not available");
+        return false;
+    }
+    if (!mContext.CreateShared(eglGetCurrentDisplay(), eglGetCurrentContext())) {
+        return false;
+    }
+    Log::Write(Log::Level::Info, Fmt("blit worker: context ready, %s fence waits", mWaitSync != nullptr ? "GPU" : "CPU"));
+    return true;
+}
+
+void BlitWorker::DestroyContext() {
+    Stop();
+    mContext.Destroy();
+}
+
+void BlitWorker::Start(cxrReceiverHandle receiver, uint32_t eyeWidth, uint32_t eyeHeight, std::function<bool()> streaming, FrameTraceWriter* trace) {
+    Stop();
+    mReceiver = receiver;
+    mEyeWidth = eyeWidth;
+    mEyeHeight = eyeHeight;
+    mStreaming = std::move(streaming);
+    mTrace = trace;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRunning = true;
+        mLatest = -1;
+    }
+    mThread = std::thread(&BlitWorker::Run, this);
+}
+
+void BlitWorker::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRunning = false;
+    }
+    mReleased.notify_all();
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+}
+
+bool BlitWorker::IsRunning() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mRunning;
+}
+
+bool BlitWorker::Acquire(cxrFramesLatched* latched) {
+    EGLSyncKHR written;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mRunning || mLatest < 0) {
+            return false;
+        }
+        mAcquired = mLatest;
+        const Slot& slot = mSlots[mAcquired];
+        if (slot.sequence == mPresentedSequence) {
+            mRepeats++;
+        }
+        mPresentedSequence = slot.sequence;
+        *latched = slot.latched;
+        written = slot.written;
+        mAcquiredTextures[0] = slot.textures[0];
+        mAcquiredTextures[1] = slot.textures[1];
+    }
+    // The worker already flushed this fence, so a GPU wait never stalls the render thread.
+    if (mWaitSync != nullptr) {
+        mWaitSync(mContext.display, written, 0);
+    } else {
+        mClientWaitSync(mContext.display, written, 0, EGL_FOREVER_KHR);
+    }
+    return true;
+}
+
+void BlitWorker::Blit(uint32_t eye, GLsizei width, GLsizei height) {
+    if (mAcquired < 0 || eye >= 2) {
+        return;
+    }
+    if (mReadFramebuffer == 0) {
+        glGenFramebuffers(1, &mReadFramebuffer);
+        GpuMemory::Add(GpuMemory::Category::Framebuffer, 0);
+    }
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, mReadFramebuffer);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mAcquiredTextures[eye], 0);
+    glBlitFramebuffer(0, 0, mEyeWidth, mEyeHeight, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
+void BlitWorker::Release() {
+    if (mAcquired < 0) {
+        return;
+    }
+    EGLSyncKHR read = mCreateSync(mContext.display, EGL_SYNC_FENCE_KHR, nullptr);
+    // Without a flush the worker's client wait could sit on a fence that was never submitted.
+    glFlush();
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mOrphaned[0] != 0 && mOrphaned[0] == mAcquiredTextures[0]) {
+            // The worker stopped while this frame was on screen and left its textures to this context's share
+            // group; GL keeps them alive until the copy above has executed.
+            mDestroySync(mContext.display, read);
+            glDeleteTextures(2, mOrphaned);
+            mOrphaned[0] = mOrphaned[1] = 0;
+            GpuMemory::Add(GpuMemory::Category::Texture, -mOrphanedBytes, -2);
+            Log::Write(Log::Level::Info, "blit worker: orphaned slot freed");
+        } else {
+            Slot& slot = mSlots[mAcquired];
+            if (slot.read != EGL_NO_SYNC_KHR) {
+                mDestroySync(mContext.display, slot.read);
+            }
+            slot.read = read;
+        }
+        mAcquired = -1;
+        mAcquiredTextures[0] = mAcquiredTextures[1] = 0;
+    }
+    mReleased.notify_all();
+}
+
+void BlitWorker::Run() {
+    HitchMonitor::RegisterThread("blit worker");
+    if (!mContext.MakeCurrent()) {
+        Log::Write(Log::Level::Error, Fmt("blit worker: eglMakeCurrent failed: 0x%x", eglGetError()));
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRunning = false;
+        return;
+    }
+
+    for (Slot& slot : mSlots) {
+        glGenTextures(2, slot.textures);
+        glGenFramebuffers(2, slot.framebuffers);
+        for (int eye = 0; eye < 2; eye++) {
+            glBindTexture(GL_TEXTURE_2D, slot.textures[eye]);
+            glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, mEyeWidth, mEyeHeight);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, slot.framebuffers[eye]);
+            glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, slot.textures[eye], 0);
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    const int64_t slotBytes = 2 * (int64_t)mEyeWidth * mEyeHeight * 4;
+    GpuMemory::Add(GpuMemory::Category::Texture, kSlotCount * slotBytes, kSlotCount * 2);
+    GpuMemory::Add(GpuMemory::Category::Framebuffer, 0, kSlotCount * 2);
+    Log::Write(Log::Level::Info, Fmt("blit worker: started, %d slots of 2 x %ux%u", kSlotCount, mEyeWidth, mEyeHeight));
+
+    auto lastMetrics = std::chrono::steady_clock::now();
+    while (true) {
+        int next = -1;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (!mRunning) {
+                break;
+            }
+            // With three slots there is always one that is neither the newest nor on screen.
+            for (int i = 0; i < kSlotCount && next < 0; i++) {
+                if (i != mLatest && i != mAcquired) {
+                    next = i;
+                }
+            }
+        }
+
+        if (!mStreaming()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        } else if (LatchInto(mSlots[next])) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mLatest >= 0 && mSlots[mLatest].sequence > mPresentedSequence) {
+                mDropped++;
+            }
+            mSlots[next].sequence = ++mSequence;
+            mLatest = next;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastMetrics >= std::chrono::seconds(1)) {
+            lastMetrics = now;
+            PublishMetrics();
+        }
+    }
+
+    // The render thread may still be between Acquire and Release. If it stays there, e.g. stalled in the
+    // compositor, the slot it reads from is not freed here but handed over to Release().
+    int orphan = -1;
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mReleased.wait_for(lock, std::chrono::milliseconds(500), [this]() { return mAcquired < 0; });
+        mLatest = -1;
+        orphan = mAcquired;
+        if (orphan >= 0) {
+            mOrphaned[0] = mSlots[orphan].textures[0];
+            mOrphaned[1] = mSlots[orphan].textures[1];
+            mOrphanedBytes = slotBytes;
+            Log::Write(Log::Level::Warning, "blit worker: frame still acquired at stop, its slot is freed on release");
+        }
+    }
+    for (int i = 0; i < kSlotCount; i++) {
+        Slot& slot = mSlots[i];
+        for (EGLSyncKHR* sync : {&slot.written, &slot.read}) {
+            if (*sync != EGL_NO_SYNC_KHR) {
+                mDestroySync(mContext.display, *sync);
+                *sync = EGL_NO_SYNC_KHR;
+            }
+        }
+        glDeleteFramebuffers(2, slot.framebuffers);
+        if (i != orphan) {
+            glDeleteTextures(2, slot.textures);
+        }
+        slot = Slot{};
+    }
+    const int freed = orphan >= 0 ? kSlotCount - 1 : kSlotCount;
+    GpuMemory::Add(GpuMemory::Category::Texture, -freed * slotBytes, -freed * 2);
+    GpuMemory::Add(GpuMemory::Category::Framebuffer, 0, -kSlotCount * 2);
+    glFinish();
+    mContext.ReleaseCurrent();
+    Log::Write(Log::Level::Info, "blit worker: stopped");
+}
+
+bool BlitWorker::LatchInto(Slot& slot) {
+    // The render thread's last copy out of this slot has to finish before it is overwritten.
+    if (slot.read != EGL_NO_SYNC_KHR) {
+        mClientWaitSync(mContext.display, slot.read, EGL_SYNC_FLUSH_COMMANDS_BIT_KHR, EGL_FOREVER_KHR);
+        mDestroySync(mContext.display, slot.read);
+        slot.read = EGL_NO_SYNC_KHR;
+    }
+
+    cxrFramesLatched latched{};
+    const uint64_t latchStartUs = mTrace != nullptr ? mTrace->NowUs() : 0;
+    const cxrError err = cxrLatchFrame(mReceiver, &latched, cxrFrameMask_All, kLatchTimeoutMs);
+    if (mTrace != nullptr && err != cxrError_Frame_Not_Ready) {
+        mTrace->RecordLatch(err, (uint32_t)(mTrace->NowUs() - latchStartUs), err == cxrError_Success ? latched.poseID : 0,
+                            err == cxrError_Success ? latched.frames[0].timeStamp : 0);
+    }
+    if (err != cxrError_Success) {
+        if (err != cxrError_Frame_Not_Ready) {
+            Log::Write(Log::Level::Error, Fmt("blit worker: cxrLatchFrame [%0d] = %s", err, cxrErrorString(err)));
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+
+    const auto blitStart = std::chrono::steady_clock::now();
+    for (uint32_t eye = 0; eye < 2; eye++) {
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, slot.framebuffers[eye]);
+        glViewport(0, 0, mEyeWidth, mEyeHeight);
+        cxrBlitFrame(mReceiver, &latched, 1 << eye);
+    }
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    cxrReleaseFrame(mReceiver, &latched);
+
+    if (slot.written != EGL_NO_SYNC_KHR) {
+        mDestroySync(mContext.display, slot.written);
+    }
+    slot.written = mCreateSync(mContext.display, EGL_SYNC_FENCE_KHR, nullptr);
+    glFlush();
+    slot.latched = latched;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mBlits++;
+    mBlitNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - blitStart).count();
+    return true;
+}
+
+void BlitWorker::PublishMetrics() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    Metrics::Set("cxr.worker_blits", (double)mBlits);
+    Metrics::Set("cxr.worker_blit_ms", mBlits != 0 ? mBlitNs / 1e6 / mBlits : 0.0);
+    Metrics::Set("cxr.worker_repeats", (double)mRepeats);
+    Metrics::Set("cxr.worker_dropped", (double)mDropped);
+    mBlits = 0;
+    mBlitNs = 0;
+    mRepeats = 0;
+    mDropped = 0;
+}
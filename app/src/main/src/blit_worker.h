@@ -0,0 +1,96 @@
+/*
+    optional blit worker for CloudXR frames, adb shell setprop debug.cxr.blitWorker 1.
+    by default the render thread latches, blits and releases every frame itself between xrBeginFrame
+    and xrEndFrame. with the worker, a second EGL context in the render context's share group latches
+    each frame as soon as it arrives, blits both eyes into a small ring of intermediate textures and
+    publishes the slot with an EGL fence. the render thread waits on that fence on the GPU and only
+    copies the newest finished image into the swapchain; a second fence per slot, inserted after
+    that copy, keeps the worker from overwriting an image the copy is still reading.
+*/
+#pragma once
+
+#include <CloudXRClient.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES3/gl3.h>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "egl_context.h"
+
+class FrameTraceWriter;
+
+class BlitWorker {
+public:
+    static const int kSlotCount = 3;
+
+    ~BlitWorker();
+
+    // Render thread, with the render context current. Creates the worker context in its share group.
+    bool CreateContext();
+    void DestroyContext();
+    EGLContext Context() const { return mContext.context; }
+
+    // Starts latching from receiver into eyeWidth x eyeHeight textures while streaming() is true.
+    void Start(cxrReceiverHandle receiver, uint32_t eyeWidth, uint32_t eyeHeight, std::function<bool()> streaming, FrameTraceWriter* trace);
+    void Stop();
+    bool IsRunning() const;
+
+    // Render thread: takes the newest finished frame, which may be the one presented last time.
+    // Only the pose fields of latched are meaningful, the frame itself was released by the worker.
+    bool Acquire(cxrFramesLatched* latched);
+    // Copies one eye of the acquired frame into the bound draw framebuffer.
+    void Blit(uint32_t eye, GLsizei width, GLsizei height);
+    void Release();
+
+private:
+    struct Slot {
+        GLuint textures[2] = {};
+        GLuint framebuffers[2] = {};  // worker context objects
+        cxrFramesLatched latched{};
+        uint64_t sequence = 0;
+        EGLSyncKHR written = EGL_NO_SYNC_KHR;  // signalled when the worker's blit is done
+        EGLSyncKHR read = EGL_NO_SYNC_KHR;     // signalled when the render thread's copy is done
+    };
+
+    void Run();
+    bool LatchInto(Slot& slot);
+    void PublishMetrics();
+
+    EglContext mContext;
+    PFNEGLCREATESYNCKHRPROC mCreateSync = nullptr;
+    PFNEGLDESTROYSYNCKHRPROC mDestroySync = nullptr;
+    PFNEGLCLIENTWAITSYNCKHRPROC mClientWaitSync = nullptr;
+    PFNEGLWAITSYNCKHRPROC mWaitSync = nullptr;  // optional, EGL_KHR_wait_sync
+
+    cxrReceiverHandle mReceiver = nullptr;
+    uint32_t mEyeWidth = 0;
+    uint32_t mEyeHeight = 0;
+    std::function<bool()> mStreaming;
+    FrameTraceWriter* mTrace = nullptr;
+    std::thread mThread;
+
+    mutable std::mutex mMutex;
+    std::condition_variable mReleased;
+    bool mRunning = false;
+    Slot mSlots[kSlotCount];
+    int mLatest = -1;
+    int mAcquired = -1;
+    uint64_t mSequence = 0;
+    uint64_t mPresentedSequence = 0;
+
+    // Textures of a slot Stop() could not wait for: the render thread deletes them in Release().
+    GLuint mOrphaned[2] = {};
+    int64_t mOrphanedBytes = 0;
+
+    // Render thread only.
+    GLuint mReadFramebuffer = 0;
+    GLuint mAcquiredTextures[2] = {};
+
+    // Per-second counters, published to Metrics by the worker.
+    uint64_t mBlits = 0;
+    uint64_t mBlitNs = 0;
+    uint64_t mRepeats = 0;
+    uint64_t mDropped = 0;
+};
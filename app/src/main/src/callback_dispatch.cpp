@@ -0,0 +1,165 @@
+/*
+    timing of the callbacks CloudXR makes on its own threads.
+*/
+#include "pch.h"
+#include "common.h"
+#include "callback_dispatch.h"
+#include "metrics.h"
+
+#include <sstream>
+
+namespace {
+
+const char* const kCallbackNames[] = {"tracking", "haptic", "audio", "state"};
+static_assert(sizeof(kCallbackNames) / sizeof(kCallbackNames[0]) == CallbackDispatch::kCallbackCount, "callback names out of sync");
+
+const uint32_t kDefaultBudgetUs[] = {1000, 1000, 20000, 2000};
+const auto kWatchdogInterval = std::chrono::milliseconds(2);
+
+}  // namespace
+
+CallbackDispatch::Scope::Scope(CallbackDispatch& dispatch, Callback callback) : dispatch(dispatch), callback(callback), startNs(NowNs()) {
+    Slot& slot = dispatch.mSlots[callback];
+    slot.sequence.fetch_add(1, std::memory_order_relaxed);
+    slot.startNs.store(startNs, std::memory_order_release);
+}
+
+CallbackDispatch::Scope::~Scope() {
+    const int64_t endNs = NowNs();
+    dispatch.mSlots[callback].startNs.store(0, std::memory_order_release);
+    dispatch.Record(callback, startNs, endNs);
+}
+
+int64_t CallbackDispatch::NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+void CallbackDispatch::Record(Callback callback, int64_t startNs, int64_t endNs) {
+    Slot& slot = mSlots[callback];
+    const int64_t ns = endNs - startNs;
+    int bucket = 0;
+    for (int64_t us = ns / 1000; us > 0 && bucket < kBucketCount - 1; us >>= 1) {
+        bucket++;
+    }
+    slot.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    if (slot.budgetNs != 0 && ns > slot.budgetNs) {
+        slot.overruns.fetch_add(1, std::memory_order_relaxed);
+    }
+    int64_t maxNs = slot.maxNs.load(std::memory_order_relaxed);
+    while (ns > maxNs && !slot.maxNs.compare_exchange_weak(maxNs, ns, std::memory_order_relaxed)) {
+    }
+}
+
+void CallbackDispatch::Start(const std::string& budgets, bool publishMetrics) {
+    Stop();
+    for (int i = 0; i < kCallbackCount; i++) {
+        mSlots[i].budgetNs = kDefaultBudgetUs[i] * 1000ll;
+    }
+    std::istringstream entries(budgets);
+    std::string entry;
+    while (std::getline(entries, entry, ',')) {
+        const size_t eq = entry.find('=');
+        const std::string name = entry.substr(0, eq);
+        int index = 0;
+        while (index < kCallbackCount && name != kCallbackNames[index]) {
+            index++;
+        }
+        uint32_t us = 0;
+        if (eq == std::string::npos || index == kCallbackCount || sscanf(entry.c_str() + eq + 1, "%u", &us) != 1) {
+            Log::Write(Log::Level::Warning, Fmt("cxr callback budget: ignoring '%s'", entry.c_str()));
+            continue;
+        }
+        mSlots[index].budgetNs = us * 1000ll;
+    }
+    mPublishMetrics = publishMetrics;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mRunning = true;
+    mThread = std::thread(&CallbackDispatch::Run, this);
+}
+
+void CallbackDispatch::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mRunning) {
+            return;
+        }
+        mRunning = false;
+    }
+    mWake.notify_all();
+    mThread.join();
+}
+
+void CallbackDispatch::Run() {
+    auto nextSecond = Clock::now() + std::chrono::seconds(1);
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (!mWake.wait_for(lock, kWatchdogInterval, [this]() { return !mRunning; })) {
+        lock.unlock();
+        CheckInFlight(NowNs());
+        if (Clock::now() >= nextSecond) {
+            nextSecond += std::chrono::seconds(1);
+            PublishSecond();
+        }
+        lock.lock();
+    }
+}
+
+void CallbackDispatch::CheckInFlight(int64_t nowNs) {
+    for (int i = 0; i < kCallbackCount; i++) {
+        Slot& slot = mSlots[i];
+        const uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        const int64_t startNs = slot.startNs.load(std::memory_order_acquire);
+        if (startNs == 0 || slot.budgetNs == 0 || nowNs - startNs <= slot.budgetNs || sequence == slot.reportedSequence) {
+            continue;
+        }
+        // Once per call; it counts as an overrun when it returns.
+        slot.reportedSequence = sequence;
+        Log::Write(Log::Level::Warning, Fmt("cxr callback %s still running after %.1f ms (budget %.1f ms)", kCallbackNames[i], (nowNs - startNs) / 1e6,
+                                            slot.budgetNs / 1e6));
+    }
+}
+
+void CallbackDispatch::PublishSecond() {
+    for (int i = 0; i < kCallbackCount; i++) {
+        Slot& slot = mSlots[i];
+        uint32_t buckets[kBucketCount];
+        uint64_t calls = 0;
+        for (int b = 0; b < kBucketCount; b++) {
+            buckets[b] = slot.buckets[b].exchange(0, std::memory_order_relaxed);
+            calls += buckets[b];
+        }
+        const uint64_t overruns = slot.overruns.exchange(0, std::memory_order_relaxed);
+        const int64_t maxNs = slot.maxNs.exchange(0, std::memory_order_relaxed);
+
+        if (overruns > 0) {
+            Log::Write(Log::Level::Warning, Fmt("cxr callback %s: %llu of %llu calls over budget in the last second, max %.1f ms (budget %.1f ms)",
+                                                kCallbackNames[i], (unsigned long long)overruns, (unsigned long long)calls, maxNs / 1e6,
+                                                slot.budgetNs / 1e6));
+        }
+        if (!mPublishMetrics) {
+            continue;
+        }
+
+        // Percentiles are the upper bound of the bucket they fall into.
+        double p50 = 0.0;
+        double p99 = 0.0;
+        uint64_t seen = 0;
+        for (int b = 0; b < kBucketCount && calls > 0; b++) {
+            const uint64_t before = seen;
+            seen += buckets[b];
+            const double upperUs = (double)(1ull << b);
+            if (before < (calls + 1) / 2 && seen >= (calls + 1) / 2) {
+                p50 = upperUs;
+            }
+            if (before < (calls * 99 + 99) / 100 && seen >= (calls * 99 + 99) / 100) {
+                p99 = upperUs;
+            }
+        }
+        const std::string prefix = std::string("cxr.cb.") + kCallbackNames[i];
+        Metrics::Set(prefix + ".calls", (double)calls);
+        Metrics::Set(prefix + ".p50_us", p50);
+        Metrics::Set(prefix + ".p99_us", p99);
+        Metrics::Set(prefix + ".max_us", maxNs / 1000.0);
+        Metrics::Set(prefix + ".overruns", (double)overruns);
+    }
+}
@@ -0,0 +1,83 @@
+/*
+    timing of the callbacks CloudXR makes on its own threads: GetTrackingState, TriggerHaptic, RenderAudio
+    and UpdateClientState. whatever they block on, a mutex, the log, an Oboe write, the haptics runtime
+    call, blocks the SDK's network and decode threads with them, so every call goes through
+    CallbackDispatch::Call, which times it into a log2 histogram and counts it as an overrun when it took
+    longer than the callback's budget. nothing is logged from the callback itself.
+
+    a watchdog thread looks at the calls in flight every 2 ms and logs a call that has been running past
+    its budget once, before it returns, so a callback that never returns shows up too. once a second it
+    logs the overruns of the last second and, except for load clients, publishes p50, p99, max, calls and
+    overruns per callback to Metrics (cxr.cb.*).
+
+    budgets in microseconds, 0 for none:
+    adb shell setprop debug.cxr.callbackBudget "tracking=1000,haptic=1000,audio=20000,state=2000"
+    (the defaults). RenderAudio blocks in the Oboe write by design while the stream's buffer is full, up to
+    the length of the audio frame, hence its larger budget.
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class CallbackDispatch {
+public:
+    enum Callback { Tracking, Haptic, Audio, State, kCallbackCount };
+
+    ~CallbackDispatch() { Stop(); }
+
+    // Before the receiver is created: budgets as in debug.cxr.callbackBudget, empty for the defaults.
+    void Start(const std::string& budgets, bool publishMetrics);
+    // Once the receiver is destroyed and no more callbacks come.
+    void Stop();
+
+    // CloudXR's threads. Each callback is made by one thread at a time.
+    template <typename Invoke>
+    auto Call(Callback callback, Invoke&& invoke) -> decltype(invoke()) {
+        const Scope scope(*this, callback);
+        return invoke();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    // Bucket i holds calls of [2^(i-1), 2^i) us, bucket 0 those under 1 us, the last one everything longer.
+    static const int kBucketCount = 24;
+
+    struct Scope {
+        Scope(CallbackDispatch& dispatch, Callback callback);
+        ~Scope();
+        CallbackDispatch& dispatch;
+        Callback callback;
+        int64_t startNs;
+    };
+
+    struct Slot {
+        int64_t budgetNs = 0;
+        std::atomic<int64_t> startNs{0};  // of the call in flight, 0 for none
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<uint32_t> buckets[kBucketCount] = {};
+        std::atomic<uint64_t> overruns{0};
+        std::atomic<int64_t> maxNs{0};
+
+        // Watchdog only.
+        uint64_t reportedSequence = 0;
+    };
+
+    static int64_t NowNs();
+    void Record(Callback callback, int64_t startNs, int64_t endNs);
+    void Run();
+    void CheckInFlight(int64_t nowNs);
+    void PublishSecond();
+
+    Slot mSlots[kCallbackCount];
+    bool mPublishMetrics = true;
+
+    std::thread mThread;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    bool mRunning = false;
+};
@@ -48,7 +48,7 @@ inline XrResult CheckXrResult(XrResult res, const char* originator = nullptr, co
 }
 
 #define THROW_XR(xr, cmd) ThrowXrResult(xr, #cmd, FILE_AND_LINE);
-#define CHECK_XRCMD(cmd) CheckXrResult(cmd, #cmd, FILE_AND_LINE);
+#define CHECK_XRCMD(cmd) CheckXrResult(XR_CALL(cmd), #cmd, FILE_AND_LINE);
 #define CHECK_XRRESULT(res, cmdStr) CheckXrResult(res, cmdStr, FILE_AND_LINE);
 
 #ifdef XR_USE_PLATFORM_WIN32
@@ -0,0 +1,168 @@
+/*
+    click-to-photon latency test.
+*/
+#include "pch.h"
+#include "common.h"
+#include "click_to_photon.h"
+#include "metrics.h"
+
+#include <fstream>
+
+namespace {
+
+const char* kReportPath = "/sdcard/CloudXRClickToPhoton.txt";
+const auto kMissedAfter = std::chrono::seconds(1);
+
+double Percentile(std::vector<double> samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    const size_t index = std::min(samples.size() - 1, (size_t)(p / 100.0 * (double)(samples.size() - 1) + 0.5));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+}  // namespace
+
+void ClickToPhoton::Start() {
+    m_running = true;
+    m_pending.clear();
+    m_skipped = 0;
+    m_inputPressed = false;
+    m_pressPending = false;
+    m_shownPressed = false;
+    m_samplesMs.clear();
+    m_presses = 0;
+    m_missed = 0;
+    Log::Write(Log::Level::Info, "click to photon: waiting for trigger presses");
+}
+
+void ClickToPhoton::Stop() {
+    if (!m_running) {
+        return;
+    }
+    m_running = false;
+    for (Slot& slot : m_slots) {
+        if (slot.fence != nullptr) {
+            glDeleteSync(slot.fence);
+        }
+        if (slot.buffer != 0) {
+            glDeleteBuffers(1, &slot.buffer);
+        }
+        slot = Slot{};
+    }
+    m_pending.clear();
+    if (m_presses > 0) {
+        WriteReport();
+    }
+}
+
+void ClickToPhoton::Input(bool pressed, Clock::time_point now) {
+    if (pressed && !m_inputPressed) {
+        if (m_pressPending) {
+            m_missed++;
+        }
+        m_presses++;
+        m_pressPending = true;
+        m_press = now;
+    }
+    m_inputPressed = pressed;
+}
+
+void ClickToPhoton::Readback(int32_t x, int32_t y) {
+    if (m_pending.size() == kSlots) {
+        // The GPU is more than kSlots frames behind, skip rather than wait.
+        m_skipped++;
+        return;
+    }
+    const int index = m_pending.empty() ? 0 : (m_pending.back() + 1) % kSlots;
+    Slot& slot = m_slots[index];
+    if (slot.buffer == 0) {
+        glGenBuffers(1, &slot.buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, 4, nullptr, GL_STREAM_READ);
+    } else {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    }
+    GLint drawFramebuffer = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, drawFramebuffer);
+    glReadPixels(x, y, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.stamped = false;
+    m_pending.push_back(index);
+}
+
+void ClickToPhoton::FrameEnd(Clock::time_point now) {
+    for (int index : m_pending) {
+        if (!m_slots[index].stamped) {
+            m_slots[index].submitted = now;
+            m_slots[index].stamped = true;
+        }
+    }
+    // xrEndFrame flushed the fences; readbacks complete in order.
+    while (!m_pending.empty()) {
+        Slot& slot = m_slots[m_pending.front()];
+        if (glClientWaitSync(slot.fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+            break;
+        }
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+        uint8_t rgba[4] = {};
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        if (const void* pixel = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, 4, GL_MAP_READ_BIT)) {
+            memcpy(rgba, pixel, 4);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        m_pending.pop_front();
+        Shown(IsPressedColor(rgba), slot.submitted);
+    }
+
+    if (m_pressPending && now - m_press > kMissedAfter) {
+        m_pressPending = false;
+        m_missed++;
+        Log::Write(Log::Level::Warning, "click to photon: press not shown within a second");
+    }
+}
+
+void ClickToPhoton::Shown(bool pressed, Clock::time_point submitted) {
+    if (pressed && !m_shownPressed && m_pressPending && submitted >= m_press) {
+        m_pressPending = false;
+        const double ms = std::chrono::duration<double, std::milli>(submitted - m_press).count();
+        m_samplesMs.push_back(ms);
+        Metrics::Set("input.click_to_photon_ms", ms);
+    }
+    m_shownPressed = pressed;
+}
+
+void ClickToPhoton::WriteReport() const {
+    char scenario[PROP_VALUE_MAX] = {};
+    __system_property_get("debug.cxr.standin.scenario", scenario);
+    const double p50 = Percentile(m_samplesMs, 50);
+    const double p90 = Percentile(m_samplesMs, 90);
+    const double p99 = Percentile(m_samplesMs, 99);
+    Log::Write(Log::Level::Info, Fmt("click to photon: %zu of %u presses shown, p50 %.1f ms, p90 %.1f ms, p99 %.1f ms", m_samplesMs.size(),
+                                     m_presses, p50, p90, p99));
+
+    std::ofstream out(kReportPath, std::ios::app);
+    if (!out.is_open()) {
+        Log::Write(Log::Level::Error, Fmt("click to photon: cannot write report to %s", kReportPath));
+        return;
+    }
+    // One block per session, fixed key set, blocks separated by a blank line.
+    out << "scenario=" << (scenario[0] != '\0' ? scenario : "none") << "\n";
+    out << "presses=" << m_presses << "\n";
+    out << "shown=" << m_samplesMs.size() << "\n";
+    out << "missed=" << m_missed << "\n";
+    out << "readbacks_skipped=" << m_skipped << "\n";
+    out << "click_to_photon_ms_min=" << (m_samplesMs.empty() ? 0.0 : *std::min_element(m_samplesMs.begin(), m_samplesMs.end())) << "\n";
+    out << "click_to_photon_ms_p50=" << p50 << "\n";
+    out << "click_to_photon_ms_p90=" << p90 << "\n";
+    out << "click_to_photon_ms_p99=" << p99 << "\n";
+    out << "click_to_photon_ms_max=" << (m_samplesMs.empty() ? 0.0 : *std::max_element(m_samplesMs.begin(), m_samplesMs.end())) << "\n";
+    out << "\n";
+    Log::Write(Log::Level::Info, Fmt("click to photon: report appended to %s", kReportPath));
+}
@@ -0,0 +1,71 @@
+/*
+    click-to-photon latency test, adb shell setprop debug.xr.clickToPhoton 1, against the CloudXR stand-in
+    (CXR_STANDIN=1), which blits white while the tracking state it polled had a trigger pulled.
+    a press is the first xrSyncActions that sees either trigger past half way; the fake runtime plays
+    scripted presses, e.g. fake_runtime/scripts/click_to_photon.txt. after the blit into the left eye
+    image the render thread copies its center pixel into a pixel pack buffer behind a fence, and reads
+    it frames later once the fence has passed, so the test never stalls the frame loop. the photon is
+    the xrEndFrame of the first frame whose pixel turned white after the press; compositor latency
+    is the runtime's and not included.
+
+    every sample goes to Metrics as input.click_to_photon_ms. when the session stops, the distribution is
+    appended to /sdcard/CloudXRClickToPhoton.txt as key=value lines labelled with the stand-in scenario
+    (debug.cxr.standin.scenario), so runs over several impairment scenarios end up in one file. a press
+    not shown within a second counts as missed.
+*/
+#pragma once
+
+#include <GLES3/gl3.h>
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+
+class ClickToPhoton {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void Start();
+    // Render thread, with the context current: writes the report and frees the buffers.
+    void Stop();
+    bool IsRunning() const { return m_running; }
+
+    // Render thread, after xrSyncActions.
+    void Input(bool pressed, Clock::time_point now);
+    // Render thread, right after a stream frame was blitted into the bound draw framebuffer.
+    void Readback(int32_t x, int32_t y);
+    // Render thread, after xrEndFrame: the readbacks of this frame were submitted at now.
+    void FrameEnd(Clock::time_point now);
+
+    // Green past half: the stand-in's press color, its color cycle keeps green at a quarter.
+    static bool IsPressedColor(const uint8_t rgba[4]) { return rgba[1] > 128; }
+
+    const std::vector<double>& Samples() const { return m_samplesMs; }
+    uint32_t Missed() const { return m_missed; }
+
+private:
+    static const int kSlots = 4;
+
+    struct Slot {
+        GLuint buffer{0};
+        GLsync fence{nullptr};
+        Clock::time_point submitted{};
+        bool stamped{false};
+    };
+
+    void Shown(bool pressed, Clock::time_point submitted);
+    void WriteReport() const;
+
+    bool m_running{false};
+    Slot m_slots[kSlots];
+    std::deque<int> m_pending;  // slots in readback order
+    uint32_t m_skipped{0};
+
+    bool m_inputPressed{false};
+    bool m_pressPending{false};
+    Clock::time_point m_press{};
+    bool m_shownPressed{false};
+    std::vector<double> m_samplesMs;
+    uint32_t m_presses{0};
+    uint32_t m_missed{0};
+};
@@ -9,10 +9,18 @@
 #include <EGL/egl.h>
 #include <GLES3/gl3.h>
 #include "logger.h"
+#include "metrics.h"
+#include "hitch_monitor.h"
+#include "memory_monitor.h"
 #include "common/gfxwrapper_opengl.h"
 
 static CloudXR::ClientOptions s_options;
 
+static const char* kDecoderVerdictPath = "/sdcard/CloudXRDecoderVerdicts.txt";
+static const uint32_t kDecoderCalibrationSeconds = 5;
+// Throttled stream, see stream_throttle.h: the bitrate cap when no maximum is configured.
+static const uint32_t kThrottledBitrateKbps = 10000;
+
 CloudXRClient::CloudXRClient(): mReceiver(nullptr), mClientState(cxrClientState_ReadyToConnect), mInstance(nullptr), mSystemId(0), mSession(nullptr) {
     memset(&mDeviceDesc, 0x00, sizeof(mDeviceDesc));
     mIsPaused = true;
@@ -26,6 +34,7 @@ CloudXRClient::CloudXRClient(): mReceiver(nullptr), mClientState(cxrClientState_
 }
 
 CloudXRClient::~CloudXRClient() {
+    mBlitWorker.DestroyContext();
 }
 
 void CloudXRClient::Initialize(XrInstance instance, XrSystemId systemId, XrSession session, float fps, bool isSupportFov, void* arg, traggerHapticCallback traggerHaptic) {
@@ -41,7 +50,10 @@ void CloudXRClient::Initialize(XrInstance instance, XrSystemId systemId, XrSessi
 
     Log::Write(Log::Level::Info, Fmt("ipd:%f", mIPD));
 
-    s_options.ParseFile("/sdcard/CloudXRLaunchOptions.txt");
+    // adb shell setprop debug.cxr.launchOptions <file> reads the launch options from elsewhere.
+    char launchOptions[PROP_VALUE_MAX] = {};
+    __system_property_get("debug.cxr.launchOptions", launchOptions);
+    s_options.ParseFile(launchOptions[0] != '\0' ? launchOptions : "/sdcard/CloudXRLaunchOptions.txt");
 
     mContext.type = cxrGraphicsContext_GLES;
     mContext.egl.display = eglGetCurrentDisplay();
@@ -55,8 +67,20 @@ void CloudXRClient::Initialize(XrInstance instance, XrSystemId systemId, XrSessi
         return;
     }
 
+    // adb shell setprop debug.cxr.blitWorker 1 moves latch and blit off the render thread, see blit_worker.h
+    char blitWorker[PROP_VALUE_MAX] = {};
+    __system_property_get("debug.cxr.blitWorker", blitWorker);
+    mUseBlitWorker = atoi(blitWorker) != 0 && mBlitWorker.CreateContext();
+    if (mUseBlitWorker) {
+        mContext.egl.context = mBlitWorker.Context();
+    }
+
+    SelectDecoder();
+
     std::thread([=](){
+        HitchMonitor::RegisterThread("cxr supervisor");
         static uint64_t lastTimeMs = 0;
+        static uint64_t lastMetricsMs = 0;
         while (true) {
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
@@ -69,31 +93,81 @@ void CloudXRClient::Initialize(XrInstance instance, XrSystemId systemId, XrSessi
                 }
             }
 
+            // The render thread may tear the receiver down between frames, see ServiceReceiver.
+            std::unique_lock<std::mutex> receiverLock(mReceiverMutex);
             if (mReceiver && mClientState == cxrClientState_StreamingSessionInProgress) {
                 uint64_t nowTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();  //milliseconds
                 // display network quality information pre second
                 if (nowTimeMs - lastTimeMs >= 1000) {
                     lastTimeMs = nowTimeMs;
                     cxrConnectionStats stats = {0};
-                    cxrError ret = cxrGetConnectionStats(mReceiver, &stats);
-                    if (ret == cxrError_Success) {
-                        Log::Write(Log::Level::Info, Fmt("clientstats framesPerSecond:%f, frameDeliveryTime:%f, frameQueueTime:%f, frameLatchTime:%f", 
-                            stats.framesPerSecond, stats.frameDeliveryTime, stats.frameQueueTime, stats.frameLatchTime));
-                        Log::Write(Log::Level::Info, Fmt("bandKbps:%6d, bandwidthUtilizationKbps:%5d, bandUtilizationPercent:%d%%, roundTripDelayMs:%d, "
-                            "jitterUs:%d, totalPacketsReceived:%d, totalPacketsLost:%d, totalPacketsDropped:%d, quality:%d, qualityReasons:%d",
-                            stats.bandwidthAvailableKbps, stats.bandwidthUtilizationKbps, stats.bandwidthUtilizationPercent, stats.roundTripDelayMs,
-                            stats.jitterUs, stats.totalPacketsReceived, stats.totalPacketsLost, stats.totalPacketsDropped, stats.quality, stats.qualityReasons));    
-                    } else {
-                        Log::Write(Log::Level::Error, Fmt("cxrGetConnectionStats error %d", ret));
+                    const bool statsValid = PollStats(&stats);
+
+                    if (statsValid && mDecoderCalibration.Active()) {
+                        const bool recreate = mDecoderCalibration.AddSecond(stats.framesPerSecond, stats.frameDeliveryTime, stats.frameLatchTime,
+                                                                            stats.totalPacketsReceived, stats.totalPacketsDropped);
+                        if (!mDecoderCalibration.Active()) {
+                            Log::Write(Log::Level::Info, Fmt("decoder calibration: %s wins for %s", mDecoderCalibration.Current().name, mDecoderDeviceKey.c_str()));
+                            if (!DecoderSelection::SaveVerdict(kDecoderVerdictPath, mDecoderDeviceKey, mDecoderCalibration.Current().name)) {
+                                Log::Write(Log::Level::Error, Fmt("decoder calibration: cannot write %s", kDecoderVerdictPath));
+                            }
+                        }
+                        if (recreate) {
+                            // The render thread may be latching from this receiver, it recreates it between frames.
+                            mDecoderFlags = mDecoderCalibration.Current().debugFlags;
+                            mRecreateRequested = true;
+                        }
                     }
                 }
             }
+            receiverLock.unlock();
+
+            uint64_t nowMetricsMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            if (nowMetricsMs - lastMetricsMs >= 1000) {
+                lastMetricsMs = nowMetricsMs;
+                Metrics::Write(Log::Level::Info);
+            }
         }
 
         Log::Write(Log::Level::Warning, Fmt("exit cloudxr thread ......"));
     }).detach(); 
 }
 
+bool CloudXRClient::PollStats(cxrConnectionStats *stats) {
+    const cxrError ret = cxrGetConnectionStats(mReceiver, stats);
+    if (ret == cxrError_Success) {
+        if (mPublishMetrics) {
+            Metrics::Set("cxr.fps", stats->framesPerSecond);
+            Metrics::Set("cxr.delivery_ms", stats->frameDeliveryTime);
+            Metrics::Set("cxr.latch_ms", stats->frameLatchTime);
+            Metrics::Set("cxr.rtt_ms", stats->roundTripDelayMs);
+        }
+        mFrameTrace.RecordStats(stats->framesPerSecond, stats->frameDeliveryTime, stats->frameQueueTime, stats->frameLatchTime,
+            stats->bandwidthAvailableKbps, stats->roundTripDelayMs, stats->jitterUs, stats->totalPacketsLost);
+        Log::Write(Log::Level::Info, Fmt("clientstats framesPerSecond:%f, frameDeliveryTime:%f, frameQueueTime:%f, frameLatchTime:%f", 
+            stats->framesPerSecond, stats->frameDeliveryTime, stats->frameQueueTime, stats->frameLatchTime));
+        Log::Write(Log::Level::Info, Fmt("bandKbps:%6d, bandwidthUtilizationKbps:%5d, bandUtilizationPercent:%d%%, roundTripDelayMs:%d, "
+            "jitterUs:%d, totalPacketsReceived:%d, totalPacketsLost:%d, totalPacketsDropped:%d, quality:%d, qualityReasons:%d",
+            stats->bandwidthAvailableKbps, stats->bandwidthUtilizationKbps, stats->bandwidthUtilizationPercent, stats->roundTripDelayMs,
+            stats->jitterUs, stats->totalPacketsReceived, stats->totalPacketsLost, stats->totalPacketsDropped, stats->quality, stats->qualityReasons));    
+    } else {
+        Log::Write(Log::Level::Error, Fmt("cxrGetConnectionStats error %d", ret));
+    }
+    mFrameTrace.Flush();
+    return ret == cxrError_Success;
+}
+
+bool CloudXRClient::StartLoadClient(const std::string& server, const cxrDeviceDesc& deviceDesc, const cxrGraphicsContext& context) {
+    mServerAddress = server;
+    mDeviceDesc = deviceDesc;
+    mDeviceDescFixed = true;
+    mContext = context;
+    mPublishMetrics = false;
+    return CreateReceiver();
+}
+
+void CloudXRClient::StopLoadClient() { TeardownReceiver(); }
+
 bool CloudXRClient::Start() {
     Log::Write(Log::Level::Info, Fmt("CloudXRClient::Start ......"));
     return CreateReceiver();
@@ -130,6 +204,28 @@ void CloudXRClient::SetSenserPoseState(XrPosef& pose, XrVector3f& linearVelocity
     Log::Write(Log::Level::Info, Fmt("IPD (mm) = %.7f", IPD_in_mm));
 }
 
+void CloudXRClient::ServiceReceiver() {
+    if (mRecreateRequested.exchange(false) && mReceiver && mClientState == cxrClientState_StreamingSessionInProgress) {
+        Log::Write(Log::Level::Info, "Recreating the receiver");
+        Stop();
+        Start();
+    }
+}
+
+void CloudXRClient::SetStreamThrottled(bool throttled) {
+    if (mThrottled == throttled) {
+        return;
+    }
+    mThrottled = throttled;
+    Log::Write(Log::Level::Info, Fmt("stream throttle: %s", throttled ? "reduced rate" : "full rate"));
+    // The frame rate and bitrate are fixed at connect: a live stream reconnects to pick them up. This is
+    // the render thread between frames, so nothing latches from the receiver being replaced.
+    if (mReceiver && mClientState == cxrClientState_StreamingSessionInProgress) {
+        Stop();
+        Start();
+    }
+}
+
 void CloudXRClient::SetTrackingState(cxrVRTrackingState &trackingState) {
     for (uint32_t i = 0; i < CXR_NUM_CONTROLLERS; i++) {
         uint32_t booleanComps = mTrackingState.controller[i].booleanComps;
@@ -156,7 +252,7 @@ void CloudXRClient::GetTrackingState(cxrVRTrackingState *trackingState) {
     *trackingState = mTrackingState;
 }
 
-bool CloudXRClient::SetupFramebuffer(GLuint colorTexture, uint32_t eye, uint32_t width, uint32_t height) {
+bool CloudXRClient::SetupFramebuffer(GLuint colorTexture, uint32_t eye, const XrRect2Di& rect) {
 
     if (mFramebuffers[eye] == 0)
     {
@@ -174,6 +270,7 @@ bool CloudXRClient::SetupFramebuffer(GLuint colorTexture, uint32_t eye, uint32_t
 
         glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
         mFramebuffers[eye] = framebuffer;
+        GpuMemory::Add(GpuMemory::Category::Framebuffer, 0);
         Log::Write(Log::Level::Info, Fmt("Created FBO %d for eye%d texture %d.", framebuffer, eye, colorTexture));
         glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mFramebuffers[eye]);
     }
@@ -182,31 +279,97 @@ bool CloudXRClient::SetupFramebuffer(GLuint colorTexture, uint32_t eye, uint32_t
         glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mFramebuffers[eye]);
         glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
     }
-    glViewport(0, 0, width, height);
+    glViewport(rect.offset.x, rect.offset.y, rect.extent.width, rect.extent.height);
+    mFramebufferSizes[eye][0] = rect.extent.width;
+    mFramebufferSizes[eye][1] = rect.extent.height;
     return true;
 }
 
 bool CloudXRClient::LatchFrame(cxrFramesLatched *framesLatched) {
+    mLastLatchUs = 0;
+    if (mUseBlitWorker) {
+        // The worker latches every frame as it arrives, so nothing backs up; the drain only tracks how old the shown frame is.
+        const uint64_t acquireStartUs = mFrameTrace.NowUs();
+        const bool acquired = mBlitWorker.Acquire(framesLatched);
+        mLastLatchUs = (uint32_t)(mFrameTrace.NowUs() - acquireStartUs);
+        if (acquired) {
+            mFrameDrain.OnLatched(framesLatched->frames[0].timeStamp);
+        }
+        PublishDrainMetrics();
+        return acquired;
+    }
+
     const uint32_t timeoutMs = 500;
     bool frameValid = false;
     if (mReceiver) {
         if (mClientState == cxrClientState_StreamingSessionInProgress) {
+            // Skip what queued up behind the last shown frame; the frame shown below is still waited for.
+            while (mDrainEnabled && mFrameDrain.Backlog() > 0) {
+                cxrFramesLatched stale{};
+                if (cxrLatchFrame(mReceiver, &stale, cxrFrameMask_All, 0) != cxrError_Success) {
+                    break;
+                }
+                mFrameTrace.RecordLatch(cxrError_Success, 0, stale.poseID, stale.frames[0].timeStamp);
+                cxrReleaseFrame(mReceiver, &stale);
+                mFrameDrain.OnDrained(false);
+            }
+
+            const uint64_t latchStartUs = mFrameTrace.NowUs();
             cxrError frameErr = cxrLatchFrame(mReceiver, framesLatched, cxrFrameMask_All, timeoutMs);
+            mLastLatchUs = (uint32_t)(mFrameTrace.NowUs() - latchStartUs);
             frameValid = (frameErr == cxrError_Success);
+            mFrameTrace.RecordLatch(frameErr, mLastLatchUs, frameValid ? framesLatched->poseID : 0, frameValid ? framesLatched->frames[0].timeStamp : 0);
             if (!frameValid) {
                 if (frameErr == cxrError_Frame_Not_Ready) {
                     Log::Write(Log::Level::Info, Fmt("Error in LatchFrame, frame not ready for %d ms", timeoutMs));
                 } else {
                     Log::Write(Log::Level::Error, Fmt("Error in LatchFrame [%0d] = %s", frameErr, cxrErrorString(frameErr)));
                 }
+            } else {
+                mFrameDrain.OnLatched(framesLatched->frames[0].timeStamp);
             }
+            PublishDrainMetrics();
         }
     }
     return frameValid;
 }
 
+void CloudXRClient::ShedBlitWorker() {
+    if (!mUseBlitWorker) {
+        return;
+    }
+    mBlitWorker.Stop();
+    mUseBlitWorker = false;
+    Log::Write(Log::Level::Info, "Blit worker shed, latching on the render thread");
+}
+
+void CloudXRClient::DrainFrames() {
+    // The blit worker latches continuously and keeps only the newest frame anyway.
+    if (!mDrainEnabled || mUseBlitWorker || !mReceiver || mClientState != cxrClientState_StreamingSessionInProgress) {
+        return;
+    }
+    cxrFramesLatched stale{};
+    while (cxrLatchFrame(mReceiver, &stale, cxrFrameMask_All, 0) == cxrError_Success) {
+        mFrameTrace.RecordLatch(cxrError_Success, 0, stale.poseID, stale.frames[0].timeStamp);
+        cxrReleaseFrame(mReceiver, &stale);
+        mFrameDrain.OnDrained(true);
+    }
+    PublishDrainMetrics();
+}
+
+void CloudXRClient::PublishDrainMetrics() {
+    uint32_t queueDepth = 0, drained = 0, drainedIdle = 0;
+    if (mFrameDrain.TakeWindow(&queueDepth, &drained, &drainedIdle) && mPublishMetrics) {
+        Metrics::Set("cxr.queue_depth", queueDepth);
+        Metrics::Set("cxr.drained", drained);
+        Metrics::Set("cxr.drained_idle", drainedIdle);
+    }
+}
+
 void CloudXRClient::BlitFrame(cxrFramesLatched *framesLatched, bool frameValid, uint32_t eye) {
-    if (frameValid) {
+    if (frameValid && mUseBlitWorker) {
+        mBlitWorker.Blit(eye, mFramebufferSizes[eye][0], mFramebufferSizes[eye][1]);
+    } else if (frameValid) {
         cxrBlitFrame(mReceiver, framesLatched, 1 << eye);
     } else {
         FillBackground();
@@ -214,7 +377,11 @@ void CloudXRClient::BlitFrame(cxrFramesLatched *framesLatched, bool frameValid,
 }
 
 void CloudXRClient::ReleaseFrame(cxrFramesLatched *framesLatched) {
-    cxrReleaseFrame(mReceiver, framesLatched);
+    if (mUseBlitWorker) {
+        mBlitWorker.Release();
+    } else {
+        cxrReleaseFrame(mReceiver, framesLatched);
+    }
 }
 
 void CloudXRClient::FillBackground() {
@@ -231,12 +398,15 @@ bool CloudXRClient::CreateReceiver() {
         return true;
     }
 //    s_options.mServerIP = "192.168.1.110";
-    if (s_options.mServerIP.empty()) {
+    const std::string& serverIP = mServerAddress.empty() ? s_options.mServerIP : mServerAddress;
+    if (serverIP.empty()) {
         Log::Write(Log::Level::Error, Fmt("no server ip specifid!!!!!!"));
         return false;
     }
 
-    GetDeviceDesc(&mDeviceDesc);
+    if (!mDeviceDescFixed) {
+        GetDeviceDesc(&mDeviceDesc);
+    }
 
     if (mDeviceDesc.receiveAudio) {
         // Initialize audio playback
@@ -268,45 +438,29 @@ bool CloudXRClient::CreateReceiver() {
         }
     }
 
-    Log::Write(Log::Level::Info, Fmt("Trying to create Receiver at %s.", s_options.mServerIP.c_str()));
+    Log::Write(Log::Level::Info, Fmt("Trying to create Receiver at %s.", serverIP.c_str()));
 
+    // Every callback goes through mCallbacks, which times it against its budget, see callback_dispatch.h
     cxrClientCallbacks clientProxy = {nullptr};
     clientProxy.GetTrackingState = [](void *context, cxrVRTrackingState *trackingState) {
-        return reinterpret_cast<CloudXRClient*>(context)->GetTrackingState(trackingState);
+        CloudXRClient *client = reinterpret_cast<CloudXRClient*>(context);
+        client->mCallbacks.Call(CallbackDispatch::Tracking, [&]() { client->GetTrackingState(trackingState); });
     };
 
     clientProxy.TriggerHaptic = [](void *context, const cxrHapticFeedback *haptic) {
-        auto &haptic1 = const_cast<cxrHapticFeedback &>(*haptic);
-        return reinterpret_cast<CloudXRClient*>(context)->TriggerHaptic(haptic);
+        CloudXRClient *client = reinterpret_cast<CloudXRClient*>(context);
+        client->mCallbacks.Call(CallbackDispatch::Haptic, [&]() { client->TriggerHaptic(haptic); });
     };
 
     clientProxy.RenderAudio = [](void *context, const cxrAudioFrame *audioFrame) {
-        return reinterpret_cast<CloudXRClient*>(context)->RenderAudio(audioFrame);
+        CloudXRClient *client = reinterpret_cast<CloudXRClient*>(context);
+        return client->mCallbacks.Call(CallbackDispatch::Audio, [&]() { return client->RenderAudio(audioFrame); });
     };
 
     //the client_lib calls into here when the async connection status changes
     clientProxy.UpdateClientState = [](void *context, cxrClientState state, cxrStateReason reason) {
-        switch (state) {
-            case cxrClientState_ReadyToConnect:
-                Log::Write(Log::Level::Info, Fmt("ready to connect......"));
-                break;
-            case cxrClientState_ConnectionAttemptInProgress:
-                Log::Write(Log::Level::Error, Fmt("Connection attempt in progress......"));
-                break;
-            case cxrClientState_ConnectionAttemptFailed:
-                Log::Write(Log::Level::Error, Fmt("Connection attempt failed. [%i]", reason));
-                break;
-            case cxrClientState_StreamingSessionInProgress:
-                Log::Write(Log::Level::Info, Fmt("Async connection succeeded."));
-                break;
-            case cxrClientState_Disconnected:
-                Log::Write(Log::Level::Error, Fmt("Server disconnected with reason: %d", reason));
-                break;
-            default:
-                Log::Write(Log::Level::Error, Fmt("Client state updated: %d, reason: %d", state, reason));
-                break;
-        }
-        reinterpret_cast<CloudXRClient *>(context)->mClientState = state;
+        CloudXRClient *client = reinterpret_cast<CloudXRClient*>(context);
+        client->mCallbacks.Call(CallbackDispatch::State, [&]() { client->UpdateClientState(state, reason); });
     };
 
     cxrReceiverDesc desc = { 0 };
@@ -317,32 +471,65 @@ bool CloudXRClient::CreateReceiver() {
     desc.shareContext = &mContext;
     desc.numStreams = 2;
     desc.receiverMode = cxrStreamingMode_XR;
-    desc.debugFlags = s_options.mDebugFlags;
-    //desc.debugFlags |= cxrDebugFlags_EnableAImageReaderDecoder + cxrDebugFlags_LogVerbose + cxrDebugFlags_OutputLinearRGBColor;
-    desc.debugFlags |= cxrDebugFlags_LogVerbose + cxrDebugFlags_OutputLinearRGBColor;
+    desc.debugFlags = s_options.mDebugFlags | mDecoderFlags | cxrDebugFlags_OutputLinearRGBColor;
+    if (mLogVerbose) {
+        desc.debugFlags |= cxrDebugFlags_LogVerbose;
+    }
     desc.logMaxSizeKB = CLOUDXR_LOG_MAX_DEFAULT;
     desc.logMaxAgeDays = CLOUDXR_LOG_MAX_DEFAULT;
 
+    // adb shell setprop debug.cxr.callbackBudget, see callback_dispatch.h
+    char callbackBudget[PROP_VALUE_MAX] = {};
+    __system_property_get("debug.cxr.callbackBudget", callbackBudget);
+    mCallbacks.Start(callbackBudget, mPublishMetrics);
+
     cxrError err = cxrCreateReceiver(&desc, &mReceiver);
     if (err != cxrError_Success) {
         Log::Write(Log::Level::Error, Fmt("Failed to create CloudXR receiver. Error %d, %s.", err, cxrErrorString(err)));
+        mCallbacks.Stop();
         return false;
     }
     Log::Write(Log::Level::Info, Fmt("cxrCreateReceiver mReceiver:%p", mReceiver));
 
+    // adb shell setprop debug.cxr.drain 0 shows queued frames oldest first again, see frame_drain.h
+    char drain[PROP_VALUE_MAX] = {};
+    if (__system_property_get("debug.cxr.drain", drain) != 0) {
+        mDrainEnabled = atoi(drain) != 0;
+    }
+    mFrameDrain.Reset(mDeviceDesc.fps);
+
+    if (mUseBlitWorker) {
+        mBlitWorker.Start(mReceiver, mDeviceDesc.width, mDeviceDesc.height,
+                          [this]() { return mClientState == cxrClientState_StreamingSessionInProgress; }, &mFrameTrace);
+    }
+
+    // adb shell setprop debug.cxr.trace /sdcard/CloudXRFrameTrace.bin, replay with the stand-in's debug.cxr.standin.replay
+    // Not for load clients, they would all write the same file.
+    char tracePath[PROP_VALUE_MAX] = {};
+    if (mPublishMetrics && __system_property_get("debug.cxr.trace", tracePath) != 0) {
+        if (mFrameTrace.Open(tracePath)) {
+            Log::Write(Log::Level::Info, Fmt("Recording frame trace to %s", tracePath));
+        } else {
+            Log::Write(Log::Level::Error, Fmt("Failed to open frame trace %s", tracePath));
+        }
+    }
+
     mConnectionDesc.async = cxrTrue;
     mConnectionDesc.maxVideoBitrateKbps = s_options.mMaxVideoBitrate;
+    if (mThrottled) {
+        mConnectionDesc.maxVideoBitrateKbps = s_options.mMaxVideoBitrate > 0 ? s_options.mMaxVideoBitrate / 4 : kThrottledBitrateKbps;
+    }
     mConnectionDesc.clientNetwork = s_options.mClientNetwork;
     mConnectionDesc.topology = s_options.mTopology;
-    err = cxrConnect(mReceiver, s_options.mServerIP.c_str(), &mConnectionDesc);
+    err = cxrConnect(mReceiver, serverIP.c_str(), &mConnectionDesc);
     if (!mConnectionDesc.async) {
         if (err != cxrError_Success) {
-            Log::Write(Log::Level::Error, Fmt("Failed to connect to CloudXR server at %s. Error %d, %s.", s_options.mServerIP.c_str(), (int) err, cxrErrorString(err)));
+            Log::Write(Log::Level::Error, Fmt("Failed to connect to CloudXR server at %s. Error %d, %s.", serverIP.c_str(), (int) err, cxrErrorString(err)));
             TeardownReceiver();
             return false;
         } else {
             mClientState = cxrClientState_StreamingSessionInProgress;
-            Log::Write(Log::Level::Info, Fmt("Receiver created for server: %s", s_options.mServerIP.c_str()));
+            Log::Write(Log::Level::Info, Fmt("Receiver created for server: %s", serverIP.c_str()));
         }
     }
     return true;
@@ -357,10 +544,50 @@ void CloudXRClient::TeardownReceiver() {
     if (mPlaybackStream) {
         mPlaybackStream->stop();
     }
+    mBlitWorker.Stop();
     if (mReceiver != nullptr) {
+        std::lock_guard<std::mutex> lock(mReceiverMutex);
         cxrDestroyReceiver(mReceiver);
         mReceiver = nullptr;
     }
+    mCallbacks.Stop();
+    mFrameTrace.Close();
+}
+
+void CloudXRClient::SelectDecoder() {
+    // adb shell setprop debug.cxr.logVerbose 1 for CloudXR's verbose log, it costs time on every frame.
+    char value[PROP_VALUE_MAX] = {};
+    __system_property_get("debug.cxr.logVerbose", value);
+    mLogVerbose = atoi(value) != 0;
+
+    // adb shell setprop debug.cxr.decoder, see decoder_selection.h
+    value[0] = '\0';
+    __system_property_get("debug.cxr.decoder", value);
+    const std::string setting = value[0] != '\0' ? value : "mediacodec";
+    const DecoderBackend* backend = DecoderSelection::Find(setting);
+    const char* source = "";
+    if (setting == "auto" || setting == "calibrate") {
+        char model[PROP_VALUE_MAX] = {};
+        char build[PROP_VALUE_MAX] = {};
+        __system_property_get("ro.product.model", model);
+        __system_property_get("ro.build.id", build);
+        mDecoderDeviceKey = std::string(model) + "/" + build;
+
+        std::string cached;
+        if (setting == "auto" && DecoderSelection::LoadVerdict(kDecoderVerdictPath, mDecoderDeviceKey, &cached)) {
+            backend = DecoderSelection::Find(cached);
+            source = ", cached verdict";
+        } else {
+            mDecoderCalibration.Begin(mFps, kDecoderCalibrationSeconds);
+            backend = &mDecoderCalibration.Current();
+            source = ", calibrating";
+        }
+    } else if (backend == nullptr) {
+        Log::Write(Log::Level::Warning, Fmt("Unknown debug.cxr.decoder %s", setting.c_str()));
+        backend = &DecoderSelection::Backends()[0];
+    }
+    mDecoderFlags = backend->debugFlags;
+    Log::Write(Log::Level::Info, Fmt("decoder: %s%s%s", backend->name, source, mLogVerbose ? ", verbose log" : ""));
 }
 
 void CloudXRClient::GetDeviceDesc(cxrDeviceDesc *desc) const {
@@ -394,10 +621,10 @@ void CloudXRClient::GetDeviceDesc(cxrDeviceDesc *desc) const {
     desc->deliveryType = cxrDeliveryType_Stereo_RGB;
     desc->width = configViews[0].recommendedImageRectWidth;
     desc->height = configViews[0].recommendedImageRectHeight;
-    desc->fps = mFps;
+    desc->fps = mThrottled ? mFps / 2 : mFps;
     desc->ipd = mIPD;
     desc->predOffset = -0.02f;
-    desc->receiveAudio = true;
+    desc->receiveAudio = s_options.mReceiveAudio;
     desc->sendAudio = false;
     desc->posePollFreq = 0;
     desc->ctrlType = cxrControllerType_OculusTouch;
@@ -405,7 +632,7 @@ void CloudXRClient::GetDeviceDesc(cxrDeviceDesc *desc) const {
     desc->angularVelocityInDeviceSpace = false;
     desc->disableVVSync = false;
     desc->foveatedScaleFactor = (s_options.mFoveation > 0 && s_options.mFoveation < 100) ? s_options.mFoveation : 0;
-    desc->maxResFactor = 1.0f;
+    desc->maxResFactor = mMaxResFactor;
 
     for (int i = 0; i < viewCount; i++) {
         if (configViews[i].next) {
@@ -623,7 +850,37 @@ void CloudXRClient::TriggerHaptic(const cxrHapticFeedback *hapticFeedback) {
     }
 }
 
+void CloudXRClient::UpdateClientState(cxrClientState state, cxrStateReason reason) {
+    switch (state) {
+        case cxrClientState_ReadyToConnect:
+            Log::Write(Log::Level::Info, Fmt("ready to connect......"));
+            break;
+        case cxrClientState_ConnectionAttemptInProgress:
+            Log::Write(Log::Level::Error, Fmt("Connection attempt in progress......"));
+            break;
+        case cxrClientState_ConnectionAttemptFailed:
+            Log::Write(Log::Level::Error, Fmt("Connection attempt failed. [%i]", reason));
+            break;
+        case cxrClientState_StreamingSessionInProgress:
+            Log::Write(Log::Level::Info, Fmt("Async connection succeeded."));
+            break;
+        case cxrClientState_Disconnected:
+            Log::Write(Log::Level::Error, Fmt("Server disconnected with reason: %d", reason));
+            break;
+        default:
+            Log::Write(Log::Level::Error, Fmt("Client state updated: %d, reason: %d", state, reason));
+            break;
+    }
+    mClientState = state;
+}
+
 cxrBool CloudXRClient::RenderAudio(const cxrAudioFrame *audioFrame) {
+    // CloudXR's audio thread, blocked in the write below most of the time: never signalled, see hitch_monitor.h.
+    static thread_local bool registered = false;
+    if (!registered) {
+        registered = true;
+        HitchMonitor::RegisterThread("audio", false);
+    }
     if (!mPlaybackStream.get()) {
         return cxrFalse;
     }
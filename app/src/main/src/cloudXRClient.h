@@ -9,9 +9,15 @@
 #include <CloudXRClient.h>
 #include <GLES3/gl3.h>
 #include <GLES3/gl3ext.h>
+#include <atomic>
 #include <map>
 #include <memory>
 #include <mutex>
+#include "frametrace.h"
+#include "blit_worker.h"
+#include "decoder_selection.h"
+#include "frame_drain.h"
+#include "callback_dispatch.h"
 
 typedef void (*traggerHapticCallback)(void* arg, int controllerIdx, float amplitude, float seconds, float frequency);
 
@@ -26,12 +32,32 @@ public:
 
     void SetPaused(bool pause);
 
+    // Render thread, between frames: recreates the receiver when the client thread asked for it, e.g. for
+    // the next decoder calibration step. Nothing latches or blits while that happens.
+    void ServiceReceiver();
+
+    // Render thread, between frames, see stream_throttle.h: reconnects at half the frame rate and a quarter
+    // of the bitrate, or back at full rate. Load clients are never throttled.
+    void SetStreamThrottled(bool throttled);
+
     bool LatchFrame(cxrFramesLatched *framesLatched);
 
     void BlitFrame(cxrFramesLatched *framesLatched, bool frameValid, uint32_t eye);
 
     void ReleaseFrame(cxrFramesLatched *framesLatched);
 
+    // For display frames that show no stream, e.g. tracking lost or not visible: releases everything queued.
+    void DrainFrames();
+
+    // How long the frame LatchFrame returned last had been queued in the receiver.
+    float LastFrameWaitMs() const { return mFrameDrain.LastWaitMs(); }
+    // Render thread: how long the last LatchFrame blocked in cxrLatchFrame, or for the blit worker, latched or not.
+    uint32_t LastLatchUs() const { return mLastLatchUs; }
+
+    // Render thread, between frames: stops the blit worker and frees its textures, the render thread latches from then on.
+    // The receiver keeps the worker's context, which shares with the render context.
+    void ShedBlitWorker();
+
     void SetSenserPoseState(XrPosef& pose, XrVector3f& linearVelocity, XrVector3f& angularVelocity, std::vector<XrPosef> &handPose, float ipd);
 
     XrQuaternionf cxrToQuaternion(const cxrMatrix34 &m);
@@ -40,7 +66,21 @@ public:
 
     void SetTrackingState(cxrVRTrackingState &trackingState);
 
-    bool SetupFramebuffer(GLuint colorTexture, uint32_t eye, uint32_t width, uint32_t height);
+    // Binds the eye's FBO to colorTexture with the viewport at rect, the streamed part of the swapchain image.
+    bool SetupFramebuffer(GLuint colorTexture, uint32_t eye, const XrRect2Di& rect);
+
+    // Before Initialize: how far above the recommended size the server may scale the stream.
+    void SetMaxResolutionFactor(float factor) { mMaxResFactor = factor; }
+
+    // Load generator client, see loadgen/loadgen.cpp: no OpenXR session, no audio unless deviceDesc asks for it,
+    // no client thread and nothing published to Metrics. Tracking goes through SetSenserPoseState and frames
+    // through LatchFrame / ReleaseFrame as for the headset.
+    bool StartLoadClient(const std::string& server, const cxrDeviceDesc& deviceDesc, const cxrGraphicsContext& context);
+    void StopLoadClient();
+    bool IsStreaming() const { return mClientState == cxrClientState_StreamingSessionInProgress; }
+
+    // Connection stats, logged and recorded to the frame trace; also published to Metrics except for load clients.
+    bool PollStats(cxrConnectionStats *stats);
 
 private:
 
@@ -62,14 +102,23 @@ private:
 
     void TriggerHaptic(const cxrHapticFeedback *);
 
+    void UpdateClientState(cxrClientState state, cxrStateReason reason);
+
     cxrTrackedDevicePose ConvertPose(const XrPosef& inPose, float rotationX = 0);
 
     cxrBool RenderAudio(const cxrAudioFrame *audioFrame);
 
     void FillBackground();
 
+    void SelectDecoder();
+
+    void PublishDrainMetrics();
+
 private:
     cxrReceiverHandle mReceiver;
+    // Held by the client thread while it polls stats, and around destroying the receiver.
+    std::mutex mReceiverMutex;
+    std::atomic<bool> mRecreateRequested{false};
     cxrClientState mClientState;
     cxrDeviceDesc mDeviceDesc;
     cxrConnectionDesc mConnectionDesc;
@@ -90,10 +139,32 @@ private:
 
     bool mIsPaused;
     bool mWasPaused;
+    // Set by the render thread, read wherever the receiver is created, e.g. the client thread on unpause.
+    std::atomic<bool> mThrottled{false};
     float mIPD;
     float mFps;
+    float mMaxResFactor = 1.0f;
+    std::string mServerAddress;  // s_options.mServerIP when empty
+    bool mDeviceDescFixed = false;
+    bool mPublishMetrics = true;
+
+    FrameTraceWriter mFrameTrace;
+    BlitWorker mBlitWorker;
+    std::atomic<bool> mUseBlitWorker{false};  // cleared by the render thread, see ShedBlitWorker
+
+    FrameDrain mFrameDrain;
+    uint32_t mLastLatchUs = 0;
+    bool mDrainEnabled = true;
+
+    CallbackDispatch mCallbacks;
+
+    uint32_t mDecoderFlags = 0;
+    bool mLogVerbose = false;
+    std::string mDecoderDeviceKey;
+    DecoderCalibration mDecoderCalibration;
 
     GLuint mFramebuffers[2];
+    GLsizei mFramebufferSizes[2][2] = {};
     uint32_t mDefaultBGColor = 0xFF000000; // black to start until we set around OnResume.
     uint32_t mBGColor = mDefaultBGColor;
 
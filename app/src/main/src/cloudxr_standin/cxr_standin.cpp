@@ -0,0 +1,461 @@
+/*
+    stand-in for libCloudXRClient.so, built instead of the prebuilt library with CXR_STANDIN=1.
+    a simulated server thread polls GetTrackingState at the device frame rate, encodes nothing,
+    and pushes each frame through the NetImpairment link model. the client latches, blits and
+    releases those frames through the regular cxr* api, so the whole client-side pipeline can be
+    exercised without a CloudXR server. a scenario can also scale the streamed size (widthFinal /
+    heightFinal) as the server's adaptive resolution does. blits fill the target with a color derived
+    from poseID, or white while the frame's tracking state had a trigger pulled past half way, so the
+    client can time a scripted press to the frame that shows it (see click_to_photon.h).
+    alternatively a frame trace recorded by the client (debug.cxr.trace) is replayed: every frame the
+    client latched in the recording becomes available at the time it was latched, and the recorded
+    connection stats are reported back, so different client builds see identical frame arrivals.
+
+    configuration (android system property, or environment variable on other platforms):
+      debug.cxr.standin.scenario / CXR_STANDIN_SCENARIO   impairment scenario file
+      debug.cxr.standin.report   / CXR_STANDIN_REPORT     metrics report written on teardown
+      debug.cxr.standin.replay   / CXR_STANDIN_REPLAY     frame trace to replay instead of the link model
+      debug.cxr.standin.decodeMs / CXR_STANDIN_DECODE_MS  "<ms>[,<ms with AImageReader>]" decode time added to
+                                                          every arrival, so decoder selection can be exercised
+*/
+#include "pch.h"
+#include "common.h"
+#include <CloudXRClient.h>
+#include <GLES3/gl3.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include "frametrace.h"
+#include "netimpair.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char* kDefaultReportPath = "/sdcard/CloudXRStandinReport.txt";
+const uint32_t kDefaultBitrateKbps = 50000;
+
+std::string GetStandinSetting(const char* property, const char* env) {
+#if defined(XR_USE_PLATFORM_ANDROID)
+    char value[PROP_VALUE_MAX] = {};
+    if (__system_property_get(property, value) != 0) {
+        return value;
+    }
+#endif
+    const char* envValue = getenv(env);
+    return envValue ? envValue : "";
+}
+
+struct InFlightFrame {
+    uint64_t poseID;
+    cxrMatrix34 poseMatrix;
+    double sentMs;
+    double arrivalMs;
+    bool pressed;
+    double scale;
+    uint32_t packets;
+};
+
+// Either trigger past half way, the analog value is what the client forwards every frame.
+bool TriggerPressed(const cxrVRTrackingState& tracking) {
+    for (const cxrControllerTrackingState& controller : tracking.controller) {
+        if (controller.scalarComps[cxrAnalog_Trigger] > 0.5f) {
+            return true;
+        }
+    }
+    return false;
+}
+
+cxrMatrix34 PoseToMatrix(const cxrTrackedDevicePose& pose) {
+    const cxrQuaternion& q = pose.rotation;
+    cxrMatrix34 m{};
+    m.m[0][0] = 1 - 2 * (q.y * q.y + q.z * q.z);
+    m.m[0][1] = 2 * (q.x * q.y - q.w * q.z);
+    m.m[0][2] = 2 * (q.x * q.z + q.w * q.y);
+    m.m[1][0] = 2 * (q.x * q.y + q.w * q.z);
+    m.m[1][1] = 1 - 2 * (q.x * q.x + q.z * q.z);
+    m.m[1][2] = 2 * (q.y * q.z - q.w * q.x);
+    m.m[2][0] = 2 * (q.x * q.z - q.w * q.y);
+    m.m[2][1] = 2 * (q.y * q.z + q.w * q.x);
+    m.m[2][2] = 1 - 2 * (q.x * q.x + q.y * q.y);
+    m.m[0][3] = pose.position.v[0];
+    m.m[1][3] = pose.position.v[1];
+    m.m[2][3] = pose.position.v[2];
+    return m;
+}
+
+}  // namespace
+
+struct cxrReceiver {
+    cxrReceiverDesc desc{};
+    cxrConnectionDesc connection{};
+    Clock::time_point start;
+
+    std::thread serverThread;
+    std::atomic<bool> running{false};
+
+    std::mutex mutex;
+    std::condition_variable frameArrived;
+    NetImpairment link;
+    std::string replayPath;
+    std::vector<FrameTraceRecord> replay;
+    FrameTraceRecord replayStats{};
+    std::deque<InFlightFrame> inFlight;  // ordered by send time
+    double decodeMs = 0.0;
+    uint64_t lastLatchedPoseID = 0;
+    bool frameLatched = false;
+    bool latchedPressed = false;
+
+    // Report accounting, guarded by mutex.
+    std::vector<double> deliveryMs;
+    std::vector<double> latchWaitMs;
+    uint64_t latched = 0;
+    uint64_t latchTimeouts = 0;
+    uint64_t lateDropped = 0;
+    uint64_t lateDroppedPackets = 0;
+    uint64_t pressedLatched = 0;
+    uint64_t statsWindowLatched = 0;
+    Clock::time_point statsWindowStart;
+
+    double NowMs() const { return std::chrono::duration<double, std::milli>(Clock::now() - start).count(); }
+
+    void ServerLoop() {
+        if (!replay.empty()) {
+            ReplayLoop();
+            return;
+        }
+        const double fps = desc.deviceDesc.fps > 0 ? desc.deviceDesc.fps : 72.0f;
+        const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+        const uint32_t bitrateKbps = connection.maxVideoBitrateKbps > 0 ? connection.maxVideoBitrateKbps : kDefaultBitrateKbps;
+        const uint32_t frameBytes = (uint32_t)(bitrateKbps * 1000.0 / 8.0 / fps);
+
+        uint64_t poseID = 0;
+        Clock::time_point next = Clock::now();
+        while (running) {
+            next += period;
+            std::this_thread::sleep_until(next);
+
+            cxrVRTrackingState tracking{};
+            if (desc.clientCallbacks.GetTrackingState) {
+                desc.clientCallbacks.GetTrackingState(desc.clientContext, &tracking);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            const double nowMs = NowMs();
+            const NetImpairmentResult result = link.Send(nowMs, frameBytes);
+            poseID++;
+            if (result.delivered) {
+                inFlight.push_back({poseID, PoseToMatrix(tracking.hmd.pose), nowMs, result.arrivalMs + decodeMs, TriggerPressed(tracking),
+                                    link.ActiveParams(nowMs).resolutionScale, result.packets});
+                frameArrived.notify_all();
+            }
+        }
+    }
+
+    void ReplayLoop() {
+        for (const FrameTraceRecord& record : replay) {
+            std::this_thread::sleep_until(start + std::chrono::microseconds(record.timeUs));
+            if (!running) {
+                return;
+            }
+
+            if (record.type == FrameTraceRecord_Stats) {
+                std::lock_guard<std::mutex> lock(mutex);
+                replayStats = record;
+                continue;
+            }
+            if (record.type != FrameTraceRecord_Latch || record.result != cxrError_Success) {
+                // Failed latches are not replayed as such, they recur whenever no frame has arrived yet.
+                continue;
+            }
+
+            cxrVRTrackingState tracking{};
+            if (desc.clientCallbacks.GetTrackingState) {
+                desc.clientCallbacks.GetTrackingState(desc.clientContext, &tracking);
+            }
+
+            // The recording only knows when the client got the frame, which bounds the arrival time from
+            // above; the delivery time comes from the last recorded stats.
+            std::lock_guard<std::mutex> lock(mutex);
+            const double arrivalMs = record.timeUs / 1000.0;
+            const double sentMs = arrivalMs - replayStats.stats.frameDeliveryTime;
+            // Packet counts are not recorded, a replayed frame is one packet.
+            inFlight.push_back({record.latch.poseID, PoseToMatrix(tracking.hmd.pose), sentMs, arrivalMs, TriggerPressed(tracking), 1.0, 1});
+            frameArrived.notify_all();
+        }
+        Log::Write(Log::Level::Info, Fmt("standin: replay of %s finished", replayPath.c_str()));
+    }
+
+    // Earliest-arriving frame that has not been superseded, or inFlight.end().
+    std::deque<InFlightFrame>::iterator NextArrival() {
+        auto next = inFlight.end();
+        for (auto it = inFlight.begin(); it != inFlight.end(); ++it) {
+            if (next == inFlight.end() || it->arrivalMs < next->arrivalMs) {
+                next = it;
+            }
+        }
+        return next;
+    }
+
+    void WriteReport() {
+        std::string path = GetStandinSetting("debug.cxr.standin.report", "CXR_STANDIN_REPORT");
+        if (path.empty()) {
+            path = kDefaultReportPath;
+        }
+        std::ofstream out(path);
+        if (!out.is_open()) {
+            Log::Write(Log::Level::Error, Fmt("standin: cannot write report to %s", path.c_str()));
+            return;
+        }
+
+        // One key=value per line, fixed key set, so reports from different client builds diff cleanly.
+        const NetImpairmentStats& stats = link.Stats();
+        out << "scenario=" << link.Name() << "\n";
+        out << "replay=" << (replayPath.empty() ? "none" : replayPath) << "\n";
+        out << "seed=" << link.Seed() << "\n";
+        out << "duration_ms=" << (uint64_t)NowMs() << "\n";
+        out << "frames_sent=" << stats.framesSent << "\n";
+        out << "frames_delivered=" << stats.framesDelivered << "\n";
+        out << "frames_lost=" << stats.framesLost << "\n";
+        out << "frames_queue_dropped=" << stats.framesQueueDropped << "\n";
+        out << "frames_reordered=" << stats.framesReordered << "\n";
+        out << "frames_late_dropped=" << lateDropped << "\n";
+        out << "frames_latched=" << latched << "\n";
+        out << "latch_timeouts=" << latchTimeouts << "\n";
+        out << "frames_pressed=" << pressedLatched << "\n";
+        out << "packets_sent=" << stats.packetsSent << "\n";
+        out << "packets_lost=" << stats.packetsLost << "\n";
+        out << "delivery_ms_p50=" << NetImpairmentPercentile(deliveryMs, 50) << "\n";
+        out << "delivery_ms_p95=" << NetImpairmentPercentile(deliveryMs, 95) << "\n";
+        out << "delivery_ms_p99=" << NetImpairmentPercentile(deliveryMs, 99) << "\n";
+        out << "latch_wait_ms_p50=" << NetImpairmentPercentile(latchWaitMs, 50) << "\n";
+        out << "latch_wait_ms_p95=" << NetImpairmentPercentile(latchWaitMs, 95) << "\n";
+        out << "latch_wait_ms_p99=" << NetImpairmentPercentile(latchWaitMs, 99) << "\n";
+        Log::Write(Log::Level::Info, Fmt("standin: report written to %s", path.c_str()));
+    }
+};
+
+extern "C" {
+
+cxrError cxrCreateReceiver(const cxrReceiverDesc* description, cxrReceiverHandle* receiver) {
+    if (description == nullptr || receiver == nullptr) {
+        return cxrError_Parameter_Invalid;
+    }
+    cxrReceiver* r = new cxrReceiver();
+    r->desc = *description;
+
+    const std::string scenario = GetStandinSetting("debug.cxr.standin.scenario", "CXR_STANDIN_SCENARIO");
+    if (!scenario.empty()) {
+        std::string error;
+        if (!r->link.LoadScenario(scenario, &error)) {
+            Log::Write(Log::Level::Error, Fmt("standin: bad scenario %s: %s", scenario.c_str(), error.c_str()));
+            delete r;
+            return cxrError_Parameter_Invalid;
+        }
+        Log::Write(Log::Level::Info, Fmt("standin: scenario '%s' seed %llu", r->link.Name().c_str(), (unsigned long long)r->link.Seed()));
+    }
+
+    const std::string decodeMs = GetStandinSetting("debug.cxr.standin.decodeMs", "CXR_STANDIN_DECODE_MS");
+    if (!decodeMs.empty()) {
+        const size_t comma = decodeMs.find(',');
+        const bool imageReader = (r->desc.debugFlags & cxrDebugFlags_EnableAImageReaderDecoder) != 0;
+        r->decodeMs = atof(imageReader && comma != std::string::npos ? decodeMs.c_str() + comma + 1 : decodeMs.c_str());
+        Log::Write(Log::Level::Info, Fmt("standin: %.1f ms decode%s", r->decodeMs, imageReader ? " with AImageReader" : ""));
+    }
+
+    r->replayPath = GetStandinSetting("debug.cxr.standin.replay", "CXR_STANDIN_REPLAY");
+    if (!r->replayPath.empty()) {
+        std::string error;
+        if (!FrameTraceLoad(r->replayPath, nullptr, &r->replay, &error)) {
+            Log::Write(Log::Level::Error, Fmt("standin: cannot replay: %s", error.c_str()));
+            delete r;
+            return cxrError_Parameter_Invalid;
+        }
+        Log::Write(Log::Level::Info, Fmt("standin: replaying %zu records from %s", r->replay.size(), r->replayPath.c_str()));
+    }
+
+    *receiver = r;
+    return cxrError_Success;
+}
+
+cxrError cxrConnect(cxrReceiverHandle receiver, const char* serverAddr, cxrConnectionDesc* connectionDesc) {
+    if (receiver == nullptr) {
+        return cxrError_Parameter_Invalid;
+    }
+    Log::Write(Log::Level::Info, Fmt("standin: connect to %s (simulated)", serverAddr ? serverAddr : "<null>"));
+    if (connectionDesc) {
+        receiver->connection = *connectionDesc;
+    }
+    receiver->start = Clock::now();
+    receiver->statsWindowStart = receiver->start;
+    receiver->link.Reset();
+    receiver->running = true;
+    receiver->serverThread = std::thread(&cxrReceiver::ServerLoop, receiver);
+
+    if (receiver->desc.clientCallbacks.UpdateClientState) {
+        receiver->desc.clientCallbacks.UpdateClientState(receiver->desc.clientContext, cxrClientState_ConnectionAttemptInProgress, cxrStateReason_NoError);
+        receiver->desc.clientCallbacks.UpdateClientState(receiver->desc.clientContext, cxrClientState_StreamingSessionInProgress, cxrStateReason_NoError);
+    }
+    return cxrError_Success;
+}
+
+void cxrDestroyReceiver(cxrReceiverHandle receiver) {
+    if (receiver == nullptr) {
+        return;
+    }
+    receiver->running = false;
+    if (receiver->serverThread.joinable()) {
+        receiver->serverThread.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(receiver->mutex);
+        receiver->WriteReport();
+    }
+    if (receiver->desc.clientCallbacks.UpdateClientState) {
+        receiver->desc.clientCallbacks.UpdateClientState(receiver->desc.clientContext, cxrClientState_Disconnected, cxrStateReason_NoError);
+    }
+    delete receiver;
+}
+
+cxrError cxrLatchFrame(cxrReceiverHandle receiver, cxrFramesLatched* framesLatched, uint32_t frameMask, uint32_t timeoutMs) {
+    if (receiver == nullptr || framesLatched == nullptr) {
+        return cxrError_Parameter_Invalid;
+    }
+    (void)frameMask;
+
+    std::unique_lock<std::mutex> lock(receiver->mutex);
+    const double requestMs = receiver->NowMs();
+    const double deadlineMs = requestMs + timeoutMs;
+    while (true) {
+        auto next = receiver->NextArrival();
+        const double nowMs = receiver->NowMs();
+        if (next != receiver->inFlight.end() && next->arrivalMs <= nowMs) {
+            const InFlightFrame frame = *next;
+            receiver->inFlight.erase(next);
+            if (frame.poseID < receiver->lastLatchedPoseID) {
+                // Overtaken by a newer frame on the link: a real decoder would have discarded it.
+                receiver->lateDropped++;
+                receiver->lateDroppedPackets += frame.packets;
+                continue;
+            }
+
+            receiver->lastLatchedPoseID = frame.poseID;
+            receiver->frameLatched = true;
+            receiver->latchedPressed = frame.pressed;
+            receiver->pressedLatched += frame.pressed ? 1 : 0;
+            receiver->latched++;
+            receiver->statsWindowLatched++;
+            receiver->deliveryMs.push_back(frame.arrivalMs - frame.sentMs);
+            receiver->latchWaitMs.push_back(nowMs - requestMs);
+
+            *framesLatched = cxrFramesLatched{};
+            framesLatched->count = receiver->desc.numStreams;
+            for (uint32_t i = 0; i < receiver->desc.numStreams && i < CXR_NUM_VIDEO_STREAMS_XR; i++) {
+                framesLatched->frames[i].width = receiver->desc.deviceDesc.width;
+                framesLatched->frames[i].height = receiver->desc.deviceDesc.height;
+                framesLatched->frames[i].widthFinal = (uint32_t)(receiver->desc.deviceDesc.width * frame.scale);
+                framesLatched->frames[i].heightFinal = (uint32_t)(receiver->desc.deviceDesc.height * frame.scale);
+                framesLatched->frames[i].timeStamp = (uint64_t)(frame.sentMs * 1000.0);
+            }
+            framesLatched->poseMatrix = frame.poseMatrix;
+            framesLatched->poseID = frame.poseID;
+            return cxrError_Success;
+        }
+
+        if (nowMs >= deadlineMs) {
+            receiver->latchTimeouts++;
+            return cxrError_Frame_Not_Ready;
+        }
+        const double waitUntilMs = (next != receiver->inFlight.end()) ? std::min(next->arrivalMs, deadlineMs) : deadlineMs;
+        receiver->frameArrived.wait_until(lock, receiver->start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(waitUntilMs)));
+    }
+}
+
+cxrBool cxrBlitFrame(cxrReceiverHandle receiver, cxrFramesLatched* framesLatched, uint32_t frameMask) {
+    if (receiver == nullptr || framesLatched == nullptr || !receiver->frameLatched) {
+        return cxrFalse;
+    }
+    (void)frameMask;
+    // Slow color cycle so dropped or repeated frames are visible on the headset. The cycle keeps green at
+    // a quarter, so a press shows as the only frames with green past half.
+    const float phase = (float)(framesLatched->poseID % 256) / 255.0f;
+    if (receiver->latchedPressed) {
+        glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+    } else {
+        glClearColor(phase, 0.25f, 1.0f - phase, 1.0f);
+    }
+    glClear(GL_COLOR_BUFFER_BIT);
+    return cxrTrue;
+}
+
+cxrError cxrReleaseFrame(cxrReceiverHandle receiver, cxrFramesLatched* framesLatched) {
+    if (receiver == nullptr || framesLatched == nullptr) {
+        return cxrError_Parameter_Invalid;
+    }
+    std::lock_guard<std::mutex> lock(receiver->mutex);
+    if (!receiver->frameLatched) {
+        return cxrError_Frame_Not_Latched;
+    }
+    receiver->frameLatched = false;
+    return cxrError_Success;
+}
+
+cxrError cxrGetConnectionStats(cxrReceiverHandle receiver, cxrConnectionStats* stats) {
+    if (receiver == nullptr || stats == nullptr) {
+        return cxrError_Parameter_Invalid;
+    }
+    std::lock_guard<std::mutex> lock(receiver->mutex);
+    const double nowMs = receiver->NowMs();
+    const NetImpairmentParams& params = receiver->link.ActiveParams(nowMs);
+    const NetImpairmentStats& link = receiver->link.Stats();
+    const double windowSeconds = std::chrono::duration<double>(Clock::now() - receiver->statsWindowStart).count();
+
+    *stats = cxrConnectionStats{};
+    stats->framesPerSecond = windowSeconds > 0.0 ? (float)(receiver->statsWindowLatched / windowSeconds) : 0.0f;
+    stats->frameDeliveryTime = receiver->deliveryMs.empty() ? 0.0f : (float)receiver->deliveryMs.back();
+    stats->frameLatchTime = receiver->latchWaitMs.empty() ? 0.0f : (float)receiver->latchWaitMs.back();
+    stats->frameQueueTime = 0.0f;
+    stats->bandwidthAvailableKbps = params.bandwidthKbps;
+    stats->roundTripDelayMs = (uint32_t)(2.0 * params.latencyMs);
+    stats->jitterUs = (uint32_t)(params.jitterMs * 1000.0);
+    stats->totalPacketsReceived = (uint32_t)(link.packetsSent - link.packetsLost);
+    stats->totalPacketsLost = (uint32_t)link.packetsLost;
+    // Packets, like the SDK's: a frame dropped whole drops all of its packets.
+    stats->totalPacketsDropped = (uint32_t)(receiver->lateDroppedPackets + link.packetsQueueDropped);
+
+    if (!receiver->replay.empty()) {
+        const FrameTraceRecord& recorded = receiver->replayStats;
+        stats->framesPerSecond = recorded.stats.framesPerSecond;
+        stats->frameDeliveryTime = recorded.stats.frameDeliveryTime;
+        stats->frameQueueTime = recorded.stats.frameQueueTime;
+        stats->frameLatchTime = recorded.stats.frameLatchTime;
+        stats->bandwidthAvailableKbps = recorded.stats.bandwidthAvailableKbps;
+        stats->roundTripDelayMs = recorded.stats.roundTripDelayMs;
+        stats->jitterUs = recorded.stats.jitterUs;
+        stats->totalPacketsLost = recorded.stats.totalPacketsLost;
+    }
+
+    receiver->statsWindowLatched = 0;
+    receiver->statsWindowStart = Clock::now();
+    return cxrError_Success;
+}
+
+const char* cxrErrorString(cxrError E) {
+    switch (E) {
+        case cxrError_Success:
+            return "success";
+        case cxrError_Parameter_Invalid:
+            return "invalid parameter";
+        case cxrError_Frame_Not_Ready:
+            return "frame not ready";
+        case cxrError_Frame_Not_Latched:
+            return "frame not latched";
+        default:
+            return "standin error";
+    }
+}
+
+}  // extern "C"
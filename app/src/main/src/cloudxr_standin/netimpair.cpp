@@ -0,0 +1,219 @@
+/*
+    network impairment model used by the cloudxr receiver stand-in.
+*/
+#include "netimpair.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+bool ApplyKey(NetImpairmentParams& params, const std::string& key, double value) {
+    if (key == "latency") {
+        params.latencyMs = value;
+    } else if (key == "jitter") {
+        params.jitterMs = value;
+    } else if (key == "bandwidth") {
+        params.bandwidthKbps = (uint32_t)value;
+    } else if (key == "loss_good") {
+        params.lossGood = value;
+    } else if (key == "loss_bad") {
+        params.lossBad = value;
+    } else if (key == "p_gb") {
+        params.pGoodToBad = value;
+    } else if (key == "p_bg") {
+        params.pBadToGood = value;
+    } else if (key == "reorder") {
+        params.reorder = value;
+    } else if (key == "reorder_delay") {
+        params.reorderDelayMs = value;
+    } else if (key == "max_queue") {
+        params.maxQueueMs = value;
+    } else if (key == "scale") {
+        params.resolutionScale = std::min(std::max(value, 0.1), 1.0);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+NetImpairment::NetImpairment() : mName("none"), mSeed(1), mBadState(false), mLinkFreeMs(0.0) {
+    mSteps.push_back(NetImpairmentStep{});
+    Reset();
+}
+
+bool NetImpairment::LoadScenario(const std::string& path, std::string* error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        if (error) {
+            *error = "cannot open " + path;
+        }
+        return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    return ParseScenario(text.str(), error);
+}
+
+bool NetImpairment::ParseScenario(const std::string& text, std::string* error) {
+    std::vector<NetImpairmentStep> steps;
+    NetImpairmentParams current;
+    std::istringstream lines(text);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(lines, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream tokens(line);
+        std::string token;
+        if (!(tokens >> token)) {
+            continue;
+        }
+
+        NetImpairmentStep step;
+        char* end = nullptr;
+        step.startMs = strtoull(token.c_str(), &end, 10);
+        if (*end != '\0') {
+            if (error) {
+                *error = "line " + std::to_string(lineNumber) + ": expected start time, got '" + token + "'";
+            }
+            return false;
+        }
+        if (!steps.empty() && step.startMs < steps.back().startMs) {
+            if (error) {
+                *error = "line " + std::to_string(lineNumber) + ": steps must be in time order";
+            }
+            return false;
+        }
+
+        while (tokens >> token) {
+            const size_t eq = token.find('=');
+            if (eq == std::string::npos) {
+                if (error) {
+                    *error = "line " + std::to_string(lineNumber) + ": expected key=value, got '" + token + "'";
+                }
+                return false;
+            }
+            const std::string key = token.substr(0, eq);
+            const std::string value = token.substr(eq + 1);
+            if (key == "name") {
+                mName = value;
+            } else if (key == "seed") {
+                mSeed = strtoull(value.c_str(), nullptr, 10);
+            } else if (!ApplyKey(current, key, atof(value.c_str()))) {
+                if (error) {
+                    *error = "line " + std::to_string(lineNumber) + ": unknown key '" + key + "'";
+                }
+                return false;
+            }
+        }
+        step.params = current;
+        steps.push_back(step);
+    }
+
+    if (steps.empty() || steps.front().startMs != 0) {
+        steps.insert(steps.begin(), NetImpairmentStep{});
+    }
+    mSteps = steps;
+    Reset();
+    return true;
+}
+
+void NetImpairment::SetParams(const NetImpairmentParams& params) {
+    mSteps.clear();
+    NetImpairmentStep step;
+    step.params = params;
+    mSteps.push_back(step);
+    Reset();
+}
+
+void NetImpairment::Reset() {
+    mRng.seed(mSeed);
+    mBadState = false;
+    mLinkFreeMs = 0.0;
+    mStats = NetImpairmentStats{};
+}
+
+const NetImpairmentParams& NetImpairment::ActiveParams(double nowMs) const {
+    size_t active = 0;
+    for (size_t i = 0; i < mSteps.size(); i++) {
+        if ((double)mSteps[i].startMs <= nowMs) {
+            active = i;
+        }
+    }
+    return mSteps[active].params;
+}
+
+NetImpairmentResult NetImpairment::Send(double nowMs, uint32_t bytes) {
+    const NetImpairmentParams& params = ActiveParams(nowMs);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    NetImpairmentResult result;
+    result.packets = std::max<uint32_t>(1, (bytes + kPacketBytes - 1) / kPacketBytes);
+
+    // Gilbert-Elliott: the loss probability depends on the current state, then the state transitions.
+    // Every random draw happens in frame order, regardless of what the link does with the frame,
+    // so two runs with the same scenario and seed see the same sequence of impairments.
+    for (uint32_t i = 0; i < result.packets; i++) {
+        const double lossProbability = mBadState ? params.lossBad : params.lossGood;
+        if (uniform(mRng) < lossProbability) {
+            result.packetsLost++;
+        }
+        const double transition = uniform(mRng);
+        if (mBadState) {
+            mBadState = transition >= params.pBadToGood;
+        } else {
+            mBadState = transition < params.pGoodToBad;
+        }
+    }
+    std::normal_distribution<double> jitter(0.0, params.jitterMs > 0.0 ? params.jitterMs : 1.0);
+    const double jitterMs = params.jitterMs > 0.0 ? jitter(mRng) : 0.0;
+    const bool reordered = uniform(mRng) < params.reorder;
+
+    mStats.framesSent++;
+    mStats.packetsSent += result.packets;
+    mStats.packetsLost += result.packetsLost;
+    mStats.bytesSent += bytes;
+
+    // Serialization through the capped link; frames queue behind each other.
+    double departMs = nowMs;
+    if (params.bandwidthKbps > 0) {
+        const double startMs = std::max(nowMs, mLinkFreeMs);
+        if (startMs - nowMs > params.maxQueueMs) {
+            result.queueDropped = true;
+            mStats.framesQueueDropped++;
+            mStats.packetsQueueDropped += result.packets;
+            return result;
+        }
+        departMs = startMs + (double)bytes * 8.0 / (double)params.bandwidthKbps;
+        mLinkFreeMs = departMs;
+    }
+
+    if (result.packetsLost > 0) {
+        // No FEC in the model: a frame missing any packet cannot be decoded.
+        mStats.framesLost++;
+        return result;
+    }
+
+    result.delivered = true;
+    result.reordered = reordered;
+    result.arrivalMs = departMs + std::max(0.0, params.latencyMs + jitterMs);
+    if (reordered) {
+        result.arrivalMs += params.reorderDelayMs;
+        mStats.framesReordered++;
+    }
+    mStats.framesDelivered++;
+    return result;
+}
+
+double NetImpairmentPercentile(std::vector<double> samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    const size_t index = std::min(samples.size() - 1, (size_t)(p / 100.0 * (double)(samples.size() - 1) + 0.5));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
@@ -0,0 +1,92 @@
+/*
+    network impairment model used by the cloudxr receiver stand-in.
+    frames sent by the simulated server are split into packets and pushed through a
+    link with latency, jitter, a bandwidth cap, Gilbert-Elliott burst loss and reordering.
+    the parameters can be scripted over time from a scenario file.
+*/
+#pragma once
+
+#include <stdint.h>
+#include <random>
+#include <string>
+#include <vector>
+
+struct NetImpairmentParams {
+    double latencyMs = 0.0;         // one way base latency
+    double jitterMs = 0.0;          // standard deviation of the per-frame latency noise
+    uint32_t bandwidthKbps = 0;     // link capacity, 0 means unlimited
+    double lossGood = 0.0;          // packet loss probability in the Gilbert-Elliott "good" state
+    double lossBad = 0.0;           // packet loss probability in the "bad" state
+    double pGoodToBad = 0.0;        // per-packet transition probability good -> bad
+    double pBadToGood = 1.0;        // per-packet transition probability bad -> good
+    double reorder = 0.0;           // probability that a frame is held back behind its successor
+    double reorderDelayMs = 20.0;   // extra delay applied to a reordered frame
+    double maxQueueMs = 500.0;      // link queue depth, frames beyond it are tail-dropped
+    double resolutionScale = 1.0;   // streamed size relative to the requested one, as the server's adaptive resolution
+};
+
+struct NetImpairmentStep {
+    uint64_t startMs = 0;
+    NetImpairmentParams params;
+};
+
+struct NetImpairmentResult {
+    bool delivered = false;
+    bool reordered = false;
+    bool queueDropped = false;
+    uint32_t packets = 0;
+    uint32_t packetsLost = 0;
+    double arrivalMs = 0.0;
+};
+
+struct NetImpairmentStats {
+    uint64_t framesSent = 0;
+    uint64_t framesDelivered = 0;
+    uint64_t framesLost = 0;
+    uint64_t framesQueueDropped = 0;
+    uint64_t framesReordered = 0;
+    uint64_t packetsSent = 0;
+    uint64_t packetsLost = 0;
+    uint64_t packetsQueueDropped = 0;
+    uint64_t bytesSent = 0;
+};
+
+class NetImpairment {
+public:
+    static constexpr uint32_t kPacketBytes = 1200;
+
+    NetImpairment();
+
+    // Scenario file: one step per line, "<startMs> key=value ...". Steps are cumulative, each one
+    // overrides only the keys it names. "seed=<n>" and "name=<s>" apply to the whole scenario.
+    bool LoadScenario(const std::string& path, std::string* error);
+
+    bool ParseScenario(const std::string& text, std::string* error);
+
+    void SetParams(const NetImpairmentParams& params);
+
+    void Reset();
+
+    // Push one frame of the given size into the link at time nowMs (relative to session start).
+    NetImpairmentResult Send(double nowMs, uint32_t bytes);
+
+    const NetImpairmentParams& ActiveParams(double nowMs) const;
+
+    const NetImpairmentStats& Stats() const { return mStats; }
+
+    const std::string& Name() const { return mName; }
+
+    uint64_t Seed() const { return mSeed; }
+
+private:
+    std::string mName;
+    uint64_t mSeed;
+    std::vector<NetImpairmentStep> mSteps;
+    std::mt19937_64 mRng;
+    bool mBadState;
+    double mLinkFreeMs;
+    NetImpairmentStats mStats;
+};
+
+// Percentile of an unsorted sample set, p in [0, 100].
+double NetImpairmentPercentile(std::vector<double> samples, double p);
@@ -95,3 +95,4 @@ constexpr size_t ArraySize(const T (&/*unused*/)[Size]) noexcept {
 
 #include "logger.h"
 #include "check.h"
+#include "xr_call_budget.h"
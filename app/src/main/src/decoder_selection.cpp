@@ -0,0 +1,134 @@
+/*
+    decoder backend selection.
+*/
+#include "pch.h"
+#include "common.h"
+#include <CloudXRClient.h>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include "decoder_selection.h"
+
+namespace DecoderSelection {
+
+const std::vector<DecoderBackend>& Backends() {
+    static const std::vector<DecoderBackend> backends = {{"mediacodec", 0}, {"aimagereader", cxrDebugFlags_EnableAImageReaderDecoder}};
+    return backends;
+}
+
+const DecoderBackend* Find(const std::string& name) {
+    for (const DecoderBackend& backend : Backends()) {
+        if (name == backend.name) {
+            return &backend;
+        }
+    }
+    return nullptr;
+}
+
+double Score(const Sample& sample, double targetFps) {
+    if (sample.seconds == 0 || sample.fps <= 0.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    const double frameMs = 1000.0 / targetFps;
+    const double expectedFrames = targetFps * sample.seconds;
+    const double frames = sample.fps * sample.seconds;
+    // A frame is many packets at streaming bitrates: the packets of the frames shown give the size of the frames
+    // dropped. Without received packets, one packet a frame.
+    const double shownPackets = (double)sample.received - sample.dropped;
+    const double packetsPerFrame = shownPackets > 0.0 ? std::max(shownPackets / frames, 1.0) : 1.0;
+    const double missing = std::max(expectedFrames - frames, 0.0) + sample.dropped / packetsPerFrame;
+    return sample.deliveryMs + sample.latchMs + frameMs * missing / expectedFrames;
+}
+
+size_t PickWinner(const std::vector<Sample>& samples, double targetFps) {
+    size_t winner = 0;
+    for (size_t i = 1; i < samples.size(); i++) {
+        if (Score(samples[i], targetFps) < Score(samples[winner], targetFps)) {
+            winner = i;
+        }
+    }
+    return winner;
+}
+
+bool LoadVerdict(const std::string& path, const std::string& deviceKey, std::string* backend) {
+    std::ifstream in(path);
+    std::string line;
+    const std::string prefix = deviceKey + "=";
+    while (std::getline(in, line)) {
+        if (line.compare(0, prefix.size(), prefix) == 0) {
+            *backend = line.substr(prefix.size());
+            return Find(*backend) != nullptr;
+        }
+    }
+    return false;
+}
+
+bool SaveVerdict(const std::string& path, const std::string& deviceKey, const std::string& backend) {
+    // Keep the other devices' verdicts, a shared /sdcard file may have been copied between headsets.
+    std::ostringstream kept;
+    {
+        std::ifstream in(path);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.compare(0, deviceKey.size() + 1, deviceKey + "=") != 0) {
+                kept << line << "\n";
+            }
+        }
+    }
+    std::ofstream out(path, std::ios::trunc);
+    out << kept.str() << deviceKey << "=" << backend << "\n";
+    return out.good();
+}
+
+}  // namespace DecoderSelection
+
+void DecoderCalibration::Begin(double targetFps, uint32_t secondsPerBackend) {
+    m_active = true;
+    m_targetFps = targetFps > 0.0 ? targetFps : 72.0;
+    m_secondsPerBackend = std::max(secondsPerBackend, 1u);
+    m_current = 0;
+    m_warm = false;
+    m_samples.assign(DecoderSelection::Backends().size(), {});
+}
+
+const DecoderBackend& DecoderCalibration::Current() const { return DecoderSelection::Backends()[m_current]; }
+
+bool DecoderCalibration::AddSecond(double fps, double deliveryMs, double latchMs, uint32_t totalReceived, uint32_t totalDropped) {
+    if (!m_active) {
+        return false;
+    }
+    if (!m_warm) {
+        m_warm = true;
+        m_receivedBase = totalReceived;
+        m_droppedBase = totalDropped;
+        return false;
+    }
+
+    DecoderSelection::Sample& sample = m_samples[m_current];
+    const double n = sample.seconds;
+    sample.fps = (sample.fps * n + fps) / (n + 1);
+    sample.deliveryMs = (sample.deliveryMs * n + deliveryMs) / (n + 1);
+    sample.latchMs = (sample.latchMs * n + latchMs) / (n + 1);
+    sample.received = totalReceived - m_receivedBase;
+    sample.dropped = totalDropped - m_droppedBase;
+    sample.seconds++;
+    if (sample.seconds < m_secondsPerBackend) {
+        return false;
+    }
+
+    Log::Write(Log::Level::Info, Fmt("decoder calibration: %s %.1f fps, delivery %.2f ms, latch %.2f ms, %u of %u packets dropped, score %.2f",
+                                     Current().name, sample.fps, sample.deliveryMs, sample.latchMs, sample.dropped, sample.received,
+                                     DecoderSelection::Score(sample, m_targetFps)));
+    m_warm = false;
+    if (m_current + 1 < m_samples.size()) {
+        m_current++;
+        return true;
+    }
+
+    m_active = false;
+    const size_t winner = DecoderSelection::PickWinner(m_samples, m_targetFps);
+    // Streaming already runs with the last backend, so only a different winner needs a new receiver.
+    const bool recreate = winner != m_current;
+    m_current = winner;
+    return recreate;
+}
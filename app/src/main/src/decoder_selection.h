@@ -0,0 +1,70 @@
+/*
+    decoder backend selection, adb shell setprop debug.cxr.decoder mediacodec|aimagereader|auto|calibrate.
+    mediacodec is the CloudXR default, aimagereader sets cxrDebugFlags_EnableAImageReaderDecoder.
+    "auto" uses the verdict cached for this device and ROM, and calibrates on the first run without one:
+    the client streams a few seconds under each backend in turn, recreating the receiver in between,
+    scores each by delivery + latch time, frame rate deficit and dropped packets (in frames), caches the winner and
+    keeps streaming with it. "calibrate" does the same even when a verdict is cached.
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+
+struct DecoderBackend {
+    const char* name;
+    uint32_t debugFlags;
+};
+
+namespace DecoderSelection {
+const std::vector<DecoderBackend>& Backends();
+
+// nullptr for an unknown name.
+const DecoderBackend* Find(const std::string& name);
+
+// One backend's calibration run, averaged over the seconds it streamed.
+struct Sample {
+    uint32_t seconds = 0;
+    double fps = 0.0;
+    double deliveryMs = 0.0;
+    double latchMs = 0.0;
+    // Video packets, over the seconds measured.
+    uint32_t received = 0;
+    uint32_t dropped = 0;
+};
+
+// Milliseconds of latency per frame, with missing and dropped frames charged a full frame each. Lower is better.
+// Dropped packets count as frames at the sample's packets per frame.
+double Score(const Sample& sample, double targetFps);
+
+// Index of the best sample; samples that never streamed lose to any that did.
+size_t PickWinner(const std::vector<Sample>& samples, double targetFps);
+
+// The cache holds one "<device key>=<backend name>" line per device and ROM.
+bool LoadVerdict(const std::string& path, const std::string& deviceKey, std::string* backend);
+bool SaveVerdict(const std::string& path, const std::string& deviceKey, const std::string& backend);
+}  // namespace DecoderSelection
+
+class DecoderCalibration {
+public:
+    void Begin(double targetFps, uint32_t secondsPerBackend);
+    bool Active() const { return m_active; }
+
+    // The backend the receiver should run with now: the one being measured, or the winner once done.
+    const DecoderBackend& Current() const;
+
+    // Once a second while streaming under Current(), with that second's connection stats and the cumulative
+    // packet counts. The first second of each backend is warm-up. True when the receiver has to be recreated
+    // for the next Current().
+    bool AddSecond(double fps, double deliveryMs, double latchMs, uint32_t totalReceived, uint32_t totalDropped);
+
+private:
+    bool m_active = false;
+    double m_targetFps = 72.0;
+    uint32_t m_secondsPerBackend = 5;
+    size_t m_current = 0;
+    bool m_warm = false;
+    uint32_t m_receivedBase = 0;
+    uint32_t m_droppedBase = 0;
+    std::vector<DecoderSelection::Sample> m_samples;
+};
@@ -0,0 +1,43 @@
+/*
+    the mirror's desktop window on the linux simulator (host/run_host.sh), debug.xr.mirror 2: a gfxwrapper
+    ksGpuWindow on xlib, built as libdesktop_mirror.so from host/desktop_mirror.cpp, which the mirror
+    thread loads with dlopen; android builds have no such library and the mirror says so.
+
+    the window has a GLX context of its own, which cannot share with the EGL one CloudXR renders with, so
+    the mirror reads each frame back and the window uploads and presents it. both contexts live on the
+    mirror thread, current in turn: the functions here are called with no EGL context current and leave
+    none current. swaps are paced with swap interval 1 and ksGpuWindow_GetNextSwapTimeNanoseconds, on
+    CLOCK_MONOTONIC like std::chrono::steady_clock.
+*/
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define DESKTOP_MIRROR_EXPORT __attribute__((visibility("default")))
+#else
+#define DESKTOP_MIRROR_EXPORT
+#endif
+
+struct DesktopMirror;
+
+extern "C" {
+
+// A window for width x height frames, scaled down to at most 1280 wide; nullptr without an X display or GLX.
+DESKTOP_MIRROR_EXPORT DesktopMirror* desktopMirrorCreate(int width, int height);
+DESKTOP_MIRROR_EXPORT void desktopMirrorDestroy(DesktopMirror* mirror);
+
+// ksGpuWindow_GetNextSwapTimeNanoseconds and ksGpuWindow_GetFrameTimeNanoseconds.
+DESKTOP_MIRROR_EXPORT int64_t desktopMirrorNextSwapNanoseconds(DesktopMirror* mirror);
+DESKTOP_MIRROR_EXPORT int64_t desktopMirrorFrameNanoseconds(DesktopMirror* mirror);
+
+// Letterboxes width x height RGBA pixels, bottom row first as glReadPixels returns them, and swaps.
+// Returns false once the window was closed.
+DESKTOP_MIRROR_EXPORT bool desktopMirrorPresent(DesktopMirror* mirror, const void* pixels, int width, int height);
+
+typedef DesktopMirror* (*PFN_desktopMirrorCreate)(int width, int height);
+typedef void (*PFN_desktopMirrorDestroy)(DesktopMirror* mirror);
+typedef int64_t (*PFN_desktopMirrorNextSwapNanoseconds)(DesktopMirror* mirror);
+typedef int64_t (*PFN_desktopMirrorFrameNanoseconds)(DesktopMirror* mirror);
+typedef bool (*PFN_desktopMirrorPresent)(DesktopMirror* mirror, const void* pixels, int width, int height);
+}
@@ -0,0 +1,182 @@
+/*
+    a GLES 3 context that is never presented.
+*/
+#include "pch.h"
+#include "common.h"
+#include "egl_context.h"
+
+#include <EGL/eglext.h>
+
+#ifndef EGL_OPENGL_ES3_BIT
+#define EGL_OPENGL_ES3_BIT 0x0040
+#endif
+
+namespace {
+
+bool HasExtension(EGLDisplay display, const char* name) {
+    const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (extensions == nullptr) {
+        return false;
+    }
+    const size_t length = strlen(name);
+    for (const char* found = strstr(extensions, name); found != nullptr; found = strstr(found + length, name)) {
+        if ((found == extensions || found[-1] == ' ') && (found[length] == ' ' || found[length] == '\0')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+EGLDisplay InitializeDisplay() {
+    EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr)) {
+        return display;
+    }
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+    // Desktop mesa without a display server.
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay != nullptr) {
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr)) {
+            return display;
+        }
+    }
+#endif
+    return EGL_NO_DISPLAY;
+}
+
+// Same rules as gfxwrapper: no eglChooseConfig, which picks up the "force 4x MSAA" developer option on android.
+// RGBA8 without multisampling, and the config with the fewest depth + stencil bits, ideally none.
+EGLConfig SelectConfig(EGLDisplay display, bool needPbuffer) {
+    const int MAX_CONFIGS = 1024;
+    EGLConfig configs[MAX_CONFIGS];
+    EGLint numConfigs = 0;
+    if (!eglGetConfigs(display, configs, MAX_CONFIGS, &numConfigs)) {
+        return nullptr;
+    }
+
+    const EGLint configAttribs[] = {EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8, EGL_SAMPLE_BUFFERS, 0, EGL_NONE};
+
+    EGLConfig best = nullptr;
+    EGLint bestDepthStencil = 0;
+    for (int i = 0; i < numConfigs; i++) {
+        EGLint value = 0;
+        eglGetConfigAttrib(display, configs[i], EGL_RENDERABLE_TYPE, &value);
+        if ((value & EGL_OPENGL_ES3_BIT) != EGL_OPENGL_ES3_BIT) {
+            continue;
+        }
+        if (needPbuffer) {
+            eglGetConfigAttrib(display, configs[i], EGL_SURFACE_TYPE, &value);
+            if ((value & EGL_PBUFFER_BIT) == 0) {
+                continue;
+            }
+        }
+
+        int j = 0;
+        for (; configAttribs[j] != EGL_NONE; j += 2) {
+            eglGetConfigAttrib(display, configs[i], configAttribs[j], &value);
+            if (value != configAttribs[j + 1]) {
+                break;
+            }
+        }
+        if (configAttribs[j] != EGL_NONE) {
+            continue;
+        }
+
+        EGLint depth = 0;
+        EGLint stencil = 0;
+        eglGetConfigAttrib(display, configs[i], EGL_DEPTH_SIZE, &depth);
+        eglGetConfigAttrib(display, configs[i], EGL_STENCIL_SIZE, &stencil);
+        if (best == nullptr || depth + stencil < bestDepthStencil) {
+            best = configs[i];
+            bestDepthStencil = depth + stencil;
+        }
+    }
+    return best;
+}
+
+}  // namespace
+
+bool EglContext::Create(const EglContext* share) {
+    if (share != nullptr) {
+        return CreateShared(share->display, share->context);
+    }
+
+    display = InitializeDisplay();
+    if (display == EGL_NO_DISPLAY) {
+        Log::Write(Log::Level::Error, Fmt("eglInitialize failed: 0x%x", eglGetError()));
+        return false;
+    }
+    config = SelectConfig(display, !HasExtension(display, "EGL_KHR_surfaceless_context"));
+    if (config == nullptr) {
+        Log::Write(Log::Level::Error, "No GLES 3 RGBA8 EGLConfig");
+        return false;
+    }
+    return CreateContext(EGL_NO_CONTEXT);
+}
+
+bool EglContext::CreateShared(EGLDisplay shareDisplay, EGLContext shareContext) {
+    display = shareDisplay;
+    EGLint configId = 0;
+    EGLint numConfigs = 0;
+    if (!eglQueryContext(display, shareContext, EGL_CONFIG_ID, &configId)) {
+        Log::Write(Log::Level::Error, Fmt("eglQueryContext EGL_CONFIG_ID failed: 0x%x", eglGetError()));
+        return false;
+    }
+    const EGLint configAttribs[] = {EGL_CONFIG_ID, configId, EGL_NONE};
+    if (!eglChooseConfig(display, configAttribs, &config, 1, &numConfigs) || numConfigs != 1) {
+        Log::Write(Log::Level::Error, Fmt("No EGLConfig with id %d", configId));
+        return false;
+    }
+    return CreateContext(shareContext);
+}
+
+bool EglContext::CreateContext(EGLContext shareContext) {
+    const bool surfaceless = HasExtension(display, "EGL_KHR_surfaceless_context");
+    const EGLint contextAttribs[] = {EGL_CONTEXT_CLIENT_VERSION, 3, EGL_NONE};
+    context = eglCreateContext(display, config, shareContext, contextAttribs);
+    if (context == EGL_NO_CONTEXT) {
+        Log::Write(Log::Level::Error, Fmt("eglCreateContext failed: 0x%x", eglGetError()));
+        return false;
+    }
+
+    if (!surfaceless) {
+        const EGLint surfaceAttribs[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+        surface = eglCreatePbufferSurface(display, config, surfaceAttribs);
+        if (surface == EGL_NO_SURFACE) {
+            Log::Write(Log::Level::Error, Fmt("eglCreatePbufferSurface failed: 0x%x", eglGetError()));
+            Destroy();
+            return false;
+        }
+    }
+
+    EGLint depth = 0;
+    eglGetConfigAttrib(display, config, EGL_DEPTH_SIZE, &depth);
+    Log::Write(Log::Level::Info, Fmt("EGL context %p created %s, depth bits %d%s", context, surfaceless ? "surfaceless" : "on a 1x1 pbuffer", depth,
+                                     shareContext != EGL_NO_CONTEXT ? ", shared" : ""));
+    return true;
+}
+
+void EglContext::Destroy() {
+    if (display == EGL_NO_DISPLAY) {
+        return;
+    }
+    if (eglGetCurrentContext() == context) {
+        ReleaseCurrent();
+    }
+    if (surface != EGL_NO_SURFACE) {
+        eglDestroySurface(display, surface);
+        surface = EGL_NO_SURFACE;
+    }
+    if (context != EGL_NO_CONTEXT) {
+        eglDestroyContext(display, context);
+        context = EGL_NO_CONTEXT;
+    }
+    // The display is shared with the runtime and CloudXR, so it is left initialized.
+    display = EGL_NO_DISPLAY;
+    config = nullptr;
+}
+
+bool EglContext::MakeCurrent() const { return eglMakeCurrent(display, surface, surface, context) == EGL_TRUE; }
+
+void EglContext::ReleaseCurrent() const { eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT); }
@@ -0,0 +1,29 @@
+/*
+    a GLES 3 context that is never presented: there is no window surface and no depth/stencil buffer.
+    made current without a surface when EGL_KHR_surfaceless_context is available, otherwise on a 1x1
+    pbuffer. works on android and on desktop mesa, where a headless run can use
+    EGL_PLATFORM=surfaceless.
+*/
+#pragma once
+
+#include <EGL/egl.h>
+
+struct EglContext {
+    EGLDisplay display{EGL_NO_DISPLAY};
+    EGLConfig config{nullptr};
+    EGLContext context{EGL_NO_CONTEXT};
+    // EGL_NO_SURFACE when the context is surfaceless.
+    EGLSurface surface{EGL_NO_SURFACE};
+
+    // Passing share reuses its display and config, and shares textures, buffers and syncs with it.
+    bool Create(const EglContext* share = nullptr);
+    // Same, for a context created elsewhere, e.g. the one current on the render thread.
+    bool CreateShared(EGLDisplay shareDisplay, EGLContext shareContext);
+    void Destroy();
+
+    bool MakeCurrent() const;
+    void ReleaseCurrent() const;
+
+   private:
+    bool CreateContext(EGLContext shareContext);
+};
@@ -0,0 +1,1448 @@
+/*
+    deterministic in-process OpenXR runtime, see fake_runtime.h for the script format.
+*/
+#define XR_USE_GRAPHICS_API_OPENGL 1
+#define XR_USE_GRAPHICS_API_OPENGL_ES 1
+#include <EGL/egl.h>  // openxr_platform.h uses EGL types for the GLES structs
+#include <openxr/openxr.h>
+#include <openxr/openxr_platform.h>
+#include <openxr/openxr_reflection.h>
+#include <common/loader_interfaces.h>
+#include "fake_runtime.h"
+
+#include <dlfcn.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const XrSystemId kSystemId = 1;
+const XrTime kStartTime = 1000000000;  // virtual clock origin, non zero so 0 stays "no time"
+const uint32_t kSwapchainImageCount = 3;
+const uint32_t kFirstImageName = 0x10000;  // headless images: names only, no GL objects behind them
+
+const int64_t kGL_RGBA8 = 0x8058;
+const int64_t kGL_SRGB8_ALPHA8 = 0x8C43;
+const int64_t kGL_DEPTH_COMPONENT24 = 0x81A6;
+
+// XR_EXT_user_presence, newer than the bundled headers; the client's definitions are in stream_throttle.h.
+#ifndef XR_EXT_user_presence
+#define XR_EXT_USER_PRESENCE_EXTENSION_NAME "XR_EXT_user_presence"
+const XrStructureType XR_TYPE_EVENT_DATA_USER_PRESENCE_CHANGED_EXT = (XrStructureType)1000470000;
+struct XrEventDataUserPresenceChangedEXT {
+    XrStructureType type;
+    const void* next;
+    XrSession session;
+    XrBool32 isUserPresent;
+};
+#endif
+
+// XR_KHR_android_create_instance is only declared for XR_USE_PLATFORM_ANDROID; the Android build of the app
+// enables it, and its XrInstanceCreateInfoAndroidKHR is ignored here.
+#ifndef XR_KHR_ANDROID_CREATE_INSTANCE_EXTENSION_NAME
+#define XR_KHR_ANDROID_CREATE_INSTANCE_EXTENSION_NAME "XR_KHR_android_create_instance"
+#endif
+
+struct PoseKey {
+    double ms;
+    XrPosef pose;
+};
+
+struct InputKey {
+    double ms;
+    float value;
+};
+
+struct StateKey {
+    double ms;
+    XrSessionState state;
+};
+
+struct PresenceKey {
+    double ms;
+    bool present;
+};
+
+struct Script {
+    double displayPeriodMs = 1000.0 / 72.0;
+    bool realtime = false;
+    uint32_t viewWidth = 1832;
+    uint32_t viewHeight = 1920;
+    float ipd = 0.063f;
+    std::map<std::string, uint32_t> latencyUs;
+    std::map<std::string, std::vector<PoseKey>> poses;
+    std::map<std::string, std::vector<InputKey>> inputs;
+    std::vector<StateKey> states;
+    std::vector<PresenceKey> presence;
+};
+
+struct ActionSet;
+
+struct Action {
+    ActionSet* set;
+    XrActionType type;
+    std::string name;
+    std::vector<XrPath> subactionPaths;
+    std::vector<XrPath> bindings;
+};
+
+struct ActionSet {
+    std::string name;
+    std::vector<std::unique_ptr<Action>> actions;
+};
+
+struct Space {
+    enum Kind { Reference, Action } kind;
+    XrReferenceSpaceType referenceType;
+    std::string device;  // "head", "left", "right" for action spaces
+    XrPosef offset;
+};
+
+struct Swapchain {
+    int64_t format;
+    uint32_t width, height;
+    uint32_t images[kSwapchainImageCount];
+    bool textures = false;  // images are GL textures, see CreateTextures
+    uint32_t next = 0;
+    std::deque<uint32_t> acquired;
+    bool waited = false;
+};
+
+struct Session {
+    XrSessionState state = XR_SESSION_STATE_UNKNOWN;
+    bool running = false;
+    bool exitRequested = false;
+    bool frameWaited = false;
+    bool frameBegun = false;
+    std::vector<std::unique_ptr<Space>> spaces;
+    std::vector<std::unique_ptr<Swapchain>> swapchains;
+};
+
+struct CallStats {
+    uint64_t total = 0;
+    uint64_t inFrames = 0;  // calls made inside completed frames
+    uint32_t maxPerFrame = 0;
+};
+
+struct Runtime {
+    std::recursive_mutex mutex;
+    // Signalled by xrBeginFrame and xrEndSession, for an xrWaitFrame called ahead on another thread.
+    std::condition_variable_any frameBegunSignal;
+    Script script;
+    bool instanceCreated = false;
+    std::vector<std::string> paths{""};  // XrPath is the index, 0 is XR_NULL_PATH
+    std::vector<std::unique_ptr<ActionSet>> actionSets;
+    std::unique_ptr<Session> session;
+    std::deque<XrEventDataBuffer> events;
+    bool userPresenceEnabled = false;
+    bool refreshRateEnabled = false;
+    size_t nextState = 0;     // script.states not applied yet
+    size_t nextPresence = 0;  // script.presence not sent yet
+
+    XrTime now = kStartTime;
+    std::chrono::steady_clock::time_point lastWaitFrame;
+
+    // Input values latched by the last xrSyncActions and the one before it.
+    std::map<XrPath, float> syncedInput;
+    std::map<XrPath, float> previousInput;
+    XrTime syncTime = kStartTime;
+    bool inputActive = false;  // the session was focused at the last xrSyncActions
+
+    bool inFrame = false;
+    uint64_t frames = 0;
+    std::map<std::string, uint32_t> frameCalls;
+    std::map<std::string, uint32_t> lastFrameCalls;
+    std::map<std::string, CallStats> callStats;
+};
+
+Runtime& GetRuntime() {
+    static Runtime runtime;
+    return runtime;
+}
+
+// --- pose math ---
+
+XrQuaternionf Multiply(const XrQuaternionf& a, const XrQuaternionf& b) {
+    return {a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y, a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w, a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z};
+}
+
+XrVector3f Rotate(const XrQuaternionf& q, const XrVector3f& v) {
+    const XrQuaternionf p{v.x, v.y, v.z, 0};
+    const XrQuaternionf conj{-q.x, -q.y, -q.z, q.w};
+    const XrQuaternionf r = Multiply(Multiply(q, p), conj);
+    return {r.x, r.y, r.z};
+}
+
+XrPosef Compose(const XrPosef& a, const XrPosef& b) {
+    XrPosef r;
+    r.orientation = Multiply(a.orientation, b.orientation);
+    const XrVector3f p = Rotate(a.orientation, b.position);
+    r.position = {a.position.x + p.x, a.position.y + p.y, a.position.z + p.z};
+    return r;
+}
+
+XrPosef Invert(const XrPosef& a) {
+    XrPosef r;
+    r.orientation = {-a.orientation.x, -a.orientation.y, -a.orientation.z, a.orientation.w};
+    const XrVector3f p = Rotate(r.orientation, a.position);
+    r.position = {-p.x, -p.y, -p.z};
+    return r;
+}
+
+XrPosef Identity() {
+    XrPosef r{};
+    r.orientation.w = 1.0f;
+    return r;
+}
+
+XrPosef Interpolate(const XrPosef& a, const XrPosef& b, float t) {
+    XrPosef r;
+    r.position = {a.position.x + (b.position.x - a.position.x) * t, a.position.y + (b.position.y - a.position.y) * t,
+                  a.position.z + (b.position.z - a.position.z) * t};
+    XrQuaternionf qb = b.orientation;
+    const float dot = a.orientation.x * qb.x + a.orientation.y * qb.y + a.orientation.z * qb.z + a.orientation.w * qb.w;
+    if (dot < 0.0f) {
+        qb = {-qb.x, -qb.y, -qb.z, -qb.w};
+    }
+    XrQuaternionf q{a.orientation.x + (qb.x - a.orientation.x) * t, a.orientation.y + (qb.y - a.orientation.y) * t,
+                    a.orientation.z + (qb.z - a.orientation.z) * t, a.orientation.w + (qb.w - a.orientation.w) * t};
+    const float length = sqrtf(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    r.orientation = {q.x / length, q.y / length, q.z / length, q.w / length};
+    return r;
+}
+
+double TimeToMs(XrTime time) { return (double)(time - kStartTime) / 1e6; }
+
+XrPosef DevicePose(const Runtime& rt, const std::string& device, XrTime time) {
+    auto it = rt.script.poses.find(device);
+    if (it == rt.script.poses.end() || it->second.empty()) {
+        XrPosef pose = Identity();
+        if (device == "head") {
+            pose.position.y = 1.6f;
+        } else {
+            pose.position = {device == "left" ? -0.2f : 0.2f, 1.3f, -0.3f};
+        }
+        return pose;
+    }
+    const std::vector<PoseKey>& keys = it->second;
+    const double ms = TimeToMs(time);
+    if (ms <= keys.front().ms) {
+        return keys.front().pose;
+    }
+    for (size_t i = 1; i < keys.size(); i++) {
+        if (ms < keys[i].ms) {
+            const float t = (float)((ms - keys[i - 1].ms) / (keys[i].ms - keys[i - 1].ms));
+            return Interpolate(keys[i - 1].pose, keys[i].pose, t);
+        }
+    }
+    return keys.back().pose;
+}
+
+float InputValue(const Runtime& rt, const std::string& path, XrTime time) {
+    auto it = rt.script.inputs.find(path);
+    if (it == rt.script.inputs.end()) {
+        return 0.0f;
+    }
+    const double ms = TimeToMs(time);
+    float value = 0.0f;
+    for (const InputKey& key : it->second) {
+        if (key.ms <= ms) {
+            value = key.value;
+        }
+    }
+    return value;
+}
+
+XrPosef SpacePose(const Runtime& rt, const Space* space, XrTime time) {
+    if (space->kind == Space::Action) {
+        return Compose(DevicePose(rt, space->device, time), space->offset);
+    }
+    if (space->referenceType == XR_REFERENCE_SPACE_TYPE_VIEW) {
+        return Compose(DevicePose(rt, "head", time), space->offset);
+    }
+    return space->offset;
+}
+
+// --- script ---
+
+bool LoadScript(const char* path, Script* script) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        fprintf(stderr, "fake_runtime: cannot open script %s\n", path);
+        return false;
+    }
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream tokens(line);
+        std::string directive;
+        if (!(tokens >> directive)) {
+            continue;
+        }
+        bool ok = true;
+        if (directive == "display_period_ms") {
+            ok = (bool)(tokens >> script->displayPeriodMs) && script->displayPeriodMs > 0.0;
+        } else if (directive == "realtime") {
+            int realtime = 0;
+            ok = (bool)(tokens >> realtime);
+            script->realtime = realtime != 0;
+        } else if (directive == "view_size") {
+            ok = (bool)(tokens >> script->viewWidth >> script->viewHeight);
+        } else if (directive == "ipd") {
+            ok = (bool)(tokens >> script->ipd);
+        } else if (directive == "latency") {
+            std::string function;
+            uint32_t us = 0;
+            ok = (bool)(tokens >> function >> us);
+            script->latencyUs[function] = us;
+        } else if (directive == "pose") {
+            PoseKey key;
+            std::string device;
+            XrPosef& p = key.pose;
+            ok = (bool)(tokens >> key.ms >> device >> p.position.x >> p.position.y >> p.position.z >> p.orientation.x >> p.orientation.y >>
+                        p.orientation.z >> p.orientation.w);
+            script->poses[device].push_back(key);
+        } else if (directive == "input") {
+            InputKey key;
+            std::string inputPath;
+            ok = (bool)(tokens >> key.ms >> inputPath >> key.value);
+            script->inputs[inputPath].push_back(key);
+        } else if (directive == "click") {
+            double ms = 0.0, periodMs = 0.0, holdMs = 0.0;
+            uint32_t count = 0;
+            std::string inputPath;
+            ok = (bool)(tokens >> ms >> count >> periodMs >> holdMs >> inputPath) && holdMs > 0.0 && holdMs < periodMs;
+            for (uint32_t i = 0; ok && i < count; i++) {
+                script->inputs[inputPath].push_back({ms + i * periodMs, 1.0f});
+                script->inputs[inputPath].push_back({ms + i * periodMs + holdMs, 0.0f});
+            }
+        } else if (directive == "state") {
+            StateKey key;
+            std::string state;
+            ok = (bool)(tokens >> key.ms >> state);
+            key.state = state == "focused" ? XR_SESSION_STATE_FOCUSED : state == "visible" ? XR_SESSION_STATE_VISIBLE
+                      : state == "synchronized" ? XR_SESSION_STATE_SYNCHRONIZED : XR_SESSION_STATE_UNKNOWN;
+            ok = ok && key.state != XR_SESSION_STATE_UNKNOWN;
+            script->states.push_back(key);
+        } else if (directive == "presence") {
+            PresenceKey key;
+            int present = 0;
+            ok = (bool)(tokens >> key.ms >> present);
+            key.present = present != 0;
+            script->presence.push_back(key);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            fprintf(stderr, "fake_runtime: %s:%d: cannot parse '%s'\n", path, lineNumber, line.c_str());
+            return false;
+        }
+    }
+    // InputValue takes the last key that has passed, click and input lines may interleave.
+    for (auto& input : script->inputs) {
+        std::stable_sort(input.second.begin(), input.second.end(), [](const InputKey& a, const InputKey& b) { return a.ms < b.ms; });
+    }
+    std::stable_sort(script->states.begin(), script->states.end(), [](const StateKey& a, const StateKey& b) { return a.ms < b.ms; });
+    std::stable_sort(script->presence.begin(), script->presence.end(), [](const PresenceKey& a, const PresenceKey& b) { return a.ms < b.ms; });
+    return true;
+}
+
+void WriteReport(const Runtime& rt, const char* path) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        fprintf(stderr, "fake_runtime: cannot write report %s\n", path);
+        return;
+    }
+    out << "frames=" << rt.frames << "\n";
+    for (const auto& entry : rt.callStats) {
+        const double perFrame = rt.frames > 0 ? (double)entry.second.inFrames / (double)rt.frames : 0.0;
+        out << "calls." << entry.first << ".total=" << entry.second.total << "\n";
+        out << "calls." << entry.first << ".per_frame_avg=" << perFrame << "\n";
+        out << "calls." << entry.first << ".per_frame_max=" << entry.second.maxPerFrame << "\n";
+    }
+}
+
+// --- call accounting ---
+
+void EndFrameCounting(Runtime& rt) {
+    if (!rt.inFrame) {
+        // Calls made before the first xrWaitFrame are setup, not part of any frame.
+        rt.frameCalls.clear();
+        rt.inFrame = true;
+        return;
+    }
+    for (const auto& entry : rt.frameCalls) {
+        CallStats& stats = rt.callStats[entry.first];
+        stats.inFrames += entry.second;
+        stats.maxPerFrame = std::max(stats.maxPerFrame, entry.second);
+    }
+    rt.lastFrameCalls.swap(rt.frameCalls);
+    rt.frameCalls.clear();
+    rt.frames++;
+}
+
+// Every entry point starts with this: counts the call and burns the scripted latency.
+void Enter(Runtime& rt, const char* function) {
+    uint32_t latencyUs = 0;
+    {
+        std::lock_guard<std::recursive_mutex> lock(rt.mutex);
+        rt.frameCalls[function]++;
+        rt.callStats[function].total++;
+        auto it = rt.script.latencyUs.find(function);
+        if (it != rt.script.latencyUs.end()) {
+            latencyUs = it->second;
+        }
+    }
+    if (latencyUs > 0) {
+        // Busy wait rather than sleep, sleeps are far too coarse for the microsecond costs being modelled.
+        const auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(latencyUs);
+        while (std::chrono::steady_clock::now() < until) {
+        }
+    }
+}
+
+#define FAKE_XR_ENTER(name)              \
+    Runtime& rt = GetRuntime();          \
+    Enter(rt, name);                     \
+    std::lock_guard<std::recursive_mutex> lock(rt.mutex)
+
+void PushEvent(Runtime& rt, const void* event, size_t size) {
+    XrEventDataBuffer buffer{};
+    memcpy(&buffer, event, size);
+    rt.events.push_back(buffer);
+}
+
+void SetSessionState(Runtime& rt, XrSessionState state) {
+    rt.session->state = state;
+    XrEventDataSessionStateChanged event{XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED};
+    event.session = (XrSession)rt.session.get();
+    event.state = state;
+    event.time = rt.now;
+    PushEvent(rt, &event, sizeof(event));
+}
+
+// Steps through the states in between, as a runtime has to: focused <-> visible <-> synchronized.
+void MoveToState(Runtime& rt, XrSessionState target) {
+    auto rank = [](XrSessionState state) {
+        return state == XR_SESSION_STATE_FOCUSED ? 2 : state == XR_SESSION_STATE_VISIBLE ? 1 : 0;
+    };
+    while (rt.session->state != target) {
+        const int current = rank(rt.session->state);
+        const int step = rank(target) > current ? current + 1 : current - 1;
+        SetSessionState(rt, step == 2 ? XR_SESSION_STATE_FOCUSED : step == 1 ? XR_SESSION_STATE_VISIBLE : XR_SESSION_STATE_SYNCHRONIZED);
+    }
+}
+
+// Scripted state changes and presence events whose time has come, from xrWaitFrame.
+void ApplyScriptedEvents(Runtime& rt) {
+    const double ms = TimeToMs(rt.now);
+    for (; rt.nextState < rt.script.states.size() && rt.script.states[rt.nextState].ms <= ms; rt.nextState++) {
+        if (!rt.session->exitRequested) {
+            MoveToState(rt, rt.script.states[rt.nextState].state);
+        }
+    }
+    for (; rt.nextPresence < rt.script.presence.size() && rt.script.presence[rt.nextPresence].ms <= ms; rt.nextPresence++) {
+        if (rt.userPresenceEnabled) {
+            XrEventDataUserPresenceChangedEXT event{XR_TYPE_EVENT_DATA_USER_PRESENCE_CHANGED_EXT};
+            event.session = (XrSession)rt.session.get();
+            event.isUserPresent = rt.script.presence[rt.nextPresence].present ? XR_TRUE : XR_FALSE;
+            PushEvent(rt, &event, sizeof(event));
+        }
+    }
+}
+
+template <typename T>
+XrResult CopyArray(const std::vector<T>& source, uint32_t capacity, uint32_t* count, T* output) {
+    *count = (uint32_t)source.size();
+    if (capacity == 0) {
+        return XR_SUCCESS;
+    }
+    if (capacity < source.size()) {
+        return XR_ERROR_SIZE_INSUFFICIENT;
+    }
+    std::copy(source.begin(), source.end(), output);
+    return XR_SUCCESS;
+}
+
+XrResult CopyString(const std::string& source, uint32_t capacity, uint32_t* count, char* buffer) {
+    *count = (uint32_t)source.size() + 1;
+    if (capacity == 0) {
+        return XR_SUCCESS;
+    }
+    if (capacity < *count) {
+        return XR_ERROR_SIZE_INSUFFICIENT;
+    }
+    memcpy(buffer, source.c_str(), *count);
+    return XR_SUCCESS;
+}
+
+const std::string& PathString(const Runtime& rt, XrPath path) {
+    static const std::string empty;
+    return path < rt.paths.size() ? rt.paths[path] : empty;
+}
+
+bool StartsWith(const std::string& s, const std::string& prefix) { return s.compare(0, prefix.size(), prefix) == 0; }
+
+// Bindings of the action that belong to the given subaction path (or all of them for XR_NULL_PATH).
+std::vector<XrPath> BoundPaths(const Runtime& rt, const Action* action, XrPath subactionPath) {
+    std::vector<XrPath> result;
+    for (XrPath binding : action->bindings) {
+        if (subactionPath == XR_NULL_PATH || StartsWith(PathString(rt, binding), PathString(rt, subactionPath))) {
+            result.push_back(binding);
+        }
+    }
+    return result;
+}
+
+float SyncedValue(const std::map<XrPath, float>& values, XrPath path) {
+    auto it = values.find(path);
+    return it == values.end() ? 0.0f : it->second;
+}
+
+XrPath GetOrCreatePath(Runtime& rt, const std::string& string) {
+    for (size_t i = 1; i < rt.paths.size(); i++) {
+        if (rt.paths[i] == string) {
+            return (XrPath)i;
+        }
+    }
+    rt.paths.push_back(string);
+    return (XrPath)(rt.paths.size() - 1);
+}
+
+// --- instance ---
+
+XrResult XRAPI_CALL FakeEnumerateApiLayerProperties(uint32_t, uint32_t* countOutput, XrApiLayerProperties*) {
+    *countOutput = 0;
+    return XR_SUCCESS;
+}
+
+const std::vector<const char*>& SupportedExtensions() {
+    static const std::vector<const char*> extensions = {XR_KHR_OPENGL_ENABLE_EXTENSION_NAME, XR_KHR_OPENGL_ES_ENABLE_EXTENSION_NAME,
+                                                        XR_MND_HEADLESS_EXTENSION_NAME, XR_EXT_USER_PRESENCE_EXTENSION_NAME,
+                                                        XR_FB_DISPLAY_REFRESH_RATE_EXTENSION_NAME, XR_KHR_ANDROID_CREATE_INSTANCE_EXTENSION_NAME};
+    return extensions;
+}
+
+XrResult XRAPI_CALL FakeEnumerateInstanceExtensionProperties(const char* layerName, uint32_t capacity, uint32_t* countOutput,
+                                                            XrExtensionProperties* properties) {
+    if (layerName != nullptr) {
+        return XR_ERROR_API_LAYER_NOT_PRESENT;
+    }
+    std::vector<XrExtensionProperties> list;
+    for (const char* name : SupportedExtensions()) {
+        XrExtensionProperties extension{XR_TYPE_EXTENSION_PROPERTIES};
+        strncpy(extension.extensionName, name, XR_MAX_EXTENSION_NAME_SIZE - 1);
+        extension.extensionVersion = 1;
+        list.push_back(extension);
+    }
+    return CopyArray(list, capacity, countOutput, properties);
+}
+
+XrResult XRAPI_CALL FakeCreateInstance(const XrInstanceCreateInfo* createInfo, XrInstance* instance) {
+    FAKE_XR_ENTER("xrCreateInstance");
+    if (rt.instanceCreated) {
+        return XR_ERROR_LIMIT_REACHED;
+    }
+    rt.userPresenceEnabled = false;
+    rt.refreshRateEnabled = false;
+    for (uint32_t i = 0; i < createInfo->enabledExtensionCount; i++) {
+        rt.userPresenceEnabled = rt.userPresenceEnabled || strcmp(createInfo->enabledExtensionNames[i], XR_EXT_USER_PRESENCE_EXTENSION_NAME) == 0;
+        rt.refreshRateEnabled = rt.refreshRateEnabled || strcmp(createInfo->enabledExtensionNames[i], XR_FB_DISPLAY_REFRESH_RATE_EXTENSION_NAME) == 0;
+        bool known = false;
+        for (const char* name : SupportedExtensions()) {
+            known = known || strcmp(name, createInfo->enabledExtensionNames[i]) == 0;
+        }
+        if (!known) {
+            return XR_ERROR_EXTENSION_NOT_PRESENT;
+        }
+    }
+
+    rt.script = Script{};
+    if (const char* scriptPath = getenv("FAKE_XR_SCRIPT")) {
+        if (!LoadScript(scriptPath, &rt.script)) {
+            return XR_ERROR_INITIALIZATION_FAILED;
+        }
+    }
+    rt.paths.assign(1, "");
+    rt.actionSets.clear();
+    rt.events.clear();
+    rt.now = kStartTime;
+    rt.syncTime = kStartTime;
+    rt.inputActive = false;
+    rt.nextState = 0;
+    rt.nextPresence = 0;
+    rt.syncedInput.clear();
+    rt.previousInput.clear();
+    rt.inFrame = false;
+    rt.frames = 0;
+    rt.frameCalls.clear();
+    rt.lastFrameCalls.clear();
+    rt.callStats.clear();
+    // The xrCreateInstance call itself was counted before the reset.
+    rt.frameCalls["xrCreateInstance"] = 1;
+    rt.callStats["xrCreateInstance"].total = 1;
+
+    rt.instanceCreated = true;
+    *instance = (XrInstance)&rt;
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeDestroyInstance(XrInstance) {
+    FAKE_XR_ENTER("xrDestroyInstance");
+    if (const char* reportPath = getenv("FAKE_XR_REPORT")) {
+        WriteReport(rt, reportPath);
+    }
+    rt.session.reset();
+    rt.actionSets.clear();
+    rt.instanceCreated = false;
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeGetInstanceProperties(XrInstance, XrInstanceProperties* properties) {
+    FAKE_XR_ENTER("xrGetInstanceProperties");
+    properties->runtimeVersion = XR_MAKE_VERSION(0, 1, 0);
+    strncpy(properties->runtimeName, "CloudXR client fake runtime", XR_MAX_RUNTIME_NAME_SIZE - 1);
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakePollEvent(XrInstance, XrEventDataBuffer* eventData) {
+    FAKE_XR_ENTER("xrPollEvent");
+    if (rt.events.empty()) {
+        return XR_EVENT_UNAVAILABLE;
+    }
+    *eventData = rt.events.front();
+    rt.events.pop_front();
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeResultToString(XrInstance, XrResult value, char buffer[XR_MAX_RESULT_STRING_SIZE]) {
+    switch (value) {
+#define FAKE_XR_RESULT_CASE(name, val) \
+    case name:                         \
+        snprintf(buffer, XR_MAX_RESULT_STRING_SIZE, "%s", #name); \
+        return XR_SUCCESS;
+        XR_LIST_ENUM_XrResult(FAKE_XR_RESULT_CASE)
+#undef FAKE_XR_RESULT_CASE
+        default:
+            snprintf(buffer, XR_MAX_RESULT_STRING_SIZE, "XR_UNKNOWN_%d", (int)value);
+            return XR_SUCCESS;
+    }
+}
+
+XrResult XRAPI_CALL FakeStructureTypeToString(XrInstance, XrStructureType value, char buffer[XR_MAX_STRUCTURE_NAME_SIZE]) {
+    switch (value) {
+#define FAKE_XR_STRUCTURE_CASE(name, val) \
+    case name:                            \
+        snprintf(buffer, XR_MAX_STRUCTURE_NAME_SIZE, "%s", #name); \
+        return XR_SUCCESS;
+        XR_LIST_ENUM_XrStructureType(FAKE_XR_STRUCTURE_CASE)
+#undef FAKE_XR_STRUCTURE_CASE
+        default:
+            snprintf(buffer, XR_MAX_STRUCTURE_NAME_SIZE, "XR_UNKNOWN_STRUCTURE_TYPE_%d", (int)value);
+            return XR_SUCCESS;
+    }
+}
+
+XrResult XRAPI_CALL FakeStringToPath(XrInstance, const char* pathString, XrPath* path) {
+    FAKE_XR_ENTER("xrStringToPath");
+    if (pathString == nullptr || pathString[0] != '/') {
+        return XR_ERROR_PATH_FORMAT_INVALID;
+    }
+    *path = GetOrCreatePath(rt, pathString);
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakePathToString(XrInstance, XrPath path, uint32_t capacity, uint32_t* countOutput, char* buffer) {
+    FAKE_XR_ENTER("xrPathToString");
+    if (path == XR_NULL_PATH || path >= rt.paths.size()) {
+        return XR_ERROR_PATH_INVALID;
+    }
+    return CopyString(rt.paths[path], capacity, countOutput, buffer);
+}
+
+// --- system ---
+
+XrResult XRAPI_CALL FakeGetSystem(XrInstance, const XrSystemGetInfo* getInfo, XrSystemId* systemId) {
+    FAKE_XR_ENTER("xrGetSystem");
+    if (getInfo->formFactor != XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY) {
+        return XR_ERROR_FORM_FACTOR_UNSUPPORTED;
+    }
+    *systemId = kSystemId;
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeGetSystemProperties(XrInstance, XrSystemId, XrSystemProperties* properties) {
+    FAKE_XR_ENTER("xrGetSystemProperties");
+    properties->systemId = kSystemId;
+    properties->vendorId = 0;
+    strncpy(properties->systemName, "fake hmd", XR_MAX_SYSTEM_NAME_SIZE - 1);
+    properties->graphicsProperties.maxSwapchainImageWidth = 4096;
+    properties->graphicsProperties.maxSwapchainImageHeight = 4096;
+    properties->graphicsProperties.maxLayerCount = XR_MIN_COMPOSITION_LAYERS_SUPPORTED;
+    properties->trackingProperties.orientationTracking = XR_TRUE;
+    properties->trackingProperties.positionTracking = XR_TRUE;
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeEnumerateViewConfigurations(XrInstance, XrSystemId, uint32_t capacity, uint32_t* countOutput,
+                                                    XrViewConfigurationType* types) {
+    FAKE_XR_ENTER("xrEnumerateViewConfigurations");
+    return CopyArray(std::vector<XrViewConfigurationType>{XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO}, capacity, countOutput, types);
+}
+
+XrResult XRAPI_CALL FakeGetViewConfigurationProperties(XrInstance, XrSystemId, XrViewConfigurationType type,
+                                                       XrViewConfigurationProperties* properties) {
+    FAKE_XR_ENTER("xrGetViewConfigurationProperties");
+    if (type != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO) {
+        return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+    }
+    properties->viewConfigurationType = type;
+    properties->fovMutable = XR_FALSE;
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeEnumerateViewConfigurationViews(XrInstance, XrSystemId, XrViewConfigurationType type, uint32_t capacity,
+                                                        uint32_t* countOutput, XrViewConfigurationView* views) {
+    FAKE_XR_ENTER("xrEnumerateViewConfigurationViews");
+    if (type != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO) {
+        return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+    }
+    *countOutput = 2;
+    if (capacity == 0) {
+        return XR_SUCCESS;
+    }
+    if (capacity < 2) {
+        return XR_ERROR_SIZE_INSUFFICIENT;
+    }
+    for (uint32_t i = 0; i < 2; i++) {
+        // Keep the caller's next chain, e.g. XR_EPIC_view_configuration_fov which is not supported here.
+        views[i].recommendedImageRectWidth = rt.script.viewWidth;
+        views[i].recommendedImageRectHeight = rt.script.viewHeight;
+        views[i].maxImageRectWidth = 4096;
+        views[i].maxImageRectHeight = 4096;
+        views[i].recommendedSwapchainSampleCount = 1;
+        views[i].maxSwapchainSampleCount = 1;
+    }
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeEnumerateEnvironmentBlendModes(XrInstance, XrSystemId, XrViewConfigurationType, uint32_t capacity,
+                                                       uint32_t* countOutput, XrEnvironmentBlendMode* modes) {
+    FAKE_XR_ENTER("xrEnumerateEnvironmentBlendModes");
+    return CopyArray(std::vector<XrEnvironmentBlendMode>{XR_ENVIRONMENT_BLEND_MODE_OPAQUE}, capacity, countOutput, modes);
+}
+
+XrResult XRAPI_CALL FakeGetOpenGLGraphicsRequirementsKHR(XrInstance, XrSystemId, XrGraphicsRequirementsOpenGLKHR* requirements) {
+    FAKE_XR_ENTER("xrGetOpenGLGraphicsRequirementsKHR");
+    requirements->minApiVersionSupported = XR_MAKE_VERSION(3, 3, 0);
+    requirements->maxApiVersionSupported = XR_MAKE_VERSION(4, 6, 0);
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeGetOpenGLESGraphicsRequirementsKHR(XrInstance, XrSystemId, XrGraphicsRequirementsOpenGLESKHR* requirements) {
+    FAKE_XR_ENTER("xrGetOpenGLESGraphicsRequirementsKHR");
+    requirements->minApiVersionSupported = XR_MAKE_VERSION(3, 0, 0);
+    requirements->maxApiVersionSupported = XR_MAKE_VERSION(3, 2, 0);
+    return XR_SUCCESS;
+}
+
+// --- session ---
+
+XrResult XRAPI_CALL FakeCreateSession(XrInstance, const XrSessionCreateInfo*, XrSession* session) {
+    FAKE_XR_ENTER("xrCreateSession");
+    if (rt.session) {
+        return XR_ERROR_LIMIT_REACHED;
+    }
+    // Any graphics binding (or none, with XR_MND_headless) is accepted, nothing is rendered.
+    rt.session.reset(new Session());
+    SetSessionState(rt, XR_SESSION_STATE_IDLE);
+    SetSessionState(rt, XR_SESSION_STATE_READY);
+    *session = (XrSession)rt.session.get();
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeDestroySession(XrSession) {
+    FAKE_XR_ENTER("xrDestroySession");
+    rt.session.reset();
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeBeginSession(XrSession, const XrSessionBeginInfo*) {
+    FAKE_XR_ENTER("xrBeginSession");
+    if (!rt.session || rt.session->running) {
+        return XR_ERROR_SESSION_RUNNING;
+    }
+    rt.session->running = true;
+    SetSessionState(rt, XR_SESSION_STATE_SYNCHRONIZED);
+    SetSessionState(rt, XR_SESSION_STATE_VISIBLE);
+    SetSessionState(rt, XR_SESSION_STATE_FOCUSED);
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeEndSession(XrSession) {
+    FAKE_XR_ENTER("xrEndSession");
+    if (!rt.session || !rt.session->running) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+    rt.session->running = false;
+    rt.frameBegunSignal.notify_all();
+    SetSessionState(rt, XR_SESSION_STATE_IDLE);
+    if (rt.session->exitRequested) {
+        SetSessionState(rt, XR_SESSION_STATE_EXITING);
+    }
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeRequestExitSession(XrSession) {
+    FAKE_XR_ENTER("xrRequestExitSession");
+    if (!rt.session || !rt.session->running) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+    rt.session->exitRequested = true;
+    SetSessionState(rt, XR_SESSION_STATE_VISIBLE);
+    SetSessionState(rt, XR_SESSION_STATE_SYNCHRONIZED);
+    SetSessionState(rt, XR_SESSION_STATE_STOPPING);
+    return XR_SUCCESS;
+}
+
+// --- display refresh rate ---
+
+// The one rate offered is the scripted display period's.
+XrResult XRAPI_CALL FakeEnumerateDisplayRefreshRatesFB(XrSession, uint32_t capacity, uint32_t* countOutput, float* rates) {
+    FAKE_XR_ENTER("xrEnumerateDisplayRefreshRatesFB");
+    return CopyArray(std::vector<float>{(float)(1000.0 / rt.script.displayPeriodMs)}, capacity, countOutput, rates);
+}
+
+XrResult XRAPI_CALL FakeGetDisplayRefreshRateFB(XrSession, float* rate) {
+    FAKE_XR_ENTER("xrGetDisplayRefreshRateFB");
+    *rate = (float)(1000.0 / rt.script.displayPeriodMs);
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeRequestDisplayRefreshRateFB(XrSession, float rate) {
+    FAKE_XR_ENTER("xrRequestDisplayRefreshRateFB");
+    if (rate != 0.0f && std::abs(rate - (float)(1000.0 / rt.script.displayPeriodMs)) > 0.01f) {
+        return XR_ERROR_DISPLAY_REFRESH_RATE_UNSUPPORTED_FB;
+    }
+    return XR_SUCCESS;
+}
+
+// --- frame loop ---
+
+XrResult XRAPI_CALL FakeWaitFrame(XrSession, const XrFrameWaitInfo*, XrFrameState* frameState) {
+    Runtime& rt = GetRuntime();
+    // The previous frame ends here, so this call is the first one counted in the new frame.
+    {
+        std::unique_lock<std::recursive_mutex> lock(rt.mutex);
+        // As on a real runtime, a frame can only be waited once the previously waited frame was begun.
+        rt.frameBegunSignal.wait(lock, [&rt]() { return !rt.session || !rt.session->running || !rt.session->frameWaited; });
+        EndFrameCounting(rt);
+    }
+    Enter(rt, "xrWaitFrame");
+
+    const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::milli>(rt.script.displayPeriodMs));
+    if (rt.script.realtime) {
+        const auto now = std::chrono::steady_clock::now();
+        if (rt.lastWaitFrame.time_since_epoch().count() != 0 && now < rt.lastWaitFrame + period) {
+            std::this_thread::sleep_until(rt.lastWaitFrame + period);
+        }
+        rt.lastWaitFrame = std::chrono::steady_clock::now();
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(rt.mutex);
+    if (!rt.session || !rt.session->running) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+    const XrDuration periodNs = (XrDuration)(rt.script.displayPeriodMs * 1e6);
+    rt.now += periodNs;
+    frameState->predictedDisplayTime = rt.now + periodNs;
+    frameState->predictedDisplayPeriod = periodNs;
+    ApplyScriptedEvents(rt);
+    frameState->shouldRender = rt.session->state == XR_SESSION_STATE_VISIBLE || rt.session->state == XR_SESSION_STATE_FOCUSED;
+    rt.session->frameWaited = true;
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeBeginFrame(XrSession, const XrFrameBeginInfo*) {
+    FAKE_XR_ENTER("xrBeginFrame");
+    if (!rt.session || !rt.session->running) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+    if (!rt.session->frameWaited) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    rt.session->frameWaited = false;
+    rt.frameBegunSignal.notify_all();
+    const bool discarded = rt.session->frameBegun;
+    rt.session->frameBegun = true;
+    return discarded ? XR_FRAME_DISCARDED : XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeEndFrame(XrSession, const XrFrameEndInfo* frameEndInfo) {
+    FAKE_XR_ENTER("xrEndFrame");
+    if (!rt.session || !rt.session->running) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+    if (!rt.session->frameBegun) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    if (frameEndInfo->layerCount > XR_MIN_COMPOSITION_LAYERS_SUPPORTED) {
+        return XR_ERROR_LAYER_LIMIT_EXCEEDED;
+    }
+    if (frameEndInfo->environmentBlendMode != XR_ENVIRONMENT_BLEND_MODE_OPAQUE) {
+        return XR_ERROR_ENVIRONMENT_BLEND_MODE_UNSUPPORTED;
+    }
+    rt.session->frameBegun = false;
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeLocateViews(XrSession, const XrViewLocateInfo* viewLocateInfo, XrViewState* viewState, uint32_t capacity,
+                                    uint32_t* countOutput, XrView* views) {
+    FAKE_XR_ENTER("xrLocateViews");
+    *countOutput = 2;
+    if (capacity == 0) {
+        return XR_SUCCESS;
+    }
+    if (capacity < 2) {
+        return XR_ERROR_SIZE_INSUFFICIENT;
+    }
+    const Space* base = reinterpret_cast<const Space*>(viewLocateInfo->space);
+    const XrPosef baseInverse = Invert(SpacePose(rt, base, viewLocateInfo->displayTime));
+    const XrPosef head = DevicePose(rt, "head", viewLocateInfo->displayTime);
+    viewState->viewStateFlags = XR_VIEW_STATE_ORIENTATION_VALID_BIT | XR_VIEW_STATE_POSITION_VALID_BIT |
+                                XR_VIEW_STATE_ORIENTATION_TRACKED_BIT | XR_VIEW_STATE_POSITION_TRACKED_BIT;
+    for (uint32_t i = 0; i < 2; i++) {
+        XrPosef eye = Identity();
+        eye.position.x = (i == 0 ? -0.5f : 0.5f) * rt.script.ipd;
+        views[i].pose = Compose(baseInverse, Compose(head, eye));
+        views[i].fov = {-0.785398f, 0.785398f, 0.785398f, -0.785398f};
+    }
+    return XR_SUCCESS;
+}
+
+// --- spaces ---
+
+XrResult XRAPI_CALL FakeEnumerateReferenceSpaces(XrSession, uint32_t capacity, uint32_t* countOutput, XrReferenceSpaceType* spaces) {
+    FAKE_XR_ENTER("xrEnumerateReferenceSpaces");
+    return CopyArray(std::vector<XrReferenceSpaceType>{XR_REFERENCE_SPACE_TYPE_VIEW, XR_REFERENCE_SPACE_TYPE_LOCAL, XR_REFERENCE_SPACE_TYPE_STAGE},
+                     capacity, countOutput, spaces);
+}
+
+XrResult XRAPI_CALL FakeCreateReferenceSpace(XrSession, const XrReferenceSpaceCreateInfo* createInfo, XrSpace* space) {
+    FAKE_XR_ENTER("xrCreateReferenceSpace");
+    if (!rt.session) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    std::unique_ptr<Space> s(new Space());
+    s->kind = Space::Reference;
+    s->referenceType = createInfo->referenceSpaceType;
+    s->offset = createInfo->poseInReferenceSpace;
+    *space = (XrSpace)s.get();
+    rt.session->spaces.push_back(std::move(s));
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeGetReferenceSpaceBoundsRect(XrSession, XrReferenceSpaceType, XrExtent2Df* bounds) {
+    FAKE_XR_ENTER("xrGetReferenceSpaceBoundsRect");
+    bounds->width = 2.0f;
+    bounds->height = 2.0f;
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeCreateActionSpace(XrSession, const XrActionSpaceCreateInfo* createInfo, XrSpace* space) {
+    FAKE_XR_ENTER("xrCreateActionSpace");
+    if (!rt.session) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    std::unique_ptr<Space> s(new Space());
+    s->kind = Space::Action;
+    const std::string& subaction = PathString(rt, createInfo->subactionPath);
+    s->device = StartsWith(subaction, "/user/hand/left") ? "left" : StartsWith(subaction, "/user/hand/right") ? "right" : "head";
+    s->offset = createInfo->poseInActionSpace;
+    *space = (XrSpace)s.get();
+    rt.session->spaces.push_back(std::move(s));
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeDestroySpace(XrSpace space) {
+    FAKE_XR_ENTER("xrDestroySpace");
+    if (rt.session) {
+        auto& spaces = rt.session->spaces;
+        spaces.erase(std::remove_if(spaces.begin(), spaces.end(), [&](const std::unique_ptr<Space>& s) { return (XrSpace)s.get() == space; }),
+                     spaces.end());
+    }
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation* location) {
+    FAKE_XR_ENTER("xrLocateSpace");
+    const Space* s = reinterpret_cast<const Space*>(space);
+    const Space* base = reinterpret_cast<const Space*>(baseSpace);
+    location->pose = Compose(Invert(SpacePose(rt, base, time)), SpacePose(rt, s, time));
+    location->locationFlags = XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT |
+                              XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT | XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
+    // Velocities are left untouched unless requested; scripted poses are piecewise linear, so report zero.
+    XrSpaceVelocity* velocity = reinterpret_cast<XrSpaceVelocity*>(const_cast<void*>(location->next));
+    if (velocity != nullptr && velocity->type == XR_TYPE_SPACE_VELOCITY) {
+        velocity->velocityFlags = XR_SPACE_VELOCITY_LINEAR_VALID_BIT | XR_SPACE_VELOCITY_ANGULAR_VALID_BIT;
+        velocity->linearVelocity = {0, 0, 0};
+        velocity->angularVelocity = {0, 0, 0};
+    }
+    return XR_SUCCESS;
+}
+
+// --- swapchains ---
+
+XrResult XRAPI_CALL FakeEnumerateSwapchainFormats(XrSession, uint32_t capacity, uint32_t* countOutput, int64_t* formats) {
+    FAKE_XR_ENTER("xrEnumerateSwapchainFormats");
+    return CopyArray(std::vector<int64_t>{kGL_SRGB8_ALPHA8, kGL_RGBA8, kGL_DEPTH_COMPONENT24}, capacity, countOutput, formats);
+}
+
+// With a GL context current on the calling thread, as the app's GL plugins have in xrCreateSwapchain, the images are
+// textures of that context, so rendering into them is valid GL. The runtime links no GL library: the entry points are
+// the app's, looked up in the process. Nothing is ever composited from them.
+bool CreateTextures(Swapchain* s, uint32_t arraySize) {
+    using PFN_GetCurrentContext = void* (*)();
+    using PFN_GenTextures = void (*)(int, uint32_t*);
+    using PFN_BindTexture = void (*)(uint32_t, uint32_t);
+    using PFN_TexStorage2D = void (*)(uint32_t, int, uint32_t, int, int);
+    using PFN_TexStorage3D = void (*)(uint32_t, int, uint32_t, int, int, int);
+    static const auto getCurrentContext = reinterpret_cast<PFN_GetCurrentContext>(dlsym(RTLD_DEFAULT, "eglGetCurrentContext"));
+    static const auto genTextures = reinterpret_cast<PFN_GenTextures>(dlsym(RTLD_DEFAULT, "glGenTextures"));
+    static const auto bindTexture = reinterpret_cast<PFN_BindTexture>(dlsym(RTLD_DEFAULT, "glBindTexture"));
+    static const auto texStorage2D = reinterpret_cast<PFN_TexStorage2D>(dlsym(RTLD_DEFAULT, "glTexStorage2D"));
+    static const auto texStorage3D = reinterpret_cast<PFN_TexStorage3D>(dlsym(RTLD_DEFAULT, "glTexStorage3D"));
+    if (getCurrentContext == nullptr || genTextures == nullptr || bindTexture == nullptr || texStorage2D == nullptr ||
+        texStorage3D == nullptr || getCurrentContext() == nullptr) {
+        return false;
+    }
+    const uint32_t kGL_TEXTURE_2D = 0x0DE1;
+    const uint32_t kGL_TEXTURE_2D_ARRAY = 0x8C1A;
+    const uint32_t target = arraySize > 1 ? kGL_TEXTURE_2D_ARRAY : kGL_TEXTURE_2D;
+    genTextures(kSwapchainImageCount, s->images);
+    for (uint32_t image : s->images) {
+        bindTexture(target, image);
+        if (arraySize > 1) {
+            texStorage3D(target, 1, (uint32_t)s->format, (int)s->width, (int)s->height, (int)arraySize);
+        } else {
+            texStorage2D(target, 1, (uint32_t)s->format, (int)s->width, (int)s->height);
+        }
+    }
+    bindTexture(target, 0);
+    return true;
+}
+
+void DeleteTextures(Swapchain* s) {
+    using PFN_DeleteTextures = void (*)(int, const uint32_t*);
+    static const auto deleteTextures = reinterpret_cast<PFN_DeleteTextures>(dlsym(RTLD_DEFAULT, "glDeleteTextures"));
+    if (s->textures && deleteTextures != nullptr) {
+        deleteTextures(kSwapchainImageCount, s->images);
+    }
+}
+
+XrResult XRAPI_CALL FakeCreateSwapchain(XrSession, const XrSwapchainCreateInfo* createInfo, XrSwapchain* swapchain) {
+    FAKE_XR_ENTER("xrCreateSwapchain");
+    if (!rt.session) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    static uint32_t nextImageName = kFirstImageName;
+    std::unique_ptr<Swapchain> s(new Swapchain());
+    s->format = createInfo->format;
+    s->width = createInfo->width;
+    s->height = createInfo->height;
+    s->textures = CreateTextures(s.get(), createInfo->arraySize);
+    if (!s->textures) {
+        for (uint32_t& image : s->images) {
+            image = nextImageName++;
+        }
+    }
+    *swapchain = (XrSwapchain)s.get();
+    rt.session->swapchains.push_back(std::move(s));
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeDestroySwapchain(XrSwapchain swapchain) {
+    FAKE_XR_ENTER("xrDestroySwapchain");
+    if (rt.session) {
+        auto& swapchains = rt.session->swapchains;
+        auto it = std::find_if(swapchains.begin(), swapchains.end(),
+                               [&](const std::unique_ptr<Swapchain>& s) { return (XrSwapchain)s.get() == swapchain; });
+        if (it != swapchains.end()) {
+            DeleteTextures(it->get());
+            swapchains.erase(it);
+        }
+    }
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeEnumerateSwapchainImages(XrSwapchain swapchain, uint32_t capacity, uint32_t* countOutput,
+                                                 XrSwapchainImageBaseHeader* images) {
+    FAKE_XR_ENTER("xrEnumerateSwapchainImages");
+    const Swapchain* s = reinterpret_cast<const Swapchain*>(swapchain);
+    *countOutput = kSwapchainImageCount;
+    if (capacity == 0) {
+        return XR_SUCCESS;
+    }
+    if (capacity < kSwapchainImageCount) {
+        return XR_ERROR_SIZE_INSUFFICIENT;
+    }
+    // XrSwapchainImageOpenGLKHR and XrSwapchainImageOpenGLESKHR share the same layout.
+    for (uint32_t i = 0; i < kSwapchainImageCount; i++) {
+        if (images->type == XR_TYPE_SWAPCHAIN_IMAGE_OPENGL_ES_KHR) {
+            reinterpret_cast<XrSwapchainImageOpenGLESKHR*>(images)[i].image = s->images[i];
+        } else if (images->type == XR_TYPE_SWAPCHAIN_IMAGE_OPENGL_KHR) {
+            reinterpret_cast<XrSwapchainImageOpenGLKHR*>(images)[i].image = s->images[i];
+        } else {
+            return XR_ERROR_VALIDATION_FAILURE;
+        }
+    }
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeAcquireSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageAcquireInfo*, uint32_t* index) {
+    FAKE_XR_ENTER("xrAcquireSwapchainImage");
+    Swapchain* s = reinterpret_cast<Swapchain*>(swapchain);
+    if (s->acquired.size() >= kSwapchainImageCount) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    *index = s->next;
+    s->acquired.push_back(s->next);
+    s->next = (s->next + 1) % kSwapchainImageCount;
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeWaitSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageWaitInfo*) {
+    FAKE_XR_ENTER("xrWaitSwapchainImage");
+    Swapchain* s = reinterpret_cast<Swapchain*>(swapchain);
+    if (s->acquired.empty() || s->waited) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    s->waited = true;
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeReleaseSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageReleaseInfo*) {
+    FAKE_XR_ENTER("xrReleaseSwapchainImage");
+    Swapchain* s = reinterpret_cast<Swapchain*>(swapchain);
+    if (!s->waited) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    s->acquired.pop_front();
+    s->waited = false;
+    return XR_SUCCESS;
+}
+
+// --- actions ---
+
+XrResult XRAPI_CALL FakeCreateActionSet(XrInstance, const XrActionSetCreateInfo* createInfo, XrActionSet* actionSet) {
+    FAKE_XR_ENTER("xrCreateActionSet");
+    std::unique_ptr<ActionSet> set(new ActionSet());
+    set->name = createInfo->actionSetName;
+    *actionSet = (XrActionSet)set.get();
+    rt.actionSets.push_back(std::move(set));
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeDestroyActionSet(XrActionSet actionSet) {
+    FAKE_XR_ENTER("xrDestroyActionSet");
+    rt.actionSets.erase(std::remove_if(rt.actionSets.begin(), rt.actionSets.end(),
+                                       [&](const std::unique_ptr<ActionSet>& s) { return (XrActionSet)s.get() == actionSet; }),
+                        rt.actionSets.end());
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeCreateAction(XrActionSet actionSet, const XrActionCreateInfo* createInfo, XrAction* action) {
+    FAKE_XR_ENTER("xrCreateAction");
+    ActionSet* set = reinterpret_cast<ActionSet*>(actionSet);
+    std::unique_ptr<Action> a(new Action());
+    a->set = set;
+    a->type = createInfo->actionType;
+    a->name = createInfo->actionName;
+    a->subactionPaths.assign(createInfo->subactionPaths, createInfo->subactionPaths + createInfo->countSubactionPaths);
+    *action = (XrAction)a.get();
+    set->actions.push_back(std::move(a));
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeDestroyAction(XrAction) {
+    FAKE_XR_ENTER("xrDestroyAction");
+    // Actions are owned by their set and go away with it.
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeSuggestInteractionProfileBindings(XrInstance, const XrInteractionProfileSuggestedBinding* suggestedBindings) {
+    FAKE_XR_ENTER("xrSuggestInteractionProfileBindings");
+    // Every suggested profile is accepted and all of them stay active at once.
+    for (uint32_t i = 0; i < suggestedBindings->countSuggestedBindings; i++) {
+        Action* action = reinterpret_cast<Action*>(suggestedBindings->suggestedBindings[i].action);
+        action->bindings.push_back(suggestedBindings->suggestedBindings[i].binding);
+    }
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeAttachSessionActionSets(XrSession, const XrSessionActionSetsAttachInfo*) {
+    FAKE_XR_ENTER("xrAttachSessionActionSets");
+    return rt.session ? XR_SUCCESS : XR_ERROR_HANDLE_INVALID;
+}
+
+XrResult XRAPI_CALL FakeGetCurrentInteractionProfile(XrSession, XrPath, XrInteractionProfileState* state) {
+    FAKE_XR_ENTER("xrGetCurrentInteractionProfile");
+    state->interactionProfile = XR_NULL_PATH;
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeSyncActions(XrSession, const XrActionsSyncInfo*) {
+    FAKE_XR_ENTER("xrSyncActions");
+    if (!rt.session || !rt.session->running) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+    rt.previousInput.swap(rt.syncedInput);
+    rt.syncedInput.clear();
+    // As the spec asks, nothing is active without focus.
+    rt.inputActive = rt.session->state == XR_SESSION_STATE_FOCUSED;
+    for (size_t path = 1; rt.inputActive && path < rt.paths.size(); path++) {
+        rt.syncedInput[(XrPath)path] = InputValue(rt, rt.paths[path], rt.now);
+    }
+    rt.syncTime = rt.now;
+    return rt.inputActive ? XR_SUCCESS : XR_SESSION_NOT_FOCUSED;
+}
+
+XrResult XRAPI_CALL FakeGetActionStateBoolean(XrSession, const XrActionStateGetInfo* getInfo, XrActionStateBoolean* state) {
+    FAKE_XR_ENTER("xrGetActionStateBoolean");
+    const Action* action = reinterpret_cast<const Action*>(getInfo->action);
+    const std::vector<XrPath> bound = rt.inputActive ? BoundPaths(rt, action, getInfo->subactionPath) : std::vector<XrPath>();
+    bool current = false, previous = false;
+    for (XrPath path : bound) {
+        current = current || SyncedValue(rt.syncedInput, path) > 0.5f;
+        previous = previous || SyncedValue(rt.previousInput, path) > 0.5f;
+    }
+    state->currentState = current ? XR_TRUE : XR_FALSE;
+    state->changedSinceLastSync = current != previous ? XR_TRUE : XR_FALSE;
+    state->lastChangeTime = rt.syncTime;
+    state->isActive = bound.empty() ? XR_FALSE : XR_TRUE;
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeGetActionStateFloat(XrSession, const XrActionStateGetInfo* getInfo, XrActionStateFloat* state) {
+    FAKE_XR_ENTER("xrGetActionStateFloat");
+    const Action* action = reinterpret_cast<const Action*>(getInfo->action);
+    const std::vector<XrPath> bound = rt.inputActive ? BoundPaths(rt, action, getInfo->subactionPath) : std::vector<XrPath>();
+    float current = 0.0f, previous = 0.0f;
+    for (XrPath path : bound) {
+        current = std::max(current, SyncedValue(rt.syncedInput, path));
+        previous = std::max(previous, SyncedValue(rt.previousInput, path));
+    }
+    state->currentState = current;
+    state->changedSinceLastSync = current != previous ? XR_TRUE : XR_FALSE;
+    state->lastChangeTime = rt.syncTime;
+    state->isActive = bound.empty() ? XR_FALSE : XR_TRUE;
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeGetActionStateVector2f(XrSession, const XrActionStateGetInfo* getInfo, XrActionStateVector2f* state) {
+    FAKE_XR_ENTER("xrGetActionStateVector2f");
+    const Action* action = reinterpret_cast<const Action*>(getInfo->action);
+    const std::vector<XrPath> bound = rt.inputActive ? BoundPaths(rt, action, getInfo->subactionPath) : std::vector<XrPath>();
+    XrVector2f current{0, 0}, previous{0, 0};
+    for (XrPath path : bound) {
+        // A vector2 binding such as .../thumbstick reads its components from .../thumbstick/x and /y.
+        const std::string& base = PathString(rt, path);
+        current.x = InputValue(rt, base + "/x", rt.syncTime);
+        current.y = InputValue(rt, base + "/y", rt.syncTime);
+        previous.x = SyncedValue(rt.previousInput, GetOrCreatePath(rt, base + "/x"));
+        previous.y = SyncedValue(rt.previousInput, GetOrCreatePath(rt, base + "/y"));
+    }
+    state->currentState = current;
+    state->changedSinceLastSync = (current.x != previous.x || current.y != previous.y) ? XR_TRUE : XR_FALSE;
+    state->lastChangeTime = rt.syncTime;
+    state->isActive = bound.empty() ? XR_FALSE : XR_TRUE;
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeGetActionStatePose(XrSession, const XrActionStateGetInfo* getInfo, XrActionStatePose* state) {
+    FAKE_XR_ENTER("xrGetActionStatePose");
+    const Action* action = reinterpret_cast<const Action*>(getInfo->action);
+    state->isActive = !rt.inputActive || BoundPaths(rt, action, getInfo->subactionPath).empty() ? XR_FALSE : XR_TRUE;
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeEnumerateBoundSourcesForAction(XrSession, const XrBoundSourcesForActionEnumerateInfo* enumerateInfo, uint32_t capacity,
+                                                       uint32_t* countOutput, XrPath* sources) {
+    FAKE_XR_ENTER("xrEnumerateBoundSourcesForAction");
+    const Action* action = reinterpret_cast<const Action*>(enumerateInfo->action);
+    return CopyArray(action->bindings, capacity, countOutput, sources);
+}
+
+XrResult XRAPI_CALL FakeGetInputSourceLocalizedName(XrSession, const XrInputSourceLocalizedNameGetInfo* getInfo, uint32_t capacity,
+                                                    uint32_t* countOutput, char* buffer) {
+    FAKE_XR_ENTER("xrGetInputSourceLocalizedName");
+    return CopyString(PathString(rt, getInfo->sourcePath), capacity, countOutput, buffer);
+}
+
+XrResult XRAPI_CALL FakeApplyHapticFeedback(XrSession, const XrHapticActionInfo*, const XrHapticBaseHeader*) {
+    FAKE_XR_ENTER("xrApplyHapticFeedback");
+    return XR_SUCCESS;
+}
+
+XrResult XRAPI_CALL FakeStopHapticFeedback(XrSession, const XrHapticActionInfo*) {
+    FAKE_XR_ENTER("xrStopHapticFeedback");
+    return XR_SUCCESS;
+}
+
+// --- dispatch ---
+
+XrResult XRAPI_CALL FakeGetInstanceProcAddr(XrInstance instance, const char* name, PFN_xrVoidFunction* function) {
+#define FAKE_XR_ENTRY(fn) {"xr" #fn, reinterpret_cast<PFN_xrVoidFunction>(Fake##fn)}
+    static const std::map<std::string, PFN_xrVoidFunction> entries = {
+        FAKE_XR_ENTRY(GetInstanceProcAddr),
+        FAKE_XR_ENTRY(EnumerateApiLayerProperties),
+        FAKE_XR_ENTRY(EnumerateInstanceExtensionProperties),
+        FAKE_XR_ENTRY(CreateInstance),
+        FAKE_XR_ENTRY(DestroyInstance),
+        FAKE_XR_ENTRY(GetInstanceProperties),
+        FAKE_XR_ENTRY(PollEvent),
+        FAKE_XR_ENTRY(ResultToString),
+        FAKE_XR_ENTRY(StructureTypeToString),
+        FAKE_XR_ENTRY(StringToPath),
+        FAKE_XR_ENTRY(PathToString),
+        FAKE_XR_ENTRY(GetSystem),
+        FAKE_XR_ENTRY(GetSystemProperties),
+        FAKE_XR_ENTRY(EnumerateViewConfigurations),
+        FAKE_XR_ENTRY(GetViewConfigurationProperties),
+        FAKE_XR_ENTRY(EnumerateViewConfigurationViews),
+        FAKE_XR_ENTRY(EnumerateEnvironmentBlendModes),
+        FAKE_XR_ENTRY(GetOpenGLGraphicsRequirementsKHR),
+        FAKE_XR_ENTRY(GetOpenGLESGraphicsRequirementsKHR),
+        FAKE_XR_ENTRY(CreateSession),
+        FAKE_XR_ENTRY(DestroySession),
+        FAKE_XR_ENTRY(BeginSession),
+        FAKE_XR_ENTRY(EndSession),
+        FAKE_XR_ENTRY(RequestExitSession),
+        FAKE_XR_ENTRY(WaitFrame),
+        FAKE_XR_ENTRY(BeginFrame),
+        FAKE_XR_ENTRY(EndFrame),
+        FAKE_XR_ENTRY(LocateViews),
+        FAKE_XR_ENTRY(EnumerateReferenceSpaces),
+        FAKE_XR_ENTRY(CreateReferenceSpace),
+        FAKE_XR_ENTRY(GetReferenceSpaceBoundsRect),
+        FAKE_XR_ENTRY(CreateActionSpace),
+        FAKE_XR_ENTRY(DestroySpace),
+        FAKE_XR_ENTRY(LocateSpace),
+        FAKE_XR_ENTRY(EnumerateSwapchainFormats),
+        FAKE_XR_ENTRY(CreateSwapchain),
+        FAKE_XR_ENTRY(DestroySwapchain),
+        FAKE_XR_ENTRY(EnumerateSwapchainImages),
+        FAKE_XR_ENTRY(AcquireSwapchainImage),
+        FAKE_XR_ENTRY(WaitSwapchainImage),
+        FAKE_XR_ENTRY(ReleaseSwapchainImage),
+        FAKE_XR_ENTRY(CreateActionSet),
+        FAKE_XR_ENTRY(DestroyActionSet),
+        FAKE_XR_ENTRY(CreateAction),
+        FAKE_XR_ENTRY(DestroyAction),
+        FAKE_XR_ENTRY(SuggestInteractionProfileBindings),
+        FAKE_XR_ENTRY(AttachSessionActionSets),
+        FAKE_XR_ENTRY(GetCurrentInteractionProfile),
+        FAKE_XR_ENTRY(SyncActions),
+        FAKE_XR_ENTRY(GetActionStateBoolean),
+        FAKE_XR_ENTRY(GetActionStateFloat),
+        FAKE_XR_ENTRY(GetActionStateVector2f),
+        FAKE_XR_ENTRY(GetActionStatePose),
+        FAKE_XR_ENTRY(EnumerateBoundSourcesForAction),
+        FAKE_XR_ENTRY(GetInputSourceLocalizedName),
+        FAKE_XR_ENTRY(ApplyHapticFeedback),
+        FAKE_XR_ENTRY(StopHapticFeedback),
+    };
+    static const std::map<std::string, PFN_xrVoidFunction> refreshRateEntries = {
+        FAKE_XR_ENTRY(EnumerateDisplayRefreshRatesFB),
+        FAKE_XR_ENTRY(GetDisplayRefreshRateFB),
+        FAKE_XR_ENTRY(RequestDisplayRefreshRateFB),
+    };
+#undef FAKE_XR_ENTRY
+
+    bool refreshRateEnabled = false;
+    {
+        Runtime& rt = GetRuntime();
+        std::lock_guard<std::recursive_mutex> lock(rt.mutex);
+        refreshRateEnabled = rt.refreshRateEnabled;
+    }
+    if (instance != XR_NULL_HANDLE && refreshRateEnabled) {
+        auto it = refreshRateEntries.find(name);
+        if (it != refreshRateEntries.end()) {
+            *function = it->second;
+            return XR_SUCCESS;
+        }
+    }
+
+    auto it = entries.find(name);
+    if (it == entries.end()) {
+        *function = nullptr;
+        return XR_ERROR_FUNCTION_UNSUPPORTED;
+    }
+    if (instance == XR_NULL_HANDLE && it->first != "xrEnumerateInstanceExtensionProperties" && it->first != "xrEnumerateApiLayerProperties" &&
+        it->first != "xrCreateInstance" && it->first != "xrGetInstanceProcAddr") {
+        *function = nullptr;
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    *function = it->second;
+    return XR_SUCCESS;
+}
+
+}  // namespace
+
+extern "C" {
+
+FAKE_XR_EXPORT XrResult XRAPI_CALL xrNegotiateLoaderRuntimeInterface(const XrNegotiateLoaderInfo* loaderInfo,
+                                                                     XrNegotiateRuntimeRequest* runtimeRequest) {
+    if (loaderInfo == nullptr || runtimeRequest == nullptr || loaderInfo->structType != XR_LOADER_INTERFACE_STRUCT_LOADER_INFO ||
+        runtimeRequest->structType != XR_LOADER_INTERFACE_STRUCT_RUNTIME_REQUEST) {
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+    if (loaderInfo->minInterfaceVersion > XR_CURRENT_LOADER_RUNTIME_VERSION || loaderInfo->maxInterfaceVersion < XR_CURRENT_LOADER_RUNTIME_VERSION) {
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+    runtimeRequest->runtimeInterfaceVersion = XR_CURRENT_LOADER_RUNTIME_VERSION;
+    runtimeRequest->runtimeApiVersion = XR_CURRENT_API_VERSION;
+    runtimeRequest->getInstanceProcAddr = FakeGetInstanceProcAddr;
+    return XR_SUCCESS;
+}
+
+FAKE_XR_EXPORT uint64_t fakeXrFrameCount() {
+    Runtime& rt = GetRuntime();
+    std::lock_guard<std::recursive_mutex> lock(rt.mutex);
+    return rt.frames;
+}
+
+FAKE_XR_EXPORT uint32_t fakeXrLastFrameCallCount(const char* function) {
+    Runtime& rt = GetRuntime();
+    std::lock_guard<std::recursive_mutex> lock(rt.mutex);
+    auto it = rt.lastFrameCalls.find(function);
+    return it == rt.lastFrameCalls.end() ? 0 : it->second;
+}
+
+FAKE_XR_EXPORT uint32_t fakeXrLastFrameTotalCalls() {
+    Runtime& rt = GetRuntime();
+    std::lock_guard<std::recursive_mutex> lock(rt.mutex);
+    uint32_t total = 0;
+    for (const auto& entry : rt.lastFrameCalls) {
+        total += entry.second;
+    }
+    return total;
+}
+
+}  // extern "C"
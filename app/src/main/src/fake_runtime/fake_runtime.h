@@ -0,0 +1,68 @@
+/*
+    deterministic in-process OpenXR runtime for tests and benchmarks of OpenXrProgram.
+
+    build (linux):
+      g++ -std=c++17 -O2 -shared -fPIC -fvisibility=hidden -I../openxr_loader/include \
+          fake_runtime.cpp -o libopenxr_fake_runtime.so -lpthread
+    use:
+      XR_RUNTIME_JSON=<dir>/fake_runtime.json FAKE_XR_SCRIPT=<script> FAKE_XR_REPORT=<report> ./app
+    or, for the android app built for linux with the CloudXR stand-in (../host/host_android.cpp):
+      ../host/run_host.sh <script> [<property>=<value> ...]
+
+    extensions: XR_KHR_opengl_enable, XR_KHR_opengl_es_enable, XR_MND_headless, XR_EXT_user_presence,
+    XR_FB_display_refresh_rate (the one rate is the script's display period) and
+    XR_KHR_android_create_instance (its create info is ignored). swapchain images are GL textures of the
+    context current in xrCreateSwapchain, if there is one, otherwise names without GL objects.
+
+    the script is a text file with one directive per line ('#' starts a comment):
+      display_period_ms <ms>                  virtual display period, default 13.889 (72Hz)
+      realtime <0|1>                          sleep the display period in xrWaitFrame, default 0
+      view_size <width> <height>              recommended per-eye image size
+      ipd <meters>
+      latency <xrFunction> <us>               busy time spent inside every call of that function
+      pose <ms> <head|left|right> <px py pz> <qx qy qz qw>
+                                              pose keyframe, interpolated between keyframes
+      input <ms> <path> <value>               input value from that time on, e.g.
+                                              input 1000 /user/hand/right/input/trigger/value 1
+      click <ms> <count> <period ms> <hold ms> <path>
+                                              count presses of that input, 1 for hold ms then 0, one
+                                              every period from ms on, see scripts/click_to_photon.txt
+      state <ms> <focused|visible|synchronized>
+                                              session state from that time on, through the states in
+                                              between; the session begins focused
+      presence <ms> <0|1>                     XR_EXT_user_presence event, if the app enabled it
+    all times are virtual: the clock only advances in xrWaitFrame, by one display period per frame,
+    so two runs of the same script see exactly the same poses, input, events and predicted display times.
+    as the spec asks, xrSyncActions returns XR_SESSION_NOT_FOCUSED and every action is inactive while
+    the session is not focused.
+    as on a real runtime, xrWaitFrame blocks until the previously waited frame was begun, so the
+    pipelined frame loop (frame_pacer.h) can call it from its own thread.
+
+    per-frame call counts (calls between two xrWaitFrame) are available in-process through the
+    functions below, and are written to FAKE_XR_REPORT when the instance is destroyed.
+*/
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define FAKE_XR_EXPORT __attribute__((visibility("default")))
+#else
+#define FAKE_XR_EXPORT
+#endif
+
+extern "C" {
+
+// Number of frames completed so far, a frame ends when the next xrWaitFrame is called.
+FAKE_XR_EXPORT uint64_t fakeXrFrameCount();
+
+// Calls of the named function made during the last completed frame.
+FAKE_XR_EXPORT uint32_t fakeXrLastFrameCallCount(const char* function);
+
+// Calls of any runtime function made during the last completed frame.
+FAKE_XR_EXPORT uint32_t fakeXrLastFrameTotalCalls();
+
+typedef uint64_t (*PFN_fakeXrFrameCount)();
+typedef uint32_t (*PFN_fakeXrLastFrameCallCount)(const char* function);
+typedef uint32_t (*PFN_fakeXrLastFrameTotalCalls)();
+}
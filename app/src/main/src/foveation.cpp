@@ -0,0 +1,156 @@
+/*
+    fixed foveated rendering on the projection swapchains.
+*/
+#include "pch.h"
+#include "common.h"
+#include "foveation.h"
+#include "metrics.h"
+#include "options.h"
+#include "platformplugin.h"
+#include "graphicsplugin.h"
+#include "openxr_program.h"
+
+#if defined(XR_USE_PLATFORM_ANDROID)
+#include <dlfcn.h>
+#endif
+
+namespace {
+
+const char* ToString(XrFoveationLevelFB level) {
+    switch (level) {
+        case XR_FOVEATION_LEVEL_NONE_FB:
+            return "none";
+        case XR_FOVEATION_LEVEL_LOW_FB:
+            return "low";
+        case XR_FOVEATION_LEVEL_MEDIUM_FB:
+            return "medium";
+        case XR_FOVEATION_LEVEL_HIGH_FB:
+            return "high";
+        default:
+            return "unknown";
+    }
+}
+
+// AThermal is API 30 and the app's minimum is 29, so it is looked up at runtime.
+int ReadThermalStatus() {
+#if defined(XR_USE_PLATFORM_ANDROID)
+    typedef void* (*PFN_AThermal_acquireManager)();
+    typedef int (*PFN_AThermal_getCurrentThermalStatus)(void* manager);
+    static void* manager = nullptr;
+    static PFN_AThermal_getCurrentThermalStatus getStatus = nullptr;
+    static bool resolved = false;
+    if (!resolved) {
+        resolved = true;
+        void* android = dlopen("libandroid.so", RTLD_NOW);
+        auto acquire = android != nullptr ? (PFN_AThermal_acquireManager)dlsym(android, "AThermal_acquireManager") : nullptr;
+        getStatus = android != nullptr ? (PFN_AThermal_getCurrentThermalStatus)dlsym(android, "AThermal_getCurrentThermalStatus") : nullptr;
+        manager = acquire != nullptr ? acquire() : nullptr;
+    }
+    if (manager != nullptr && getStatus != nullptr) {
+        return getStatus(manager);
+    }
+#endif
+    return -1;
+}
+
+}  // namespace
+
+const std::vector<const char*>& Foveation::Extensions() {
+    static const std::vector<const char*> extensions = {XR_FB_FOVEATION_EXTENSION_NAME, XR_FB_FOVEATION_CONFIGURATION_EXTENSION_NAME,
+                                                        XR_FB_SWAPCHAIN_UPDATE_STATE_EXTENSION_NAME};
+    return extensions;
+}
+
+XrFoveationLevelFB Foveation::ChooseLevel(const std::string& setting, XrFoveationLevelFB deviceLevel, int thermalStatus) {
+    if (setting == "off") {
+        return XR_FOVEATION_LEVEL_NONE_FB;
+    }
+    if (setting == "low") {
+        return XR_FOVEATION_LEVEL_LOW_FB;
+    }
+    if (setting == "medium") {
+        return XR_FOVEATION_LEVEL_MEDIUM_FB;
+    }
+    if (setting == "high") {
+        return XR_FOVEATION_LEVEL_HIGH_FB;
+    }
+
+    // ATHERMAL_STATUS_MODERATE and up: the device is throttling or about to.
+    int level = deviceLevel;
+    if (thermalStatus >= 3) {
+        level = XR_FOVEATION_LEVEL_HIGH_FB;
+    } else if (thermalStatus == 2) {
+        level++;
+    }
+    return (XrFoveationLevelFB)std::min(level, (int)XR_FOVEATION_LEVEL_HIGH_FB);
+}
+
+void Foveation::Initialize(XrInstance instance, bool extensionsEnabled, const std::string& setting, XrFoveationLevelFB deviceLevel) {
+    m_setting = setting;
+    m_deviceLevel = deviceLevel;
+    m_applied = XR_FOVEATION_LEVEL_MAX_ENUM_FB;
+    m_createProfile = nullptr;
+    if (!extensionsEnabled || setting == "off") {
+        Log::Write(Log::Level::Info, Fmt("foveation: off%s", extensionsEnabled ? "" : ", XR_FB_foveation not supported"));
+        return;
+    }
+
+    CHECK_XRCMD(xrGetInstanceProcAddr(instance, "xrCreateFoveationProfileFB", (PFN_xrVoidFunction*)&m_createProfile));
+    CHECK_XRCMD(xrGetInstanceProcAddr(instance, "xrDestroyFoveationProfileFB", (PFN_xrVoidFunction*)&m_destroyProfile));
+    CHECK_XRCMD(xrGetInstanceProcAddr(instance, "xrUpdateSwapchainFB", (PFN_xrVoidFunction*)&m_updateSwapchain));
+    Log::Write(Log::Level::Info, Fmt("foveation: %s, device level %s", setting.c_str(), ToString(deviceLevel)));
+}
+
+void Foveation::Update(XrSession session, const std::vector<Swapchain>& swapchains) {
+    if (!IsEnabled()) {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (m_applied != XR_FOVEATION_LEVEL_MAX_ENUM_FB && now - m_lastPoll < std::chrono::seconds(1)) {
+        return;
+    }
+    m_lastPoll = now;
+
+    const int thermalStatus = m_setting == "auto" ? ReadThermalStatus() : -1;
+    const XrFoveationLevelFB level = ChooseLevel(m_setting, m_deviceLevel, thermalStatus);
+    if (level == m_applied) {
+        return;
+    }
+    if (!Apply(session, swapchains, level)) {
+        // Leave the swapchains as they are rather than retrying every second.
+        m_createProfile = nullptr;
+        return;
+    }
+    Log::Write(Log::Level::Info, Fmt("foveation: level %s, thermal status %d", ToString(level), thermalStatus));
+    Metrics::Set("frame.foveation_level", level);
+    m_applied = level;
+}
+
+bool Foveation::Apply(XrSession session, const std::vector<Swapchain>& swapchains, XrFoveationLevelFB level) {
+    XrFoveationLevelProfileCreateInfoFB levelInfo{XR_TYPE_FOVEATION_LEVEL_PROFILE_CREATE_INFO_FB};
+    levelInfo.level = level;
+    levelInfo.verticalOffset = 0.0f;
+    levelInfo.dynamic = XR_FOVEATION_DYNAMIC_DISABLED_FB;
+    XrFoveationProfileCreateInfoFB profileInfo{XR_TYPE_FOVEATION_PROFILE_CREATE_INFO_FB};
+    profileInfo.next = &levelInfo;
+
+    XrFoveationProfileFB profile{XR_NULL_HANDLE};
+    XrResult result = m_createProfile(session, &profileInfo, &profile);
+    if (XR_FAILED(result)) {
+        Log::Write(Log::Level::Error, Fmt("foveation: xrCreateFoveationProfileFB failed: %s", to_string(result)));
+        return false;
+    }
+
+    XrSwapchainStateFoveationFB state{XR_TYPE_SWAPCHAIN_STATE_FOVEATION_FB};
+    state.profile = profile;
+    for (const Swapchain& swapchain : swapchains) {
+        result = m_updateSwapchain(swapchain.handle, reinterpret_cast<const XrSwapchainStateBaseHeaderFB*>(&state));
+        if (XR_FAILED(result)) {
+            Log::Write(Log::Level::Error, Fmt("foveation: xrUpdateSwapchainFB failed: %s", to_string(result)));
+            break;
+        }
+    }
+    // The swapchains keep the state, the profile is not needed after the update.
+    m_destroyProfile(profile);
+    return XR_SUCCEEDED(result);
+}
@@ -0,0 +1,42 @@
+/*
+    fixed foveated rendering on the projection swapchains, adb shell setprop debug.xr.foveation auto|off|low|medium|high.
+    with XR_FB_foveation, XR_FB_foveation_configuration and XR_FB_swapchain_update_state the runtime
+    shades and warps the periphery of each eye buffer at reduced resolution, which the lenses blur anyway.
+    "auto" starts at the device's level and raises it as the thermal state worsens; a fixed level ignores
+    the thermal state. without the extensions, or with "off", every call is a no-op.
+*/
+#pragma once
+
+#include <chrono>
+
+struct Swapchain;
+
+class Foveation {
+public:
+    // All of them, or foveation stays off.
+    static const std::vector<const char*>& Extensions();
+
+    // Level for setting ("auto", "low", ...) on a device whose nominal level is deviceLevel.
+    // thermalStatus is an AThermalStatus, or -1 when unknown.
+    static XrFoveationLevelFB ChooseLevel(const std::string& setting, XrFoveationLevelFB deviceLevel, int thermalStatus);
+
+    // extensionsEnabled: the instance was created with Extensions().
+    void Initialize(XrInstance instance, bool extensionsEnabled, const std::string& setting, XrFoveationLevelFB deviceLevel);
+    bool IsEnabled() const { return m_createProfile != nullptr; }
+
+    // Render thread, once per frame. Applies the level to swapchains the first time, then whenever the
+    // thermal state, polled at most once a second, changes it.
+    void Update(XrSession session, const std::vector<Swapchain>& swapchains);
+
+private:
+    bool Apply(XrSession session, const std::vector<Swapchain>& swapchains, XrFoveationLevelFB level);
+
+    PFN_xrCreateFoveationProfileFB m_createProfile{nullptr};
+    PFN_xrDestroyFoveationProfileFB m_destroyProfile{nullptr};
+    PFN_xrUpdateSwapchainFB m_updateSwapchain{nullptr};
+
+    std::string m_setting;
+    XrFoveationLevelFB m_deviceLevel{XR_FOVEATION_LEVEL_NONE_FB};
+    XrFoveationLevelFB m_applied{XR_FOVEATION_LEVEL_MAX_ENUM_FB};
+    std::chrono::steady_clock::time_point m_lastPoll;
+};
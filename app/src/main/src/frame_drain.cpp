@@ -0,0 +1,55 @@
+/*
+    stale-frame drain for the render thread.
+*/
+#include "pch.h"
+#include "common.h"
+#include "frame_drain.h"
+
+void FrameDrain::Reset(float fps) {
+    mPeriodUs = (int64_t)(1e6 / (fps > 0.0f ? fps : 72.0f));
+    mTransitMinUs[0] = mTransitMinUs[1] = INT64_MAX;
+    mWindowStart = Clock::now();
+    mLastWaitUs = 0;
+    mBacklog = 0;
+    mMaxBacklog = 0;
+    mDrained = 0;
+    mDrainedIdle = 0;
+}
+
+void FrameDrain::OnLatched(uint64_t serverTimestampUs) {
+    const int64_t nowUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch()).count();
+    const int64_t transitUs = nowUs - (int64_t)serverTimestampUs;
+    mTransitMinUs[0] = std::min(mTransitMinUs[0], transitUs);
+    const int64_t lateUs = transitUs - std::min(mTransitMinUs[0], mTransitMinUs[1]);
+    mLastWaitUs = lateUs;
+    // A frame one period late had the next one arrive behind it while it waited, and so on. Jitter that
+    // overshoots costs at most one latch wait, the drain stops at the first frame that is not ready.
+    mBacklog = (uint32_t)std::min<int64_t>(lateUs / mPeriodUs, kMaxBacklog);
+    mMaxBacklog = std::max(mMaxBacklog, mBacklog);
+}
+
+void FrameDrain::OnDrained(bool idle) {
+    if (idle) {
+        mDrainedIdle++;
+    } else {
+        mDrained++;
+        mBacklog = mBacklog > 0 ? mBacklog - 1 : 0;
+    }
+}
+
+bool FrameDrain::TakeWindow(uint32_t* queueDepth, uint32_t* drained, uint32_t* drainedIdle) {
+    const Clock::time_point now = Clock::now();
+    if (now - mWindowStart < std::chrono::seconds(1)) {
+        return false;
+    }
+    mWindowStart = now;
+    mTransitMinUs[1] = mTransitMinUs[0];
+    mTransitMinUs[0] = INT64_MAX;
+    *queueDepth = mMaxBacklog;
+    *drained = mDrained;
+    *drainedIdle = mDrainedIdle;
+    mMaxBacklog = 0;
+    mDrained = 0;
+    mDrainedIdle = 0;
+    return true;
+}
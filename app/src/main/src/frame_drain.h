@@ -0,0 +1,53 @@
+/*
+    stale-frame drain for the render thread, adb shell setprop debug.cxr.drain 0 to turn it off.
+    CloudXR hands out decoded frames oldest first and only one can be latched at a time. when the
+    client misses display frames, or latches nothing while tracking is lost or the session is not
+    visible, decoded frames back up in the receiver and every later frame shows older content.
+
+    FrameDrain estimates that backlog from how late each latched frame was: the difference between
+    local latch time and the server timestamp, above the smallest difference seen recently, in frame
+    periods. before the next latch the client latches and releases that many frames without blitting,
+    then latches the one it shows as before, so the shown frame is never given up for a frame that has
+    not arrived yet. when nothing is shown at all everything queued is drained.
+
+    published to Metrics once a second: cxr.queue_depth (largest backlog seen), cxr.drained (frames
+    skipped before a shown frame) and cxr.drained_idle (frames skipped while nothing was shown).
+*/
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+class FrameDrain {
+public:
+    // At most this many frames are skipped before one latch.
+    static const uint32_t kMaxBacklog = 8;
+
+    void Reset(float fps);
+
+    // Frames expected to be queued in front of the newest one.
+    uint32_t Backlog() const { return mBacklog; }
+    // How long the last latched frame had been queued, as far as the server timestamps tell.
+    float LastWaitMs() const { return mLastWaitUs / 1000.0f; }
+
+    // serverTimestampUs is the cxrVideoFrame::timeStamp of the first stream of a frame that is about to be shown.
+    void OnLatched(uint64_t serverTimestampUs);
+    void OnDrained(bool idle);
+
+    // True once a second, with the counts since the last time; the counts restart.
+    bool TakeWindow(uint32_t* queueDepth, uint32_t* drained, uint32_t* drainedIdle);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    int64_t mPeriodUs = 13889;
+    // Smallest local minus server time, over the current and the previous window, so clock drift and
+    // route changes age out.
+    int64_t mTransitMinUs[2] = {INT64_MAX, INT64_MAX};
+    Clock::time_point mWindowStart;
+    int64_t mLastWaitUs = 0;
+    uint32_t mBacklog = 0;
+    uint32_t mMaxBacklog = 0;
+    uint32_t mDrained = 0;
+    uint32_t mDrainedIdle = 0;
+};
@@ -0,0 +1,105 @@
+/*
+    optional pipelined frame loop.
+*/
+#include "pch.h"
+#include "common.h"
+#include "frame_pacer.h"
+#include "metrics.h"
+#include "hitch_monitor.h"
+
+void FramePacer::Start(XrSession session) {
+    Stop();
+    m_session = session;
+    m_ready.store(false, std::memory_order_release);
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&FramePacer::Run, this);
+    Log::Write(Log::Level::Info, "frame pacer: xrWaitFrame moved to the pacing thread");
+}
+
+void FramePacer::Stop() {
+    m_running.store(false, std::memory_order_release);
+    {
+        // Taken so a waiter cannot miss the notification between checking its predicate and sleeping.
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+    }
+    m_wake.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+bool FramePacer::Next(XrFrameState* frameState) {
+    if (!m_ready.load(std::memory_order_acquire)) {
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wake.wait(lock, [this]() { return m_ready.load(std::memory_order_acquire) || !m_running.load(std::memory_order_acquire); });
+    }
+    if (!m_ready.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    *frameState = m_state;
+    m_ready.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+    }
+    m_wake.notify_all();
+    return true;
+}
+
+void FramePacer::Run() {
+    HitchMonitor::RegisterThread("frame pacer");
+    XrCallBudget::SetPhase(XrCallPhase::Wait);
+    while (m_running.load(std::memory_order_acquire)) {
+        XrFrameWaitInfo frameWaitInfo{XR_TYPE_FRAME_WAIT_INFO};
+        XrFrameState frameState{XR_TYPE_FRAME_STATE};
+        // Not CHECK_XRCMD: a throw here would terminate.
+        const XrResult result = XR_CALL(xrWaitFrame(m_session, &frameWaitInfo, &frameState));
+        if (XR_FAILED(result)) {
+            Log::Write(Log::Level::Error, Fmt("frame pacer: xrWaitFrame failed: %s", to_string(result)));
+            break;
+        }
+
+        m_state = frameState;
+        m_ready.store(true, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+        }
+        m_wake.notify_all();
+
+        // The next xrWaitFrame would block until this frame is begun anyway; waiting for the render thread
+        // to take it first means Stop() never leaves this thread stuck in the runtime.
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wake.wait(lock, [this]() { return !m_ready.load(std::memory_order_acquire) || !m_running.load(std::memory_order_acquire); });
+    }
+
+    m_running.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+    }
+    m_wake.notify_all();
+}
+
+void FrameTiming::Record(Clock::time_point waitStart, Clock::time_point workStart, Clock::time_point end, XrDuration displayPeriod) {
+    if (m_frames == 0 && m_windowStart == Clock::time_point{}) {
+        m_windowStart = waitStart;
+    }
+    m_frames++;
+    m_wait += workStart - waitStart;
+    m_work += end - workStart;
+    m_maxWork = std::max(m_maxWork, end - workStart);
+    m_displayPeriod = displayPeriod;
+
+    if (end - m_windowStart < std::chrono::seconds(1)) {
+        return;
+    }
+    auto ms = [](Clock::duration duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+    const double frames = (double)m_frames;
+    Metrics::Set("frame.fps", frames / std::chrono::duration<double>(end - m_windowStart).count());
+    Metrics::Set("frame.period_ms", m_displayPeriod / 1e6);
+    Metrics::Set("frame.wait_ms", ms(m_wait) / frames);
+    Metrics::Set("frame.work_ms", ms(m_work) / frames);
+    Metrics::Set("frame.work_max_ms", ms(m_maxWork));
+    m_windowStart = end;
+    m_frames = 0;
+    m_wait = m_work = m_maxWork = Clock::duration{};
+}
@@ -0,0 +1,61 @@
+/*
+    optional pipelined frame loop, adb shell setprop debug.xr.pipelined 1.
+    a pacing thread calls xrWaitFrame and hands the XrFrameState to the render thread through a single
+    slot, then immediately waits for the next frame while the render thread is still rendering and
+    submitting the current one. OpenXR allows xrWaitFrame on a different thread than begin/end, and
+    blocks it until the previous frame has been begun, so the pacing thread is never more than one
+    frame ahead.
+
+    FrameTiming measures the render thread either way: time blocked waiting for a frame state, time
+    from then until xrEndFrame returned, and the display period, published to Metrics under "frame.".
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+class FramePacer {
+public:
+    ~FramePacer() { Stop(); }
+
+    void Start(XrSession session);
+    // Render thread, between frames: the pacing thread finishes its pending xrWaitFrame and exits.
+    void Stop();
+    bool IsRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    // Render thread: blocks until the pacing thread has waited the next frame. False once the pacer
+    // stopped, e.g. because xrWaitFrame failed.
+    bool Next(XrFrameState* frameState);
+
+private:
+    void Run();
+
+    XrSession m_session{XR_NULL_HANDLE};
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+
+    // The slot: written by the pacing thread only while m_ready is false, read by the render thread only
+    // while it is true. The mutex and condition variable are only there to sleep, never held while copying.
+    XrFrameState m_state{XR_TYPE_FRAME_STATE};
+    std::atomic<bool> m_ready{false};
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+};
+
+class FrameTiming {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void Record(Clock::time_point waitStart, Clock::time_point workStart, Clock::time_point end, XrDuration displayPeriod);
+
+private:
+    Clock::time_point m_windowStart;
+    uint64_t m_frames{0};
+    Clock::duration m_wait{};
+    Clock::duration m_work{};
+    Clock::duration m_maxWork{};
+    XrDuration m_displayPeriod{0};
+};
@@ -0,0 +1,161 @@
+/*
+    compact binary trace of the per-frame receiver behavior.
+*/
+#include "frametrace.h"
+#include <chrono>
+#include "logger.h"
+
+namespace {
+
+uint64_t SteadyNowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+FrameTraceWriter::~FrameTraceWriter() {
+    Close();
+}
+
+bool FrameTraceWriter::Open(const std::string& path) {
+    Close();
+    std::lock_guard<std::mutex> fileLock(mFileMutex);
+    mFile = fopen(path.c_str(), "wb");
+    if (mFile == nullptr) {
+        return false;
+    }
+    FrameTraceHeader header;
+    header.magic = FRAME_TRACE_MAGIC;
+    header.version = FRAME_TRACE_VERSION;
+    header.startEpochUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    fwrite(&header, sizeof(header), 1, mFile);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPending.clear();
+    mPending.reserve(kCapacity);
+    mWriting.reserve(kCapacity);
+    mDropped = 0;
+    mStartUs = SteadyNowUs();
+    mRecording = true;
+    return true;
+}
+
+void FrameTraceWriter::Close() {
+    std::lock_guard<std::mutex> fileLock(mFileMutex);
+    if (mFile == nullptr) {
+        return;
+    }
+    mRecording = false;
+    WritePending();
+    fclose(mFile);
+    mFile = nullptr;
+}
+
+uint64_t FrameTraceWriter::NowUs() const {
+    return SteadyNowUs() - mStartUs;
+}
+
+void FrameTraceWriter::Append(const FrameTraceRecord& record) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mPending.size() < kCapacity) {
+        mPending.push_back(record);
+    } else {
+        mDropped++;
+    }
+}
+
+void FrameTraceWriter::RecordLatch(int32_t result, uint32_t waitUs, uint64_t poseID, uint64_t frameTimeStamp) {
+    if (!mRecording) {
+        return;
+    }
+    FrameTraceRecord record = {};
+    record.type = FrameTraceRecord_Latch;
+    record.result = result;
+    record.timeUs = NowUs();
+    record.latch.poseID = poseID;
+    record.latch.frameTimeStamp = frameTimeStamp;
+    record.latch.waitUs = waitUs;
+    Append(record);
+}
+
+void FrameTraceWriter::RecordStats(float fps, float deliveryTime, float queueTime, float latchTime, uint32_t bandwidthKbps, uint32_t rttMs, uint32_t jitterUs,
+                                   uint32_t packetsLost) {
+    if (!mRecording) {
+        return;
+    }
+    FrameTraceRecord record = {};
+    record.type = FrameTraceRecord_Stats;
+    record.timeUs = NowUs();
+    record.stats.framesPerSecond = fps;
+    record.stats.frameDeliveryTime = deliveryTime;
+    record.stats.frameQueueTime = queueTime;
+    record.stats.frameLatchTime = latchTime;
+    record.stats.bandwidthAvailableKbps = bandwidthKbps;
+    record.stats.roundTripDelayMs = rttMs;
+    record.stats.jitterUs = jitterUs;
+    record.stats.totalPacketsLost = packetsLost;
+    Append(record);
+}
+
+void FrameTraceWriter::Flush() {
+    std::lock_guard<std::mutex> fileLock(mFileMutex);
+    if (mFile == nullptr) {
+        return;
+    }
+    WritePending();
+}
+
+void FrameTraceWriter::WritePending() {
+    uint64_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mWriting.swap(mPending);
+        mPending.clear();
+        dropped = mDropped;
+        mDropped = 0;
+    }
+    if (!mWriting.empty()) {
+        fwrite(mWriting.data(), sizeof(FrameTraceRecord), mWriting.size(), mFile);
+        fflush(mFile);
+        mWriting.clear();
+    }
+    if (dropped > 0) {
+        Log::Write(Log::Level::Warning, "frametrace: buffer full, dropped " + std::to_string(dropped) + " records");
+    }
+}
+
+bool FrameTraceLoad(const std::string& path, FrameTraceHeader* header, std::vector<FrameTraceRecord>* records, std::string* error) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        if (error) {
+            *error = "cannot open " + path;
+        }
+        return false;
+    }
+    FrameTraceHeader fileHeader = {};
+    if (fread(&fileHeader, sizeof(fileHeader), 1, file) != 1 || fileHeader.magic != FRAME_TRACE_MAGIC) {
+        if (error) {
+            *error = path + " is not a frame trace";
+        }
+        fclose(file);
+        return false;
+    }
+    if (fileHeader.version != FRAME_TRACE_VERSION) {
+        if (error) {
+            *error = "unsupported frame trace version " + std::to_string(fileHeader.version);
+        }
+        fclose(file);
+        return false;
+    }
+
+    records->clear();
+    FrameTraceRecord record;
+    while (fread(&record, sizeof(record), 1, file) == 1) {
+        records->push_back(record);
+    }
+    fclose(file);
+    if (header) {
+        *header = fileHeader;
+    }
+    return true;
+}
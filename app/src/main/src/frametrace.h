@@ -0,0 +1,92 @@
+/*
+    compact binary trace of the per-frame receiver behavior (latch result, latch wait, poseID,
+    frame timestamps and the per-second connection stats). written by the client, replayed by
+    the cloudxr receiver stand-in so client-side changes can be compared under identical conditions.
+*/
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define FRAME_TRACE_MAGIC 0x54465843  // "CXFT"
+#define FRAME_TRACE_VERSION 1
+
+enum FrameTraceRecordType : uint8_t {
+    FrameTraceRecord_Latch = 1,
+    FrameTraceRecord_Stats = 2,
+};
+
+struct FrameTraceHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t startEpochUs;  // wall clock at trace start, for matching with logcat
+};
+
+// Fixed size so the file can be read back with a single fread and indexed directly.
+struct FrameTraceRecord {
+    uint8_t type;
+    uint8_t reserved[3];
+    int32_t result;   // cxrError of the latch, 0 for stats records
+    uint64_t timeUs;  // steady clock, relative to trace start
+    union {
+        struct {
+            uint64_t poseID;
+            uint64_t frameTimeStamp;  // server side capture time of the latched frame, cxrVideoFrame::timeStamp of the first stream
+            uint32_t waitUs;          // time spent inside cxrLatchFrame
+        } latch;
+        struct {
+            float framesPerSecond;
+            float frameDeliveryTime;
+            float frameQueueTime;
+            float frameLatchTime;
+            uint32_t bandwidthAvailableKbps;
+            uint32_t roundTripDelayMs;
+            uint32_t jitterUs;
+            uint32_t totalPacketsLost;
+        } stats;
+    };
+};
+static_assert(sizeof(FrameTraceRecord) == 48, "trace record layout changed, bump FRAME_TRACE_VERSION");
+
+// Recording is meant to stay enabled in the field: Record* only appends to a preallocated
+// buffer under a short lock, and the file write happens in Flush() on a non-render thread.
+class FrameTraceWriter {
+public:
+    static constexpr size_t kCapacity = 4096;
+
+    ~FrameTraceWriter();
+
+    bool Open(const std::string& path);
+
+    void Close();
+
+    bool IsOpen() const { return mRecording; }
+
+    void RecordLatch(int32_t result, uint32_t waitUs, uint64_t poseID, uint64_t frameTimeStamp);
+
+    void RecordStats(float fps, float deliveryTime, float queueTime, float latchTime, uint32_t bandwidthKbps, uint32_t rttMs, uint32_t jitterUs, uint32_t packetsLost);
+
+    void Flush();
+
+    uint64_t NowUs() const;
+
+private:
+    void Append(const FrameTraceRecord& record);
+
+    void WritePending();
+
+    std::mutex mFileMutex;  // Open/Close can race with the periodic Flush
+    FILE* mFile = nullptr;
+    std::atomic<bool> mRecording{false};
+    uint64_t mStartUs = 0;
+    std::mutex mMutex;
+    std::vector<FrameTraceRecord> mPending;
+    std::vector<FrameTraceRecord> mWriting;
+    uint64_t mDropped = 0;
+};
+
+bool FrameTraceLoad(const std::string& path, FrameTraceHeader* header, std::vector<FrameTraceRecord>* records, std::string* error);
@@ -0,0 +1,194 @@
+/*
+    on-disk cache of linked GL programs.
+*/
+#include "pch.h"
+#include "common.h"
+#include "gl_program_cache.h"
+#include "metrics.h"
+
+#if defined(XR_USE_GRAPHICS_API_OPENGL) || defined(XR_USE_GRAPHICS_API_OPENGL_ES)
+
+#include "common/gfxwrapper_opengl.h"
+
+#include <chrono>
+#include <fstream>
+
+namespace {
+
+const uint32_t kCacheMagic = 0x42505843;  // 'CXPB'
+const uint32_t kCacheVersion = 1;
+
+struct CacheFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t format;
+    uint32_t length;
+};
+
+std::string g_directory;
+
+// FNV-1a, the terminating zero of every string is hashed too so "ab"+"c" and "a"+"bc" differ.
+uint64_t Hash(uint64_t hash, const char* text) {
+    do {
+        hash ^= (uint8_t)*text;
+        hash *= 1099511628211ull;
+    } while (*text++ != '\0');
+    return hash;
+}
+
+const char* GlString(GLenum name) {
+    const GLubyte* value = glGetString(name);
+    return value != nullptr ? reinterpret_cast<const char*>(value) : "";
+}
+
+std::string CachePath(const char* vertexSource, const char* fragmentSource) {
+    if (g_directory.empty()) {
+        return {};
+    }
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats == 0) {
+        return {};
+    }
+
+    uint64_t key = 14695981039346656037ull;
+    key = Hash(key, vertexSource);
+    key = Hash(key, fragmentSource);
+    key = Hash(key, GlString(GL_VENDOR));
+    key = Hash(key, GlString(GL_RENDERER));
+    key = Hash(key, GlString(GL_VERSION));
+    return Fmt("%s/program_%016llx.bin", g_directory.c_str(), (unsigned long long)key);
+}
+
+GLuint CompileShader(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint r = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &r);
+    if (r == GL_FALSE) {
+        GLchar msg[4096] = {};
+        GLsizei length;
+        glGetShaderInfoLog(shader, sizeof(msg), &length, msg);
+        glDeleteShader(shader);
+        THROW(Fmt("Compile shader failed: %s", msg));
+    }
+    return shader;
+}
+
+bool LoadBinary(GLuint program, const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    const std::streamoff fileSize = file.tellg();
+    file.seekg(0);
+    CacheFileHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != kCacheMagic || header.version != kCacheVersion) {
+        return false;
+    }
+    // The length is only trusted when it accounts for exactly the rest of the file.
+    if (header.length == 0 || (std::streamoff)header.length != fileSize - (std::streamoff)sizeof(header)) {
+        Log::Write(Log::Level::Warning, Fmt("program cache: %s is truncated or corrupt", path.c_str()));
+        return false;
+    }
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), binary.size())) {
+        return false;
+    }
+
+    glProgramBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+    GLint r = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &r);
+    return r != GL_FALSE;
+}
+
+void StoreBinary(GLuint program, const std::string& path) {
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+    CacheFileHeader header{kCacheMagic, kCacheVersion, 0, 0};
+    std::vector<char> binary(length);
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &header.format, binary.data());
+    header.length = (uint32_t)written;
+
+    // Written next to the final name and renamed, so a crash mid-write never leaves a truncated entry.
+    const std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), written);
+        if (!file) {
+            Log::Write(Log::Level::Warning, Fmt("program cache: unable to write %s", temporaryPath.c_str()));
+            return;
+        }
+    }
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        std::remove(temporaryPath.c_str());
+    }
+}
+
+}  // namespace
+
+namespace GlProgramCache {
+void SetDirectory(const std::string& directory) {
+    g_directory = directory;
+    Log::Write(Log::Level::Info, directory.empty() ? std::string("program cache disabled") : Fmt("program cache in %s", directory.c_str()));
+}
+
+unsigned int Build(const char* vertexSource, const char* fragmentSource, const std::function<void(unsigned int)>& bindLocations) {
+    const auto start = std::chrono::steady_clock::now();
+    const std::string path = CachePath(vertexSource, fragmentSource);
+
+    GLuint program = glCreateProgram();
+    const bool hit = !path.empty() && LoadBinary(program, path);
+    if (!hit) {
+        if (!path.empty() && std::remove(path.c_str()) == 0) {
+            // The entry existed but was unusable or the driver rejected it, start over with a fresh program object.
+            Log::Write(Log::Level::Info, Fmt("program cache: dropped %s, recompiling", path.c_str()));
+            glDeleteProgram(program);
+            program = glCreateProgram();
+        }
+
+        GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource);
+        GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
+        glAttachShader(program, vertexShader);
+        glAttachShader(program, fragmentShader);
+        if (bindLocations) {
+            bindLocations(program);
+        }
+        if (!path.empty()) {
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+        glLinkProgram(program);
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+
+        GLint r = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &r);
+        if (r == GL_FALSE) {
+            GLchar msg[4096] = {};
+            GLsizei length;
+            glGetProgramInfoLog(program, sizeof(msg), &length, msg);
+            glDeleteProgram(program);
+            THROW(Fmt("Link program failed: %s", msg));
+        }
+
+        if (!path.empty()) {
+            StoreBinary(program, path);
+        }
+    }
+
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    Metrics::Add(hit ? "startup.program_cache_hits" : "startup.program_cache_misses", 1);
+    Metrics::Add("startup.program_build_ms", ms);
+    Log::Write(Log::Level::Info, Fmt("program %s in %.2f ms", hit ? "loaded from cache" : "compiled", ms));
+    return program;
+}
+}  // namespace GlProgramCache
+
+#endif
@@ -0,0 +1,27 @@
+/*
+    on-disk cache of linked GL programs.
+    a program is stored as the glGetProgramBinary blob, keyed by a hash of its shader sources and the
+    GL vendor/renderer/version strings, so a driver update or a different GPU never sees a stale blob.
+    on later launches the blob is handed to glProgramBinary; if the driver rejects it (format mismatch,
+    driver update with the same version string) the entry is dropped and the program is compiled again.
+
+    the cache is off until a directory is set, on android main.cpp points it at the app's internal
+    data path. adb shell setprop debug.xr.programCache off disables it; a cold start is the first
+    launch after removing the program_*.bin files. compare the "first frame" log line of both runs.
+    the OpenGL plugin builds its cube program through here. the GLES plugin, the android path, builds no
+    programs of its own: CloudXR blits the stream into the swapchain and compiles its shaders internally.
+*/
+#pragma once
+
+#include <functional>
+#include <string>
+
+namespace GlProgramCache {
+// Empty disables the cache, every program is then compiled and linked from source.
+void SetDirectory(const std::string& directory);
+
+// Builds a linked vertex + fragment program, from the cache when possible. Throws on compile or link
+// errors. bindLocations is called on the unlinked program, e.g. for glBindAttribLocation; anything it
+// does must be derived from the sources since it is not part of the key.
+unsigned int Build(const char* vertexSource, const char* fragmentSource, const std::function<void(unsigned int)>& bindLocations = nullptr);
+}  // namespace GlProgramCache
@@ -26,9 +26,10 @@ struct IGraphicsPlugin {
     virtual const XrBaseInStructure* GetGraphicsBinding() const = 0;
 
     // Allocate space for the swapchain image structures. These are different for each graphics API. The returned
-    // pointers are valid for the lifetime of the graphics plugin.
+    // pointers are valid for the lifetime of the graphics plugin. depth is false for swapchains that are never
+    // rendered with depth testing, see swapchain_policy.h. the Vulkan plugin allocates its depth buffer regardless.
     virtual std::vector<XrSwapchainImageBaseHeader*> AllocateSwapchainImageStructs(
-        uint32_t capacity, const XrSwapchainCreateInfo& swapchainCreateInfo) = 0;
+        uint32_t capacity, const XrSwapchainCreateInfo& swapchainCreateInfo, bool depth) = 0;
 
     // Render to a swapchain image for a projection view.
     virtual void RenderView(const XrCompositionLayerProjectionView& layerView, const XrSwapchainImageBaseHeader* swapchainImage,
@@ -6,6 +6,8 @@
 #include "common.h"
 #include "geometry.h"
 #include "graphicsplugin.h"
+#include "gl_program_cache.h"
+#include "memory_monitor.h"
 
 #ifdef XR_USE_GRAPHICS_API_OPENGL
 
@@ -70,6 +72,7 @@ struct OpenGLGraphicsPlugin : public IGraphicsPlugin {
         for (auto& colorToDepth : m_colorToDepthMap) {
             if (colorToDepth.second != 0) {
                 glDeleteTextures(1, &colorToDepth.second);
+                GpuMemory::Add(GpuMemory::Category::Depth, -m_depthBytes[colorToDepth.second], -1);
             }
         }
     }
@@ -152,24 +155,7 @@ struct OpenGLGraphicsPlugin : public IGraphicsPlugin {
     void InitializeResources() {
         glGenFramebuffers(1, &m_swapchainFramebuffer);
 
-        GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertexShader, 1, &VertexShaderGlsl, nullptr);
-        glCompileShader(vertexShader);
-        CheckShader(vertexShader);
-
-        GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragmentShader, 1, &FragmentShaderGlsl, nullptr);
-        glCompileShader(fragmentShader);
-        CheckShader(fragmentShader);
-
-        m_program = glCreateProgram();
-        glAttachShader(m_program, vertexShader);
-        glAttachShader(m_program, fragmentShader);
-        glLinkProgram(m_program);
-        CheckProgram(m_program);
-
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
+        m_program = GlProgramCache::Build(VertexShaderGlsl, FragmentShaderGlsl);
 
         m_modelViewProjectionUniformLocation = glGetUniformLocation(m_program, "ModelViewProjection");
 
@@ -195,28 +181,6 @@ struct OpenGLGraphicsPlugin : public IGraphicsPlugin {
                               reinterpret_cast<const void*>(sizeof(XrVector3f)));
     }
 
-    void CheckShader(GLuint shader) {
-        GLint r = 0;
-        glGetShaderiv(shader, GL_COMPILE_STATUS, &r);
-        if (r == GL_FALSE) {
-            GLchar msg[4096] = {};
-            GLsizei length;
-            glGetShaderInfoLog(shader, sizeof(msg), &length, msg);
-            THROW(Fmt("Compile shader failed: %s", msg));
-        }
-    }
-
-    void CheckProgram(GLuint prog) {
-        GLint r = 0;
-        glGetProgramiv(prog, GL_LINK_STATUS, &r);
-        if (r == GL_FALSE) {
-            GLchar msg[4096] = {};
-            GLsizei length;
-            glGetProgramInfoLog(prog, sizeof(msg), &length, msg);
-            THROW(Fmt("Link program failed: %s", msg));
-        }
-    }
-
     int64_t SelectColorSwapchainFormat(const std::vector<int64_t>& runtimeFormats) const override {
         // List of supported color swapchain formats.
         constexpr int64_t SupportedColorSwapchainFormats[] = {
@@ -243,7 +207,7 @@ struct OpenGLGraphicsPlugin : public IGraphicsPlugin {
     }
 
     std::vector<XrSwapchainImageBaseHeader*> AllocateSwapchainImageStructs(
-        uint32_t capacity, const XrSwapchainCreateInfo& /*swapchainCreateInfo*/) override {
+        uint32_t capacity, const XrSwapchainCreateInfo& /*swapchainCreateInfo*/, bool /*depth*/) override {
         // Allocate and initialize the buffer of image structs (must be sequential in memory for xrEnumerateSwapchainImages).
         // Return back an array of pointers to each swapchain image struct so the consumer doesn't need to know the type/size.
         std::vector<XrSwapchainImageOpenGLKHR> swapchainImageBuffer(capacity);
@@ -284,6 +248,8 @@ struct OpenGLGraphicsPlugin : public IGraphicsPlugin {
         glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
 
         m_colorToDepthMap.insert(std::make_pair(colorTexture, depthTexture));
+        m_depthBytes[depthTexture] = (int64_t)width * height * 4;
+        GpuMemory::Add(GpuMemory::Category::Depth, m_depthBytes[depthTexture]);
 
         return depthTexture;
     }
@@ -381,6 +347,8 @@ struct OpenGLGraphicsPlugin : public IGraphicsPlugin {
 
     // Map color buffer to associated depth buffer. This map is populated on demand.
     std::map<uint32_t, uint32_t> m_colorToDepthMap;
+    // Depth texture to its size, for the memory monitor.
+    std::map<uint32_t, int64_t> m_depthBytes;
 };
 }  // namespace
 
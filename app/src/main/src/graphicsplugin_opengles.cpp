@@ -6,10 +6,12 @@
 #include "common.h"
 #include "geometry.h"
 #include "graphicsplugin.h"
+#include "metrics.h"
 
 #ifdef XR_USE_GRAPHICS_API_OPENGL_ES
 
 #include "common/gfxwrapper_opengl.h"
+#include "egl_context.h"
 #include <common/xr_linear.h>
 
 namespace {
@@ -20,12 +22,10 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
     OpenGLESGraphicsPlugin& operator=(const OpenGLESGraphicsPlugin&) = delete;
     OpenGLESGraphicsPlugin(OpenGLESGraphicsPlugin&&) = delete;
     OpenGLESGraphicsPlugin& operator=(OpenGLESGraphicsPlugin&&) = delete;
-    ~OpenGLESGraphicsPlugin() override {}
+    ~OpenGLESGraphicsPlugin() override { m_context.Destroy(); }
 
     std::vector<std::string> GetInstanceExtensions() const override { return {XR_KHR_OPENGL_ES_ENABLE_EXTENSION_NAME}; }
 
-    ksGpuWindow window{};
-
     void DebugMessageCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message) {
         (void)source;
         (void)type;
@@ -43,15 +43,15 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
         XrGraphicsRequirementsOpenGLESKHR graphicsRequirements{XR_TYPE_GRAPHICS_REQUIREMENTS_OPENGL_ES_KHR};
         CHECK_XRCMD(pfnGetOpenGLESGraphicsRequirementsKHR(instance, systemId, &graphicsRequirements));
 
-        // Initialize the gl extensions. Note we have to open a window.
-        ksDriverInstance driverInstance{};
-        ksGpuQueueInfo queueInfo{};
-        ksGpuSurfaceColorFormat colorFormat{KS_GPU_SURFACE_COLOR_FORMAT_B8G8R8A8};
-        ksGpuSurfaceDepthFormat depthFormat{KS_GPU_SURFACE_DEPTH_FORMAT_D24};
-        ksGpuSampleCount sampleCount{KS_GPU_SAMPLE_COUNT_1};
-        if (!ksGpuWindow_Create(&window, &driverInstance, &queueInfo, 0, colorFormat, depthFormat, sampleCount, 640, 480, false)) {
+        // Nothing is ever presented from this context, so it gets neither a window surface nor a depth buffer.
+        if (!m_context.Create() || !m_context.MakeCurrent()) {
             THROW("Unable to create GL context");
         }
+        // ndk-build GL_EAGER=1 for the cost of looking up every GL entry point here, see gfxwrapper_opengl.h.
+        const auto extensionsStart = std::chrono::steady_clock::now();
+        GlInitExtensions();
+        Metrics::Set("startup.gl_extensions_us",
+                     std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - extensionsStart).count());
 
         GLint major = 0;
         GLint minor = 0;
@@ -64,9 +64,9 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
         }
 
 #if defined(XR_USE_PLATFORM_ANDROID)
-        m_graphicsBinding.display = window.display;
+        m_graphicsBinding.display = m_context.display;
         m_graphicsBinding.config = (EGLConfig)0;
-        m_graphicsBinding.context = window.context.context;
+        m_graphicsBinding.context = m_context.context;
 #endif
 
         glEnable(GL_DEBUG_OUTPUT);
@@ -102,7 +102,7 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
     }
 
     std::vector<XrSwapchainImageBaseHeader*> AllocateSwapchainImageStructs(
-        uint32_t capacity, const XrSwapchainCreateInfo& /*swapchainCreateInfo*/) override {
+        uint32_t capacity, const XrSwapchainCreateInfo& /*swapchainCreateInfo*/, bool /*depth*/) override {
         // Allocate and initialize the buffer of image structs (must be sequential in memory for xrEnumerateSwapchainImages).
         // Return back an array of pointers to each swapchain image struct so the consumer doesn't need to know the type/size.
         std::vector<XrSwapchainImageOpenGLESKHR> swapchainImageBuffer(capacity);
@@ -121,6 +121,8 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
     }
 
    private:
+    EglContext m_context;
+
 #ifdef XR_USE_PLATFORM_ANDROID
     XrGraphicsBindingOpenGLESAndroidKHR m_graphicsBinding{XR_TYPE_GRAPHICS_BINDING_OPENGL_ES_ANDROID_KHR};
 #endif
@@ -0,0 +1,571 @@
+/*
+    hitch snapshots with stack sampling.
+*/
+#include "pch.h"
+#include "common.h"
+#include "hitch_monitor.h"
+#include "metrics.h"
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <cerrno>
+#include <fstream>
+
+namespace {
+
+const int kMaxThreads = 8;
+const uint32_t kMaxDepth = 24;
+// How much of a blocked thread's stack above sp is searched for frame records.
+const size_t kScanBytes = 16384;
+const size_t kScanChunk = 4096;
+constexpr auto kSampleInterval = std::chrono::milliseconds(2);
+// A thread stuck for longer is left alone until the next frame.
+const int64_t kMaxSamplingNs = 1000000000;
+// The whole sampling window, so the start of a long hitch is still there when the snapshot is written.
+const uint32_t kSamplesPerThread = 512;
+static_assert(kSamplesPerThread * std::chrono::nanoseconds(kSampleInterval).count() >= kMaxSamplingNs, "sample ring shorter than the sampling window");
+const uint32_t kMissStreak = 8;
+const auto kSnapshotSpacing = std::chrono::seconds(10);
+const auto kHistory = std::chrono::seconds(3);
+const size_t kFrameRing = 512;
+const size_t kMetricsRing = 4;
+
+// StackSample::syscall of a thread that was running: sampled by the signal handler, or not at all (depth 0).
+const int32_t kRunning = -2;
+
+struct StackSample {
+    int64_t timeNs;
+    uint32_t depth;
+    // The system call a blocked thread was in, -1 if blocked outside one, or kRunning.
+    int32_t syscall;
+    uintptr_t pcs[kMaxDepth];
+};
+
+struct ThreadSlot {
+    std::atomic<int> tid{0};
+    char name[24];
+    bool signal;
+    uintptr_t stackLo;
+    uintptr_t stackHi;
+    // Set by the watchdog before it signals the thread, cleared by the handler: while set the handler may
+    // write, otherwise only the watchdog does.
+    std::atomic<bool> signalPending{false};
+    // Samples written so far. The one writer writes the sample first, then the release store; a reader
+    // keeps what was not overwritten while it copied.
+    std::atomic<uint32_t> next{0};
+    StackSample samples[kSamplesPerThread];
+};
+
+ThreadSlot g_threads[kMaxThreads];
+std::mutex g_registerMutex;
+
+// Frees the slot of a registered thread when it exits, so a later thread with the same tid is not sampled under
+// the old name and the slot can be taken again.
+struct Registration {
+    ThreadSlot* slot = nullptr;
+    ~Registration();
+};
+thread_local Registration t_registration;
+
+int64_t MonotonicNs() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+int64_t ToNs(HitchMonitor::Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+int CurrentTid() { return (int)syscall(SYS_gettid); }
+
+Registration::~Registration() {
+    std::lock_guard<std::mutex> lock(g_registerMutex);
+    if (slot != nullptr && slot->tid.load(std::memory_order_relaxed) == CurrentTid()) {
+        slot->tid.store(0, std::memory_order_release);
+    }
+}
+
+uintptr_t StripPointer(uintptr_t address) {
+#if defined(__aarch64__)
+    return address & 0x0000ffffffffffffull;  // pointer authentication and tag bits
+#else
+    return address;
+#endif
+}
+
+// Async-signal-safe: reads registers from the signal context and frame records inside [lo, hi) only.
+uint32_t Unwind(const void* context, uintptr_t lo, uintptr_t hi, uintptr_t* pcs) {
+    const ucontext_t* uc = (const ucontext_t*)context;
+    uintptr_t pc = 0;
+    uintptr_t fp = 0;
+#if defined(__aarch64__)
+    pc = uc->uc_mcontext.pc;
+    fp = uc->uc_mcontext.regs[29];
+#elif defined(__x86_64__)
+    pc = uc->uc_mcontext.gregs[REG_RIP];
+    fp = uc->uc_mcontext.gregs[REG_RBP];
+#elif defined(__arm__)
+    pc = uc->uc_mcontext.arm_pc;
+#elif defined(__i386__)
+    pc = uc->uc_mcontext.gregs[REG_EIP];
+#endif
+    uint32_t depth = 0;
+    pcs[depth++] = pc;
+#if defined(__aarch64__)
+    // A leaf has no frame record of its own, its caller is only in the link register.
+    const uintptr_t lr = uc->uc_mcontext.regs[30] & 0x0000ffffffffffffull;
+    const bool fpValid = fp >= lo && fp + 2 * sizeof(uintptr_t) <= hi;
+    if (lr != 0 && (!fpValid || (((const uintptr_t*)fp)[1] & 0x0000ffffffffffffull) != lr)) {
+        pcs[depth++] = lr;
+    }
+#endif
+#if defined(__aarch64__) || defined(__x86_64__)
+    while (depth < kMaxDepth && fp >= lo && fp + 2 * sizeof(uintptr_t) <= hi && fp % sizeof(uintptr_t) == 0) {
+        const uintptr_t* record = (const uintptr_t*)fp;
+        const uintptr_t ret = StripPointer(record[1]);
+        if (ret == 0) {
+            break;
+        }
+        pcs[depth++] = ret;
+        if (record[0] <= fp) {
+            break;
+        }
+        fp = record[0];
+    }
+#else
+    (void)lo;
+    (void)hi;
+    (void)fp;
+#endif
+    return depth;
+}
+
+void OnSampleSignal(int, siginfo_t*, void* context) {
+    const int savedErrno = errno;
+    const int tid = CurrentTid();
+    for (ThreadSlot& slot : g_threads) {
+        if (slot.tid.load(std::memory_order_acquire) == tid) {
+            // SIGPROF is blocked while this runs, so nothing else writes this slot.
+            const uint32_t next = slot.next.load(std::memory_order_relaxed);
+            StackSample& sample = slot.samples[next % kSamplesPerThread];
+            sample.depth = Unwind(context, slot.stackLo, slot.stackHi, sample.pcs);
+            sample.syscall = kRunning;
+            sample.timeNs = MonotonicNs();
+            slot.next.store(next + 1, std::memory_order_release);
+            slot.signalPending.store(false, std::memory_order_release);
+            break;
+        }
+    }
+    errno = savedErrno;
+}
+
+// Whether /proc shows the thread blocked in the kernel, and where: "running", or the system call number, its
+// arguments, sp and pc ("-1 <sp> <pc>" outside a system call).
+bool ReadBlocked(int tid, int32_t* syscallNumber, uintptr_t* sp, uintptr_t* pc) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/self/task/%d/syscall", tid);
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    char text[256];
+    const ssize_t size = read(fd, text, sizeof(text) - 1);
+    close(fd);
+    if (size <= 0 || strncmp(text, "running", 7) == 0) {
+        return false;
+    }
+    text[size] = '\0';
+    long long values[9];
+    int count = 0;
+    for (char* at = text; count < 9;) {
+        char* end = nullptr;
+        const long long value = strtoll(at, &end, 0);
+        if (end == at) {
+            break;
+        }
+        values[count++] = value;
+        at = end;
+    }
+    if (count < 3) {
+        return false;
+    }
+    *syscallNumber = (int32_t)values[0];
+    *sp = (uintptr_t)values[count - 2];
+    *pc = (uintptr_t)values[count - 1];
+    return true;
+}
+
+// A blocked thread's stack from outside: pc, then the chain from the innermost frame record found above sp, a
+// saved frame pointer further up next to a return address into a loaded module. The caller of a function that
+// keeps no frame record, e.g. a libc system call wrapper, is missing. The stack is copied with process_vm_readv,
+// which fails instead of faulting where it is unmapped, e.g. by a thread that just exited.
+uint32_t UnwindBlocked(uintptr_t sp, uintptr_t pc, uintptr_t hi, std::vector<uintptr_t>* stack, uintptr_t* pcs) {
+    uint32_t depth = 0;
+    pcs[depth++] = StripPointer(pc);
+#if defined(__aarch64__) || defined(__x86_64__)
+    const uintptr_t end = hi > sp ? std::min<uintptr_t>(hi, sp + kScanBytes) : sp + kScanBytes;
+    stack->resize(kScanBytes / sizeof(uintptr_t));
+    iovec local{stack->data(), (size_t)(end - sp)};
+    // One remote chunk each, so the copy stops at the first one that is not mapped rather than failing whole.
+    iovec remote[kScanBytes / kScanChunk + 1];
+    unsigned long chunks = 0;
+    for (uintptr_t at = sp; at < end;) {
+        const uintptr_t chunkEnd = std::min<uintptr_t>((at & ~(uintptr_t)(kScanChunk - 1)) + kScanChunk, end);
+        remote[chunks++] = {(void*)at, (size_t)(chunkEnd - at)};
+        at = chunkEnd;
+    }
+    const ssize_t copied = process_vm_readv(getpid(), &local, 1, remote, chunks, 0);
+    const size_t words = copied > 0 ? (size_t)copied / sizeof(uintptr_t) : 0;
+    const uintptr_t copiedEnd = sp + words * sizeof(uintptr_t);
+    const uintptr_t* data = stack->data();
+    auto isRecord = [&](size_t index) {
+        const uintptr_t at = sp + index * sizeof(uintptr_t);
+        const uintptr_t next = data[index];
+        return next > at && next + 2 * sizeof(uintptr_t) <= copiedEnd && next % sizeof(uintptr_t) == 0;
+    };
+
+    size_t record = words;
+    for (size_t i = 0; i + 1 < words; i++) {
+        Dl_info info{};
+        if (isRecord(i) && StripPointer(data[i + 1]) != 0 && dladdr((void*)StripPointer(data[i + 1]), &info) != 0) {
+            record = i;
+            break;
+        }
+    }
+    while (record + 1 < words && depth < kMaxDepth) {
+        const uintptr_t ret = StripPointer(data[record + 1]);
+        if (ret == 0) {
+            break;
+        }
+        pcs[depth++] = ret;
+        if (!isRecord(record)) {
+            break;
+        }
+        record = (data[record] - sp) / sizeof(uintptr_t);
+    }
+#else
+    (void)sp;
+    (void)hi;
+    (void)stack;
+#endif
+    return depth;
+}
+
+std::string Symbolize(uintptr_t pc) {
+    Dl_info info{};
+    if (dladdr((void*)pc, &info) == 0 || info.dli_fname == nullptr) {
+        return Fmt("0x%zx", (size_t)pc);
+    }
+    const char* module = strrchr(info.dli_fname, '/');
+    module = module != nullptr ? module + 1 : info.dli_fname;
+    std::string text = Fmt("%s+0x%zx", module, (size_t)(pc - (uintptr_t)info.dli_fbase));
+    if (info.dli_sname != nullptr) {
+        text += Fmt(" (%s+0x%zx)", info.dli_sname, (size_t)(pc - (uintptr_t)info.dli_saddr));
+    }
+    return text;
+}
+
+}  // namespace
+
+void HitchMonitor::RegisterThread(const char* name, bool signal) {
+    std::lock_guard<std::mutex> lock(g_registerMutex);
+    ThreadSlot* target = nullptr;
+    for (ThreadSlot& slot : g_threads) {
+        if (slot.tid.load() != 0 && strncmp(slot.name, name, sizeof(slot.name)) == 0) {
+            target = &slot;
+            break;
+        }
+        if (target == nullptr && slot.tid.load() == 0) {
+            target = &slot;
+        }
+    }
+    if (target == nullptr) {
+        return;
+    }
+
+    uintptr_t lo = 0, hi = 0;
+    pthread_attr_t attr;
+    if (pthread_getattr_np(pthread_self(), &attr) == 0) {
+        void* addr = nullptr;
+        size_t size = 0;
+        if (pthread_attr_getstack(&attr, &addr, &size) == 0) {
+            lo = (uintptr_t)addr;
+            hi = lo + size;
+        }
+        pthread_attr_destroy(&attr);
+    }
+
+    // Out of the handler's sight while the slot changes hands.
+    target->tid.store(0, std::memory_order_release);
+    strncpy(target->name, name, sizeof(target->name) - 1);
+    target->name[sizeof(target->name) - 1] = '\0';
+    target->signal = signal;
+    target->stackLo = lo;
+    target->stackHi = hi;
+    target->signalPending.store(false, std::memory_order_relaxed);
+    target->next.store(0, std::memory_order_relaxed);
+    target->tid.store(CurrentTid(), std::memory_order_release);
+    t_registration.slot = target;
+}
+
+void HitchMonitor::Start(float thresholdPeriods, const std::string& directory) {
+    Stop();
+    if (thresholdPeriods <= 0) {
+        return;
+    }
+    m_thresholdPeriods = thresholdPeriods;
+    m_directory = directory;
+    RegisterThread("render");
+
+    struct sigaction action {};
+    action.sa_sigaction = OnSampleSignal;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, nullptr);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_frames.assign(kFrameRing, FrameRecord{});
+        m_nextFrame = 0;
+        m_metrics.assign(kMetricsRing, {});
+        m_nextMetrics = 0;
+        m_pendingReason.clear();
+        m_running = true;
+    }
+    Reset();
+    m_thread = std::thread(&HitchMonitor::Run, this);
+    Log::Write(Log::Level::Info, Fmt("hitch monitor: snapshots past %.1f display periods or %u missed latches", thresholdPeriods, kMissStreak));
+}
+
+void HitchMonitor::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_wake.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void HitchMonitor::Reset() {
+    m_lastFrameEndNs.store(0, std::memory_order_release);
+    m_missStreak = 0;
+}
+
+void HitchMonitor::FrameEnd(XrDuration displayPeriod, Clock::duration wait, bool latchAttempted, bool latched, uint64_t poseID) {
+    if (m_thresholdPeriods <= 0) {
+        return;
+    }
+    const Clock::time_point now = Clock::now();
+    const int64_t nowNs = ToNs(now);
+    const int64_t previousNs = m_lastFrameEndNs.exchange(nowNs, std::memory_order_acq_rel);
+    const int64_t thresholdNs = (int64_t)(m_thresholdPeriods * displayPeriod);
+    m_thresholdNs.store(thresholdNs, std::memory_order_release);
+    const int64_t intervalNs = previousNs != 0 ? nowNs - previousNs : 0;
+
+    if (latchAttempted) {
+        m_missStreak = latched ? 0 : m_missStreak + 1;
+    }
+
+    std::string reason;
+    Clock::time_point hitchStart;
+    if (previousNs != 0 && thresholdNs > 0 && intervalNs > thresholdNs) {
+        reason = Fmt("frame took %.1f ms, %.1f display periods", intervalNs / 1e6, (double)intervalNs / displayPeriod);
+        hitchStart = now - std::chrono::nanoseconds(intervalNs);
+    } else if (m_missStreak == kMissStreak) {
+        reason = Fmt("%u latches missed in a row", kMissStreak);
+        hitchStart = now - std::chrono::nanoseconds(kMissStreak * displayPeriod);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FrameRecord& record = m_frames[m_nextFrame++ % m_frames.size()];
+    record.end = now;
+    record.intervalMs = intervalNs / 1e6f;
+    record.waitMs = std::chrono::duration<float, std::milli>(wait).count();
+    record.latchAttempted = latchAttempted;
+    record.latched = latched;
+    record.poseID = poseID;
+
+    if (!reason.empty() && m_pendingReason.empty() && (m_lastSnapshot == Clock::time_point{} || now - m_lastSnapshot >= kSnapshotSpacing)) {
+        m_lastSnapshot = now;
+        m_pendingReason = reason;
+        m_pendingStart = hitchStart;
+        m_pendingEnd = now;
+        m_wake.notify_all();
+    }
+}
+
+void HitchMonitor::Run() {
+    Clock::time_point lastMetrics = Clock::now();
+    std::vector<uintptr_t> stack;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_running) {
+        m_wake.wait_for(lock, kSampleInterval, [this]() { return !m_running || !m_pendingReason.empty(); });
+        if (!m_running) {
+            break;
+        }
+        if (!m_pendingReason.empty()) {
+            const std::string reason = m_pendingReason;
+            const Clock::time_point start = m_pendingStart;
+            const Clock::time_point end = m_pendingEnd;
+            m_pendingReason.clear();
+            lock.unlock();
+            WriteSnapshot(reason, start, end);
+            lock.lock();
+            continue;
+        }
+
+        const Clock::time_point now = Clock::now();
+        if (now - lastMetrics >= std::chrono::seconds(1)) {
+            lastMetrics = now;
+            m_metrics[m_nextMetrics++ % m_metrics.size()] = {now, Metrics::Snapshot()};
+        }
+
+        const int64_t lastEndNs = m_lastFrameEndNs.load(std::memory_order_acquire);
+        const int64_t overNs = ToNs(now) - lastEndNs - m_thresholdNs.load(std::memory_order_acquire);
+        if (lastEndNs == 0 || overNs < 0 || overNs > kMaxSamplingNs) {
+            continue;
+        }
+        // A frame is overrunning: sample everyone but this thread, blocked ones from here.
+        const int self = CurrentTid();
+        for (ThreadSlot& slot : g_threads) {
+            const int tid = slot.tid.load(std::memory_order_acquire);
+            if (tid == 0 || tid == self || slot.signalPending.load(std::memory_order_acquire)) {
+                continue;
+            }
+            int32_t syscallNumber = 0;
+            uintptr_t sp = 0, pc = 0;
+            if (ReadBlocked(tid, &syscallNumber, &sp, &pc) || !slot.signal) {
+                const uint32_t next = slot.next.load(std::memory_order_relaxed);
+                StackSample& sample = slot.samples[next % kSamplesPerThread];
+                sample.depth = pc != 0 ? UnwindBlocked(sp, pc, slot.stackHi, &stack, sample.pcs) : 0;
+                sample.syscall = pc != 0 ? syscallNumber : kRunning;
+                sample.timeNs = MonotonicNs();
+                slot.next.store(next + 1, std::memory_order_release);
+                continue;
+            }
+            slot.signalPending.store(true, std::memory_order_release);
+            if (syscall(SYS_tgkill, getpid(), tid, SIGPROF) != 0) {
+                slot.signalPending.store(false, std::memory_order_release);
+                if (errno == ESRCH) {
+                    slot.tid.store(0, std::memory_order_release);
+                }
+            }
+        }
+    }
+}
+
+void HitchMonitor::WriteSnapshot(const std::string& reason, Clock::time_point hitchStart, Clock::time_point hitchEnd) {
+    std::vector<FrameRecord> frames;
+    std::vector<std::pair<Clock::time_point, std::map<std::string, double>>> metrics;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < m_frames.size(); i++) {
+            const FrameRecord& record = m_frames[(m_nextFrame + i) % m_frames.size()];
+            if (record.end != Clock::time_point{} && record.end >= hitchEnd - kHistory) {
+                frames.push_back(record);
+            }
+        }
+        for (size_t i = 0; i < m_metrics.size(); i++) {
+            const auto& entry = m_metrics[(m_nextMetrics + i) % m_metrics.size()];
+            if (!entry.second.empty()) {
+                metrics.push_back(entry);
+            }
+        }
+    }
+
+    // Identical stacks per thread and state, with how often they were seen during the hitch.
+    using Stack = std::pair<int32_t, std::vector<uintptr_t>>;
+    const int64_t startNs = ToNs(hitchStart);
+    const int64_t endNs = ToNs(hitchEnd);
+    std::vector<std::pair<std::string, std::map<Stack, uint32_t>>> stacks;
+    for (const ThreadSlot& slot : g_threads) {
+        if (slot.tid.load(std::memory_order_acquire) == 0) {
+            continue;
+        }
+        // The signals stopped before this snapshot was queued, but a late one may still be in the
+        // handler: the oldest sample is the next one written, so it is left out, and anything the
+        // handler reached while this copied is dropped below.
+        const uint32_t written = slot.next.load(std::memory_order_acquire);
+        const uint32_t first = written > kSamplesPerThread - 1 ? written - (kSamplesPerThread - 1) : 0;
+        std::vector<std::pair<uint32_t, StackSample>> copied;
+        for (uint32_t i = first; i < written; i++) {
+            copied.emplace_back(i, slot.samples[i % kSamplesPerThread]);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint32_t writtenAfter = slot.next.load(std::memory_order_relaxed);
+
+        std::map<Stack, uint32_t> counts;
+        for (const auto& entry : copied) {
+            const StackSample& sample = entry.second;
+            if (entry.first + kSamplesPerThread <= writtenAfter) {
+                continue;
+            }
+            if (sample.timeNs >= startNs && sample.timeNs <= endNs) {
+                counts[{sample.syscall, std::vector<uintptr_t>(sample.pcs, sample.pcs + std::min(sample.depth, kMaxDepth))}]++;
+            }
+        }
+        stacks.emplace_back(slot.name, std::move(counts));
+    }
+
+    char stamp[32] = {};
+    const time_t wall = time(nullptr);
+    struct tm local {};
+    localtime_r(&wall, &local);
+    strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &local);
+    const std::string path = Fmt("%s/CloudXRHitch_%s.txt", m_directory.c_str(), stamp);
+    std::ofstream out(path);
+    if (!out) {
+        Log::Write(Log::Level::Error, Fmt("hitch monitor: cannot write %s", path.c_str()));
+        return;
+    }
+
+    auto relativeMs = [&hitchEnd](Clock::time_point time) { return std::chrono::duration<double, std::milli>(time - hitchEnd).count(); };
+    out << "hitch " << reason << "\n";
+    out << "time " << stamp << " duration_ms " << (endNs - startNs) / 1e6 << "\n";
+    out << "# per second metrics, ms relative to the end of the hitch\n";
+    for (const auto& entry : metrics) {
+        out << "metrics " << Fmt("%.0f", relativeMs(entry.first));
+        for (const auto& metric : entry.second) {
+            out << " " << metric.first << "=" << Fmt("%.3g", metric.second);
+        }
+        out << "\n";
+    }
+    out << "# frame end_ms interval_ms wait_ms latch pose\n";
+    for (const FrameRecord& record : frames) {
+        out << Fmt("frame %.1f %.2f %.2f %s %llu\n", relativeMs(record.end), record.intervalMs, record.waitMs,
+                   !record.latchAttempted ? "-" : (record.latched ? "ok" : "miss"), (unsigned long long)record.poseID);
+    }
+    out << "# stack thread samples running|syscall <number>: innermost first, none for a running thread that is not signalled\n";
+    for (const auto& thread : stacks) {
+        std::vector<std::pair<uint32_t, const Stack*>> sorted;
+        for (const auto& stack : thread.second) {
+            sorted.emplace_back(stack.second, &stack.first);
+        }
+        std::sort(sorted.begin(), sorted.end(),
+                  [](const std::pair<uint32_t, const Stack*>& a, const std::pair<uint32_t, const Stack*>& b) { return a.first > b.first; });
+        for (const auto& stack : sorted) {
+            out << "stack " << thread.first << " " << stack.first;
+            if (stack.second->first == kRunning) {
+                out << " running\n";
+            } else {
+                out << " syscall " << stack.second->first << "\n";
+            }
+            for (uintptr_t pc : stack.second->second) {
+                out << "  " << Symbolize(pc) << "\n";
+            }
+        }
+    }
+    out.close();
+
+    Metrics::Add("frame.hitches", 1);
+    Log::Write(Log::Level::Warning, Fmt("hitch monitor: %s, snapshot in %s", reason.c_str(), path.c_str()));
+}
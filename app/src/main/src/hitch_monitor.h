@@ -0,0 +1,90 @@
+/*
+    hitch snapshots, adb shell setprop debug.xr.hitch <display periods>, e.g. 4, to turn on (default 0, off).
+    a watchdog thread follows the frame loop. a frame interval longer than the threshold, or a streak of
+    frames whose CloudXR latch missed, freezes the last seconds of per-frame records and per-second
+    Metrics and writes them to /sdcard/CloudXRHitch_<time>.txt, at most one file every 10 seconds.
+
+    while a frame is overrunning, for up to a second, the watchdog also samples the registered threads
+    every 2 ms (render, blit worker, frame pacer, mirror, cxr supervisor, audio). no blocked thread is
+    ever signalled, whoever's code it is blocked in: a thread /proc/self/task/<tid>/syscall shows in the
+    kernel is sampled from there, its pc, and the frame records found on its stack above sp, copied with
+    process_vm_readv so a thread exiting meanwhile costs nothing. a running thread the app created gets
+    SIGPROF, whose handler only walks frame pointers within the thread's own stack, so it cannot fault or
+    take a lock. the check and the signal are microseconds apart, and a thread entering the kernel in
+    between sees one interrupted call: SA_RESTART restarts it unless it is one that times out (poll,
+    epoll_wait, sleeps; the app's own waits are condition variables and sleep_for, which retry). CloudXR's
+    and Oboe's threads are never signalled, running they are counted but not sampled. the build keeps
+    frame pointers on arm64 and x86_64, other ABIs get the pc only.
+
+    the snapshot lists identical stacks once per thread with their sample count and whether the thread
+    was running or in which system call, as module+offset and symbol where dladdr knows it, for addr2line
+    against the unstripped libraries.
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class HitchMonitor {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // The calling thread, sampled while a hitch is in progress until it exits. signal false for threads
+    // the app does not own, e.g. CloudXR's audio callback thread: they are only sampled while blocked. A
+    // thread registering again under the same name, e.g. a restarted worker, takes over the slot.
+    static void RegisterThread(const char* name, bool signal = true);
+
+    ~HitchMonitor() { Stop(); }
+
+    // Render thread: registers it as "render" and starts the watchdog. thresholdPeriods 0 does nothing.
+    // Snapshots go to directory.
+    void Start(float thresholdPeriods, const std::string& directory = "/sdcard");
+    void Stop();
+
+    // Render thread, when frames start or stop flowing, e.g. session begin and end: the gap is no hitch.
+    void Reset();
+
+    // Render thread, after xrEndFrame. latchAttempted is false on frames that showed no stream.
+    void FrameEnd(XrDuration displayPeriod, Clock::duration wait, bool latchAttempted, bool latched, uint64_t poseID);
+
+private:
+    struct FrameRecord {
+        Clock::time_point end;
+        float intervalMs;
+        float waitMs;
+        bool latchAttempted;
+        bool latched;
+        uint64_t poseID;
+    };
+
+    void Run();
+    void WriteSnapshot(const std::string& reason, Clock::time_point hitchStart, Clock::time_point hitchEnd);
+
+    float m_thresholdPeriods{0};
+    std::string m_directory;
+    std::thread m_thread;
+    bool m_running{false};
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+
+    // Guarded by m_mutex.
+    std::vector<FrameRecord> m_frames;  // ring
+    size_t m_nextFrame{0};
+    std::vector<std::pair<Clock::time_point, std::map<std::string, double>>> m_metrics;  // ring, one per second
+    size_t m_nextMetrics{0};
+    std::string m_pendingReason;
+    Clock::time_point m_pendingStart;
+    Clock::time_point m_pendingEnd;
+    Clock::time_point m_lastSnapshot;
+
+    // Render thread to watchdog: when the last frame ended, 0 while frames are not flowing.
+    std::atomic<int64_t> m_lastFrameEndNs{0};
+    std::atomic<int64_t> m_thresholdNs{0};
+    uint32_t m_missStreak{0};
+};
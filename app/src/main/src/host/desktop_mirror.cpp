@@ -0,0 +1,141 @@
+/*
+    host build: the mirror's desktop window, see desktop_mirror.h. run_host.sh builds it as its own
+    library, with gfxwrapper for xlib and without the android flags, since the executable links gfxwrapper
+    for android; -fvisibility=hidden keeps the two apart.
+*/
+#include "common/gfxwrapper_opengl.h"
+#include "desktop_mirror.h"
+
+#include <string.h>
+#include <X11/Xatom.h>
+
+struct DesktopMirror {
+    ksGpuWindow window;
+    Atom deleteWindow = None;
+    // The frame, uploaded as read back.
+    GLuint texture = 0;
+    GLuint framebuffer = 0;
+    int width = 0;
+    int height = 0;
+};
+
+namespace {
+const int kMaxWidth = 1280;
+
+// Whether the window manager asked to close the window. Everything else is dropped: gfxwrapper's
+// ksGpuWindow_ProcessEvents would end the process on escape, the app's, not the mirror's to end.
+bool CloseRequested(DesktopMirror* mirror) {
+    Display* display = mirror->window.xDisplay;
+    bool close = false;
+    while (XPending(display) > 0) {
+        XEvent event;
+        XNextEvent(display, &event);
+        if (event.type == ClientMessage && (Atom)event.xclient.data.l[0] == mirror->deleteWindow) {
+            close = true;
+        }
+    }
+    return close;
+}
+
+void DeleteFrameTexture(DesktopMirror* mirror) {
+    if (mirror->framebuffer != 0) {
+        glDeleteFramebuffers(1, &mirror->framebuffer);
+        mirror->framebuffer = 0;
+    }
+    if (mirror->texture != 0) {
+        glDeleteTextures(1, &mirror->texture);
+        mirror->texture = 0;
+    }
+}
+}  // namespace
+
+extern "C" {
+
+DesktopMirror* desktopMirrorCreate(int width, int height) {
+    if (width > kMaxWidth) {
+        height = (int)((int64_t)height * kMaxWidth / width);
+        width = kMaxWidth;
+    }
+    DesktopMirror* mirror = new DesktopMirror();
+    ksDriverInstance driverInstance{};
+    ksGpuQueueInfo queueInfo{};
+    if (!ksGpuWindow_Create(&mirror->window, &driverInstance, &queueInfo, 0, KS_GPU_SURFACE_COLOR_FORMAT_B8G8R8A8,
+                            KS_GPU_SURFACE_DEPTH_FORMAT_NONE, KS_GPU_SAMPLE_COUNT_1, width, height, false)) {
+        delete mirror;
+        return nullptr;
+    }
+    // Closing the window ends the mirror instead of the X connection.
+    mirror->deleteWindow = XInternAtom(mirror->window.xDisplay, "WM_DELETE_WINDOW", False);
+    XSetWMProtocols(mirror->window.xDisplay, mirror->window.xWindow, &mirror->deleteWindow, 1);
+    const char* title = "CloudXR mirror";
+    XStoreName(mirror->window.xDisplay, mirror->window.xWindow, title);
+    Atom netWmName = XInternAtom(mirror->window.xDisplay, "_NET_WM_NAME", False);
+    XChangeProperty(mirror->window.xDisplay, mirror->window.xWindow, netWmName, XA_STRING, 8, PropModeReplace,
+                    (const unsigned char*)title, (int)strlen(title));
+    ksGpuWindow_SwapInterval(&mirror->window, 1);
+    ksGpuContext_UnsetCurrent(&mirror->window.context);
+    return mirror;
+}
+
+void desktopMirrorDestroy(DesktopMirror* mirror) {
+    if (mirror == nullptr) {
+        return;
+    }
+    ksGpuContext_SetCurrent(&mirror->window.context);
+    DeleteFrameTexture(mirror);
+    ksGpuContext_UnsetCurrent(&mirror->window.context);
+    ksGpuWindow_Destroy(&mirror->window);
+    delete mirror;
+}
+
+int64_t desktopMirrorNextSwapNanoseconds(DesktopMirror* mirror) { return ksGpuWindow_GetNextSwapTimeNanoseconds(&mirror->window); }
+
+int64_t desktopMirrorFrameNanoseconds(DesktopMirror* mirror) { return ksGpuWindow_GetFrameTimeNanoseconds(&mirror->window); }
+
+bool desktopMirrorPresent(DesktopMirror* mirror, const void* pixels, int width, int height) {
+    if (CloseRequested(mirror)) {
+        return false;
+    }
+    ksGpuContext_SetCurrent(&mirror->window.context);
+
+    if (mirror->width != width || mirror->height != height) {
+        DeleteFrameTexture(mirror);
+        glGenTextures(1, &mirror->texture);
+        glBindTexture(GL_TEXTURE_2D, mirror->texture);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+        glGenFramebuffers(1, &mirror->framebuffer);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, mirror->framebuffer);
+        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mirror->texture, 0);
+        mirror->width = width;
+        mirror->height = height;
+    }
+    glBindTexture(GL_TEXTURE_2D, mirror->texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Letterboxed, like the activity's window.
+    const int windowWidth = mirror->window.windowWidth;
+    const int windowHeight = mirror->window.windowHeight;
+    GLint w = windowWidth;
+    GLint h = (GLint)((int64_t)windowWidth * height / width);
+    if (h > windowHeight) {
+        h = windowHeight;
+        w = (GLint)((int64_t)windowHeight * width / height);
+    }
+    const GLint x = (windowWidth - w) / 2;
+    const GLint y = (windowHeight - h) / 2;
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glViewport(0, 0, windowWidth, windowHeight);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, mirror->framebuffer);
+    glBlitFramebuffer(0, 0, width, height, x, y, x + w, y + h, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    ksGpuWindow_SwapBuffers(&mirror->window);
+    ksGpuContext_UnsetCurrent(&mirror->window.context);
+    return true;
+}
+}
@@ -0,0 +1,123 @@
+/*
+    host build of the android app: the NDK functions the sources call, and a main() that plays the
+    activity around android_main (main.cpp), so OpenXrProgram runs on linux against the fake runtime
+    (fake_runtime/fake_runtime.h) and the CloudXR stand-in (cloudxr_standin/). see run_host.sh.
+
+    environment (and HOST_PROPERTIES, see host_system.cpp):
+      HOST_FRAMES       frames of the fake runtime after which the activity is destroyed, default 300
+      HOST_DATA_DIR     the activity's internalDataPath, default the working directory
+    the process exits with 0 once android_main returned after HOST_FRAMES frames, 1 if it returned
+    early (an exception, or the session exited) or the runtime is not the fake one.
+*/
+#include <jni.h>
+#include <android/input.h>
+#include <android/native_window.h>
+#include <android_native_app_glue.h>
+
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include "host_loader.h"
+#include "fake_runtime/fake_runtime.h"
+
+namespace {
+
+struct Activity {
+    std::mutex mutex;
+    std::deque<int32_t> commands;
+    bool finishing = false;
+    android_poll_source commandSource{};
+    int32_t pendingCommand = 0;
+    uint64_t frameLimit = 300;
+    PFN_fakeXrFrameCount frameCount = nullptr;
+};
+
+Activity g_activity;
+JavaVM g_vm;
+
+void Finish() {
+    std::lock_guard<std::mutex> lock(g_activity.mutex);
+    if (!g_activity.finishing) {
+        g_activity.finishing = true;
+        g_activity.commands.insert(g_activity.commands.end(), {APP_CMD_PAUSE, APP_CMD_STOP, APP_CMD_DESTROY});
+    }
+}
+
+void ProcessCommand(android_app* app, android_poll_source*) {
+    if (app->onAppCmd != nullptr) {
+        app->onAppCmd(app, g_activity.pendingCommand);
+    }
+    if (g_activity.pendingCommand == APP_CMD_DESTROY) {
+        app->destroyRequested = 1;
+    }
+}
+
+uint64_t FramesSoFar() {
+    if (g_activity.frameCount == nullptr && HostLoaderRuntimeLibrary() != nullptr) {
+        g_activity.frameCount = reinterpret_cast<PFN_fakeXrFrameCount>(dlsym(HostLoaderRuntimeLibrary(), "fakeXrFrameCount"));
+    }
+    return g_activity.frameCount != nullptr ? g_activity.frameCount() : 0;
+}
+
+}  // namespace
+
+extern "C" {
+
+// No input events are ever delivered.
+int32_t AInputEvent_getType(const AInputEvent*) { return 0; }
+int32_t AInputEvent_getSource(const AInputEvent*) { return 0; }
+int32_t AKeyEvent_getAction(const AInputEvent*) { return 0; }
+int32_t AKeyEvent_getKeyCode(const AInputEvent*) { return 0; }
+float AMotionEvent_getRawX(const AInputEvent*, size_t) { return 0.0f; }
+float AMotionEvent_getRawY(const AInputEvent*, size_t) { return 0.0f; }
+
+int32_t ANativeWindow_setBuffersGeometry(ANativeWindow*, int32_t, int32_t, int32_t) { return 0; }
+
+void ANativeActivity_finish(ANativeActivity*) { Finish(); }
+void ANativeActivity_setWindowFlags(ANativeActivity*, uint32_t, uint32_t) {}
+
+// One queued command per call, like the glue's main looper. Never blocks: with nothing queued the caller's frame loop
+// keeps going, and while the session is not running it sleeps on its own.
+int ALooper_pollAll(int, int*, int*, void** outData) {
+    if (FramesSoFar() >= g_activity.frameLimit) {
+        Finish();
+    }
+    std::lock_guard<std::mutex> lock(g_activity.mutex);
+    if (g_activity.commands.empty()) {
+        return -3;  // ALOOPER_POLL_TIMEOUT
+    }
+    g_activity.pendingCommand = g_activity.commands.front();
+    g_activity.commands.pop_front();
+    *outData = &g_activity.commandSource;
+    return LOOPER_ID_MAIN;
+}
+
+}  // extern "C"
+
+int main() {
+    if (const char* frames = getenv("HOST_FRAMES")) {
+        g_activity.frameLimit = strtoull(frames, nullptr, 10);
+    }
+    const char* dataDir = getenv("HOST_DATA_DIR");
+
+    ANativeActivity activity{};
+    activity.vm = &g_vm;
+    activity.internalDataPath = dataDir != nullptr ? dataDir : ".";
+    android_app app{};
+    app.activity = &activity;
+    g_activity.commandSource.id = LOOPER_ID_MAIN;
+    g_activity.commandSource.app = &app;
+    g_activity.commandSource.process = ProcessCommand;
+    g_activity.commands = {APP_CMD_START, APP_CMD_RESUME};
+
+    android_main(&app);
+
+    const uint64_t frames = FramesSoFar();
+    fprintf(stderr, "host: android_main returned after %llu frames\n", (unsigned long long)frames);
+    return frames >= g_activity.frameLimit && g_activity.frameCount != nullptr ? 0 : 1;
+}
@@ -0,0 +1,223 @@
+/*
+    host build: a minimal OpenXR loader in place of libopenxr_loader.so, which only ships for android.
+    it opens the runtime named by XR_RUNTIME_JSON (the manifest's library_path, relative to the
+    manifest), negotiates the loader interface with it and forwards the core functions the app links
+    against. no api layers, one runtime. xrInitializeLoaderKHR is the loader's own and accepts
+    anything, there is no VM to hand on.
+*/
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#include <openxr/openxr.h>
+#include <common/loader_interfaces.h>
+#include "host_loader.h"
+
+namespace {
+
+struct Loader {
+    void* library = nullptr;
+    PFN_xrGetInstanceProcAddr getInstanceProcAddr = nullptr;
+    XrInstance instance = XR_NULL_HANDLE;
+};
+
+bool LoadRuntime(Loader* loader) {
+    const char* manifestPath = getenv("XR_RUNTIME_JSON");
+    if (manifestPath == nullptr) {
+        fprintf(stderr, "host loader: XR_RUNTIME_JSON is not set\n");
+        return false;
+    }
+    std::ifstream manifest(manifestPath);
+    std::stringstream text;
+    text << manifest.rdbuf();
+    const std::string json = text.str();
+    // No JSON parser: "library_path": "<path>" is the only value needed.
+    const size_t key = json.find("\"library_path\"");
+    const size_t open = key == std::string::npos ? key : json.find('"', json.find(':', key));
+    const size_t close = open == std::string::npos ? open : json.find('"', open + 1);
+    if (close == std::string::npos) {
+        fprintf(stderr, "host loader: no library_path in %s\n", manifestPath);
+        return false;
+    }
+    std::string libraryPath = json.substr(open + 1, close - open - 1);
+    const std::string manifestDir(manifestPath, strrchr(manifestPath, '/') ? strrchr(manifestPath, '/') - manifestPath + 1 : 0);
+    if (libraryPath[0] != '/') {
+        libraryPath = manifestDir + libraryPath;
+    }
+
+    loader->library = dlopen(libraryPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (loader->library == nullptr) {
+        fprintf(stderr, "host loader: %s\n", dlerror());
+        return false;
+    }
+    auto negotiate = reinterpret_cast<PFN_xrNegotiateLoaderRuntimeInterface>(dlsym(loader->library, "xrNegotiateLoaderRuntimeInterface"));
+    if (negotiate == nullptr) {
+        fprintf(stderr, "host loader: %s exports no xrNegotiateLoaderRuntimeInterface\n", libraryPath.c_str());
+        return false;
+    }
+    XrNegotiateLoaderInfo loaderInfo{XR_LOADER_INTERFACE_STRUCT_LOADER_INFO, XR_LOADER_INFO_STRUCT_VERSION, sizeof(XrNegotiateLoaderInfo)};
+    loaderInfo.minInterfaceVersion = 1;
+    loaderInfo.maxInterfaceVersion = XR_CURRENT_LOADER_RUNTIME_VERSION;
+    loaderInfo.minApiVersion = XR_MAKE_VERSION(1, 0, 0);
+    loaderInfo.maxApiVersion = XR_MAKE_VERSION(1, 0x3ff, 0xfff);
+    XrNegotiateRuntimeRequest runtimeRequest{XR_LOADER_INTERFACE_STRUCT_RUNTIME_REQUEST, XR_RUNTIME_INFO_STRUCT_VERSION,
+                                             sizeof(XrNegotiateRuntimeRequest)};
+    if (XR_FAILED(negotiate(&loaderInfo, &runtimeRequest)) || runtimeRequest.getInstanceProcAddr == nullptr) {
+        fprintf(stderr, "host loader: negotiation with %s failed\n", libraryPath.c_str());
+        return false;
+    }
+    loader->getInstanceProcAddr = runtimeRequest.getInstanceProcAddr;
+    return true;
+}
+
+Loader& GetLoader() {
+    static Loader loader;
+    static std::once_flag once;
+    std::call_once(once, [] {
+        if (!LoadRuntime(&loader)) {
+            loader = Loader{};
+        }
+    });
+    return loader;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL HostInitializeLoaderKHR(const XrLoaderInitInfoBaseHeaderKHR*) { return XR_SUCCESS; }
+
+// The runtime's function, looked up with the instance once there is one; XR_ERROR_RUNTIME_UNAVAILABLE from the forwarders
+// below if there is no runtime or it lacks the function.
+template <typename Function>
+Function Resolve(const char* name) {
+    Loader& loader = GetLoader();
+    PFN_xrVoidFunction function = nullptr;
+    if (loader.getInstanceProcAddr == nullptr || XR_FAILED(loader.getInstanceProcAddr(loader.instance, name, &function))) {
+        return nullptr;
+    }
+    return reinterpret_cast<Function>(function);
+}
+
+}  // namespace
+
+void* HostLoaderRuntimeLibrary() { return GetLoader().library; }
+
+extern "C" {
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetInstanceProcAddr(XrInstance instance, const char* name, PFN_xrVoidFunction* function) {
+    if (strcmp(name, "xrInitializeLoaderKHR") == 0) {
+        *function = reinterpret_cast<PFN_xrVoidFunction>(HostInitializeLoaderKHR);
+        return XR_SUCCESS;
+    }
+    Loader& loader = GetLoader();
+    if (loader.getInstanceProcAddr == nullptr) {
+        *function = nullptr;
+        return XR_ERROR_RUNTIME_UNAVAILABLE;
+    }
+    return loader.getInstanceProcAddr(instance, name, function);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateInstance(const XrInstanceCreateInfo* createInfo, XrInstance* instance) {
+    static const PFN_xrCreateInstance createInstance = Resolve<PFN_xrCreateInstance>("xrCreateInstance");
+    if (createInstance == nullptr) {
+        return XR_ERROR_RUNTIME_UNAVAILABLE;
+    }
+    const XrResult result = createInstance(createInfo, instance);
+    if (XR_SUCCEEDED(result)) {
+        GetLoader().instance = *instance;
+    }
+    return result;
+}
+
+#define HOST_XR_FORWARD(name, parameters, arguments)                                        \
+    XRAPI_ATTR XrResult XRAPI_CALL name parameters {                                        \
+        static const PFN_##name function = Resolve<PFN_##name>(#name);                     \
+        return function != nullptr ? function arguments : XR_ERROR_RUNTIME_UNAVAILABLE;     \
+    }
+
+HOST_XR_FORWARD(xrEnumerateApiLayerProperties, (uint32_t capacity, uint32_t* count, XrApiLayerProperties* properties),
+                (capacity, count, properties))
+HOST_XR_FORWARD(xrEnumerateInstanceExtensionProperties,
+                (const char* layerName, uint32_t capacity, uint32_t* count, XrExtensionProperties* properties),
+                (layerName, capacity, count, properties))
+HOST_XR_FORWARD(xrDestroyInstance, (XrInstance instance), (instance))
+HOST_XR_FORWARD(xrGetInstanceProperties, (XrInstance instance, XrInstanceProperties* properties), (instance, properties))
+HOST_XR_FORWARD(xrPollEvent, (XrInstance instance, XrEventDataBuffer* eventData), (instance, eventData))
+HOST_XR_FORWARD(xrStringToPath, (XrInstance instance, const char* pathString, XrPath* path), (instance, pathString, path))
+HOST_XR_FORWARD(xrGetSystem, (XrInstance instance, const XrSystemGetInfo* getInfo, XrSystemId* systemId), (instance, getInfo, systemId))
+HOST_XR_FORWARD(xrGetSystemProperties, (XrInstance instance, XrSystemId systemId, XrSystemProperties* properties),
+                (instance, systemId, properties))
+HOST_XR_FORWARD(xrEnumerateViewConfigurations,
+                (XrInstance instance, XrSystemId systemId, uint32_t capacity, uint32_t* count, XrViewConfigurationType* types),
+                (instance, systemId, capacity, count, types))
+HOST_XR_FORWARD(xrGetViewConfigurationProperties,
+                (XrInstance instance, XrSystemId systemId, XrViewConfigurationType type, XrViewConfigurationProperties* properties),
+                (instance, systemId, type, properties))
+HOST_XR_FORWARD(xrEnumerateViewConfigurationViews,
+                (XrInstance instance, XrSystemId systemId, XrViewConfigurationType type, uint32_t capacity, uint32_t* count,
+                 XrViewConfigurationView* views),
+                (instance, systemId, type, capacity, count, views))
+HOST_XR_FORWARD(xrEnumerateEnvironmentBlendModes,
+                (XrInstance instance, XrSystemId systemId, XrViewConfigurationType type, uint32_t capacity, uint32_t* count,
+                 XrEnvironmentBlendMode* modes),
+                (instance, systemId, type, capacity, count, modes))
+HOST_XR_FORWARD(xrCreateSession, (XrInstance instance, const XrSessionCreateInfo* createInfo, XrSession* session),
+                (instance, createInfo, session))
+HOST_XR_FORWARD(xrDestroySession, (XrSession session), (session))
+HOST_XR_FORWARD(xrBeginSession, (XrSession session, const XrSessionBeginInfo* beginInfo), (session, beginInfo))
+HOST_XR_FORWARD(xrEndSession, (XrSession session), (session))
+HOST_XR_FORWARD(xrWaitFrame, (XrSession session, const XrFrameWaitInfo* waitInfo, XrFrameState* frameState), (session, waitInfo, frameState))
+HOST_XR_FORWARD(xrBeginFrame, (XrSession session, const XrFrameBeginInfo* beginInfo), (session, beginInfo))
+HOST_XR_FORWARD(xrEndFrame, (XrSession session, const XrFrameEndInfo* endInfo), (session, endInfo))
+HOST_XR_FORWARD(xrLocateViews,
+                (XrSession session, const XrViewLocateInfo* locateInfo, XrViewState* viewState, uint32_t capacity, uint32_t* count,
+                 XrView* views),
+                (session, locateInfo, viewState, capacity, count, views))
+HOST_XR_FORWARD(xrEnumerateReferenceSpaces, (XrSession session, uint32_t capacity, uint32_t* count, XrReferenceSpaceType* spaces),
+                (session, capacity, count, spaces))
+HOST_XR_FORWARD(xrCreateReferenceSpace, (XrSession session, const XrReferenceSpaceCreateInfo* createInfo, XrSpace* space),
+                (session, createInfo, space))
+HOST_XR_FORWARD(xrCreateActionSpace, (XrSession session, const XrActionSpaceCreateInfo* createInfo, XrSpace* space),
+                (session, createInfo, space))
+HOST_XR_FORWARD(xrDestroySpace, (XrSpace space), (space))
+HOST_XR_FORWARD(xrLocateSpace, (XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation* location), (space, baseSpace, time, location))
+HOST_XR_FORWARD(xrEnumerateSwapchainFormats, (XrSession session, uint32_t capacity, uint32_t* count, int64_t* formats),
+                (session, capacity, count, formats))
+HOST_XR_FORWARD(xrCreateSwapchain, (XrSession session, const XrSwapchainCreateInfo* createInfo, XrSwapchain* swapchain),
+                (session, createInfo, swapchain))
+HOST_XR_FORWARD(xrDestroySwapchain, (XrSwapchain swapchain), (swapchain))
+HOST_XR_FORWARD(xrEnumerateSwapchainImages, (XrSwapchain swapchain, uint32_t capacity, uint32_t* count, XrSwapchainImageBaseHeader* images),
+                (swapchain, capacity, count, images))
+HOST_XR_FORWARD(xrAcquireSwapchainImage, (XrSwapchain swapchain, const XrSwapchainImageAcquireInfo* acquireInfo, uint32_t* index),
+                (swapchain, acquireInfo, index))
+HOST_XR_FORWARD(xrWaitSwapchainImage, (XrSwapchain swapchain, const XrSwapchainImageWaitInfo* waitInfo), (swapchain, waitInfo))
+HOST_XR_FORWARD(xrReleaseSwapchainImage, (XrSwapchain swapchain, const XrSwapchainImageReleaseInfo* releaseInfo), (swapchain, releaseInfo))
+HOST_XR_FORWARD(xrCreateActionSet, (XrInstance instance, const XrActionSetCreateInfo* createInfo, XrActionSet* actionSet),
+                (instance, createInfo, actionSet))
+HOST_XR_FORWARD(xrDestroyActionSet, (XrActionSet actionSet), (actionSet))
+HOST_XR_FORWARD(xrCreateAction, (XrActionSet actionSet, const XrActionCreateInfo* createInfo, XrAction* action), (actionSet, createInfo, action))
+HOST_XR_FORWARD(xrSuggestInteractionProfileBindings, (XrInstance instance, const XrInteractionProfileSuggestedBinding* suggestedBindings),
+                (instance, suggestedBindings))
+HOST_XR_FORWARD(xrAttachSessionActionSets, (XrSession session, const XrSessionActionSetsAttachInfo* attachInfo), (session, attachInfo))
+HOST_XR_FORWARD(xrSyncActions, (XrSession session, const XrActionsSyncInfo* syncInfo), (session, syncInfo))
+HOST_XR_FORWARD(xrGetActionStateBoolean, (XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateBoolean* state),
+                (session, getInfo, state))
+HOST_XR_FORWARD(xrGetActionStateFloat, (XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateFloat* state),
+                (session, getInfo, state))
+HOST_XR_FORWARD(xrGetActionStateVector2f, (XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateVector2f* state),
+                (session, getInfo, state))
+HOST_XR_FORWARD(xrEnumerateBoundSourcesForAction,
+                (XrSession session, const XrBoundSourcesForActionEnumerateInfo* enumerateInfo, uint32_t capacity, uint32_t* count,
+                 XrPath* sources),
+                (session, enumerateInfo, capacity, count, sources))
+HOST_XR_FORWARD(xrGetInputSourceLocalizedName,
+                (XrSession session, const XrInputSourceLocalizedNameGetInfo* getInfo, uint32_t capacity, uint32_t* count, char* buffer),
+                (session, getInfo, capacity, count, buffer))
+HOST_XR_FORWARD(xrApplyHapticFeedback, (XrSession session, const XrHapticActionInfo* actionInfo, const XrHapticBaseHeader* feedback),
+                (session, actionInfo, feedback))
+
+#undef HOST_XR_FORWARD
+
+}  // extern "C"
@@ -0,0 +1,7 @@
+/*
+    host build: the OpenXR loader stand-in, see host_loader.cpp.
+*/
+#pragma once
+
+// dlopen handle of the runtime, for runtime specific exports such as fake_runtime.h's; null without a runtime.
+void* HostLoaderRuntimeLibrary();
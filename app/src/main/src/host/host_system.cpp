@@ -0,0 +1,101 @@
+/*
+    host build: system properties and the android log, for the app (host_android.cpp) and the host tests
+    (tests/) alike.
+
+    environment:
+      HOST_PROPERTIES   file of "<name> <value>" lines, the system properties (adb shell setprop)
+*/
+#include <android/log.h>
+#include <sys/system_properties.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+namespace {
+
+struct Properties {
+    std::mutex mutex;
+    bool loaded = false;
+    std::map<std::string, std::string> values;
+};
+
+Properties& GetProperties() {
+    static Properties properties;
+    std::lock_guard<std::mutex> lock(properties.mutex);
+    if (!properties.loaded) {
+        properties.loaded = true;
+        if (const char* path = getenv("HOST_PROPERTIES")) {
+            std::ifstream file(path);
+            std::string line;
+            while (std::getline(file, line)) {
+                std::istringstream tokens(line);
+                std::string name, value;
+                if (tokens >> name) {
+                    std::getline(tokens >> std::ws, value);
+                    properties.values[name] = value.substr(0, PROP_VALUE_MAX - 1);
+                }
+            }
+        }
+    }
+    return properties;
+}
+
+}  // namespace
+
+extern "C" {
+
+int __system_property_get(const char* name, char* value) {
+    Properties& properties = GetProperties();
+    std::lock_guard<std::mutex> lock(properties.mutex);
+    auto it = properties.values.find(name);
+    const std::string found = it != properties.values.end() ? it->second : "";
+    strcpy(value, found.c_str());
+    return (int)found.size();
+}
+
+int __system_property_foreach(void (*callback)(const prop_info* info, void* cookie), void* cookie) {
+    Properties& properties = GetProperties();
+    std::map<std::string, std::string> values;
+    {
+        std::lock_guard<std::mutex> lock(properties.mutex);
+        values = properties.values;
+    }
+    for (const auto& entry : values) {
+        callback(reinterpret_cast<const prop_info*>(&entry), cookie);
+    }
+    return 0;
+}
+
+void __system_property_read_callback(const prop_info* info, void (*callback)(void* cookie, const char* name, const char* value, uint32_t serial),
+                                     void* cookie) {
+    const auto* entry = reinterpret_cast<const std::pair<const std::string, std::string>*>(info);
+    callback(cookie, entry->first.c_str(), entry->second.c_str(), 0);
+}
+
+// logger.cpp already writes every line to stdout, only warnings and errors are repeated here, with whatever else logs.
+int __android_log_write(int prio, const char* tag, const char* text) {
+    if (prio < ANDROID_LOG_WARN) {
+        return 0;
+    }
+    static const char kLevels[] = "??VDIWEFS";
+    fprintf(stderr, "%c/%s: %s\n", kLevels[prio >= 0 && prio <= ANDROID_LOG_SILENT ? prio : 0], tag, text);
+    return 1;
+}
+
+int __android_log_print(int prio, const char* tag, const char* fmt, ...) {
+    char text[1024];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+    return __android_log_write(prio, tag, text);
+}
+
+}  // extern "C"
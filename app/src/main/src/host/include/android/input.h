@@ -0,0 +1,48 @@
+/*
+    host build: the input constants and accessors the Android sources use; the host glue never
+    delivers input events, see host_android.cpp.
+*/
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <android/keycodes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    AINPUT_EVENT_TYPE_KEY = 1,
+    AINPUT_EVENT_TYPE_MOTION = 2,
+};
+
+enum {
+    AINPUT_SOURCE_TOUCHSCREEN = 0x00001002,
+    AINPUT_SOURCE_MOUSE = 0x00002002,
+};
+
+enum {
+    AKEY_EVENT_ACTION_DOWN = 0,
+    AKEY_EVENT_ACTION_UP = 1,
+};
+
+enum {
+    AMOTION_EVENT_ACTION_MASK = 0xff,
+    AMOTION_EVENT_ACTION_DOWN = 0,
+    AMOTION_EVENT_ACTION_UP = 1,
+};
+
+struct AInputEvent;
+typedef struct AInputEvent AInputEvent;
+
+int32_t AInputEvent_getType(const AInputEvent* event);
+int32_t AInputEvent_getSource(const AInputEvent* event);
+int32_t AKeyEvent_getAction(const AInputEvent* event);
+int32_t AKeyEvent_getKeyCode(const AInputEvent* event);
+float AMotionEvent_getRawX(const AInputEvent* event, size_t pointerIndex);
+float AMotionEvent_getRawY(const AInputEvent* event, size_t pointerIndex);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+enum {
+    AKEYCODE_DPAD_UP = 19,
+    AKEYCODE_DPAD_DOWN = 20,
+    AKEYCODE_DPAD_LEFT = 21,
+    AKEYCODE_DPAD_RIGHT = 22,
+    AKEYCODE_A = 29,
+    AKEYCODE_B = 30,
+    AKEYCODE_C = 31,
+    AKEYCODE_D = 32,
+    AKEYCODE_E = 33,
+    AKEYCODE_F = 34,
+    AKEYCODE_G = 35,
+    AKEYCODE_H = 36,
+    AKEYCODE_I = 37,
+    AKEYCODE_J = 38,
+    AKEYCODE_K = 39,
+    AKEYCODE_L = 40,
+    AKEYCODE_M = 41,
+    AKEYCODE_N = 42,
+    AKEYCODE_O = 43,
+    AKEYCODE_P = 44,
+    AKEYCODE_Q = 45,
+    AKEYCODE_R = 46,
+    AKEYCODE_S = 47,
+    AKEYCODE_T = 48,
+    AKEYCODE_U = 49,
+    AKEYCODE_V = 50,
+    AKEYCODE_W = 51,
+    AKEYCODE_X = 52,
+    AKEYCODE_Y = 53,
+    AKEYCODE_Z = 54,
+    AKEYCODE_ALT_LEFT = 57,
+    AKEYCODE_SHIFT_LEFT = 59,
+    AKEYCODE_TAB = 61,
+    AKEYCODE_ENTER = 66,
+    AKEYCODE_BUTTON_A = 96,
+    AKEYCODE_BUTTON_B = 97,
+    AKEYCODE_BUTTON_X = 99,
+    AKEYCODE_BUTTON_Y = 100,
+    AKEYCODE_BUTTON_START = 108,
+    AKEYCODE_BUTTON_SELECT = 109,
+    AKEYCODE_ESCAPE = 111,
+    AKEYCODE_CTRL_LEFT = 113,
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct ALooper;
+typedef struct ALooper ALooper;
+
+// Host glue: runs the queued app commands, see host_android.cpp.
+int ALooper_pollAll(int timeoutMillis, int* outFd, int* outEvents, void** outData);
+
+#ifdef __cplusplus
+}
+#endif
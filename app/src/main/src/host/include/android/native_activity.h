@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+#include <jni.h>
+#include <android/input.h>
+#include <android/native_window.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ANativeActivity {
+    JavaVM* vm;
+    JNIEnv* env;
+    jobject clazz;
+    const char* internalDataPath;
+    const char* externalDataPath;
+} ANativeActivity;
+
+void ANativeActivity_finish(ANativeActivity* activity);
+void ANativeActivity_setWindowFlags(ANativeActivity* activity, uint32_t addFlags, uint32_t removeFlags);
+
+#ifdef __cplusplus
+}
+#endif
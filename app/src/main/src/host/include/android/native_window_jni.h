@@ -0,0 +1,4 @@
+#pragma once
+
+#include <jni.h>
+#include <android/native_window.h>
@@ -0,0 +1,6 @@
+#pragma once
+
+enum {
+    AWINDOW_FLAG_KEEP_SCREEN_ON = 0x00000080,
+    AWINDOW_FLAG_FULLSCREEN = 0x00000400,
+};
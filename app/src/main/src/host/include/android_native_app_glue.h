@@ -0,0 +1,64 @@
+/*
+    host build: the part of android_native_app_glue the app uses. host_android.cpp's main() plays the
+    activity: it calls android_main with APP_CMD_START and APP_CMD_RESUME queued for ALooper_pollAll,
+    never creates a window, and queues APP_CMD_PAUSE, APP_CMD_STOP and APP_CMD_DESTROY after HOST_FRAMES
+    frames of the fake runtime, or when the app finishes the activity.
+*/
+#pragma once
+
+#include <stdint.h>
+#include <android/looper.h>
+#include <android/native_activity.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct android_app;
+
+struct android_poll_source {
+    int32_t id;
+    struct android_app* app;
+    void (*process)(struct android_app* app, struct android_poll_source* source);
+};
+
+struct android_app {
+    void* userData;
+    void (*onAppCmd)(struct android_app* app, int32_t cmd);
+    int32_t (*onInputEvent)(struct android_app* app, AInputEvent* event);
+    ANativeActivity* activity;
+    ALooper* looper;
+    ANativeWindow* window;
+    int destroyRequested;
+};
+
+enum {
+    LOOPER_ID_MAIN = 1,
+    LOOPER_ID_INPUT = 2,
+    LOOPER_ID_USER = 3,
+};
+
+enum {
+    APP_CMD_INPUT_CHANGED,
+    APP_CMD_INIT_WINDOW,
+    APP_CMD_TERM_WINDOW,
+    APP_CMD_WINDOW_RESIZED,
+    APP_CMD_WINDOW_REDRAW_NEEDED,
+    APP_CMD_CONTENT_RECT_CHANGED,
+    APP_CMD_GAINED_FOCUS,
+    APP_CMD_LOST_FOCUS,
+    APP_CMD_CONFIG_CHANGED,
+    APP_CMD_LOW_MEMORY,
+    APP_CMD_START,
+    APP_CMD_RESUME,
+    APP_CMD_SAVE_STATE,
+    APP_CMD_PAUSE,
+    APP_CMD_STOP,
+    APP_CMD_DESTROY,
+};
+
+void android_main(struct android_app* app);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,16 @@
+/*
+    host build: force-included into every source. what bionic's headers declare that glibc's do not,
+    or only through includes the sources do not make.
+*/
+#pragma once
+
+// gettid and the like, which bionic declares unconditionally.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <sys/time.h>
+
+#ifndef SCHED_FLAG_RESET_ON_FORK
+#define SCHED_FLAG_RESET_ON_FORK 0x01
+#endif
@@ -0,0 +1,49 @@
+/*
+    host build: the JNI types and calls the Android sources use. there is no VM on the host, the
+    activity handed to android_main has none, and nothing here is ever called through.
+*/
+#pragma once
+
+#include <stdint.h>
+
+typedef int32_t jint;
+typedef float jfloat;
+typedef void* jobject;
+typedef jobject jclass;
+typedef jobject jstring;
+typedef struct _jfieldID* jfieldID;
+typedef struct _jmethodID* jmethodID;
+
+#ifdef __cplusplus
+struct _JNIEnv {};
+struct _JavaVM {
+    jint AttachCurrentThread(_JNIEnv** env, void*) {
+        *env = nullptr;
+        return 0;
+    }
+    jint DetachCurrentThread() { return 0; }
+};
+typedef _JNIEnv JNIEnv;
+typedef _JavaVM JavaVM;
+#else
+struct JNINativeInterface;
+struct JNIInvokeInterface;
+typedef const struct JNINativeInterface* JNIEnv;
+typedef const struct JNIInvokeInterface* JavaVM;
+
+struct JNINativeInterface {
+    jclass (*FindClass)(JNIEnv*, const char*);
+    jclass (*GetObjectClass)(JNIEnv*, jobject);
+    jmethodID (*GetMethodID)(JNIEnv*, jclass, const char*, const char*);
+    jobject (*CallObjectMethod)(JNIEnv*, jobject, jmethodID, ...);
+    jfloat (*CallFloatMethod)(JNIEnv*, jobject, jmethodID, ...);
+    jfieldID (*GetStaticFieldID)(JNIEnv*, jclass, const char*, const char*);
+    jobject (*GetStaticObjectField)(JNIEnv*, jclass, jfieldID);
+    void (*DeleteLocalRef)(JNIEnv*, jobject);
+};
+
+struct JNIInvokeInterface {
+    jint (*AttachCurrentThread)(JavaVM*, JNIEnv**, void*);
+    jint (*DetachCurrentThread)(JavaVM*);
+};
+#endif
@@ -0,0 +1,24 @@
+/*
+    host build: system properties are read from the file named by HOST_PROPERTIES, one
+    "<name> <value>" per line as adb shell setprop would take them, see host_android.cpp.
+*/
+#pragma once
+
+#include <stdint.h>
+
+#define PROP_VALUE_MAX 92
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct prop_info prop_info;
+
+int __system_property_get(const char* name, char* value);
+int __system_property_foreach(void (*callback)(const prop_info* info, void* cookie), void* cookie);
+void __system_property_read_callback(const prop_info* info,
+                                     void (*callback)(void* cookie, const char* name, const char* value, uint32_t serial), void* cookie);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,19 @@
+/*
+    host build: liboboe only ships for android, and there is no audio device to play to. no stream
+    ever opens; run with the -dra (disable-receive-audio) launch option so the client asks for none.
+*/
+#include <oboe/Oboe.h>
+
+namespace oboe {
+
+Result AudioStreamBuilder::openStream(std::shared_ptr<AudioStream>& stream) {
+    stream.reset();
+    return Result::ErrorUnavailable;
+}
+
+template <>
+const char* convertToText<Result>(Result result) {
+    return result == Result::OK ? "OK" : "ErrorUnavailable (host build, no audio)";
+}
+
+}  // namespace oboe
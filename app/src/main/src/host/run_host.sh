@@ -0,0 +1,75 @@
+#!/bin/sh
+# Builds the android app for linux and runs it against the fake runtime and the CloudXR stand-in, see
+# host_android.cpp. Usage:
+#   host/run_host.sh <fake runtime script> [<property>=<value> ...]
+# e.g. host/run_host.sh fake_runtime/scripts/stale_frames.txt debug.cxr.drain=0
+# The properties are what adb shell setprop would set. Needs g++, unzip and a GLES 3 capable EGL with
+# surfaceless contexts (mesa: EGL_PLATFORM=surfaceless, set here). Build and run output go to
+# $HOST_BUILD, default /tmp/cloudxr_host: fake_xr_report.txt (FAKE_XR_REPORT), standin_report.txt
+# (debug.cxr.standin.report) and whatever the properties ask for. HOST_FRAMES as in host_android.cpp.
+# debug.xr.mirror=2 opens the mirror in a desktop window, see desktop_mirror.h; that needs an X display and
+# the Xlib, GLX, Xrandr and xf86vidmode libraries, and the run goes on without it if they are missing.
+# Exits with the app's status.
+set -e
+[ $# -ge 1 ] || { sed -n '2,12p' "$0"; exit 2; }
+SCRIPT=$(realpath "$1")
+shift
+cd "$(dirname "$0")/.."
+SRC=$(pwd)
+LIBS=$SRC/../../../libs
+BUILD=${HOST_BUILD:-/tmp/cloudxr_host}
+mkdir -p "$BUILD/obj"
+
+# The same headers ndk-build compiles against, from the SDK archives.
+unzip -q -o "$LIBS/CloudXR.aar" 'include/*' -d "$BUILD/cloudxr"
+unzip -q -o "$LIBS/oboe-1.6.0.aar" 'prefab/modules/oboe/include/*' -d "$BUILD/oboe"
+
+g++ -std=c++17 -O2 -shared -fPIC -fvisibility=hidden -Iopenxr_loader/include \
+    fake_runtime/fake_runtime.cpp -o "$BUILD/libopenxr_fake_runtime.so" -lpthread
+cp fake_runtime/fake_runtime.json "$BUILD/"
+
+# The desktop mirror, with gfxwrapper for xlib, kept out of obj/ where the android one goes.
+XLIB_FLAGS="-O2 -fPIC -fvisibility=hidden -DOS_LINUX_XLIB -I. -Iopenxr_loader/include"
+rm -f "$BUILD/libdesktop_mirror.so"
+if ! { gcc $XLIB_FLAGS -c openxr_loader/include/common/gfxwrapper_opengl.c -o "$BUILD/gfxwrapper_xlib.o" &&
+        g++ -std=c++17 $XLIB_FLAGS -shared host/desktop_mirror.cpp "$BUILD/gfxwrapper_xlib.o" \
+            -o "$BUILD/libdesktop_mirror.so" -lX11 -lGL -lXxf86vm -lXrandr; } > "$BUILD/desktop_mirror.log" 2>&1; then
+    echo "no desktop mirror (debug.xr.mirror 2), see $BUILD/desktop_mirror.log"
+fi
+
+# Android.mk's LOCAL_SRC_FILES, the stand-in built into the executable instead of libCloudXRClient.so,
+# and the host glue in place of the NDK, liboboe and the OpenXR loader.
+SOURCES="main.cpp logger.cpp platformplugin_factory.cpp platformplugin_android.cpp graphicsplugin_factory.cpp
+    graphicsplugin_opengles.cpp gl_program_cache.cpp egl_context.cpp openxr_loader/include/common/gfxwrapper_opengl.c
+    cloudXRClient.cpp blit_worker.cpp decoder_selection.cpp frame_drain.cpp frametrace.cpp metrics.cpp
+    xr_call_budget.cpp frame_pacer.cpp view_resolution.cpp swapchain_policy.cpp foveation.cpp latch_scheduler.cpp
+    hitch_monitor.cpp memory_monitor.cpp click_to_photon.cpp mirror_window.cpp callback_dispatch.cpp
+    session_columns.cpp session_export.cpp stream_throttle.cpp openxr_program.cpp
+    cloudxr_standin/cxr_standin.cpp cloudxr_standin/netimpair.cpp
+    host/host_android.cpp host/host_system.cpp host/host_loader.cpp host/oboe_host.cpp"
+FLAGS="-O1 -fno-omit-frame-pointer -DANDROID -D__ANDROID__ -DXR_USE_PLATFORM_ANDROID=1 -DXR_USE_GRAPHICS_API_OPENGL_ES=1
+    -Ihost/include -include bionic_compat.h -I$BUILD/cloudxr/include -I$BUILD/oboe/prefab/modules/oboe/include
+    -I. -Iopenxr_loader/include"
+export FLAGS BUILD
+echo $SOURCES | tr ' ' '\n' | xargs -P "$(nproc)" -I{} sh -c '
+    case {} in
+        *.c) gcc $FLAGS -c {} -o "$BUILD/obj/$(echo {} | tr / _).o" ;;
+        *) g++ -std=c++17 $FLAGS -c {} -o "$BUILD/obj/$(echo {} | tr / _).o" ;;
+    esac'
+g++ "$BUILD"/obj/*.o -o "$BUILD/cloudxr_client" -lEGL -lGLESv2 -lpthread -ldl
+
+# No server to name and no audio device, see host/oboe_host.cpp.
+echo "-s 127.0.0.1 -dra" > "$BUILD/CloudXRLaunchOptions.txt"
+{
+    echo "debug.cxr.launchOptions $BUILD/CloudXRLaunchOptions.txt"
+    echo "debug.cxr.standin.report $BUILD/standin_report.txt"
+    for property in "$@"; do
+        echo "${property%%=*} ${property#*=}"
+    done
+} > "$BUILD/properties.txt"
+
+cd "$BUILD"
+EGL_PLATFORM=surfaceless LD_LIBRARY_PATH="$BUILD${LD_LIBRARY_PATH:+:$LD_LIBRARY_PATH}" \
+    XR_RUNTIME_JSON="$BUILD/fake_runtime.json" FAKE_XR_SCRIPT="$SCRIPT" \
+    FAKE_XR_REPORT="$BUILD/fake_xr_report.txt" HOST_PROPERTIES="$BUILD/properties.txt" HOST_DATA_DIR="$BUILD" \
+    ./cloudxr_client
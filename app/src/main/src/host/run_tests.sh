@@ -0,0 +1,80 @@
+#!/bin/sh
+# Builds and runs the host tests in host/tests, each against the app's sources it tests, compiled for linux like
+# run_host.sh does. Usage:
+#   host/run_tests.sh [<test> ...]
+# e.g. host/run_tests.sh frame_drain_test; without arguments every test runs. Needs what run_host.sh needs.
+# Build output goes to $HOST_BUILD/tests, default /tmp/cloudxr_host/tests. Exits with 1 if any test failed.
+set -e
+cd "$(dirname "$0")/.."
+SRC=$(pwd)
+LIBS=$SRC/../../../libs
+BUILD=${HOST_BUILD:-/tmp/cloudxr_host}/tests
+mkdir -p "$BUILD/obj"
+
+unzip -q -o "$LIBS/CloudXR.aar" 'include/*' -d "$BUILD/cloudxr"
+unzip -q -o "$LIBS/oboe-1.6.0.aar" 'prefab/modules/oboe/include/*' -d "$BUILD/oboe"
+
+FLAGS="-O1 -fno-omit-frame-pointer -DANDROID -D__ANDROID__ -DXR_USE_PLATFORM_ANDROID=1 -DXR_USE_GRAPHICS_API_OPENGL_ES=1
+    -Ihost/include -include bionic_compat.h -I$BUILD/cloudxr/include -I$BUILD/oboe/prefab/modules/oboe/include
+    -I. -Iopenxr_loader/include -Ihost/tests"
+
+# <test>: the sources it links besides host/tests/<test>.cpp.
+CLOUDXR="cloudXRClient.cpp blit_worker.cpp callback_dispatch.cpp decoder_selection.cpp frame_drain.cpp frametrace.cpp
+    metrics.cpp logger.cpp egl_context.cpp memory_monitor.cpp hitch_monitor.cpp
+    cloudxr_standin/cxr_standin.cpp cloudxr_standin/netimpair.cpp host/host_system.cpp host/host_loader.cpp host/oboe_host.cpp"
+sources() {
+    case $1 in
+        decoder_selection_test) echo "decoder_selection.cpp logger.cpp host/host_system.cpp" ;;
+        frame_drain_test) echo "$CLOUDXR" ;;
+        hitch_monitor_test) echo "hitch_monitor.cpp metrics.cpp logger.cpp host/host_system.cpp" ;;
+        memory_monitor_test) echo "memory_monitor.cpp metrics.cpp" ;;
+        stream_throttle_test) echo "stream_throttle.cpp metrics.cpp logger.cpp host/host_system.cpp" ;;
+        swapchain_policy_test) echo "swapchain_policy.cpp" ;;
+        view_resolution_test) echo "view_resolution.cpp" ;;
+        xr_call_budget_test) echo "xr_call_budget.cpp metrics.cpp logger.cpp host/host_system.cpp" ;;
+        *) echo "unknown test $1" >&2; exit 2 ;;
+    esac
+}
+
+# <test>: the runs, one per line: the system properties (name=value, comma separated, or -) and the arguments.
+runs() {
+    case $1 in
+        frame_drain_test) printf '%s\n' "-" "debug.cxr.drain=0 off" ;;
+        *) echo "-" ;;
+    esac
+}
+
+# Whether an object is older than its source or any header it included, as listed by -MMD.
+stale() {
+    [ ! -e "$1" ] && return 0
+    for dependency in $(sed -e 's/^[^:]*://' -e 's/\\$//' "$1.d"); do
+        [ "$dependency" -nt "$1" ] && return 0
+    done
+    return 1
+}
+
+TESTS=${*:-$(cd host/tests && ls *_test.cpp | sed 's/\.cpp$//')}
+failed=0
+for test in $TESTS; do
+    objects=""
+    for source in host/tests/$test.cpp $(sources "$test"); do
+        object="$BUILD/obj/$(echo "$source" | tr / _).o"
+        if stale "$object"; then
+            g++ -std=c++17 $FLAGS -MMD -MF "$object.d" -c "$source" -o "$object"
+        fi
+        objects="$objects $object"
+    done
+    g++ -rdynamic $objects -o "$BUILD/$test" -lEGL -lGLESv2 -lpthread -ldl
+
+    runs "$test" | while read -r properties arguments; do
+        if [ "$properties" = "-" ]; then
+            : > "$BUILD/$test.properties"
+        else
+            echo "$properties" | tr ',' '\n' | sed 's/=/ /' > "$BUILD/$test.properties"
+        fi
+        echo "== $test $properties $arguments"
+        (cd "$BUILD" && EGL_PLATFORM=surfaceless HOST_PROPERTIES="$BUILD/$test.properties" "./$test" $arguments) || exit 1
+    done || failed=1
+done
+[ $failed -eq 0 ] && echo "all passed" || echo "FAILED"
+exit $failed
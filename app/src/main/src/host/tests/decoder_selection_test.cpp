@@ -0,0 +1,85 @@
+/*
+    decoder_selection.h: the score charges dropped packets as the frames they made up, and a calibration
+    over both backends picks the one that scores best, the dropped count taken from the warm-up second on.
+*/
+#include "pch.h"
+#include "common.h"
+#include "decoder_selection.h"
+#include "host_test.h"
+
+namespace {
+DecoderSelection::Sample MakeSample(double fps, uint32_t received, uint32_t dropped) {
+    DecoderSelection::Sample sample;
+    sample.seconds = 5;
+    sample.fps = fps;
+    sample.deliveryMs = 20.0;
+    sample.latchMs = 1.0;
+    sample.received = received;
+    sample.dropped = dropped;
+    return sample;
+}
+
+bool Near(double a, double b) { return std::fabs(a - b) < 1e-6; }
+
+void Score() {
+    const double frameMs = 1000.0 / 72.0;
+
+    // Every frame there, none dropped: latency alone.
+    EXPECT(Near(DecoderSelection::Score(MakeSample(72.0, 360 * 40, 0), 72.0), 21.0));
+
+    // 360 frames shown at 40 packets each, and 400 packets dropped: 10 frames of 360, not 400.
+    EXPECT(Near(DecoderSelection::Score(MakeSample(72.0, 360 * 40 + 400, 400), 72.0), 21.0 + frameMs * 10.0 / 360.0));
+
+    // The frame rate deficit adds, shown frames give the packet size: 350 frames shown, 5 dropped.
+    EXPECT(Near(DecoderSelection::Score(MakeSample(70.0, 350 * 40 + 200, 200), 72.0), 21.0 + frameMs * 15.0 / 360.0));
+
+    // Without packet counts a dropped packet is a frame, as before.
+    EXPECT(Near(DecoderSelection::Score(MakeSample(72.0, 0, 3), 72.0), 21.0 + frameMs * 3.0 / 360.0));
+
+    // Never streamed.
+    EXPECT(std::isinf(DecoderSelection::Score(MakeSample(0.0, 0, 0), 72.0)));
+    DecoderSelection::Sample empty;
+    EXPECT(std::isinf(DecoderSelection::Score(empty, 72.0)));
+}
+
+void PickWinner() {
+    // A millisecond faster but 4000 packets of 40 a frame dropped: 100 frames, almost 4 ms at 72Hz.
+    std::vector<DecoderSelection::Sample> samples = {MakeSample(72.0, 360 * 40 + 4000, 4000), MakeSample(72.0, 360 * 40, 0)};
+    samples[0].deliveryMs = 19.0;
+    EXPECT(DecoderSelection::PickWinner(samples, 72.0) == 1);
+
+    // One frame's worth of packets dropped keeps the lead; charged a frame per packet it would be 40 frames.
+    samples[0] = MakeSample(72.0, 360 * 40 + 40, 40);
+    samples[0].deliveryMs = 19.0;
+    EXPECT(DecoderSelection::PickWinner(samples, 72.0) == 0);
+}
+
+void Calibration() {
+    DecoderCalibration calibration;
+    calibration.Begin(72.0, 2);
+    EXPECT(calibration.Active() && std::string(calibration.Current().name) == "mediacodec");
+
+    // Warm-up, then two seconds dropping 400 of 3280 packets a second; the counts are cumulative.
+    uint32_t received = 100000, dropped = 5000;
+    EXPECT(!calibration.AddSecond(72.0, 20.0, 1.0, received, dropped));
+    received += 3280, dropped += 400;
+    EXPECT(!calibration.AddSecond(72.0, 20.0, 1.0, received, dropped));
+    received += 3280, dropped += 400;
+    EXPECT(calibration.AddSecond(72.0, 20.0, 1.0, received, dropped));
+    EXPECT(calibration.Active() && std::string(calibration.Current().name) == "aimagereader");
+
+    // The new receiver counts from zero. No drops, a millisecond slower: it wins, the receiver stays.
+    EXPECT(!calibration.AddSecond(72.0, 21.0, 1.0, 0, 0));
+    EXPECT(!calibration.AddSecond(72.0, 21.0, 1.0, 2880, 0));
+    EXPECT(!calibration.AddSecond(72.0, 21.0, 1.0, 5760, 0));
+    EXPECT(!calibration.Active() && std::string(calibration.Current().name) == "aimagereader");
+}
+}  // namespace
+
+int main() {
+    Log::SetLevel(Log::Level::Warning);
+    Score();
+    PickWinner();
+    Calibration();
+    return HostTest::Result();
+}
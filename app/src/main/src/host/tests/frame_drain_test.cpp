@@ -0,0 +1,91 @@
+/*
+    frame_drain.h against the CloudXR stand-in: a 72Hz render loop that stalls for 300 ms (nothing latched,
+    the stand-in keeps sending) and is later not visible for 500 ms (DrainFrames only). lag is how many
+    frames the latched poseID is behind the frame that is due now.
+
+    with the drain (default) the lag after the stall and after the idle time stays where it was. run with
+    the argument "off" and debug.cxr.drain 0 in HOST_PROPERTIES, and the backlog has to show instead, so
+    the test also fails when the stand-in stops queueing and the drain has nothing to do.
+*/
+#include "pch.h"
+#include "common.h"
+#include "cloudXRClient.h"
+#include "egl_context.h"
+#include "host_test.h"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Lag {
+    double sum = 0.0;
+    int count = 0;
+    double Average() const { return count > 0 ? sum / count : 0.0; }
+};
+}  // namespace
+
+int main(int argc, char** argv) {
+    const bool drainOff = argc > 1 && strcmp(argv[1], "off") == 0;
+    Log::SetLevel(Log::Level::Warning);
+
+    EglContext egl;
+    if (!EXPECT(egl.Create())) {
+        return HostTest::Result();
+    }
+    egl.MakeCurrent();
+    cxrDeviceDesc deviceDesc{};
+    deviceDesc.width = 64;
+    deviceDesc.height = 64;
+    deviceDesc.fps = 72;
+    cxrGraphicsContext context{};
+    context.type = cxrGraphicsContext_GLES;
+    context.egl.display = egl.display;
+    context.egl.context = egl.context;
+
+    CloudXRClient client;
+    if (!EXPECT(client.StartLoadClient("standin", deviceDesc, context))) {
+        return HostTest::Result();
+    }
+
+    const auto period = std::chrono::microseconds(13889);
+    const Clock::time_point start = Clock::now();
+    Clock::time_point next = start;
+    Lag before, afterStall, afterIdle;
+    for (int frame = 0; frame < 72 * 6; frame++) {
+        next += period;
+        std::this_thread::sleep_until(next);
+        const double t = std::chrono::duration<double>(Clock::now() - start).count();
+        if (t > 2.0 && t < 2.3) {
+            next = Clock::now();
+            continue;
+        }
+        if (t > 4.0 && t < 4.5) {
+            client.DrainFrames();
+            continue;
+        }
+        cxrFramesLatched framesLatched{};
+        if (!client.LatchFrame(&framesLatched)) {
+            continue;
+        }
+        const double due = std::chrono::duration<double>(Clock::now() - start).count() * 72.0;
+        const double lag = due - framesLatched.poseID;
+        client.ReleaseFrame(&framesLatched);
+        Lag* window = t > 1.0 && t < 2.0 ? &before : t > 3.0 && t < 4.0 ? &afterStall : t > 5.0 ? &afterIdle : nullptr;
+        if (window != nullptr) {
+            window->sum += lag;
+            window->count++;
+        }
+    }
+    client.StopLoadClient();
+
+    printf("lag in frames: %.2f before, %.2f after the stall, %.2f after the idle time (drain %s)\n", before.Average(),
+           afterStall.Average(), afterIdle.Average(), drainOff ? "off" : "on");
+    EXPECT(before.count > 36 && afterStall.count > 36 && afterIdle.count > 36);
+    if (drainOff) {
+        EXPECT(afterStall.Average() > before.Average() + 4.0);
+        EXPECT(afterIdle.Average() > before.Average() + 4.0);
+    } else {
+        EXPECT(afterStall.Average() < before.Average() + 1.0);
+        EXPECT(afterIdle.Average() < before.Average() + 1.0);
+    }
+    return HostTest::Result();
+}
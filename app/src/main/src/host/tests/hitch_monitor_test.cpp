@@ -0,0 +1,162 @@
+/*
+    hitch_monitor.h through a 400 ms render stall: a thread blocked in poll() throughout is sampled from /proc
+    and never sees EINTR, a running app thread is sampled by signal, a running thread registered without
+    signals is counted only, and threads that exited before gave their slots back. checks the snapshot file.
+*/
+#include "pch.h"
+#include "common.h"
+#include "hitch_monitor.h"
+#include "host_test.h"
+
+#include <poll.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace {
+std::atomic<bool> g_stop{false};
+std::atomic<int> g_interrupted{0};
+std::atomic<int> g_registered{0};
+int g_pipe[2];
+
+void HitchTestPoll() {
+    HitchMonitor::RegisterThread("poller");
+    g_registered++;
+    // Woken through the pipe at the end, long after the stall.
+    pollfd fd{g_pipe[0], POLLIN, 0};
+    while (poll(&fd, 1, 10000) < 0) {
+        g_interrupted++;
+    }
+}
+
+void HitchTestSpin(const char* name, bool signal) {
+    HitchMonitor::RegisterThread(name, signal);
+    g_registered++;
+    volatile uint64_t sum = 0;
+    while (!g_stop.load(std::memory_order_relaxed)) {
+        for (int i = 0; i < 1000; i++) {
+            sum = sum + i;
+        }
+    }
+}
+
+std::string ReadSnapshot(const std::string& directory) {
+    std::string listing;
+    FILE* ls = popen(("ls " + directory).c_str(), "r");
+    char name[256];
+    while (ls != nullptr && fgets(name, sizeof(name), ls) != nullptr) {
+        listing = name;
+    }
+    if (ls != nullptr) {
+        pclose(ls);
+    }
+    if (listing.empty()) {
+        return "";
+    }
+    listing.erase(listing.find_last_not_of('\n') + 1);
+    std::ifstream file(directory + "/" + listing);
+    std::ostringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+// The "stack <thread> ..." lines of the snapshot, each with the frames below it.
+std::vector<std::pair<std::string, std::vector<std::string>>> Stacks(const std::string& snapshot, const std::string& thread) {
+    std::vector<std::pair<std::string, std::vector<std::string>>> stacks;
+    std::istringstream lines(snapshot);
+    std::string line;
+    bool inThread = false;
+    while (std::getline(lines, line)) {
+        if (line.compare(0, 6, "stack ") == 0) {
+            inThread = line.compare(6, thread.size() + 1, thread + " ") == 0;
+            if (inThread) {
+                stacks.push_back({line, {}});
+            }
+        } else if (inThread && line.compare(0, 2, "  ") == 0) {
+            stacks.back().second.push_back(line);
+        }
+    }
+    return stacks;
+}
+}  // namespace
+
+int main() {
+    Log::SetLevel(Log::Level::Warning);
+    char directory[] = "/tmp/hitch_test_XXXXXX";
+    if (!EXPECT(mkdtemp(directory) != nullptr) || !EXPECT(pipe(g_pipe) == 0)) {
+        return HostTest::Result();
+    }
+
+    // More threads than there are slots register and exit first.
+    for (int i = 0; i < 12; i++) {
+        std::thread([i]() { HitchMonitor::RegisterThread(Fmt("gone %d", i).c_str()); }).join();
+    }
+
+    std::thread poller(HitchTestPoll);
+    std::thread spinner(HitchTestSpin, "spinner", true);
+    std::thread foreign(HitchTestSpin, "foreign", false);
+    while (g_registered.load() < 3) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    HitchMonitor monitor;
+    monitor.Start(2.0f, directory);
+    const XrDuration period = 13888889;
+    for (int frame = 0; frame < 30; frame++) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(period));
+        monitor.FrameEnd(period, std::chrono::milliseconds(10), false, false, 0);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    monitor.FrameEnd(period, std::chrono::milliseconds(10), false, false, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    monitor.Stop();
+    g_stop.store(true);
+    EXPECT(write(g_pipe[1], "x", 1) == 1);
+    poller.join();
+    spinner.join();
+    foreign.join();
+
+    const std::string snapshot = ReadSnapshot(directory);
+    if (!EXPECT(!snapshot.empty())) {
+        return HostTest::Result();
+    }
+    EXPECT(g_interrupted.load() == 0);
+
+    // Blocked in poll: from /proc, in poll and with the frames found further up the stack.
+    bool pollerBlocked = false;
+    for (const auto& stack : Stacks(snapshot, "poller")) {
+        pollerBlocked = pollerBlocked || (stack.first.find(" syscall ") != std::string::npos && stack.second.size() >= 2 &&
+                                          stack.second[0].find("poll") != std::string::npos);
+    }
+    EXPECT(pollerBlocked);
+
+    // The render thread sleeping through the stall, the same way.
+    bool renderBlocked = false;
+    for (const auto& stack : Stacks(snapshot, "render")) {
+        renderBlocked = renderBlocked || stack.first.find(" syscall ") != std::string::npos;
+    }
+    EXPECT(renderBlocked);
+
+    // Running app thread: signalled, frames of its own.
+    bool spinnerSampled = false;
+    for (const auto& stack : Stacks(snapshot, "spinner")) {
+        spinnerSampled = spinnerSampled || (stack.first.find(" running") != std::string::npos && !stack.second.empty());
+    }
+    EXPECT(spinnerSampled);
+
+    // Running thread without signals: counted, never sampled.
+    const auto foreignStacks = Stacks(snapshot, "foreign");
+    EXPECT(!foreignStacks.empty());
+    for (const auto& stack : foreignStacks) {
+        EXPECT(stack.first.find(" running") == std::string::npos || stack.second.empty());
+    }
+
+    EXPECT(snapshot.find("stack gone") == std::string::npos);
+    if (HostTest::Failures() != 0) {
+        fprintf(stderr, "%s", snapshot.substr(snapshot.find("# stack")).c_str());
+    }
+    return HostTest::Result();
+}
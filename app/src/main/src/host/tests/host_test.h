@@ -0,0 +1,31 @@
+/*
+    checks for the host tests, see ../run_tests.sh. a failed EXPECT prints where and what, and the test's
+    main returns HostTest::Result(): 0 if nothing failed.
+*/
+#pragma once
+
+#include <stdio.h>
+
+namespace HostTest {
+inline int& Failures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline bool Check(bool ok, const char* expression, const char* file, int line) {
+    if (!ok) {
+        fprintf(stderr, "%s:%d: EXPECT(%s) failed\n", file, line, expression);
+        Failures()++;
+    }
+    return ok;
+}
+
+inline int Result() {
+    if (Failures() != 0) {
+        fprintf(stderr, "%d check(s) failed\n", Failures());
+    }
+    return Failures() != 0 ? 1 : 0;
+}
+}  // namespace HostTest
+
+#define EXPECT(expression) HostTest::Check((expression), #expression, __FILE__, __LINE__)
@@ -0,0 +1,143 @@
+/*
+    memory_monitor.h on synthetic samples, 5 s apart on a clock of the test's own: the trend and its
+    warning thresholds, and shedding past the budget. links this Log instead of logger.cpp, to count the
+    monitor's warnings.
+*/
+#include "pch.h"
+#include "common.h"
+#include "memory_monitor.h"
+#include "host_test.h"
+
+namespace {
+int g_growthWarnings = 0;
+int g_budgetWarnings = 0;
+}  // namespace
+
+namespace Log {
+void SetLevel(Level) {}
+void Write(Level severity, const std::string& msg) {
+    if (severity == Level::Warning && msg.find("growing") != std::string::npos) {
+        g_growthWarnings++;
+    }
+    if (severity == Level::Warning && msg.find("over the") != std::string::npos) {
+        g_budgetWarnings++;
+    }
+}
+}  // namespace Log
+
+namespace {
+using Clock = MemoryMonitor::Clock;
+const auto kInterval = std::chrono::seconds(5);
+
+struct Feed {
+    MemoryMonitor& monitor;
+    Clock::time_point now = Clock::now();
+    double pssMb = 400.0;
+
+    // Samples for the given time, PSS growing by mbPerMinute.
+    void Run(std::chrono::seconds duration, double mbPerMinute, double swapMb = 0.0) {
+        for (auto elapsed = std::chrono::seconds(0); elapsed < duration; elapsed += kInterval) {
+            now += kInterval;
+            pssMb += mbPerMinute * kInterval.count() / 60.0;
+            MemorySample sample;
+            sample.pssMb = pssMb;
+            sample.rssMb = pssMb * 1.2;
+            sample.swapMb = swapMb;
+            monitor.Sample(sample, now);
+        }
+    }
+};
+
+void Trend() {
+    MemoryMonitor monitor;
+    monitor.Start(0, Clock::duration::zero());
+    Feed feed{monitor};
+    g_growthWarnings = 0;
+
+    // Nothing before 5 minutes of samples, however fast PSS grows.
+    feed.Run(std::chrono::seconds(295), 10.0);
+    EXPECT(monitor.TrendMbPerMinute() == 0.0);
+    EXPECT(g_growthWarnings == 0);
+
+    // Then one warning, and the next not before another 5 minutes.
+    feed.Run(std::chrono::seconds(10), 10.0);
+    EXPECT(std::fabs(monitor.TrendMbPerMinute() - 10.0) < 0.01);
+    EXPECT(g_growthWarnings == 1);
+    feed.Run(std::chrono::seconds(290), 10.0);
+    EXPECT(g_growthWarnings == 1);
+    feed.Run(std::chrono::seconds(10), 10.0);
+    EXPECT(g_growthWarnings == 2);
+
+    // Flat from here: half the 10 minute window still grows and warns once more, then the growth ages out.
+    feed.Run(std::chrono::seconds(300), 0.0);
+    EXPECT(g_growthWarnings == 3);
+    feed.Run(std::chrono::seconds(310), 0.0);
+    EXPECT(std::fabs(monitor.TrendMbPerMinute()) < 0.01);
+    EXPECT(g_growthWarnings == 3);
+}
+
+void TrendThreshold() {
+    // The threshold is 2 MB a minute: just under it never warns, a little over it does.
+    MemoryMonitor slow;
+    slow.Start(0, Clock::duration::zero());
+    Feed slowFeed{slow};
+    g_growthWarnings = 0;
+    slowFeed.Run(std::chrono::seconds(900), 1.9);
+    EXPECT(std::fabs(slow.TrendMbPerMinute() - 1.9) < 0.01);
+    EXPECT(g_growthWarnings == 0);
+
+    MemoryMonitor fast;
+    fast.Start(0, Clock::duration::zero());
+    Feed fastFeed{fast};
+    fastFeed.Run(std::chrono::seconds(310), 2.5);
+    EXPECT(g_growthWarnings == 1);
+}
+
+void Budget() {
+    MemoryMonitor monitor;
+    std::vector<std::string> shed;
+    monitor.AddShedder("first", [&shed]() { shed.push_back("first"); });
+    monitor.AddShedder("second", [&shed]() { shed.push_back("second"); });
+    monitor.Start(500, Clock::duration::zero());
+    Feed feed{monitor};
+    g_budgetWarnings = 0;
+
+    // Under the budget nothing is asked for.
+    feed.Run(std::chrono::seconds(60), 0.0);
+    monitor.Update();
+    EXPECT(shed.empty() && monitor.ShedCount() == 0);
+
+    // Swapped PSS counts: 400 + 150 MB is over. Samples alone shed nothing, Update sheds one feature.
+    feed.Run(std::chrono::seconds(30), 0.0, 150.0);
+    EXPECT(g_budgetWarnings == 1);
+    EXPECT(shed.empty());
+    monitor.Update();
+    monitor.Update();
+    EXPECT(shed.size() == 1 && shed[0] == "first" && monitor.ShedCount() == 1);
+
+    // Still over on the next sample: the second one, then nothing is left.
+    feed.Run(std::chrono::seconds(5), 0.0, 150.0);
+    monitor.Update();
+    EXPECT(shed.size() == 2 && shed[1] == "second" && monitor.ShedCount() == 2);
+    feed.Run(std::chrono::seconds(30), 0.0, 150.0);
+    monitor.Update();
+    EXPECT(shed.size() == 2);
+    EXPECT(g_budgetWarnings == 1);
+
+    // No budget, no shedding.
+    MemoryMonitor unbudgeted;
+    unbudgeted.AddShedder("first", [&shed]() { shed.push_back("unbudgeted"); });
+    unbudgeted.Start(0, Clock::duration::zero());
+    Feed unbudgetedFeed{unbudgeted};
+    unbudgetedFeed.Run(std::chrono::seconds(30), 0.0, 10000.0);
+    unbudgeted.Update();
+    EXPECT(shed.size() == 2 && unbudgeted.ShedCount() == 0);
+}
+}  // namespace
+
+int main() {
+    Trend();
+    TrendThreshold();
+    Budget();
+    return HostTest::Result();
+}
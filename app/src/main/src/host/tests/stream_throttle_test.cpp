@@ -0,0 +1,131 @@
+/*
+    stream_throttle.h transitions on a clock of the test's own: the delay before reduced rate, refocus and
+    the user's return going back to full rate at once, and a stopped session or a disabled throttle never
+    reducing it.
+*/
+#include "pch.h"
+#include "common.h"
+#include "stream_throttle.h"
+#include "host_test.h"
+
+namespace {
+using Clock = StreamThrottle::Clock;
+using std::chrono::milliseconds;
+
+struct Run {
+    StreamThrottle throttle;
+    Clock::time_point now = Clock::now();
+    int changes = 0;
+
+    explicit Run(bool enabled) {
+        throttle.Initialize(enabled, 3000.0f);
+        throttle.SessionState(XR_SESSION_STATE_FOCUSED);
+    }
+
+    // Updates every 10 ms, like the render loop, and counts the changes reported.
+    void Advance(milliseconds duration) {
+        for (milliseconds elapsed(0); elapsed < duration; elapsed += milliseconds(10)) {
+            now += milliseconds(10);
+            changes += throttle.Update(now) ? 1 : 0;
+        }
+    }
+};
+
+void Delay() {
+    Run run(true);
+    run.Advance(milliseconds(1000));
+    EXPECT(!run.throttle.Throttled() && run.changes == 0);
+
+    // A system overlay: nothing for 3 s, then reduced rate, reported once.
+    run.throttle.SessionState(XR_SESSION_STATE_VISIBLE);
+    run.Advance(milliseconds(2990));
+    EXPECT(!run.throttle.Throttled() && run.changes == 0);
+    run.Advance(milliseconds(20));
+    EXPECT(run.throttle.Throttled() && run.changes == 1);
+    run.Advance(milliseconds(5000));
+    EXPECT(run.changes == 1);
+}
+
+void Refocus() {
+    Run run(true);
+    run.throttle.SessionState(XR_SESSION_STATE_SYNCHRONIZED);
+    run.Advance(milliseconds(4000));
+    EXPECT(run.throttle.Throttled());
+
+    // Full rate on the first update after focus comes back.
+    run.throttle.SessionState(XR_SESSION_STATE_FOCUSED);
+    EXPECT(run.throttle.Update(run.now) && !run.throttle.Throttled());
+
+    // A glance at the system menu shorter than the delay costs nothing, and the delay starts over each time.
+    run.changes = 0;
+    for (int glance = 0; glance < 3; glance++) {
+        run.throttle.SessionState(XR_SESSION_STATE_VISIBLE);
+        run.Advance(milliseconds(2500));
+        run.throttle.SessionState(XR_SESSION_STATE_FOCUSED);
+        run.Advance(milliseconds(100));
+    }
+    EXPECT(!run.throttle.Throttled() && run.changes == 0);
+}
+
+void Presence() {
+    Run run(true);
+    run.throttle.UserPresence(false);
+    run.Advance(milliseconds(3100));
+    EXPECT(run.throttle.Throttled() && run.changes == 1);
+
+    // Losing focus while already away keeps the reduced rate, getting it back while away does too.
+    run.throttle.SessionState(XR_SESSION_STATE_VISIBLE);
+    run.Advance(milliseconds(500));
+    run.throttle.SessionState(XR_SESSION_STATE_FOCUSED);
+    run.Advance(milliseconds(500));
+    EXPECT(run.throttle.Throttled() && run.changes == 1);
+
+    // The user returns: full rate at once.
+    run.throttle.UserPresence(true);
+    run.Advance(milliseconds(10));
+    EXPECT(!run.throttle.Throttled() && run.changes == 2);
+
+    // Back while unfocused is not enough, focus is needed too.
+    run.throttle.UserPresence(false);
+    run.throttle.SessionState(XR_SESSION_STATE_VISIBLE);
+    run.Advance(milliseconds(3100));
+    run.throttle.UserPresence(true);
+    run.Advance(milliseconds(100));
+    EXPECT(run.throttle.Throttled() && run.changes == 3);
+    run.throttle.SessionState(XR_SESSION_STATE_FOCUSED);
+    run.Advance(milliseconds(10));
+    EXPECT(!run.throttle.Throttled() && run.changes == 4);
+}
+
+void Stopped() {
+    // A stopping session drops the reduced rate, the next session starts at full rate.
+    Run run(true);
+    run.throttle.SessionState(XR_SESSION_STATE_VISIBLE);
+    run.Advance(milliseconds(3100));
+    EXPECT(run.throttle.Throttled());
+    run.throttle.SessionState(XR_SESSION_STATE_STOPPING);
+    run.Advance(milliseconds(10));
+    EXPECT(!run.throttle.Throttled());
+    run.throttle.SessionState(XR_SESSION_STATE_IDLE);
+    run.Advance(milliseconds(5000));
+    EXPECT(!run.throttle.Throttled() && run.changes == 2);
+}
+
+void Disabled() {
+    Run run(false);
+    run.throttle.SessionState(XR_SESSION_STATE_VISIBLE);
+    run.throttle.UserPresence(false);
+    run.Advance(milliseconds(10000));
+    EXPECT(!run.throttle.Throttled() && run.changes == 0);
+}
+}  // namespace
+
+int main() {
+    Log::SetLevel(Log::Level::Warning);
+    Delay();
+    Refocus();
+    Presence();
+    Stopped();
+    Disabled();
+    return HostTest::Result();
+}
@@ -0,0 +1,63 @@
+/*
+    swapchain_policy.h: the configuration of each use, and the memory estimates the swapchain log line and
+    startup.swapchain_mb report, at a Quest 2 sized view of 1832x1920 with 3 images.
+*/
+#include "pch.h"
+#include "common.h"
+#include "swapchain_policy.h"
+#include "host_test.h"
+
+namespace {
+const int64_t kFormat = 0x8C43;  // GL_SRGB8_ALPHA8
+const uint32_t kWidth = 1832, kHeight = 1920, kImages = 3;
+const uint64_t kPixels = (uint64_t)kWidth * kHeight;
+
+void Uses() {
+    // Streamed projection: one sample, rendered into only, no depth, whatever the plugin supports.
+    const SwapchainConfig streamed = SwapchainPolicy::Select(SwapchainUse::StreamedProjection, kFormat, 4);
+    EXPECT(streamed.format == kFormat && streamed.sampleCount == 1 && !streamed.depth);
+    EXPECT(streamed.usageFlags == XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT);
+
+    // HUD quad: one sample, uploaded into as well, no depth.
+    const SwapchainConfig hud = SwapchainPolicy::Select(SwapchainUse::HudQuad, kFormat, 4);
+    EXPECT(hud.format == kFormat && hud.sampleCount == 1 && !hud.depth);
+    EXPECT(hud.usageFlags == (XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT | XR_SWAPCHAIN_USAGE_TRANSFER_DST_BIT));
+
+    // Debug overlay: geometry, with the plugin's sample count and depth; at least one sample.
+    const SwapchainConfig overlay = SwapchainPolicy::Select(SwapchainUse::DebugOverlay, kFormat, 4);
+    EXPECT(overlay.format == kFormat && overlay.sampleCount == 4 && overlay.depth);
+    EXPECT(overlay.usageFlags == XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT);
+    EXPECT(SwapchainPolicy::Select(SwapchainUse::DebugOverlay, kFormat, 0).sampleCount == 1);
+
+    // Nothing samples any of them but the compositor.
+    for (SwapchainUse use : {SwapchainUse::StreamedProjection, SwapchainUse::HudQuad, SwapchainUse::DebugOverlay}) {
+        EXPECT((SwapchainPolicy::Select(use, kFormat, 4).usageFlags & XR_SWAPCHAIN_USAGE_SAMPLED_BIT) == 0);
+        EXPECT(std::string(SwapchainPolicy::ToString(use)) != "unknown");
+    }
+}
+
+void Estimates() {
+    // The previous setup: 4x MSAA color images and a 4x depth buffer.
+    const SwapchainConfig unoptimized = SwapchainPolicy::Unoptimized(kFormat, 4);
+    EXPECT(unoptimized.sampleCount == 4 && unoptimized.depth);
+    EXPECT(SwapchainPolicy::EstimateBytes(unoptimized, kWidth, kHeight, kImages) == kPixels * 4 * (4 * kImages + 4));
+    EXPECT(SwapchainPolicy::Unoptimized(kFormat, 0).sampleCount == 1);
+
+    // A streamed view is its color images alone: about 40 MB, against about 215 MB before.
+    const SwapchainConfig streamed = SwapchainPolicy::Select(SwapchainUse::StreamedProjection, kFormat, 4);
+    const uint64_t streamedBytes = SwapchainPolicy::EstimateBytes(streamed, kWidth, kHeight, kImages);
+    EXPECT(streamedBytes == kPixels * 4 * kImages);
+    EXPECT(streamedBytes / (1024 * 1024) == 40);
+    EXPECT(SwapchainPolicy::EstimateBytes(unoptimized, kWidth, kHeight, kImages) / (1024 * 1024) == 214);
+
+    // The color size per pixel is the caller's, depth stays 4 bytes a sample.
+    const SwapchainConfig overlay = SwapchainPolicy::Select(SwapchainUse::DebugOverlay, kFormat, 2);
+    EXPECT(SwapchainPolicy::EstimateBytes(overlay, kWidth, kHeight, kImages, 8) == kPixels * 2 * (8 * kImages + 4));
+}
+}  // namespace
+
+int main() {
+    Uses();
+    Estimates();
+    return HostTest::Result();
+}
@@ -0,0 +1,79 @@
+/*
+    view_resolution.h: the allocation for a view, and the active rect over a stream that renegotiates its
+    resolution, as openxr_program.cpp feeds it from cxrVideoFrame::widthFinal/heightFinal.
+*/
+#include "pch.h"
+#include "common.h"
+#include "view_resolution.h"
+#include "host_test.h"
+
+namespace {
+XrViewConfigurationView View(uint32_t width, uint32_t height, uint32_t maxWidth, uint32_t maxHeight) {
+    XrViewConfigurationView view{XR_TYPE_VIEW_CONFIGURATION_VIEW};
+    view.recommendedImageRectWidth = width;
+    view.recommendedImageRectHeight = height;
+    view.maxImageRectWidth = maxWidth;
+    view.maxImageRectHeight = maxHeight;
+    return view;
+}
+
+bool Is(const XrRect2Di& rect, int32_t width, int32_t height) {
+    return rect.offset.x == 0 && rect.offset.y == 0 && rect.extent.width == width && rect.extent.height == height;
+}
+
+void AllocationExtent() {
+    XrExtent2Di extent = ViewResolution::AllocationExtent(View(1832, 1920, 4096, 4096), 1.0f);
+    EXPECT(extent.width == 1832 && extent.height == 1920);
+
+    extent = ViewResolution::AllocationExtent(View(1832, 1920, 4096, 4096), 1.5f);
+    EXPECT(extent.width == 2748 && extent.height == 2880);
+
+    // Below 1 is the recommended size, the runtime's maximum caps each dimension on its own.
+    extent = ViewResolution::AllocationExtent(View(1832, 1920, 4096, 4096), 0.5f);
+    EXPECT(extent.width == 1832 && extent.height == 1920);
+    extent = ViewResolution::AllocationExtent(View(1832, 1920, 2048, 4096), 2.0f);
+    EXPECT(extent.width == 2048 && extent.height == 3840);
+
+    // No maximum reported, and nothing recommended.
+    extent = ViewResolution::AllocationExtent(View(1000, 1000, 0, 0), 1.25f);
+    EXPECT(extent.width == 1250 && extent.height == 1250);
+    extent = ViewResolution::AllocationExtent(View(0, 0, 0, 0), 2.0f);
+    EXPECT(extent.width == 1 && extent.height == 1);
+}
+
+void ResizeSequence() {
+    ViewResolution resolution;
+    resolution.Reset({2748, 2880}, {1832, 1920});
+    EXPECT(Is(resolution.ActiveRect(), 1832, 1920));
+    EXPECT(resolution.Allocated().width == 2748 && resolution.Allocated().height == 2880);
+
+    // The same size again, and frames without a size, change nothing.
+    EXPECT(!resolution.Update(1832, 1920));
+    EXPECT(!resolution.Update(0, 0));
+    EXPECT(!resolution.Update(1440, 0));
+    EXPECT(Is(resolution.ActiveRect(), 1832, 1920));
+
+    // Down, up within the allocation, then past it: each dimension is clamped on its own.
+    EXPECT(resolution.Update(1440, 1504));
+    EXPECT(Is(resolution.ActiveRect(), 1440, 1504));
+    EXPECT(resolution.Update(2748, 2880));
+    EXPECT(Is(resolution.ActiveRect(), 2748, 2880));
+    EXPECT(resolution.Update(3000, 2000));
+    EXPECT(Is(resolution.ActiveRect(), 2748, 2000));
+    EXPECT(!resolution.Update(4000, 2000));
+    EXPECT(Is(resolution.ActiveRect(), 2748, 2000));
+
+    // A new allocation starts over, an initial size beyond it is clamped too.
+    resolution.Reset({1832, 1920}, {2748, 2880});
+    EXPECT(Is(resolution.ActiveRect(), 1832, 1920));
+    resolution.Reset({1832, 1920}, {0, 0});
+    EXPECT(Is(resolution.ActiveRect(), 0, 0));
+    EXPECT(resolution.Update(1832, 1920));
+}
+}  // namespace
+
+int main() {
+    AllocationExtent();
+    ResizeSequence();
+    return HostTest::Result();
+}
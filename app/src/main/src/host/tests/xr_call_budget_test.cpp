@@ -0,0 +1,66 @@
+/*
+    xr_call_budget.h with a pacing thread: a render thread records three render phase calls a frame while
+    another thread records an xrWaitFrame every millisecond in the wait phase. each has to be counted in
+    its own phase and nothing lost, whatever phase the other thread is in. run under -fsanitize=thread to
+    see the races too.
+*/
+#include "pch.h"
+#include "common.h"
+#include "metrics.h"
+#include "host_test.h"
+
+#include <atomic>
+#include <thread>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+void Pacer(const std::atomic<bool>& running, std::atomic<uint64_t>* calls) {
+    XrCallBudget::SetPhase(XrCallPhase::Wait);
+    while (running.load()) {
+        XrCallBudget::Record("xrWaitFrame(m_session, &frameWaitInfo, &frameState)", std::chrono::microseconds(100));
+        calls->fetch_add(1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+}  // namespace
+
+int main() {
+    Log::SetLevel(Log::Level::Error);
+    XrCallBudget::Configure("wait=1:0,render=8:0");
+
+    std::atomic<bool> running{true};
+    std::atomic<uint64_t> waitCalls{0};
+    std::thread pacer(Pacer, std::cref(running), &waitCalls);
+
+    // Three render calls a frame, with the events phase in between as the frame loop has it.
+    const Clock::time_point start = Clock::now();
+    while (Clock::now() - start < std::chrono::milliseconds(1100)) {
+        XrCallBudget::SetPhase(XrCallPhase::Events);
+        XrCallBudget::SetPhase(XrCallPhase::Render);
+        for (int call = 0; call < 3; call++) {
+            XrCallBudget::Record("xrLocateViews(m_session, &viewLocateInfo, &viewState, viewCapacityInput, &viewCountOutput, m_views.data())",
+                                 std::chrono::microseconds(10));
+        }
+        XrCallBudget::EndFrame();
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    running.store(false);
+    pacer.join();
+
+    const std::map<std::string, double> metrics = Metrics::Snapshot();
+    auto value = [&metrics](const char* name) {
+        auto it = metrics.find(name);
+        return EXPECT(it != metrics.end()) ? it->second : -1.0;
+    };
+    printf("per frame: %.3f render calls, %.3f wait calls, %.3f xrWaitFrame, %.3f events calls; %llu waits\n",
+           value("xr.render.calls_per_frame"), value("xr.wait.calls_per_frame"), value("xrcall.xrWaitFrame.per_frame"),
+           value("xr.events.calls_per_frame"), (unsigned long long)waitCalls.load());
+    EXPECT(value("xr.render.calls_per_frame") == 3.0);
+    EXPECT(value("xr.render.us_per_frame") == 30.0);
+    EXPECT(value("xr.events.calls_per_frame") == 0.0);
+    EXPECT(value("xr.wait.calls_per_frame") > 0.1);
+    EXPECT(value("xr.wait.calls_per_frame") == value("xrcall.xrWaitFrame.per_frame"));
+    EXPECT(value("xrcall.xrLocateViews.per_frame") == 3.0);
+    return HostTest::Result();
+}
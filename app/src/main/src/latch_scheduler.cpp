@@ -0,0 +1,122 @@
+/*
+    just-in-time latch.
+*/
+#include "pch.h"
+#include "common.h"
+#include "latch_scheduler.h"
+#include "metrics.h"
+
+namespace {
+const int64_t kMsNs = 1000000;
+const int64_t kBaseMarginNs = 2 * kMsNs;
+const int64_t kMaxMarginNs = 8 * kMsNs;
+// Until the first frames are measured.
+const int64_t kInitialCostNs = 3 * kMsNs;
+
+int64_t MonotonicNs() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+}  // namespace
+
+void LatchScheduler::Initialize(XrInstance instance, bool extensionEnabled, bool sleep, float leadMs) {
+    m_instance = instance;
+    m_sleep = sleep;
+    m_leadNs = (int64_t)(leadMs * kMsNs);
+    m_marginNs = kBaseMarginNs;
+    m_convertTime = nullptr;
+    if (extensionEnabled) {
+        CHECK_XRCMD(xrGetInstanceProcAddr(instance, "xrConvertTimeToTimespecTimeKHR", (PFN_xrVoidFunction*)&m_convertTime));
+    }
+    Log::Write(Log::Level::Info, Fmt("latch scheduler: %s", IsSleeping() ? "just in time" : (sleep ? "early, no " XR_KHR_CONVERT_TIMESPEC_TIME_EXTENSION_NAME : "early")));
+}
+
+int64_t LatchScheduler::Cost() const {
+    if (m_costCount < 8) {
+        return kInitialCostNs;
+    }
+    std::array<int64_t, kCostSamples> sorted = m_cost;
+    const int n = std::min(m_costCount, kCostSamples);
+    std::nth_element(sorted.begin(), sorted.begin() + n * 9 / 10, sorted.begin() + n);
+    return sorted[n * 9 / 10];
+}
+
+void LatchScheduler::WaitToLatch(XrTime displayTime, XrDuration displayPeriod) {
+    m_latchNs = 0;
+    m_displayNs = 0;
+    m_periodNs = displayPeriod;
+    m_sleepStartNs = MonotonicNs();
+    m_sleptNs = 0;
+    timespec display{};
+    if (m_convertTime == nullptr || XR_FAILED(m_convertTime(m_instance, displayTime, &display))) {
+        return;
+    }
+    m_displayNs = (int64_t)display.tv_sec * 1000000000 + display.tv_nsec;
+    if (!m_sleep) {
+        return;
+    }
+
+    const int64_t leadNs = m_leadNs > 0 ? m_leadNs : displayPeriod;
+    const int64_t wakeNs = m_displayNs - leadNs - Cost() - m_marginNs;
+    const int64_t sleepNs = std::min<int64_t>(wakeNs - m_sleepStartNs, displayPeriod);
+    if (sleepNs > 0) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(sleepNs));
+        m_sleptNs = MonotonicNs() - m_sleepStartNs;
+    }
+}
+
+void LatchScheduler::Latched(bool frameValid, float frameWaitMs) {
+    const int64_t nowNs = MonotonicNs();
+    m_latchNs = nowNs;
+    if (!frameValid || m_displayNs == 0) {
+        return;
+    }
+    const int64_t arrivalNs = nowNs - (int64_t)(frameWaitMs * kMsNs);
+    m_sleepMs += m_sleptNs / 1e6;
+    m_ageMs += (m_displayNs - arrivalNs) / 1e6;
+    // Every period spent sleeping after the shown frame arrived would otherwise have shown a frame one period older.
+    const int64_t freshNs = std::min(arrivalNs, m_sleepStartNs + m_sleptNs) - m_sleepStartNs;
+    if (freshNs > 0 && m_periodNs > 0) {
+        m_gainMs += ((freshNs + m_periodNs - 1) / m_periodNs) * m_periodNs / 1e6;
+    }
+    m_frames++;
+}
+
+void LatchScheduler::Submitted() {
+    if (m_latchNs == 0) {
+        return;
+    }
+    const int64_t nowNs = MonotonicNs();
+    m_cost[m_costCount % kCostSamples] = nowNs - m_latchNs;
+    m_costCount++;
+    m_latchNs = 0;
+
+    if (m_displayNs != 0) {
+        const int64_t deadlineNs = m_displayNs - (m_leadNs > 0 ? m_leadNs : m_periodNs);
+        if (nowNs > deadlineNs) {
+            m_late++;
+            m_marginNs = std::min(m_marginNs + kMsNs, kMaxMarginNs);
+        } else {
+            m_marginNs = std::max(m_marginNs - kMsNs / 20, kBaseMarginNs);
+        }
+    }
+
+    if (m_windowStartNs == 0) {
+        m_windowStartNs = nowNs;
+    }
+    if (nowNs - m_windowStartNs < 1000 * kMsNs) {
+        return;
+    }
+    const double frames = std::max<double>(m_frames, 1);
+    Metrics::Set("frame.jit_sleep_ms", m_sleepMs / frames);
+    Metrics::Set("frame.jit_cost_ms", Cost() / 1e6);
+    Metrics::Set("frame.jit_margin_ms", m_marginNs / 1e6);
+    Metrics::Set("frame.jit_late", m_late);
+    Metrics::Set("frame.jit_gain_ms", m_gainMs / frames);
+    Metrics::Set("cxr.frame_age_ms", m_ageMs / frames);
+    m_windowStartNs = nowNs;
+    m_frames = 0;
+    m_late = 0;
+    m_sleepMs = m_ageMs = m_gainMs = 0;
+}
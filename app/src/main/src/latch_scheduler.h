@@ -0,0 +1,65 @@
+/*
+    just-in-time latch, adb shell setprop debug.xr.jitLatch 1.
+    by default the render thread latches a CloudXR frame right after xrBeginFrame, so the frame shown is
+    whatever had arrived by then, even when a newer one arrives a few milliseconds later with time left
+    to blit it. instead the render thread sleeps until
+        predicted display time - compositor lead - blit and submit cost - margin
+    and latches then. the cost is learned on the render thread: the 90th percentile of the time from the
+    latch returning to xrEndFrame returning, over the last frames. the lead defaults to one display period,
+    adb shell setprop debug.xr.latchLeadMs overrides it.
+
+    safety: the sleep is never longer than one display period; a frame submitted after its deadline widens
+    the margin by a millisecond, up to 8 ms, and on-time frames narrow it again slowly. without
+    XR_KHR_convert_timespec_time there is no display time to schedule against and the latch stays early.
+
+    whether sleeping or not, once a second to Metrics: frame.jit_sleep_ms, frame.jit_cost_ms,
+    frame.jit_margin_ms, frame.jit_late, cxr.frame_age_ms (arrival of the shown frame to its display time)
+    and frame.jit_gain_ms (how much newer the shown frame is than the one queued when the sleep began).
+*/
+#pragma once
+
+#include <array>
+
+class LatchScheduler {
+public:
+    static const char* Extension() { return XR_KHR_CONVERT_TIMESPEC_TIME_EXTENSION_NAME; }
+
+    // extensionEnabled: the instance was created with Extension(). sleep: debug.xr.jitLatch.
+    void Initialize(XrInstance instance, bool extensionEnabled, bool sleep, float leadMs);
+    bool IsSleeping() const { return m_sleep && m_convertTime != nullptr; }
+
+    // Render thread, right before LatchFrame.
+    void WaitToLatch(XrTime displayTime, XrDuration displayPeriod);
+    // Right after LatchFrame; frameWaitMs is how long the latched frame had been queued, see FrameDrain.
+    void Latched(bool frameValid, float frameWaitMs);
+    // Right after xrEndFrame, on frames that latched.
+    void Submitted();
+
+private:
+    static const int kCostSamples = 64;
+
+    int64_t Cost() const;
+
+    XrInstance m_instance{XR_NULL_HANDLE};
+    PFN_xrConvertTimeToTimespecTimeKHR m_convertTime{nullptr};
+    bool m_sleep{false};
+    int64_t m_leadNs{0};
+    int64_t m_marginNs{0};
+
+    // This frame, CLOCK_MONOTONIC nanoseconds; m_latchNs is 0 when nothing was latched.
+    int64_t m_displayNs{0};
+    int64_t m_periodNs{0};
+    int64_t m_sleepStartNs{0};
+    int64_t m_sleptNs{0};
+    int64_t m_latchNs{0};
+
+    std::array<int64_t, kCostSamples> m_cost{};
+    int m_costCount{0};
+
+    int64_t m_windowStartNs{0};
+    uint32_t m_frames{0};
+    uint32_t m_late{0};
+    double m_sleepMs{0};
+    double m_ageMs{0};
+    double m_gainMs{0};
+};
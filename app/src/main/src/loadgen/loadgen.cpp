@@ -0,0 +1,346 @@
+/*
+    load generator for server capacity planning, built as an executable with CXR_LOADGEN=1.
+    runs N simulated clients in one process against a CloudXR server, or against the stand-in when
+    CXR_STANDIN=1 is set as well. every client is a regular CloudXRClient started with StartLoadClient:
+    tracking goes through SetSenserPoseState and GetTrackingState, frames through LatchFrame and
+    ReleaseFrame, and stats through PollStats, so the load is the same the headset client generates,
+    minus rendering, audio and OpenXR. frames are latched and released without a blit.
+
+    each client gets its own surfaceless EGL context, a tracking thread that plays back recorded head
+    motion (or a synthetic sway) at the configured rate, and a latch thread. every second the stats of
+    all clients are polled. at the end a per-client and aggregate report is printed: latched frames per
+    second, stream fps and drops as reported by the server, and p50/p95/p99 of the local latch wait and
+    of the reported frame delivery time.
+
+    usage: cloudxr_loadgen -s <server> [-n clients] [-t seconds] [-r tracking hz] [-m motion file]
+                           [-w eye width] [-h eye height] [-f fps] [-v]
+    the motion file has one sample per line, "<seconds> px py pz qx qy qz qw", as a head pose in
+    meters and a unit quaternion. it is looped, with each client starting at a different offset so
+    the clients do not move in lockstep.
+*/
+#include "pch.h"
+#include "common.h"
+#include "cloudXRClient.h"
+#include "egl_context.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct LoadOptions {
+    std::string server;
+    uint32_t clients{1};
+    uint32_t seconds{60};
+    float trackingHz{90.0f};
+    std::string motionPath;
+    uint32_t width{1920};
+    uint32_t height{1920};
+    float fps{72.0f};
+    bool verbose{false};
+};
+
+struct MotionSample {
+    double time;
+    XrPosef pose;
+};
+
+std::vector<MotionSample> LoadMotion(const std::string& path) {
+    std::vector<MotionSample> motion;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        MotionSample sample{};
+        XrPosef& pose = sample.pose;
+        if (fields >> sample.time >> pose.position.x >> pose.position.y >> pose.position.z >> pose.orientation.x >> pose.orientation.y >>
+            pose.orientation.z >> pose.orientation.w) {
+            motion.push_back(sample);
+        }
+    }
+    return motion;
+}
+
+// Recorded motion looped from offset, or a slow yaw sway with a little head bob.
+XrPosef SamplePose(const std::vector<MotionSample>& motion, double time, double offset) {
+    if (motion.size() < 2) {
+        const double t = time + offset;
+        const float yaw = 0.5f * (float)sin(t * 0.8);
+        XrPosef pose{};
+        pose.orientation = {0.0f, sinf(yaw / 2), 0.0f, cosf(yaw / 2)};
+        pose.position = {0.05f * (float)sin(t * 1.3), 0.02f * (float)sin(t * 2.1), 0.0f};
+        return pose;
+    }
+    const double start = motion.front().time;
+    const double length = motion.back().time - start;
+    const double t = start + (length > 0 ? fmod(time + offset * length, length) : 0.0);
+    const auto next = std::upper_bound(motion.begin(), motion.end(), t, [](double value, const MotionSample& s) { return value < s.time; });
+    if (next == motion.begin() || next == motion.end()) {
+        return next == motion.end() ? motion.back().pose : motion.front().pose;
+    }
+    // Nearest previous sample, recordings are dense enough that interpolating is not worth it here.
+    return (next - 1)->pose;
+}
+
+struct ClientReport {
+    uint64_t latched{0};
+    uint64_t notReady{0};
+    std::vector<float> latchWaitMs;
+    std::vector<float> deliveryMs;
+    double fpsSum{0};
+    double kbpsSum{0};
+    uint32_t statsSeconds{0};
+    uint32_t packetsDropped{0};
+    uint32_t packetsLost{0};
+};
+
+struct LoadClient {
+    uint32_t index{0};
+    CloudXRClient client;
+    EglContext egl;
+    std::thread tracking;
+    std::thread latching;
+    std::mutex reportMutex;
+    ClientReport report;
+};
+
+void TrackingLoop(LoadClient* lc, const LoadOptions& options, const std::vector<MotionSample>& motion, const std::atomic<bool>& running) {
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / options.trackingHz));
+    const double offset = options.clients > 1 ? (double)lc->index / options.clients : 0.0;
+    const auto start = Clock::now();
+    auto next = start;
+    XrPosef previous = SamplePose(motion, 0.0, offset);
+    while (running.load(std::memory_order_acquire)) {
+        const double time = std::chrono::duration<double>(Clock::now() - start).count();
+        XrPosef pose = SamplePose(motion, time, offset);
+        const float dt = 1.0f / options.trackingHz;
+        XrVector3f linearVelocity{(pose.position.x - previous.position.x) / dt, (pose.position.y - previous.position.y) / dt,
+                                  (pose.position.z - previous.position.z) / dt};
+        XrVector3f angularVelocity{};
+        // Controllers held in front of the head, as the headset reports them when idle.
+        std::vector<XrPosef> handPose(2, pose);
+        handPose[0].position.x -= 0.2f;
+        handPose[1].position.x += 0.2f;
+        for (XrPosef& hand : handPose) {
+            hand.position.y -= 0.3f;
+            hand.position.z -= 0.3f;
+        }
+        lc->client.SetSenserPoseState(pose, linearVelocity, angularVelocity, handPose, 0.063f);
+        previous = pose;
+
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void LatchLoop(LoadClient* lc, const std::atomic<bool>& running) {
+    if (!lc->egl.MakeCurrent()) {
+        Log::Write(Log::Level::Error, Fmt("loadgen: client %u eglMakeCurrent failed: 0x%x", lc->index, eglGetError()));
+        return;
+    }
+    while (running.load(std::memory_order_acquire)) {
+        if (!lc->client.IsStreaming()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        cxrFramesLatched latched{};
+        const auto latchStart = Clock::now();
+        const bool valid = lc->client.LatchFrame(&latched);
+        const float waitMs = std::chrono::duration<float, std::milli>(Clock::now() - latchStart).count();
+        {
+            std::lock_guard<std::mutex> lock(lc->reportMutex);
+            if (valid) {
+                lc->report.latched++;
+                lc->report.latchWaitMs.push_back(waitMs);
+            } else {
+                lc->report.notReady++;
+            }
+        }
+        if (valid) {
+            lc->client.ReleaseFrame(&latched);
+        }
+    }
+    lc->egl.ReleaseCurrent();
+}
+
+float Percentile(std::vector<float> values, float p) {
+    if (values.empty()) {
+        return 0.0f;
+    }
+    const size_t n = std::min(values.size() - 1, (size_t)(p / 100.0f * values.size()));
+    std::nth_element(values.begin(), values.begin() + n, values.end());
+    return values[n];
+}
+
+void PrintRow(const char* name, const ClientReport& report, double seconds) {
+    printf("%-8s %8.1f %8.1f %8u %8u %8.0f %7.2f %7.2f %7.2f %7.2f %7.2f %7.2f\n", name, report.latched / seconds,
+           report.statsSeconds ? report.fpsSum / report.statsSeconds : 0.0, report.packetsDropped, report.packetsLost,
+           report.statsSeconds ? report.kbpsSum / report.statsSeconds : 0.0, Percentile(report.latchWaitMs, 50),
+           Percentile(report.latchWaitMs, 95), Percentile(report.latchWaitMs, 99), Percentile(report.deliveryMs, 50),
+           Percentile(report.deliveryMs, 95), Percentile(report.deliveryMs, 99));
+}
+
+bool ParseOptions(int argc, char** argv, LoadOptions* options) {
+    int opt;
+    while ((opt = getopt(argc, argv, "s:n:t:r:m:w:h:f:v")) != -1) {
+        switch (opt) {
+            case 's': options->server = optarg; break;
+            case 'n': options->clients = (uint32_t)std::max(1, atoi(optarg)); break;
+            case 't': options->seconds = (uint32_t)std::max(1, atoi(optarg)); break;
+            case 'r': options->trackingHz = std::max(1.0f, (float)atof(optarg)); break;
+            case 'm': options->motionPath = optarg; break;
+            case 'w': options->width = (uint32_t)std::max(16, atoi(optarg)); break;
+            case 'h': options->height = (uint32_t)std::max(16, atoi(optarg)); break;
+            case 'f': options->fps = std::max(1.0f, (float)atof(optarg)); break;
+            case 'v': options->verbose = true; break;
+            default: return false;
+        }
+    }
+    return !options->server.empty();
+}
+
+cxrDeviceDesc LoadDeviceDesc(const LoadOptions& options) {
+    // What GetDeviceDesc reports for a headset without the FOV extension, minus audio.
+    cxrDeviceDesc desc{};
+    desc.deliveryType = cxrDeliveryType_Stereo_RGB;
+    desc.width = options.width;
+    desc.height = options.height;
+    desc.fps = options.fps;
+    desc.ipd = 0.063f;
+    desc.predOffset = -0.02f;
+    desc.receiveAudio = false;
+    desc.sendAudio = false;
+    desc.posePollFreq = 0;
+    desc.ctrlType = cxrControllerType_OculusTouch;
+    desc.maxResFactor = 1.0f;
+    for (int i = 0; i < 2; i++) {
+        desc.proj[i][0] = -1.09130836f;
+        desc.proj[i][1] = 1.09130836f;
+        desc.proj[i][2] = -1.09130836f;
+        desc.proj[i][3] = 1.09130836f;
+    }
+    return desc;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    LoadOptions options;
+    if (!ParseOptions(argc, argv, &options)) {
+        fprintf(stderr, "usage: %s -s <server> [-n clients] [-t seconds] [-r tracking hz] [-m motion file] [-w width] [-h height] [-f fps] [-v]\n",
+                argv[0]);
+        return 1;
+    }
+    if (!options.verbose) {
+        Log::SetLevel(Log::Level::Warning);
+    }
+
+    std::vector<MotionSample> motion;
+    if (!options.motionPath.empty()) {
+        motion = LoadMotion(options.motionPath);
+        if (motion.size() < 2) {
+            fprintf(stderr, "loadgen: no usable motion in %s\n", options.motionPath.c_str());
+            return 1;
+        }
+    }
+    printf("loadgen: %u clients -> %s for %us, %ux%u@%.0f, tracking %.0f Hz from %s\n", options.clients, options.server.c_str(), options.seconds,
+           options.width, options.height, options.fps, options.trackingHz,
+           motion.empty() ? "synthetic motion" : options.motionPath.c_str());
+
+    const cxrDeviceDesc deviceDesc = LoadDeviceDesc(options);
+    std::atomic<bool> running{true};
+    std::vector<std::unique_ptr<LoadClient>> clients;
+    for (uint32_t i = 0; i < options.clients; i++) {
+        std::unique_ptr<LoadClient> lc(new LoadClient);
+        lc->index = i;
+        // The receiver shares this context, so it has to be current while the receiver is created.
+        if (!lc->egl.Create() || !lc->egl.MakeCurrent()) {
+            fprintf(stderr, "loadgen: client %u: no EGL context\n", i);
+            return 1;
+        }
+        cxrGraphicsContext context{};
+        context.type = cxrGraphicsContext_GLES;
+        context.egl.display = lc->egl.display;
+        context.egl.context = lc->egl.context;
+        const bool started = lc->client.StartLoadClient(options.server, deviceDesc, context);
+        lc->egl.ReleaseCurrent();
+        if (!started) {
+            fprintf(stderr, "loadgen: client %u failed to start\n", i);
+            return 1;
+        }
+        lc->tracking = std::thread(TrackingLoop, lc.get(), std::cref(options), std::cref(motion), std::cref(running));
+        lc->latching = std::thread(LatchLoop, lc.get(), std::cref(running));
+        clients.push_back(std::move(lc));
+    }
+
+    const auto start = Clock::now();
+    for (uint32_t second = 1; second <= options.seconds; second++) {
+        std::this_thread::sleep_until(start + std::chrono::seconds(second));
+        for (auto& lc : clients) {
+            if (!lc->client.IsStreaming()) {
+                continue;
+            }
+            cxrConnectionStats stats{};
+            if (!lc->client.PollStats(&stats)) {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(lc->reportMutex);
+            ClientReport& report = lc->report;
+            report.statsSeconds++;
+            report.fpsSum += stats.framesPerSecond;
+            report.kbpsSum += stats.bandwidthUtilizationKbps;
+            report.deliveryMs.push_back(stats.frameDeliveryTime);
+            report.packetsDropped = stats.totalPacketsDropped;
+            report.packetsLost = stats.totalPacketsLost;
+        }
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    running.store(false, std::memory_order_release);
+    for (auto& lc : clients) {
+        lc->tracking.join();
+        lc->latching.join();
+        lc->egl.MakeCurrent();
+        lc->client.StopLoadClient();
+        lc->egl.ReleaseCurrent();
+    }
+
+    printf("%-8s %8s %8s %8s %8s %8s %7s %7s %7s %7s %7s %7s\n", "client", "latch/s", "fps", "dropped", "lost", "kbps", "wait50", "wait95",
+           "wait99", "dlvr50", "dlvr95", "dlvr99");
+    ClientReport total;
+    uint32_t streaming = 0;
+    for (auto& lc : clients) {
+        const ClientReport& report = lc->report;
+        PrintRow(std::to_string(lc->index).c_str(), report, seconds);
+        streaming += report.statsSeconds > 0 ? 1 : 0;
+        total.latched += report.latched;
+        total.notReady += report.notReady;
+        total.latchWaitMs.insert(total.latchWaitMs.end(), report.latchWaitMs.begin(), report.latchWaitMs.end());
+        total.deliveryMs.insert(total.deliveryMs.end(), report.deliveryMs.begin(), report.deliveryMs.end());
+        total.fpsSum += report.fpsSum;
+        total.kbpsSum += report.kbpsSum;
+        total.statsSeconds += report.statsSeconds;
+        total.packetsDropped += report.packetsDropped;
+        total.packetsLost += report.packetsLost;
+    }
+    // Aggregate row: frames and bandwidth summed over clients, fps averaged, percentiles over all samples.
+    total.kbpsSum *= streaming;
+    PrintRow("all", total, seconds);
+    printf("loadgen: %u of %u clients streamed, %.0f frames/s total, %.0f kbps total\n", streaming, options.clients, total.latched / seconds,
+           total.statsSeconds ? total.kbpsSum / total.statsSeconds : 0.0);
+
+    for (auto& lc : clients) {
+        lc->egl.Destroy();
+    }
+    return streaming == options.clients ? 0 : 2;
+}
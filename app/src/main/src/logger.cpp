@@ -58,9 +58,10 @@ void Write(Level severity, const std::string& msg) {
         << "[" << severityName[severity] << "] " << msg << std::endl;
 
     std::lock_guard<std::mutex> lock(g_logLock);  // Ensure output is serialized
-    ((severity == Level::Error) ? std::clog : std::cout) << out.str();
+    const std::string text = out.str();
+    ((severity == Level::Error) ? std::clog : std::cout) << text;
 
-    const char* message = out.str().c_str();
+    const char* message = text.c_str();
 
 #if defined(_WIN32)
     OutputDebugStringA(message);
@@ -10,6 +10,7 @@
 #include "graphicsplugin.h"
 #include "openxr_program.h"
 #include "cloudXRClient.h"
+#include "gl_program_cache.h"
 
 namespace {
 
@@ -18,6 +19,30 @@ void ShowHelp() {
     Log::Write(Log::Level::Info, "adb shell setprop debug.xr.formFactor Hmd|Handheld");
     Log::Write(Log::Level::Info, "adb shell setprop debug.xr.viewConfiguration Stereo|Mono");
     Log::Write(Log::Level::Info, "adb shell setprop debug.xr.blendMode Opaque|Additive|AlphaBlend");
+    Log::Write(Log::Level::Info, "adb shell setprop debug.xr.callBudget events=<calls>:<us>,input=..,wait=..,render=..");
+    Log::Write(Log::Level::Info, "adb shell setprop debug.xr.programCache off|<directory>");
+    Log::Write(Log::Level::Info, "adb shell setprop debug.xr.pipelined 0|1");
+    Log::Write(Log::Level::Info, "adb shell setprop debug.xr.maxResScale 1.0-2.0");
+    Log::Write(Log::Level::Info, "adb shell setprop debug.xr.foveation auto|off|low|medium|high");
+    Log::Write(Log::Level::Info, "adb shell setprop debug.xr.jitLatch 0|1");
+    Log::Write(Log::Level::Info, "adb shell setprop debug.xr.latchLeadMs <ms>");
+    Log::Write(Log::Level::Info, "adb shell setprop debug.xr.hitch <display periods>|0");
+    Log::Write(Log::Level::Info, "adb shell setprop debug.xr.memBudgetMb <MB>|0");
+    Log::Write(Log::Level::Info, "adb shell setprop debug.xr.clickToPhoton 0|1");
+    Log::Write(Log::Level::Info, "adb shell setprop debug.xr.mirror 0|1|2 (2: desktop window, linux simulator)");
+    Log::Write(Log::Level::Info, "adb shell setprop debug.xr.sessionExport 0|1");
+    Log::Write(Log::Level::Info, "adb shell setprop debug.xr.throttle 0|1");
+    Log::Write(Log::Level::Info, "adb shell setprop debug.xr.throttleDelayMs <ms>");
+}
+
+void UpdateProgramCacheFromSystemProperties(const char* internalDataPath) {
+    char value[PROP_VALUE_MAX] = {};
+    __system_property_get("debug.xr.programCache", value);
+    if (strcmp(value, "off") == 0) {
+        GlProgramCache::SetDirectory({});
+    } else {
+        GlProgramCache::SetDirectory(value[0] != '\0' ? value : (internalDataPath != nullptr ? internalDataPath : ""));
+    }
 }
 
 bool UpdateOptionsFromSystemProperties(Options& options) {
@@ -26,6 +51,65 @@ bool UpdateOptionsFromSystemProperties(Options& options) {
         options.GraphicsPlugin = value;
     }
 
+    value[0] = '\0';
+    __system_property_get("debug.xr.pipelined", value);
+    options.Pipelined = atoi(value) != 0;
+
+    value[0] = '\0';
+    if (__system_property_get("debug.xr.maxResScale", value) != 0) {
+        options.MaxResolutionScale = std::min(std::max((float)atof(value), 1.0f), 2.0f);
+    }
+
+    value[0] = '\0';
+    if (__system_property_get("debug.xr.foveation", value) != 0) {
+        options.Foveation = value;
+    }
+
+    value[0] = '\0';
+    __system_property_get("debug.xr.jitLatch", value);
+    options.JitLatch = atoi(value) != 0;
+
+    value[0] = '\0';
+    if (__system_property_get("debug.xr.latchLeadMs", value) != 0) {
+        options.LatchLeadMs = std::max((float)atof(value), 0.0f);
+    }
+
+    value[0] = '\0';
+    if (__system_property_get("debug.xr.hitch", value) != 0) {
+        options.HitchPeriods = std::max((float)atof(value), 0.0f);
+    }
+
+    value[0] = '\0';
+    if (__system_property_get("debug.xr.memBudgetMb", value) != 0) {
+        options.MemoryBudgetMb = std::max((float)atof(value), 0.0f);
+    }
+
+    value[0] = '\0';
+    __system_property_get("debug.xr.clickToPhoton", value);
+    options.ClickToPhoton = atoi(value) != 0;
+
+    value[0] = '\0';
+    __system_property_get("debug.xr.mirror", value);
+    options.Mirror = atoi(value);
+
+    value[0] = '\0';
+    __system_property_get("debug.xr.sessionExport", value);
+    options.SessionExport = atoi(value) != 0;
+
+    value[0] = '\0';
+    if (__system_property_get("debug.xr.throttle", value) != 0) {
+        options.Throttle = atoi(value) != 0;
+    }
+
+    value[0] = '\0';
+    if (__system_property_get("debug.xr.throttleDelayMs", value) != 0) {
+        options.ThrottleDelayMs = std::max((float)atof(value), 0.0f);
+    }
+
+    value[0] = '\0';
+    __system_property_get("debug.xr.callBudget", value);
+    XrCallBudget::Configure(value);
+
     // Check for required parameters.
     if (options.GraphicsPlugin.empty()) {
         Log::Write(Log::Level::Warning, "GraphicsPlugin Default OpenGLES");
@@ -90,12 +174,18 @@ static void app_handle_cmd(struct android_app* app, int32_t cmd) {
             Log::Write(Log::Level::Info, "surfaceCreated()");
             Log::Write(Log::Level::Info, "    APP_CMD_INIT_WINDOW");
             appState->NativeWindow = app->window;
+            if (appState->program.get()) {
+                appState->program->SetMirrorWindow(app->window);
+            }
             break;
         }
         case APP_CMD_TERM_WINDOW: {
             Log::Write(Log::Level::Info, "surfaceDestroyed()");
             Log::Write(Log::Level::Info, "    APP_CMD_TERM_WINDOW");
             appState->NativeWindow = NULL;
+            if (appState->program.get()) {
+                appState->program->SetMirrorWindow(nullptr);
+            }
             break;
         }
     }
@@ -131,6 +221,7 @@ void android_main(struct android_app* app) {
         if (!UpdateOptionsFromSystemProperties(*options)) {
             return;
         }
+        UpdateProgramCacheFromSystemProperties(app->activity->internalDataPath);
 
         std::shared_ptr<PlatformData> data = std::make_shared<PlatformData>();
         data->applicationVM = app->activity->vm;
@@ -0,0 +1,238 @@
+/*
+    process memory monitor and GL allocation accounting.
+*/
+#include "pch.h"
+#include "common.h"
+#include "memory_monitor.h"
+#include "metrics.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+const auto kTrendWindow = std::chrono::minutes(10);
+const auto kTrendMinimum = std::chrono::minutes(5);
+const auto kTrendWarningSpacing = std::chrono::minutes(5);
+const double kTrendWarningMbPerMinute = 2.0;
+
+const int kCategoryCount = (int)GpuMemory::Category::Count;
+std::atomic<int64_t> g_gpuBytes[kCategoryCount];
+std::atomic<int32_t> g_gpuObjects[kCategoryCount];
+
+double ToMb(int64_t bytes) { return bytes / 1048576.0; }
+
+bool ReadFile(const char* path, std::string* text) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    *text = contents.str();
+    return true;
+}
+
+}  // namespace
+
+namespace GpuMemory {
+const char* ToString(Category category) {
+    switch (category) {
+        case Category::Swapchain:
+            return "swapchain";
+        case Category::Depth:
+            return "depth";
+        case Category::Texture:
+            return "texture";
+        case Category::Framebuffer:
+            return "framebuffer";
+        default:
+            return "unknown";
+    }
+}
+
+void Add(Category category, int64_t bytes, int32_t objects) {
+    g_gpuBytes[(int)category].fetch_add(bytes, std::memory_order_relaxed);
+    g_gpuObjects[(int)category].fetch_add(objects, std::memory_order_relaxed);
+}
+
+int64_t Bytes(Category category) { return g_gpuBytes[(int)category].load(std::memory_order_relaxed); }
+
+int32_t Objects(Category category) { return g_gpuObjects[(int)category].load(std::memory_order_relaxed); }
+}  // namespace GpuMemory
+
+bool MemoryMonitor::Parse(const std::string& text, MemorySample* sample) {
+    // Lines are "<Name>: <value> kB".
+    double pssKb = -1, rssKb = -1, swapKb = 0;
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+        const std::string name = line.substr(0, colon);
+        const double kb = atof(line.c_str() + colon + 1);
+        if (name == "Pss") {
+            pssKb = kb;
+        } else if (name == "Rss" || name == "VmRSS") {
+            rssKb = kb;
+        } else if (name == "SwapPss" || name == "VmSwap") {
+            swapKb = kb;
+        }
+    }
+    if (rssKb < 0) {
+        return false;
+    }
+    sample->rssMb = rssKb / 1024.0;
+    sample->pssMb = (pssKb < 0 ? rssKb : pssKb) / 1024.0;
+    sample->swapMb = swapKb / 1024.0;
+    return true;
+}
+
+bool MemoryMonitor::ReadProcess(MemorySample* sample) {
+    std::string text;
+    // smaps_rollup is Linux 4.14 and later.
+    return (ReadFile("/proc/self/smaps_rollup", &text) && Parse(text, sample)) ||
+           (ReadFile("/proc/self/status", &text) && Parse(text, sample));
+}
+
+void MemoryMonitor::AddShedder(const std::string& name, std::function<void()> shed) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_shedders.push_back({name, std::move(shed)});
+}
+
+void MemoryMonitor::Start(float budgetMb, Clock::duration interval) {
+    Stop();
+    m_budgetMb = budgetMb;
+    m_interval = interval;
+    m_pss.clear();
+    m_lastTrendWarning = Clock::time_point{};
+    m_overBudget = false;
+    if (interval > Clock::duration::zero()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = true;
+        }
+        m_thread = std::thread(&MemoryMonitor::Run, this);
+    }
+    if (budgetMb > 0) {
+        Log::Write(Log::Level::Info, Fmt("memory monitor: budget %.0f MB", budgetMb));
+    } else {
+        Log::Write(Log::Level::Info, "memory monitor: no budget");
+    }
+}
+
+void MemoryMonitor::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_wake.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void MemoryMonitor::Update() {
+    const uint32_t done = m_shedDone.load(std::memory_order_relaxed);
+    if (done == m_shedRequested.load(std::memory_order_acquire)) {
+        return;
+    }
+    Shedder shedder;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (done >= m_shedders.size()) {
+            return;
+        }
+        shedder = m_shedders[done];
+    }
+    Log::Write(Log::Level::Warning, Fmt("memory monitor: over budget, shedding %s", shedder.name.c_str()));
+    shedder.shed();
+    m_shedDone.store(done + 1, std::memory_order_release);
+    Metrics::Set("mem.shed", done + 1);
+}
+
+void MemoryMonitor::Sample(const MemorySample& sample, Clock::time_point now) {
+    Metrics::Set("mem.pss_mb", sample.pssMb);
+    Metrics::Set("mem.rss_mb", sample.rssMb);
+    Metrics::Set("mem.swap_mb", sample.swapMb);
+    for (int i = 0; i < kCategoryCount; i++) {
+        const auto category = (GpuMemory::Category)i;
+        const std::string name = GpuMemory::ToString(category);
+        if (category == GpuMemory::Category::Framebuffer) {
+            // Framebuffer objects hold no memory of their own, their attachments are counted where they were allocated.
+            Metrics::Set("mem.gl_" + name + "s", GpuMemory::Objects(category));
+        } else {
+            Metrics::Set("mem.gl_" + name + "_mb", ToMb(GpuMemory::Bytes(category)));
+        }
+    }
+
+    m_pss.emplace_back(now, sample.pssMb);
+    while (now - m_pss.front().first > kTrendWindow) {
+        m_pss.pop_front();
+    }
+    const double trend = TrendMbPerMinute();
+    Metrics::Set("mem.trend_mb_min", trend);
+    if (trend > kTrendWarningMbPerMinute &&
+        (m_lastTrendWarning == Clock::time_point{} || now - m_lastTrendWarning >= kTrendWarningSpacing)) {
+        m_lastTrendWarning = now;
+        Log::Write(Log::Level::Warning, Fmt("memory monitor: PSS %.0f MB, growing %.1f MB/min over the last %lld s, GL swapchain %.0f MB, texture %.0f MB",
+                                            sample.pssMb, trend,
+                                            (long long)std::chrono::duration_cast<std::chrono::seconds>(now - m_pss.front().first).count(),
+                                            ToMb(GpuMemory::Bytes(GpuMemory::Category::Swapchain)),
+                                            ToMb(GpuMemory::Bytes(GpuMemory::Category::Texture))));
+    }
+
+    if (m_budgetMb <= 0) {
+        return;
+    }
+    const bool overBudget = sample.pssMb + sample.swapMb > m_budgetMb;
+    if (overBudget != m_overBudget) {
+        m_overBudget = overBudget;
+        Log::Write(overBudget ? Log::Level::Warning : Log::Level::Info,
+                   Fmt("memory monitor: PSS %.0f MB + swap %.0f MB, %s the %.0f MB budget", sample.pssMb, sample.swapMb,
+                       overBudget ? "over" : "back under", m_budgetMb));
+    }
+    // One feature at a time, and only once the render thread has shed the last one, so each has a sample to take effect.
+    const uint32_t requested = m_shedRequested.load(std::memory_order_relaxed);
+    size_t shedders;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        shedders = m_shedders.size();
+    }
+    if (overBudget && requested == m_shedDone.load(std::memory_order_acquire) && requested < shedders) {
+        m_shedRequested.store(requested + 1, std::memory_order_release);
+    }
+}
+
+double MemoryMonitor::TrendMbPerMinute() const {
+    if (m_pss.size() < 2 || m_pss.back().first - m_pss.front().first < kTrendMinimum) {
+        return 0;
+    }
+    // Least squares slope, in minutes from the first sample so the sums stay small.
+    double sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+    for (const auto& point : m_pss) {
+        const double x = std::chrono::duration<double>(point.first - m_pss.front().first).count() / 60.0;
+        sumX += x;
+        sumY += point.second;
+        sumXX += x * x;
+        sumXY += x * point.second;
+    }
+    const double n = (double)m_pss.size();
+    const double denominator = n * sumXX - sumX * sumX;
+    return denominator > 0 ? (n * sumXY - sumX * sumY) / denominator : 0;
+}
+
+void MemoryMonitor::Run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_running) {
+        lock.unlock();
+        MemorySample sample;
+        if (ReadProcess(&sample)) {
+            Sample(sample, Clock::now());
+        }
+        lock.lock();
+        m_wake.wait_for(lock, m_interval, [this]() { return !m_running; });
+    }
+}
@@ -0,0 +1,96 @@
+/*
+    process memory monitor, adb shell setprop debug.xr.memBudgetMb <MB> to shed optional features past a budget, 0 for none (default).
+    a monitor thread reads PSS, RSS and swapped PSS from /proc/self/smaps_rollup every 5 seconds (VmRSS and VmSwap from
+    /proc/self/status on kernels without the rollup) and publishes them as mem.* Metrics, next to the client's own GL
+    allocations that the code creating them accounts with GpuMemory::Add: swapchain images (estimated, the runtime allocates
+    them), depth buffers, intermediate textures and framebuffer objects.
+
+    a least squares fit over the last 10 minutes of PSS warns, at most every 5 minutes, while the process grows by more than
+    2 MB a minute. once PSS plus swapped PSS is over the budget, each sample sheds one more registered feature, in the order
+    they were registered; the render thread runs the shedder from Update(). the monitor never brings a shed feature back.
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace GpuMemory {
+enum class Category { Swapchain, Depth, Texture, Framebuffer, Count };
+
+const char* ToString(Category category);
+
+// Any thread, wherever the object is created or deleted: bytes and objects are negative for a release.
+void Add(Category category, int64_t bytes, int32_t objects = 1);
+
+int64_t Bytes(Category category);
+int32_t Objects(Category category);
+}  // namespace GpuMemory
+
+struct MemorySample {
+    double pssMb{0};
+    double rssMb{0};
+    double swapMb{0};
+};
+
+class MemoryMonitor {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Reads smaps_rollup text (Pss:, Rss:, SwapPss:) or status text (VmRSS:, VmSwap:, PSS is then RSS).
+    // False when the text has no resident size.
+    static bool Parse(const std::string& text, MemorySample* sample);
+    static bool ReadProcess(MemorySample* sample);
+
+    ~MemoryMonitor() { Stop(); }
+
+    // Any thread, any time. shed runs on the render thread and should free what the feature holds.
+    void AddShedder(const std::string& name, std::function<void()> shed);
+
+    // budgetMb 0 only monitors. interval zero starts no thread, the caller takes the samples.
+    void Start(float budgetMb, Clock::duration interval = std::chrono::seconds(5));
+    void Stop();
+
+    // Render thread, once a frame: runs a shedder the monitor asked for. One atomic load otherwise.
+    void Update();
+
+    // Monitor thread, or a test driving its own clock: takes one sample.
+    void Sample(const MemorySample& sample, Clock::time_point now);
+
+    // PSS growth over the window in MB per minute, 0 until the window holds 5 minutes of samples.
+    double TrendMbPerMinute() const;
+    uint32_t ShedCount() const { return m_shedDone.load(std::memory_order_acquire); }
+
+private:
+    struct Shedder {
+        std::string name;
+        std::function<void()> shed;
+    };
+
+    void Run();
+
+    float m_budgetMb{0};
+    Clock::duration m_interval{};
+    std::thread m_thread;
+    bool m_running{false};
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+
+    // Guarded by m_mutex.
+    std::vector<Shedder> m_shedders;
+
+    // Monitor thread.
+    std::deque<std::pair<Clock::time_point, double>> m_pss;
+    Clock::time_point m_lastTrendWarning{};
+    bool m_overBudget{false};
+
+    // Monitor thread asks, render thread sheds: shedders [m_shedDone, m_shedRequested) are pending.
+    std::atomic<uint32_t> m_shedRequested{0};
+    std::atomic<uint32_t> m_shedDone{0};
+};
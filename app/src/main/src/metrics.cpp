@@ -0,0 +1,55 @@
+/*
+    process wide named metrics.
+*/
+#include "pch.h"
+#include "common.h"
+#include "metrics.h"
+
+#include <mutex>
+#include <sstream>
+
+namespace {
+std::mutex g_metricsLock;
+std::map<std::string, double> g_metrics;
+}  // namespace
+
+namespace Metrics {
+void Set(const std::string& name, double value) {
+    std::lock_guard<std::mutex> lock(g_metricsLock);
+    g_metrics[name] = value;
+}
+
+void Add(const std::string& name, double delta) {
+    std::lock_guard<std::mutex> lock(g_metricsLock);
+    g_metrics[name] += delta;
+}
+
+std::map<std::string, double> Snapshot() {
+    std::lock_guard<std::mutex> lock(g_metricsLock);
+    return g_metrics;
+}
+
+void Write(Log::Level severity) {
+    const std::map<std::string, double> metrics = Snapshot();
+
+    // The map is sorted, so every group is a contiguous run of entries.
+    std::string group;
+    std::ostringstream line;
+    for (const auto& metric : metrics) {
+        const size_t dot = metric.first.find('.');
+        const std::string metricGroup = metric.first.substr(0, dot);
+        if (metricGroup != group) {
+            if (!group.empty()) {
+                Log::Write(severity, line.str());
+            }
+            group = metricGroup;
+            line.str("");
+            line << "metrics " << group << ":";
+        }
+        line << " " << (dot == std::string::npos ? metric.first : metric.first.substr(dot + 1)) << "=" << metric.second;
+    }
+    if (!group.empty()) {
+        Log::Write(severity, line.str());
+    }
+}
+}  // namespace Metrics
@@ -0,0 +1,19 @@
+/*
+    process wide named metrics, written to the log once a second by the cloudxr client thread.
+    names are "<group>.<name>", e.g. "xr.render.calls_per_frame"; each group is logged on one line.
+*/
+#pragma once
+
+#include <map>
+#include <string>
+#include "logger.h"
+
+namespace Metrics {
+void Set(const std::string& name, double value);
+
+void Add(const std::string& name, double delta);
+
+std::map<std::string, double> Snapshot();
+
+void Write(Log::Level severity);
+}  // namespace Metrics
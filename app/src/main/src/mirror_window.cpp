@@ -0,0 +1,492 @@
+/*
+    mirror window.
+*/
+#include "pch.h"
+#include "common.h"
+#include "mirror_window.h"
+#include "metrics.h"
+#include "hitch_monitor.h"
+#include "memory_monitor.h"
+#include "desktop_mirror.h"
+
+#include <dlfcn.h>
+
+namespace {
+// How long before the predicted swap the newest frame is picked; the letterbox blit is short.
+const auto kPickLead = std::chrono::milliseconds(3);
+// APP_CMD_TERM_WINDOW has to return promptly even when the mirror thread is stuck in a swap.
+const auto kSurfaceChangeTimeout = std::chrono::milliseconds(500);
+}  // namespace
+
+MirrorWindow::~MirrorWindow() { Stop(); }
+
+void MirrorWindow::SetNativeWindow(EGLNativeWindowType window) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mWindow = window;
+    if (mRunning && !mDesktop) {
+        mSurfaceChanged.wait_for(lock, kSurfaceChangeTimeout, [this, window]() { return !mRunning || mSurfaceWindow == window; });
+    }
+}
+
+bool MirrorWindow::Start(uint32_t eyeWidth, uint32_t eyeHeight, bool desktop) {
+    Stop();
+    mDesktop = desktop;
+    mCreateSync = (PFNEGLCREATESYNCKHRPROC)eglGetProcAddress("eglCreateSyncKHR");
+    mDestroySync = (PFNEGLDESTROYSYNCKHRPROC)eglGetProcAddress("eglDestroySyncKHR");
+    mClientWaitSync = (PFNEGLCLIENTWAITSYNCKHRPROC)eglGetProcAddress("eglClientWaitSyncKHR");
+    mWaitSync = (PFNEGLWAITSYNCKHRPROC)eglGetProcAddress("eglWaitSyncKHR");
+    if (mCreateSync == nullptr || mDestroySync == nullptr || mClientWaitSync == nullptr) {
+        Log::Write(Log::Level::Error, "mirror: EGL_KHR_fence_sync not available");
+        return false;
+    }
+    if (!mContext.CreateShared(eglGetCurrentDisplay(), eglGetCurrentContext())) {
+        return false;
+    }
+
+    // Half resolution per eye, side by side.
+    mWidth = eyeWidth / 2 * 2;
+    mHeight = eyeHeight / 2;
+    for (Slot& slot : mSlots) {
+        glGenTextures(1, &slot.texture);
+        glBindTexture(GL_TEXTURE_2D, slot.texture);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, mWidth, mHeight);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glGenFramebuffers(1, &slot.framebuffer);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, slot.framebuffer);
+        glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, slot.texture, 0);
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glGenFramebuffers(1, &mCopyFramebuffer);
+    GpuMemory::Add(GpuMemory::Category::Texture, kSlotCount * (int64_t)mWidth * mHeight * 4, kSlotCount);
+    GpuMemory::Add(GpuMemory::Category::Framebuffer, 0, kSlotCount + 1);
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRunning = true;
+        mLatest = -1;
+        mPresenting = -1;
+        mSequence = 0;
+        mShownSequence = 0;
+    }
+    mWriting = -1;
+    mThread = std::thread(&MirrorWindow::Run, this);
+    Log::Write(Log::Level::Info, Fmt("mirror: started, %d slots of %ux%u, %s fence waits, into %s", kSlotCount, mWidth, mHeight,
+                                     mWaitSync != nullptr ? "GPU" : "polled", mDesktop ? "a desktop window" : "the activity's window"));
+    return true;
+}
+
+void MirrorWindow::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mRunning && !mThread.joinable()) {
+            return;
+        }
+        mRunning = false;
+    }
+    mSurfaceChanged.notify_all();
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+    DestroySlots();
+    mContext.Destroy();
+    Log::Write(Log::Level::Info, "mirror: stopped");
+}
+
+bool MirrorWindow::IsRunning() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mRunning;
+}
+
+bool MirrorWindow::BeginFrame() {
+    EGLSyncKHR read = EGL_NO_SYNC_KHR;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mRunning || !mShowing) {
+            return false;
+        }
+        // With three slots there is always one that is neither the newest nor on screen.
+        for (int i = 0; i < kSlotCount && mWriting < 0; i++) {
+            if (i != mLatest && i != mPresenting) {
+                mWriting = i;
+            }
+        }
+        read = mSlots[mWriting].read;
+    }
+    // The mirror's last blit out of this slot has to finish before it is overwritten.
+    if (read != EGL_NO_SYNC_KHR) {
+        if (mWaitSync != nullptr) {
+            mWaitSync(mContext.display, read, 0);
+        } else if (mClientWaitSync(mContext.display, read, 0, 0) != EGL_CONDITION_SATISFIED_KHR) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mDropped++;
+            mWriting = -1;
+            return false;
+        }
+    }
+    return true;
+}
+
+void MirrorWindow::CopyEye(uint32_t eye, GLuint texture, const XrRect2Di& rect) {
+    if (mWriting < 0 || eye >= 2) {
+        return;
+    }
+    GLint drawFramebuffer = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+    const GLboolean scissor = glIsEnabled(GL_SCISSOR_TEST);
+    glDisable(GL_SCISSOR_TEST);
+
+    const GLint half = (GLint)mWidth / 2;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, mCopyFramebuffer);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mSlots[mWriting].framebuffer);
+    glBlitFramebuffer(rect.offset.x, rect.offset.y, rect.offset.x + rect.extent.width, rect.offset.y + rect.extent.height, (GLint)eye * half, 0,
+                      ((GLint)eye + 1) * half, mHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFramebuffer);
+    if (scissor) {
+        glEnable(GL_SCISSOR_TEST);
+    }
+}
+
+void MirrorWindow::EndFrame() {
+    if (mWriting < 0) {
+        return;
+    }
+    Slot& slot = mSlots[mWriting];
+    if (slot.written != EGL_NO_SYNC_KHR) {
+        mDestroySync(mContext.display, slot.written);
+    }
+    slot.written = mCreateSync(mContext.display, EGL_SYNC_FENCE_KHR, nullptr);
+    // Without a flush the mirror could wait on a fence that was never submitted.
+    glFlush();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mLatest >= 0 && mSlots[mLatest].sequence > mShownSequence) {
+        mDropped++;
+    }
+    slot.sequence = ++mSequence;
+    mLatest = mWriting;
+    mWriting = -1;
+}
+
+void MirrorWindow::Run() {
+    HitchMonitor::RegisterThread("mirror");
+    if (!mContext.MakeCurrent()) {
+        Log::Write(Log::Level::Error, Fmt("mirror: eglMakeCurrent failed: 0x%x", eglGetError()));
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRunning = false;
+        mSurfaceChanged.notify_all();
+        return;
+    }
+
+    if (mDesktop) {
+        RunDesktop();
+    } else {
+        RunWindow();
+    }
+
+    for (Slot& slot : mSlots) {
+        if (slot.readFramebuffer != 0) {
+            glDeleteFramebuffers(1, &slot.readFramebuffer);
+            slot.readFramebuffer = 0;
+        }
+    }
+    glFinish();
+    mContext.ReleaseCurrent();
+}
+
+void MirrorWindow::RunWindow() {
+    auto lastMetrics = Clock::now();
+    while (true) {
+        EGLNativeWindowType window;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (!mRunning) {
+                break;
+            }
+            window = mWindow;
+        }
+        if (window != mSurfaceWindow) {
+            UpdateSurface(window);
+        }
+
+        const auto now = Clock::now();
+        if (now - lastMetrics >= std::chrono::seconds(1)) {
+            lastMetrics = now;
+            PublishMetrics();
+        }
+
+        if (mSurface == EGL_NO_SURFACE) {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mSurfaceChanged.wait_for(lock, std::chrono::milliseconds(100), [this]() { return !mRunning || mWindow != mSurfaceWindow; });
+            continue;
+        }
+
+        // Pick the newest frame just before the predicted swap, so it is as fresh as the window allows.
+        std::this_thread::sleep_until(mLastSwap + mSwapPeriod - kPickLead);
+        const int present = Pick();
+        if (present < 0) {
+            // Nothing new: skip this swap, the window keeps showing the last frame.
+            mLastSwap += mSwapPeriod;
+            if (mLastSwap < now - mSwapPeriod) {
+                mLastSwap = now;
+            }
+            continue;
+        }
+
+        if (mWaitSync != nullptr) {
+            mWaitSync(mContext.display, mSlots[present].written, 0);
+        } else {
+            mClientWaitSync(mContext.display, mSlots[present].written, 0, EGL_FOREVER_KHR);
+        }
+        Present(mSlots[present]);
+        Release(present);
+
+        eglSwapBuffers(mContext.display, mSurface);
+        Swapped();
+    }
+
+    UpdateSurface(0);
+}
+
+void MirrorWindow::RunDesktop() {
+    void* library = dlopen("libdesktop_mirror.so", RTLD_NOW | RTLD_LOCAL);
+    if (library == nullptr) {
+        Log::Write(Log::Level::Error, Fmt("mirror: no desktop window, host/run_host.sh builds it: %s", dlerror()));
+        return;
+    }
+    auto create = reinterpret_cast<PFN_desktopMirrorCreate>(dlsym(library, "desktopMirrorCreate"));
+    auto destroy = reinterpret_cast<PFN_desktopMirrorDestroy>(dlsym(library, "desktopMirrorDestroy"));
+    auto nextSwapNanoseconds = reinterpret_cast<PFN_desktopMirrorNextSwapNanoseconds>(dlsym(library, "desktopMirrorNextSwapNanoseconds"));
+    auto frameNanoseconds = reinterpret_cast<PFN_desktopMirrorFrameNanoseconds>(dlsym(library, "desktopMirrorFrameNanoseconds"));
+    auto present = reinterpret_cast<PFN_desktopMirrorPresent>(dlsym(library, "desktopMirrorPresent"));
+    if (create == nullptr || destroy == nullptr || nextSwapNanoseconds == nullptr || frameNanoseconds == nullptr || present == nullptr) {
+        Log::Write(Log::Level::Error, "mirror: libdesktop_mirror.so is missing functions");
+        dlclose(library);
+        return;
+    }
+
+    // The window's GLX context and the mirror's EGL one are current in turn, never together.
+    mContext.ReleaseCurrent();
+    DesktopMirror* desktop = create(mWidth, mHeight);
+    mContext.MakeCurrent();
+    if (desktop == nullptr) {
+        Log::Write(Log::Level::Error, "mirror: no desktop window, is DISPLAY set?");
+        dlclose(library);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mShowing = true;
+    }
+    Log::Write(Log::Level::Info, "mirror: presenting into a desktop window");
+    mPixels.resize((size_t)mWidth * mHeight * 4);
+
+    auto lastMetrics = Clock::now();
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (!mRunning) {
+                break;
+            }
+        }
+        const auto now = Clock::now();
+        if (now - lastMetrics >= std::chrono::seconds(1)) {
+            lastMetrics = now;
+            PublishMetrics();
+        }
+
+        // The first swap the window predicts that leaves time to pick and read back a frame; without a
+        // swap the window's prediction stays where the last one left it.
+        mSwapPeriod = std::chrono::nanoseconds(frameNanoseconds(desktop));
+        Clock::time_point swap{std::chrono::nanoseconds(nextSwapNanoseconds(desktop))};
+        while (swap - kPickLead < now) {
+            swap += mSwapPeriod;
+        }
+        std::this_thread::sleep_until(swap - kPickLead);
+        const int slot = Pick();
+        if (slot < 0) {
+            continue;
+        }
+
+        // Read back on the CPU, so the fence is waited for here.
+        mClientWaitSync(mContext.display, mSlots[slot].written, 0, EGL_FOREVER_KHR);
+        BindRead(mSlots[slot]);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(0, 0, mWidth, mHeight, GL_RGBA, GL_UNSIGNED_BYTE, mPixels.data());
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+        Release(slot);
+
+        mContext.ReleaseCurrent();
+        const bool open = present(desktop, mPixels.data(), (int)mWidth, (int)mHeight);
+        mContext.MakeCurrent();
+        if (!open) {
+            Log::Write(Log::Level::Info, "mirror: desktop window closed");
+            break;
+        }
+        std::lock_guard<std::mutex> lock(mMutex);
+        mShown++;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mShowing = false;
+    }
+    mContext.ReleaseCurrent();
+    destroy(desktop);
+    mContext.MakeCurrent();
+    dlclose(library);
+    mPixels = std::vector<uint8_t>();
+}
+
+int MirrorWindow::Pick() {
+    // The newest frame, unless it was shown already; the render thread leaves it alone until Release.
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mLatest < 0 || mSlots[mLatest].sequence <= mShownSequence) {
+        return -1;
+    }
+    mPresenting = mLatest;
+    mShownSequence = mSlots[mLatest].sequence;
+    return mPresenting;
+}
+
+void MirrorWindow::Release(int slot) {
+    // The render thread overwrites the slot once what was just submitted reading it is done.
+    EGLSyncKHR read = mCreateSync(mContext.display, EGL_SYNC_FENCE_KHR, nullptr);
+    glFlush();
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mSlots[slot].read != EGL_NO_SYNC_KHR) {
+        mDestroySync(mContext.display, mSlots[slot].read);
+    }
+    mSlots[slot].read = read;
+    mPresenting = -1;
+}
+
+void MirrorWindow::UpdateSurface(EGLNativeWindowType window) {
+    if (mSurface != EGL_NO_SURFACE) {
+        mContext.MakeCurrent();
+        eglDestroySurface(mContext.display, mSurface);
+        mSurface = EGL_NO_SURFACE;
+        Log::Write(Log::Level::Info, "mirror: window surface destroyed");
+    }
+    if (window != 0) {
+        EGLint surfaceType = 0;
+        eglGetConfigAttrib(mContext.display, mContext.config, EGL_SURFACE_TYPE, &surfaceType);
+        if ((surfaceType & EGL_WINDOW_BIT) == 0) {
+            Log::Write(Log::Level::Error, "mirror: the render context's EGLConfig has no window surfaces");
+        } else {
+            mSurface = eglCreateWindowSurface(mContext.display, mContext.config, window, nullptr);
+            if (mSurface == EGL_NO_SURFACE) {
+                Log::Write(Log::Level::Error, Fmt("mirror: eglCreateWindowSurface failed: 0x%x", eglGetError()));
+            } else if (!eglMakeCurrent(mContext.display, mSurface, mSurface, mContext.context)) {
+                Log::Write(Log::Level::Error, Fmt("mirror: eglMakeCurrent on the window failed: 0x%x", eglGetError()));
+                mContext.MakeCurrent();
+                eglDestroySurface(mContext.display, mSurface);
+                mSurface = EGL_NO_SURFACE;
+            } else {
+                eglSwapInterval(mContext.display, 1);
+                mLastSwap = Clock::now();
+                Log::Write(Log::Level::Info, "mirror: presenting into the window");
+            }
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mSurfaceWindow = window;
+        mShowing = mSurface != EGL_NO_SURFACE;
+    }
+    mSurfaceChanged.notify_all();
+}
+
+void MirrorWindow::BindRead(Slot& slot) {
+    if (slot.readFramebuffer == 0) {
+        glGenFramebuffers(1, &slot.readFramebuffer);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, slot.readFramebuffer);
+        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, slot.texture, 0);
+    } else {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, slot.readFramebuffer);
+    }
+}
+
+void MirrorWindow::Present(Slot& slot) {
+    BindRead(slot);
+
+    EGLint width = 0;
+    EGLint height = 0;
+    eglQuerySurface(mContext.display, mSurface, EGL_WIDTH, &width);
+    eglQuerySurface(mContext.display, mSurface, EGL_HEIGHT, &height);
+    // Letterboxed, the aspect of both eyes side by side.
+    GLint w = width;
+    GLint h = (GLint)((int64_t)width * mHeight / mWidth);
+    if (h > height) {
+        h = height;
+        w = (GLint)((int64_t)height * mWidth / mHeight);
+    }
+    const GLint x = (width - w) / 2;
+    const GLint y = (height - h) / 2;
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glViewport(0, 0, width, height);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glBlitFramebuffer(0, 0, mWidth, mHeight, x, y, x + w, y + h, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
+void MirrorWindow::Swapped() {
+    // ksGpuWindow_SwapBuffers' smoothing: a swap close to the predicted one moves the prediction only a
+    // little, so the next pick time does not jitter with the scheduler.
+    Clock::time_point now = Clock::now();
+    const Clock::duration error = now - mLastSwap - mSwapPeriod;
+    if (error < mSwapPeriod * 3 / 4 && error > -mSwapPeriod * 3 / 4) {
+        // Close to a vsync: track the window's refresh, which need not be the headset's.
+        mSwapPeriod += error / 16;
+        now = mLastSwap + mSwapPeriod + error / 40;
+    }
+    mLastSwap = now;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mShown++;
+}
+
+void MirrorWindow::PublishMetrics() {
+    const double periodMs = std::chrono::duration<double, std::milli>(mSwapPeriod).count();
+    std::lock_guard<std::mutex> lock(mMutex);
+    Metrics::Set("mirror.shown", (double)mShown);
+    Metrics::Set("mirror.dropped", (double)mDropped);
+    Metrics::Set("mirror.swap_period_ms", periodMs);
+    mShown = 0;
+    mDropped = 0;
+}
+
+void MirrorWindow::DestroySlots() {
+    // Render thread, after the mirror thread exited.
+    for (Slot& slot : mSlots) {
+        for (EGLSyncKHR* sync : {&slot.written, &slot.read}) {
+            if (*sync != EGL_NO_SYNC_KHR) {
+                mDestroySync(mContext.display, *sync);
+                *sync = EGL_NO_SYNC_KHR;
+            }
+        }
+        if (slot.framebuffer != 0) {
+            glDeleteFramebuffers(1, &slot.framebuffer);
+        }
+        if (slot.texture != 0) {
+            glDeleteTextures(1, &slot.texture);
+        }
+        slot = Slot{};
+    }
+    if (mCopyFramebuffer != 0) {
+        glDeleteFramebuffers(1, &mCopyFramebuffer);
+        mCopyFramebuffer = 0;
+        GpuMemory::Add(GpuMemory::Category::Texture, -kSlotCount * (int64_t)mWidth * mHeight * 4, -kSlotCount);
+        GpuMemory::Add(GpuMemory::Category::Framebuffer, 0, -(kSlotCount + 1));
+    }
+    mWriting = -1;
+}
@@ -0,0 +1,118 @@
+/*
+    optional mirror of what the headset shows, for QA sessions and runs against the fake runtime, from a
+    thread and EGL context of its own, in the render context's share group. adb shell setprop
+    debug.xr.mirror 1 presents into the activity's window (any EGL native window), with the render
+    context's EGLConfig, so only where that config supports windows; 2 presents into a desktop window
+    on the linux simulator, see desktop_mirror.h.
+
+    once per frame, right after the stream was blitted into the eye images, the render thread copies
+    both eyes at half resolution side by side into one of three mirror textures and publishes it with
+    an EGL fence, like the blit worker (blit_worker.h) does the other way around. the render thread never
+    waits for the mirror: with three slots there is always one that is neither the newest nor on screen,
+    and the mirror's fence on that slot is waited for on the GPU (EGL_KHR_wait_sync), or the copy is
+    skipped when it has not passed yet.
+
+    the mirror thread is paced by the window's swaps: swap interval 1, and the next swap time predicted
+    from the smoothed time of the last one; shortly before it the newest published frame is letterboxed
+    into the window and swapped, without a new frame the swap is skipped. the desktop window is a
+    gfxwrapper ksGpuWindow, which predicts its own swaps (ksGpuWindow_GetNextSwapTimeNanoseconds) and
+    gets each frame read back, its GLX context cannot share with the EGL one. the activity's window
+    is predicted the same way here: gfxwrapper's android window would take over the app glue callbacks.
+    frames published but never shown, or not copied, count as dropped; the counts go to Metrics every
+    second (mirror.*).
+*/
+#pragma once
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES3/gl3.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "egl_context.h"
+
+class MirrorWindow {
+public:
+    static const int kSlotCount = 3;
+
+    ~MirrorWindow();
+
+    // Main thread: the window to present into, 0 when it goes away. Returns once the mirror stopped using
+    // the previous one, as android requires before APP_CMD_TERM_WINDOW returns.
+    void SetNativeWindow(EGLNativeWindowType window);
+
+    // Render thread, with the render context current: mirror eyeWidth x eyeHeight eye images, into a
+    // desktop window rather than the activity's with desktop.
+    bool Start(uint32_t eyeWidth, uint32_t eyeHeight, bool desktop = false);
+    void Stop();
+    bool IsRunning() const;
+
+    // Render thread, around copying the eyes of one frame from the images the stream was blitted into.
+    // Nothing to copy when BeginFrame returns false: no window, or no slot the mirror is done with.
+    bool BeginFrame();
+    void CopyEye(uint32_t eye, GLuint texture, const XrRect2Di& rect);
+    void EndFrame();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Slot {
+        GLuint texture = 0;
+        GLuint framebuffer = 0;      // render context object
+        GLuint readFramebuffer = 0;  // mirror context object
+        uint64_t sequence = 0;
+        EGLSyncKHR written = EGL_NO_SYNC_KHR;  // signalled when the render thread's copy is done
+        EGLSyncKHR read = EGL_NO_SYNC_KHR;     // signalled when the mirror's blit out of it is done
+    };
+
+    void Run();
+    void RunWindow();
+    void RunDesktop();
+    int Pick();
+    void Release(int slot);
+    void UpdateSurface(EGLNativeWindowType window);
+    void BindRead(Slot& slot);
+    void Present(Slot& slot);
+    void Swapped();
+    void PublishMetrics();
+    void DestroySlots();
+
+    EglContext mContext;
+    PFNEGLCREATESYNCKHRPROC mCreateSync = nullptr;
+    PFNEGLDESTROYSYNCKHRPROC mDestroySync = nullptr;
+    PFNEGLCLIENTWAITSYNCKHRPROC mClientWaitSync = nullptr;
+    PFNEGLWAITSYNCKHRPROC mWaitSync = nullptr;  // optional, EGL_KHR_wait_sync
+
+    uint32_t mWidth = 0;   // both eyes
+    uint32_t mHeight = 0;
+    bool mDesktop = false;
+    std::thread mThread;
+
+    mutable std::mutex mMutex;
+    std::condition_variable mSurfaceChanged;
+    bool mRunning = false;
+    EGLNativeWindowType mWindow = 0;
+    EGLNativeWindowType mSurfaceWindow = 0;  // the window the mirror thread last saw
+    bool mShowing = false;                    // it has a surface for it
+    Slot mSlots[kSlotCount];
+    int mLatest = -1;
+    int mPresenting = -1;
+    uint64_t mSequence = 0;
+    uint64_t mShownSequence = 0;
+
+    // Render thread only.
+    int mWriting = -1;
+    GLuint mCopyFramebuffer = 0;
+
+    // Mirror thread only.
+    EGLSurface mSurface = EGL_NO_SURFACE;
+    std::vector<uint8_t> mPixels;  // a frame read back for the desktop window
+    Clock::time_point mLastSwap{};
+    Clock::duration mSwapPeriod = std::chrono::microseconds(16667);
+
+    // Per-second counters, published to Metrics by the mirror thread.
+    uint64_t mShown = 0;
+    uint64_t mDropped = 0;
+};
@@ -425,148 +425,65 @@ GLint glGetInteger(GLenum pname) {
     return i;
 }
 
-static bool GlCheckExtension(const char *extension) {
+// The extension strings are read once per GlInitExtensions, every check used to query them all again.
+static const char **glExtensionNames;
+static GLint glExtensionCount;
+
+static void GlLoadExtensionNames() {
 #if defined(OS_WINDOWS) || defined(OS_LINUX)
     PFNGLGETSTRINGIPROC glGetStringi = (PFNGLGETSTRINGIPROC)GetExtension("glGetStringi");
 #endif
-    GL(const GLint numExtensions = glGetInteger(GL_NUM_EXTENSIONS));
-    for (int i = 0; i < numExtensions; i++) {
-        GL(const GLubyte *string = glGetStringi(GL_EXTENSIONS, i));
-        if (strcmp((const char *)string, extension) == 0) {
+    GL(glExtensionCount = glGetInteger(GL_NUM_EXTENSIONS));
+    glExtensionNames = (const char **)malloc(glExtensionCount * sizeof(const char *));
+    for (int i = 0; i < glExtensionCount; i++) {
+        GL(glExtensionNames[i] = (const char *)glGetStringi(GL_EXTENSIONS, i));
+    }
+}
+
+static void GlFreeExtensionNames() {
+    free(glExtensionNames);
+    glExtensionNames = NULL;
+    glExtensionCount = 0;
+}
+
+static bool GlCheckExtension(const char *extension) {
+    for (int i = 0; i < glExtensionCount; i++) {
+        if (glExtensionNames[i] != NULL && strcmp(glExtensionNames[i], extension) == 0) {
             return true;
         }
     }
     return false;
 }
 
-#if defined(OS_WINDOWS) || defined(OS_LINUX)
+#define GL_DEFINE_ENTRY_POINT(type, name, procName) ksGlEntryPoint name##_entry = {procName, NULL};
+#define GL_RESOLVE_ENTRY_POINT(type, name, procName) GlResolveEntryPoint(&name##_entry);
+#define GL_RESET_ENTRY_POINT(type, name, procName) name##_entry.proc = NULL;
 
-PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers;
-PFNGLDELETEFRAMEBUFFERSPROC glDeleteFramebuffers;
-PFNGLBINDFRAMEBUFFERPROC glBindFramebuffer;
-PFNGLBLITFRAMEBUFFERPROC glBlitFramebuffer;
-PFNGLGENRENDERBUFFERSPROC glGenRenderbuffers;
-PFNGLDELETERENDERBUFFERSPROC glDeleteRenderbuffers;
-PFNGLBINDRENDERBUFFERPROC glBindRenderbuffer;
-PFNGLISRENDERBUFFERPROC glIsRenderbuffer;
-PFNGLRENDERBUFFERSTORAGEPROC glRenderbufferStorage;
-PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC glRenderbufferStorageMultisample;
-PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC glRenderbufferStorageMultisampleEXT;
-PFNGLFRAMEBUFFERRENDERBUFFERPROC glFramebufferRenderbuffer;
-PFNGLFRAMEBUFFERTEXTURE2DPROC glFramebufferTexture2D;
-PFNGLFRAMEBUFFERTEXTURELAYERPROC glFramebufferTextureLayer;
-PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC glFramebufferTexture2DMultisampleEXT;
-PFNGLFRAMEBUFFERTEXTUREMULTIVIEWOVRPROC glFramebufferTextureMultiviewOVR;
-PFNGLFRAMEBUFFERTEXTUREMULTISAMPLEMULTIVIEWOVRPROC glFramebufferTextureMultisampleMultiviewOVR;
-PFNGLCHECKFRAMEBUFFERSTATUSPROC glCheckFramebufferStatus;
-
-PFNGLGENBUFFERSPROC glGenBuffers;
-PFNGLDELETEBUFFERSPROC glDeleteBuffers;
-PFNGLBINDBUFFERPROC glBindBuffer;
-PFNGLBINDBUFFERBASEPROC glBindBufferBase;
-PFNGLBUFFERDATAPROC glBufferData;
-PFNGLBUFFERSUBDATAPROC glBufferSubData;
-PFNGLBUFFERSTORAGEPROC glBufferStorage;
-PFNGLMAPBUFFERPROC glMapBuffer;
-PFNGLMAPBUFFERRANGEPROC glMapBufferRange;
-PFNGLUNMAPBUFFERPROC glUnmapBuffer;
-
-PFNGLGENVERTEXARRAYSPROC glGenVertexArrays;
-PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays;
-PFNGLBINDVERTEXARRAYPROC glBindVertexArray;
-PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer;
-PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor;
-PFNGLDISABLEVERTEXATTRIBARRAYPROC glDisableVertexAttribArray;
-PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray;
+void (*GlResolveEntryPoint(ksGlEntryPoint *entryPoint))(void) {
+    void (*proc)(void) = (void (*)(void))GetExtension(entryPoint->name);
+    entryPoint->proc = proc;
+    return proc;
+}
 
-#if defined(OS_WINDOWS)
-PFNGLACTIVETEXTUREPROC glActiveTexture;
-PFNGLTEXIMAGE3DPROC glTexImage3D;
-PFNGLCOMPRESSEDTEXIMAGE2DPROC glCompressedTexImage2D;
-PFNGLCOMPRESSEDTEXIMAGE3DPROC glCompressedTexImage3D;
-PFNGLTEXSUBIMAGE3DPROC glTexSubImage3D;
-PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC glCompressedTexSubImage2D;
-PFNGLCOMPRESSEDTEXSUBIMAGE3DPROC glCompressedTexSubImage3D;
+#if defined(GL_ENTRY_POINTS)
+GL_ENTRY_POINTS(GL_DEFINE_ENTRY_POINT)
+GL_ENTRY_POINTS_EXTRA(GL_DEFINE_ENTRY_POINT)
+
+// A new context may hand out different entry points, so they are all looked up again.
+static void GlInitEntryPoints() {
+#if GFXWRAPPER_EAGER_GL_ENTRY_POINTS
+    GL_ENTRY_POINTS(GL_RESOLVE_ENTRY_POINT)
+    GL_ENTRY_POINTS_EXTRA(GL_RESOLVE_ENTRY_POINT)
+#else
+    GL_ENTRY_POINTS(GL_RESET_ENTRY_POINT)
+    GL_ENTRY_POINTS_EXTRA(GL_RESET_ENTRY_POINT)
+#endif
+}
 #endif
-PFNGLTEXSTORAGE2DPROC glTexStorage2D;
-PFNGLTEXSTORAGE3DPROC glTexStorage3D;
-PFNGLTEXIMAGE2DMULTISAMPLEPROC glTexImage2DMultisample;
-PFNGLTEXIMAGE3DMULTISAMPLEPROC glTexImage3DMultisample;
-PFNGLTEXSTORAGE2DMULTISAMPLEPROC glTexStorage2DMultisample;
-PFNGLTEXSTORAGE3DMULTISAMPLEPROC glTexStorage3DMultisample;
-PFNGLGENERATEMIPMAPPROC glGenerateMipmap;
-PFNGLBINDIMAGETEXTUREPROC glBindImageTexture;
-
-PFNGLCREATEPROGRAMPROC glCreateProgram;
-PFNGLDELETEPROGRAMPROC glDeleteProgram;
-PFNGLCREATESHADERPROC glCreateShader;
-PFNGLDELETESHADERPROC glDeleteShader;
-PFNGLSHADERSOURCEPROC glShaderSource;
-PFNGLCOMPILESHADERPROC glCompileShader;
-PFNGLGETSHADERIVPROC glGetShaderiv;
-PFNGLGETSHADERINFOLOGPROC glGetShaderInfoLog;
-PFNGLUSEPROGRAMPROC glUseProgram;
-PFNGLATTACHSHADERPROC glAttachShader;
-PFNGLLINKPROGRAMPROC glLinkProgram;
-PFNGLGETPROGRAMIVPROC glGetProgramiv;
-PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog;
-PFNGLGETATTRIBLOCATIONPROC glGetAttribLocation;
-PFNGLBINDATTRIBLOCATIONPROC glBindAttribLocation;
-PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation;
-PFNGLGETUNIFORMBLOCKINDEXPROC glGetUniformBlockIndex;
-PFNGLGETPROGRAMRESOURCEINDEXPROC glGetProgramResourceIndex;
-PFNGLUNIFORMBLOCKBINDINGPROC glUniformBlockBinding;
-PFNGLSHADERSTORAGEBLOCKBINDINGPROC glShaderStorageBlockBinding;
-PFNGLPROGRAMUNIFORM1IPROC glProgramUniform1i;
-PFNGLUNIFORM1IPROC glUniform1i;
-PFNGLUNIFORM1IVPROC glUniform1iv;
-PFNGLUNIFORM2IVPROC glUniform2iv;
-PFNGLUNIFORM3IVPROC glUniform3iv;
-PFNGLUNIFORM4IVPROC glUniform4iv;
-PFNGLUNIFORM1FPROC glUniform1f;
-PFNGLUNIFORM1FVPROC glUniform1fv;
-PFNGLUNIFORM2FVPROC glUniform2fv;
-PFNGLUNIFORM3FVPROC glUniform3fv;
-PFNGLUNIFORM4FVPROC glUniform4fv;
-PFNGLUNIFORMMATRIX2FVPROC glUniformMatrix2fv;
-PFNGLUNIFORMMATRIX2X3FVPROC glUniformMatrix2x3fv;
-PFNGLUNIFORMMATRIX2X4FVPROC glUniformMatrix2x4fv;
-PFNGLUNIFORMMATRIX3X2FVPROC glUniformMatrix3x2fv;
-PFNGLUNIFORMMATRIX3FVPROC glUniformMatrix3fv;
-PFNGLUNIFORMMATRIX3X4FVPROC glUniformMatrix3x4fv;
-PFNGLUNIFORMMATRIX4X2FVPROC glUniformMatrix4x2fv;
-PFNGLUNIFORMMATRIX4X3FVPROC glUniformMatrix4x3fv;
-PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv;
-
-PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstanced;
-PFNGLDISPATCHCOMPUTEPROC glDispatchCompute;
-PFNGLMEMORYBARRIERPROC glMemoryBarrier;
-
-PFNGLGENQUERIESPROC glGenQueries;
-PFNGLDELETEQUERIESPROC glDeleteQueries;
-PFNGLISQUERYPROC glIsQuery;
-PFNGLBEGINQUERYPROC glBeginQuery;
-PFNGLENDQUERYPROC glEndQuery;
-PFNGLQUERYCOUNTERPROC glQueryCounter;
-PFNGLGETQUERYIVPROC glGetQueryiv;
-PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectiv;
-PFNGLGETQUERYOBJECTUIVPROC glGetQueryObjectuiv;
-PFNGLGETQUERYOBJECTI64VPROC glGetQueryObjecti64v;
-PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v;
-
-PFNGLFENCESYNCPROC glFenceSync;
-PFNGLCLIENTWAITSYNCPROC glClientWaitSync;
-PFNGLDELETESYNCPROC glDeleteSync;
-PFNGLISSYNCPROC glIsSync;
-
-PFNGLBLENDFUNCSEPARATEPROC glBlendFuncSeparate;
-PFNGLBLENDEQUATIONSEPARATEPROC glBlendEquationSeparate;
-
-PFNGLDEBUGMESSAGECONTROLPROC glDebugMessageControl;
-PFNGLDEBUGMESSAGECALLBACKPROC glDebugMessageCallback;
+
+#if defined(OS_WINDOWS) || defined(OS_LINUX)
 
 #if defined(OS_WINDOWS)
-PFNGLBLENDCOLORPROC glBlendColor;
 PFNWGLCHOOSEPIXELFORMATARBPROC wglChoosePixelFormatARB;
 PFNWGLCREATECONTEXTATTRIBSARBPROC wglCreateContextAttribsARB;
 PFNWGLSWAPINTERVALEXTPROC wglSwapIntervalEXT;
@@ -591,137 +508,9 @@ void GlBootstrapExtensions() {
 }
 
 void GlInitExtensions() {
-    glGenFramebuffers = (PFNGLGENFRAMEBUFFERSPROC)GetExtension("glGenFramebuffers");
-    glDeleteFramebuffers = (PFNGLDELETEFRAMEBUFFERSPROC)GetExtension("glDeleteFramebuffers");
-    glBindFramebuffer = (PFNGLBINDFRAMEBUFFERPROC)GetExtension("glBindFramebuffer");
-    glBlitFramebuffer = (PFNGLBLITFRAMEBUFFERPROC)GetExtension("glBlitFramebuffer");
-    glGenRenderbuffers = (PFNGLGENRENDERBUFFERSPROC)GetExtension("glGenRenderbuffers");
-    glDeleteRenderbuffers = (PFNGLDELETERENDERBUFFERSPROC)GetExtension("glDeleteRenderbuffers");
-    glBindRenderbuffer = (PFNGLBINDRENDERBUFFERPROC)GetExtension("glBindRenderbuffer");
-    glIsRenderbuffer = (PFNGLISRENDERBUFFERPROC)GetExtension("glIsRenderbuffer");
-    glRenderbufferStorage = (PFNGLRENDERBUFFERSTORAGEPROC)GetExtension("glRenderbufferStorage");
-    glRenderbufferStorageMultisample = (PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC)GetExtension("glRenderbufferStorageMultisample");
-    glRenderbufferStorageMultisampleEXT =
-        (PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC)GetExtension("glRenderbufferStorageMultisampleEXT");
-    glFramebufferRenderbuffer = (PFNGLFRAMEBUFFERRENDERBUFFERPROC)GetExtension("glFramebufferRenderbuffer");
-    glFramebufferTexture2D = (PFNGLFRAMEBUFFERTEXTURE2DPROC)GetExtension("glFramebufferTexture2D");
-    glFramebufferTextureLayer = (PFNGLFRAMEBUFFERTEXTURELAYERPROC)GetExtension("glFramebufferTextureLayer");
-    glFramebufferTexture2DMultisampleEXT =
-        (PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC)GetExtension("glFramebufferTexture2DMultisampleEXT");
-    glFramebufferTextureMultiviewOVR = (PFNGLFRAMEBUFFERTEXTUREMULTIVIEWOVRPROC)GetExtension("glFramebufferTextureMultiviewOVR");
-    glFramebufferTextureMultisampleMultiviewOVR =
-        (PFNGLFRAMEBUFFERTEXTUREMULTISAMPLEMULTIVIEWOVRPROC)GetExtension("glFramebufferTextureMultisampleMultiviewOVR");
-    glCheckFramebufferStatus = (PFNGLCHECKFRAMEBUFFERSTATUSPROC)GetExtension("glCheckFramebufferStatus");
-
-    glGenBuffers = (PFNGLGENBUFFERSPROC)GetExtension("glGenBuffers");
-    glDeleteBuffers = (PFNGLDELETEBUFFERSPROC)GetExtension("glDeleteBuffers");
-    glBindBuffer = (PFNGLBINDBUFFERPROC)GetExtension("glBindBuffer");
-    glBindBufferBase = (PFNGLBINDBUFFERBASEPROC)GetExtension("glBindBufferBase");
-    glBufferData = (PFNGLBUFFERDATAPROC)GetExtension("glBufferData");
-    glBufferSubData = (PFNGLBUFFERSUBDATAPROC)GetExtension("glBufferSubData");
-    glBufferStorage = (PFNGLBUFFERSTORAGEPROC)GetExtension("glBufferStorage");
-    glMapBuffer = (PFNGLMAPBUFFERPROC)GetExtension("glMapBuffer");
-    glMapBufferRange = (PFNGLMAPBUFFERRANGEPROC)GetExtension("glMapBufferRange");
-    glUnmapBuffer = (PFNGLUNMAPBUFFERPROC)GetExtension("glUnmapBuffer");
-
-    glGenVertexArrays = (PFNGLGENVERTEXARRAYSPROC)GetExtension("glGenVertexArrays");
-    glDeleteVertexArrays = (PFNGLDELETEVERTEXARRAYSPROC)GetExtension("glDeleteVertexArrays");
-    glBindVertexArray = (PFNGLBINDVERTEXARRAYPROC)GetExtension("glBindVertexArray");
-    glVertexAttribPointer = (PFNGLVERTEXATTRIBPOINTERPROC)GetExtension("glVertexAttribPointer");
-    glVertexAttribDivisor = (PFNGLVERTEXATTRIBDIVISORPROC)GetExtension("glVertexAttribDivisor");
-    glDisableVertexAttribArray = (PFNGLDISABLEVERTEXATTRIBARRAYPROC)GetExtension("glDisableVertexAttribArray");
-    glEnableVertexAttribArray = (PFNGLENABLEVERTEXATTRIBARRAYPROC)GetExtension("glEnableVertexAttribArray");
-
-#if defined(OS_WINDOWS)
-    glActiveTexture = (PFNGLACTIVETEXTUREPROC)GetExtension("glActiveTexture");
-    glTexImage3D = (PFNGLTEXIMAGE3DPROC)GetExtension("glTexImage3D");
-    glCompressedTexImage2D = (PFNGLCOMPRESSEDTEXIMAGE2DPROC)GetExtension("glCompressedTexImage2D ");
-    glCompressedTexImage3D = (PFNGLCOMPRESSEDTEXIMAGE3DPROC)GetExtension("glCompressedTexImage3D ");
-    glTexSubImage3D = (PFNGLTEXSUBIMAGE3DPROC)GetExtension("glTexSubImage3D");
-    glCompressedTexSubImage2D = (PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC)GetExtension("glCompressedTexSubImage2D");
-    glCompressedTexSubImage3D = (PFNGLCOMPRESSEDTEXSUBIMAGE3DPROC)GetExtension("glCompressedTexSubImage3D");
-#endif
-    glTexStorage2D = (PFNGLTEXSTORAGE2DPROC)GetExtension("glTexStorage2D");
-    glTexStorage3D = (PFNGLTEXSTORAGE3DPROC)GetExtension("glTexStorage3D");
-    glTexImage2DMultisample = (PFNGLTEXIMAGE2DMULTISAMPLEPROC)GetExtension("glTexImage2DMultisample");
-    glTexImage3DMultisample = (PFNGLTEXIMAGE3DMULTISAMPLEPROC)GetExtension("glTexImage3DMultisample");
-    glTexStorage2DMultisample = (PFNGLTEXSTORAGE2DMULTISAMPLEPROC)GetExtension("glTexStorage2DMultisample");
-    glTexStorage3DMultisample = (PFNGLTEXSTORAGE3DMULTISAMPLEPROC)GetExtension("glTexStorage3DMultisample");
-    glGenerateMipmap = (PFNGLGENERATEMIPMAPPROC)GetExtension("glGenerateMipmap");
-    glBindImageTexture = (PFNGLBINDIMAGETEXTUREPROC)GetExtension("glBindImageTexture");
-
-    glCreateProgram = (PFNGLCREATEPROGRAMPROC)GetExtension("glCreateProgram");
-    glDeleteProgram = (PFNGLDELETEPROGRAMPROC)GetExtension("glDeleteProgram");
-    glCreateShader = (PFNGLCREATESHADERPROC)GetExtension("glCreateShader");
-    glDeleteShader = (PFNGLDELETESHADERPROC)GetExtension("glDeleteShader");
-    glShaderSource = (PFNGLSHADERSOURCEPROC)GetExtension("glShaderSource");
-    glCompileShader = (PFNGLCOMPILESHADERPROC)GetExtension("glCompileShader");
-    glGetShaderiv = (PFNGLGETSHADERIVPROC)GetExtension("glGetShaderiv");
-    glGetShaderInfoLog = (PFNGLGETSHADERINFOLOGPROC)GetExtension("glGetShaderInfoLog");
-    glUseProgram = (PFNGLUSEPROGRAMPROC)GetExtension("glUseProgram");
-    glAttachShader = (PFNGLATTACHSHADERPROC)GetExtension("glAttachShader");
-    glLinkProgram = (PFNGLLINKPROGRAMPROC)GetExtension("glLinkProgram");
-    glGetProgramiv = (PFNGLGETPROGRAMIVPROC)GetExtension("glGetProgramiv");
-    glGetProgramInfoLog = (PFNGLGETPROGRAMINFOLOGPROC)GetExtension("glGetProgramInfoLog");
-    glGetAttribLocation = (PFNGLGETATTRIBLOCATIONPROC)GetExtension("glGetAttribLocation");
-    glBindAttribLocation = (PFNGLBINDATTRIBLOCATIONPROC)GetExtension("glBindAttribLocation");
-    glGetUniformLocation = (PFNGLGETUNIFORMLOCATIONPROC)GetExtension("glGetUniformLocation");
-    glGetUniformBlockIndex = (PFNGLGETUNIFORMBLOCKINDEXPROC)GetExtension("glGetUniformBlockIndex");
-    glProgramUniform1i = (PFNGLPROGRAMUNIFORM1IPROC)GetExtension("glProgramUniform1i");
-    glUniform1i = (PFNGLUNIFORM1IPROC)GetExtension("glUniform1i");
-    glUniform1iv = (PFNGLUNIFORM1IVPROC)GetExtension("glUniform1iv");
-    glUniform2iv = (PFNGLUNIFORM2IVPROC)GetExtension("glUniform2iv");
-    glUniform3iv = (PFNGLUNIFORM3IVPROC)GetExtension("glUniform3iv");
-    glUniform4iv = (PFNGLUNIFORM4IVPROC)GetExtension("glUniform4iv");
-    glUniform1f = (PFNGLUNIFORM1FPROC)GetExtension("glUniform1f");
-    glUniform1fv = (PFNGLUNIFORM1FVPROC)GetExtension("glUniform1fv");
-    glUniform2fv = (PFNGLUNIFORM2FVPROC)GetExtension("glUniform2fv");
-    glUniform3fv = (PFNGLUNIFORM3FVPROC)GetExtension("glUniform3fv");
-    glUniform4fv = (PFNGLUNIFORM4FVPROC)GetExtension("glUniform4fv");
-    glUniformMatrix2fv = (PFNGLUNIFORMMATRIX2FVPROC)GetExtension("glUniformMatrix3fv");
-    glUniformMatrix2x3fv = (PFNGLUNIFORMMATRIX2X3FVPROC)GetExtension("glUniformMatrix2x3fv");
-    glUniformMatrix2x4fv = (PFNGLUNIFORMMATRIX2X4FVPROC)GetExtension("glUniformMatrix2x4fv");
-    glUniformMatrix3x2fv = (PFNGLUNIFORMMATRIX3X2FVPROC)GetExtension("glUniformMatrix3x2fv");
-    glUniformMatrix3fv = (PFNGLUNIFORMMATRIX3FVPROC)GetExtension("glUniformMatrix3fv");
-    glUniformMatrix3x4fv = (PFNGLUNIFORMMATRIX3X4FVPROC)GetExtension("glUniformMatrix3x4fv");
-    glUniformMatrix4x2fv = (PFNGLUNIFORMMATRIX4X2FVPROC)GetExtension("glUniformMatrix4x2fv");
-    glUniformMatrix4x3fv = (PFNGLUNIFORMMATRIX4X3FVPROC)GetExtension("glUniformMatrix4x3fv");
-    glUniformMatrix4fv = (PFNGLUNIFORMMATRIX4FVPROC)GetExtension("glUniformMatrix4fv");
-    glGetProgramResourceIndex = (PFNGLGETPROGRAMRESOURCEINDEXPROC)GetExtension("glGetProgramResourceIndex");
-    glUniformBlockBinding = (PFNGLUNIFORMBLOCKBINDINGPROC)GetExtension("glUniformBlockBinding");
-    glShaderStorageBlockBinding = (PFNGLSHADERSTORAGEBLOCKBINDINGPROC)GetExtension("glShaderStorageBlockBinding");
-
-    glDrawElementsInstanced = (PFNGLDRAWELEMENTSINSTANCEDPROC)GetExtension("glDrawElementsInstanced");
-    glDispatchCompute = (PFNGLDISPATCHCOMPUTEPROC)GetExtension("glDispatchCompute");
-    glMemoryBarrier = (PFNGLMEMORYBARRIERPROC)GetExtension("glMemoryBarrier");
-
-    glGenQueries = (PFNGLGENQUERIESPROC)GetExtension("glGenQueries");
-    glDeleteQueries = (PFNGLDELETEQUERIESPROC)GetExtension("glDeleteQueries");
-    glIsQuery = (PFNGLISQUERYPROC)GetExtension("glIsQuery");
-    glBeginQuery = (PFNGLBEGINQUERYPROC)GetExtension("glBeginQuery");
-    glEndQuery = (PFNGLENDQUERYPROC)GetExtension("glEndQuery");
-    glQueryCounter = (PFNGLQUERYCOUNTERPROC)GetExtension("glQueryCounter");
-    glGetQueryiv = (PFNGLGETQUERYIVPROC)GetExtension("glGetQueryiv");
-    glGetQueryObjectiv = (PFNGLGETQUERYOBJECTIVPROC)GetExtension("glGetQueryObjectiv");
-    glGetQueryObjectuiv = (PFNGLGETQUERYOBJECTUIVPROC)GetExtension("glGetQueryObjectuiv");
-    glGetQueryObjecti64v = (PFNGLGETQUERYOBJECTI64VPROC)GetExtension("glGetQueryObjecti64v");
-    glGetQueryObjectui64v = (PFNGLGETQUERYOBJECTUI64VPROC)GetExtension("glGetQueryObjectui64v");
-
-    glFenceSync = (PFNGLFENCESYNCPROC)GetExtension("glFenceSync");
-    glClientWaitSync = (PFNGLCLIENTWAITSYNCPROC)GetExtension("glClientWaitSync");
-    glDeleteSync = (PFNGLDELETESYNCPROC)GetExtension("glDeleteSync");
-    glIsSync = (PFNGLISSYNCPROC)GetExtension("glIsSync");
-
-    glBlendFuncSeparate = (PFNGLBLENDFUNCSEPARATEPROC)GetExtension("glBlendFuncSeparate");
-    glBlendEquationSeparate = (PFNGLBLENDEQUATIONSEPARATEPROC)GetExtension("glBlendEquationSeparate");
-
-#if defined(OS_WINDOWS)
-    glBlendColor = (PFNGLBLENDCOLORPROC)GetExtension("glBlendColor");
-#endif
-
-    glDebugMessageControl = (PFNGLDEBUGMESSAGECONTROLPROC)GetExtension("glDebugMessageControl");
-    glDebugMessageCallback = (PFNGLDEBUGMESSAGECALLBACKPROC)GetExtension("glDebugMessageCallback");
+    GlInitEntryPoints();
 
+    GlLoadExtensionNames();
     glExtensions.timer_query = GlCheckExtension("GL_EXT_timer_query");
     glExtensions.texture_clamp_to_border = true;  // always available
     glExtensions.buffer_storage =
@@ -733,6 +522,8 @@ void GlInitExtensions() {
     glExtensions.multi_view_multi_sampled_resolve = GlCheckExtension("GL_OVR_multiview_multisampled_render_to_texture");
 
     glExtensions.texture_clamp_to_border_id = GL_CLAMP_TO_BORDER;
+
+    GlFreeExtensionNames();
 }
 
 #elif defined(OS_APPLE_MACOS)
@@ -743,6 +534,7 @@ PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC glFramebufferTexture2DMultisampleEXT
 PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC glRenderbufferStorageMultisampleEXT;
 
 void GlInitExtensions() {
+    GlLoadExtensionNames();
     glExtensions.timer_query = GlCheckExtension("GL_EXT_timer_query");
     glExtensions.texture_clamp_to_border = true;  // always available
     glExtensions.buffer_storage =
@@ -754,6 +546,8 @@ void GlInitExtensions() {
     glExtensions.multi_view_multi_sampled_resolve = GlCheckExtension("GL_OVR_multiview_multisampled_render_to_texture");
 
     glExtensions.texture_clamp_to_border_id = GL_CLAMP_TO_BORDER;
+
+    GlFreeExtensionNames();
 }
 
 #elif defined(OS_ANDROID)
@@ -783,34 +577,6 @@ typedef void(GL_APIENTRY *PFNGLBUFFERSTORAGEEXTPROC)(GLenum target, GLsizeiptr s
 typedef void(GL_APIENTRY *PFNGLTEXSTORAGE3DMULTISAMPLEPROC)(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width,
                                                             GLsizei height, GLsizei depth, GLboolean fixedsamplelocations);
 
-// EGL_KHR_fence_sync, GL_OES_EGL_sync, VG_KHR_EGL_sync
-PFNEGLCREATESYNCKHRPROC eglCreateSyncKHR_000;
-PFNEGLDESTROYSYNCKHRPROC eglDestroySyncKHR_000;
-PFNEGLCLIENTWAITSYNCKHRPROC eglClientWaitSyncKHR_000;
-PFNEGLGETSYNCATTRIBKHRPROC eglGetSyncAttribKHR_000;
-
-// GL_EXT_disjoint_timer_query
-PFNGLQUERYCOUNTEREXTPROC glQueryCounter;
-PFNGLGETQUERYOBJECTI64VEXTPROC glGetQueryObjecti64v;
-PFNGLGETQUERYOBJECTUI64VEXTPROC glGetQueryObjectui64v;
-
-// GL_EXT_buffer_storage
-PFNGLBUFFERSTORAGEEXTPROC glBufferStorage;
-
-// GL_OVR_multiview
-PFNGLFRAMEBUFFERTEXTUREMULTIVIEWOVRPROC glFramebufferTextureMultiviewOVR;
-
-// GL_EXT_multisampled_render_to_texture
-PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC glRenderbufferStorageMultisampleEXT;
-PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC glFramebufferTexture2DMultisampleEXT;
-
-// GL_OVR_multiview_multisampled_render_to_texture
-PFNGLFRAMEBUFFERTEXTUREMULTISAMPLEMULTIVIEWOVRPROC glFramebufferTextureMultisampleMultiviewOVR;
-
-#ifndef GL_ES_VERSION_3_2
-PFNGLTEXSTORAGE3DMULTISAMPLEPROC glTexStorage3DMultisample;
-#endif
-
 #if !defined(EGL_OPENGL_ES3_BIT)
 #define EGL_OPENGL_ES3_BIT 0x0040
 #endif
@@ -847,29 +613,9 @@ PFNGLTEXSTORAGE3DMULTISAMPLEPROC glTexStorage3DMultisample;
 #endif
 
 void GlInitExtensions() {
-    eglCreateSyncKHR_000 = (PFNEGLCREATESYNCKHRPROC)GetExtension("eglCreateSyncKHR");
-    eglDestroySyncKHR_000 = (PFNEGLDESTROYSYNCKHRPROC)GetExtension("eglDestroySyncKHR");
-    eglClientWaitSyncKHR_000 = (PFNEGLCLIENTWAITSYNCKHRPROC)GetExtension("eglClientWaitSyncKHR");
-    eglGetSyncAttribKHR_000 = (PFNEGLGETSYNCATTRIBKHRPROC)GetExtension("eglGetSyncAttribKHR");
-
-    glQueryCounter = (PFNGLQUERYCOUNTEREXTPROC)GetExtension("glQueryCounterEXT");
-    glGetQueryObjecti64v = (PFNGLGETQUERYOBJECTI64VEXTPROC)GetExtension("glGetQueryObjecti64vEXT");
-    glGetQueryObjectui64v = (PFNGLGETQUERYOBJECTUI64VEXTPROC)GetExtension("glGetQueryObjectui64vEXT");
-
-    glBufferStorage = (PFNGLBUFFERSTORAGEEXTPROC)GetExtension("glBufferStorageEXT");
-
-    glRenderbufferStorageMultisampleEXT =
-        (PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC)GetExtension("glRenderbufferStorageMultisampleEXT");
-    glFramebufferTexture2DMultisampleEXT =
-        (PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC)GetExtension("glFramebufferTexture2DMultisampleEXT");
-    glFramebufferTextureMultiviewOVR = (PFNGLFRAMEBUFFERTEXTUREMULTIVIEWOVRPROC)GetExtension("glFramebufferTextureMultiviewOVR");
-    glFramebufferTextureMultisampleMultiviewOVR =
-        (PFNGLFRAMEBUFFERTEXTUREMULTISAMPLEMULTIVIEWOVRPROC)GetExtension("glFramebufferTextureMultisampleMultiviewOVR");
-
-#ifndef GL_ES_VERSION_3_2
-    glTexStorage3DMultisample = (PFNGLTEXSTORAGE3DMULTISAMPLEPROC)GetExtension("glTexStorage3DMultisample");
-#endif
+    GlInitEntryPoints();
 
+    GlLoadExtensionNames();
     glExtensions.timer_query = GlCheckExtension("GL_EXT_disjoint_timer_query");
     glExtensions.texture_clamp_to_border =
         GlCheckExtension("GL_EXT_texture_border_clamp") || GlCheckExtension("GL_OES_texture_border_clamp");
@@ -882,6 +628,8 @@ void GlInitExtensions() {
         (GlCheckExtension("GL_OES_texture_border_clamp")
              ? GL_CLAMP_TO_BORDER
              : (GlCheckExtension("GL_EXT_texture_border_clamp") ? GL_CLAMP_TO_BORDER : (GL_CLAMP_TO_EDGE)));
+
+    GlFreeExtensionNames();
 }
 
 #endif
@@ -425,6 +425,25 @@ Common defines
 
 void GlInitExtensions();
 
+/*
+    GL entry points that are not exported by the GL library itself are looked up by name the first time they are used, so context
+    creation only pays for what the application calls. a missing entry point is looked up again on every use, code that may run
+    without one checks glExtensions instead. build with GFXWRAPPER_EAGER_GL_ENTRY_POINTS=1 to look them all up in GlInitExtensions.
+*/
+#if !defined(GFXWRAPPER_EAGER_GL_ENTRY_POINTS)
+#define GFXWRAPPER_EAGER_GL_ENTRY_POINTS 0
+#endif
+
+typedef struct {
+    const char *name;
+    void (*proc)(void);
+} ksGlEntryPoint;
+
+void (*GlResolveEntryPoint(ksGlEntryPoint *entryPoint))(void);
+
+#define GL_DECLARE_ENTRY_POINT(type, name, procName) extern ksGlEntryPoint name##_entry;
+#define GL_ENTRY_POINT(type, name) ((type)(name##_entry.proc != NULL ? name##_entry.proc : GlResolveEntryPoint(&name##_entry)))
+
 /*
 ================================================================================================================================
 
@@ -471,132 +490,256 @@ typedef void (*PFNGLFRAMEBUFFERTEXTUREMULTISAMPLEMULTIVIEWOVRPROC)(GLenum target
 
 #if defined(OS_WINDOWS) || defined(OS_LINUX)
 
-extern PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers;
-extern PFNGLDELETEFRAMEBUFFERSPROC glDeleteFramebuffers;
-extern PFNGLBINDFRAMEBUFFERPROC glBindFramebuffer;
-extern PFNGLBLITFRAMEBUFFERPROC glBlitFramebuffer;
-extern PFNGLGENRENDERBUFFERSPROC glGenRenderbuffers;
-extern PFNGLDELETERENDERBUFFERSPROC glDeleteRenderbuffers;
-extern PFNGLBINDRENDERBUFFERPROC glBindRenderbuffer;
-extern PFNGLISRENDERBUFFERPROC glIsRenderbuffer;
-extern PFNGLRENDERBUFFERSTORAGEPROC glRenderbufferStorage;
-extern PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC glRenderbufferStorageMultisample;
-extern PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC glRenderbufferStorageMultisampleEXT;
-extern PFNGLFRAMEBUFFERRENDERBUFFERPROC glFramebufferRenderbuffer;
-extern PFNGLFRAMEBUFFERTEXTURE2DPROC glFramebufferTexture2D;
-extern PFNGLFRAMEBUFFERTEXTURELAYERPROC glFramebufferTextureLayer;
-extern PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC glFramebufferTexture2DMultisampleEXT;
-extern PFNGLFRAMEBUFFERTEXTUREMULTIVIEWOVRPROC glFramebufferTextureMultiviewOVR;
-extern PFNGLFRAMEBUFFERTEXTUREMULTISAMPLEMULTIVIEWOVRPROC glFramebufferTextureMultisampleMultiviewOVR;
-extern PFNGLCHECKFRAMEBUFFERSTATUSPROC glCheckFramebufferStatus;
-
-extern PFNGLGENBUFFERSPROC glGenBuffers;
-extern PFNGLDELETEBUFFERSPROC glDeleteBuffers;
-extern PFNGLBINDBUFFERPROC glBindBuffer;
-extern PFNGLBINDBUFFERBASEPROC glBindBufferBase;
-extern PFNGLBUFFERDATAPROC glBufferData;
-extern PFNGLBUFFERSUBDATAPROC glBufferSubData;
-extern PFNGLBUFFERSTORAGEPROC glBufferStorage;
-extern PFNGLMAPBUFFERPROC glMapBuffer;
-extern PFNGLMAPBUFFERRANGEPROC glMapBufferRange;
-extern PFNGLUNMAPBUFFERPROC glUnmapBuffer;
-
-extern PFNGLGENVERTEXARRAYSPROC glGenVertexArrays;
-extern PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays;
-extern PFNGLBINDVERTEXARRAYPROC glBindVertexArray;
-extern PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer;
-extern PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor;
-extern PFNGLDISABLEVERTEXATTRIBARRAYPROC glDisableVertexAttribArray;
-extern PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray;
+#define GL_ENTRY_POINTS(X)                                                                                                                             \
+    X(PFNGLGENFRAMEBUFFERSPROC, glGenFramebuffers, "glGenFramebuffers")                                                                                \
+    X(PFNGLDELETEFRAMEBUFFERSPROC, glDeleteFramebuffers, "glDeleteFramebuffers")                                                                       \
+    X(PFNGLBINDFRAMEBUFFERPROC, glBindFramebuffer, "glBindFramebuffer")                                                                                \
+    X(PFNGLBLITFRAMEBUFFERPROC, glBlitFramebuffer, "glBlitFramebuffer")                                                                                \
+    X(PFNGLGENRENDERBUFFERSPROC, glGenRenderbuffers, "glGenRenderbuffers")                                                                             \
+    X(PFNGLDELETERENDERBUFFERSPROC, glDeleteRenderbuffers, "glDeleteRenderbuffers")                                                                    \
+    X(PFNGLBINDRENDERBUFFERPROC, glBindRenderbuffer, "glBindRenderbuffer")                                                                             \
+    X(PFNGLISRENDERBUFFERPROC, glIsRenderbuffer, "glIsRenderbuffer")                                                                                   \
+    X(PFNGLRENDERBUFFERSTORAGEPROC, glRenderbufferStorage, "glRenderbufferStorage")                                                                    \
+    X(PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC, glRenderbufferStorageMultisample, "glRenderbufferStorageMultisample")                                   \
+    X(PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC, glRenderbufferStorageMultisampleEXT, "glRenderbufferStorageMultisampleEXT")                          \
+    X(PFNGLFRAMEBUFFERRENDERBUFFERPROC, glFramebufferRenderbuffer, "glFramebufferRenderbuffer")                                                        \
+    X(PFNGLFRAMEBUFFERTEXTURE2DPROC, glFramebufferTexture2D, "glFramebufferTexture2D")                                                                 \
+    X(PFNGLFRAMEBUFFERTEXTURELAYERPROC, glFramebufferTextureLayer, "glFramebufferTextureLayer")                                                        \
+    X(PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC, glFramebufferTexture2DMultisampleEXT, "glFramebufferTexture2DMultisampleEXT")                       \
+    X(PFNGLFRAMEBUFFERTEXTUREMULTIVIEWOVRPROC, glFramebufferTextureMultiviewOVR, "glFramebufferTextureMultiviewOVR")                                   \
+    X(PFNGLFRAMEBUFFERTEXTUREMULTISAMPLEMULTIVIEWOVRPROC, glFramebufferTextureMultisampleMultiviewOVR, "glFramebufferTextureMultisampleMultiviewOVR")  \
+    X(PFNGLCHECKFRAMEBUFFERSTATUSPROC, glCheckFramebufferStatus, "glCheckFramebufferStatus")                                                           \
+    X(PFNGLGENBUFFERSPROC, glGenBuffers, "glGenBuffers")                                                                                               \
+    X(PFNGLDELETEBUFFERSPROC, glDeleteBuffers, "glDeleteBuffers")                                                                                      \
+    X(PFNGLBINDBUFFERPROC, glBindBuffer, "glBindBuffer")                                                                                               \
+    X(PFNGLBINDBUFFERBASEPROC, glBindBufferBase, "glBindBufferBase")                                                                                   \
+    X(PFNGLBUFFERDATAPROC, glBufferData, "glBufferData")                                                                                               \
+    X(PFNGLBUFFERSUBDATAPROC, glBufferSubData, "glBufferSubData")                                                                                      \
+    X(PFNGLBUFFERSTORAGEPROC, glBufferStorage, "glBufferStorage")                                                                                      \
+    X(PFNGLMAPBUFFERPROC, glMapBuffer, "glMapBuffer")                                                                                                  \
+    X(PFNGLMAPBUFFERRANGEPROC, glMapBufferRange, "glMapBufferRange")                                                                                   \
+    X(PFNGLUNMAPBUFFERPROC, glUnmapBuffer, "glUnmapBuffer")                                                                                            \
+    X(PFNGLGENVERTEXARRAYSPROC, glGenVertexArrays, "glGenVertexArrays")                                                                                \
+    X(PFNGLDELETEVERTEXARRAYSPROC, glDeleteVertexArrays, "glDeleteVertexArrays")                                                                       \
+    X(PFNGLBINDVERTEXARRAYPROC, glBindVertexArray, "glBindVertexArray")                                                                                \
+    X(PFNGLVERTEXATTRIBPOINTERPROC, glVertexAttribPointer, "glVertexAttribPointer")                                                                    \
+    X(PFNGLVERTEXATTRIBDIVISORPROC, glVertexAttribDivisor, "glVertexAttribDivisor")                                                                    \
+    X(PFNGLDISABLEVERTEXATTRIBARRAYPROC, glDisableVertexAttribArray, "glDisableVertexAttribArray")                                                     \
+    X(PFNGLENABLEVERTEXATTRIBARRAYPROC, glEnableVertexAttribArray, "glEnableVertexAttribArray")                                                        \
+    X(PFNGLTEXSTORAGE2DPROC, glTexStorage2D, "glTexStorage2D")                                                                                         \
+    X(PFNGLTEXSTORAGE3DPROC, glTexStorage3D, "glTexStorage3D")                                                                                         \
+    X(PFNGLTEXIMAGE2DMULTISAMPLEPROC, glTexImage2DMultisample, "glTexImage2DMultisample")                                                              \
+    X(PFNGLTEXIMAGE3DMULTISAMPLEPROC, glTexImage3DMultisample, "glTexImage3DMultisample")                                                              \
+    X(PFNGLTEXSTORAGE2DMULTISAMPLEPROC, glTexStorage2DMultisample, "glTexStorage2DMultisample")                                                        \
+    X(PFNGLTEXSTORAGE3DMULTISAMPLEPROC, glTexStorage3DMultisample, "glTexStorage3DMultisample")                                                        \
+    X(PFNGLGENERATEMIPMAPPROC, glGenerateMipmap, "glGenerateMipmap")                                                                                   \
+    X(PFNGLBINDIMAGETEXTUREPROC, glBindImageTexture, "glBindImageTexture")                                                                             \
+    X(PFNGLCREATEPROGRAMPROC, glCreateProgram, "glCreateProgram")                                                                                      \
+    X(PFNGLDELETEPROGRAMPROC, glDeleteProgram, "glDeleteProgram")                                                                                      \
+    X(PFNGLCREATESHADERPROC, glCreateShader, "glCreateShader")                                                                                         \
+    X(PFNGLDELETESHADERPROC, glDeleteShader, "glDeleteShader")                                                                                         \
+    X(PFNGLSHADERSOURCEPROC, glShaderSource, "glShaderSource")                                                                                         \
+    X(PFNGLCOMPILESHADERPROC, glCompileShader, "glCompileShader")                                                                                      \
+    X(PFNGLGETSHADERIVPROC, glGetShaderiv, "glGetShaderiv")                                                                                            \
+    X(PFNGLGETSHADERINFOLOGPROC, glGetShaderInfoLog, "glGetShaderInfoLog")                                                                             \
+    X(PFNGLUSEPROGRAMPROC, glUseProgram, "glUseProgram")                                                                                               \
+    X(PFNGLATTACHSHADERPROC, glAttachShader, "glAttachShader")                                                                                         \
+    X(PFNGLLINKPROGRAMPROC, glLinkProgram, "glLinkProgram")                                                                                            \
+    X(PFNGLGETPROGRAMIVPROC, glGetProgramiv, "glGetProgramiv")                                                                                         \
+    X(PFNGLGETPROGRAMINFOLOGPROC, glGetProgramInfoLog, "glGetProgramInfoLog")                                                                          \
+    X(PFNGLGETPROGRAMBINARYPROC, glGetProgramBinary, "glGetProgramBinary")                                                                             \
+    X(PFNGLPROGRAMBINARYPROC, glProgramBinary, "glProgramBinary")                                                                                      \
+    X(PFNGLPROGRAMPARAMETERIPROC, glProgramParameteri, "glProgramParameteri")                                                                          \
+    X(PFNGLGETATTRIBLOCATIONPROC, glGetAttribLocation, "glGetAttribLocation")                                                                          \
+    X(PFNGLBINDATTRIBLOCATIONPROC, glBindAttribLocation, "glBindAttribLocation")                                                                       \
+    X(PFNGLGETUNIFORMLOCATIONPROC, glGetUniformLocation, "glGetUniformLocation")                                                                       \
+    X(PFNGLGETUNIFORMBLOCKINDEXPROC, glGetUniformBlockIndex, "glGetUniformBlockIndex")                                                                 \
+    X(PFNGLPROGRAMUNIFORM1IPROC, glProgramUniform1i, "glProgramUniform1i")                                                                             \
+    X(PFNGLUNIFORM1IPROC, glUniform1i, "glUniform1i")                                                                                                  \
+    X(PFNGLUNIFORM1IVPROC, glUniform1iv, "glUniform1iv")                                                                                               \
+    X(PFNGLUNIFORM2IVPROC, glUniform2iv, "glUniform2iv")                                                                                               \
+    X(PFNGLUNIFORM3IVPROC, glUniform3iv, "glUniform3iv")                                                                                               \
+    X(PFNGLUNIFORM4IVPROC, glUniform4iv, "glUniform4iv")                                                                                               \
+    X(PFNGLUNIFORM1FPROC, glUniform1f, "glUniform1f")                                                                                                  \
+    X(PFNGLUNIFORM1FVPROC, glUniform1fv, "glUniform1fv")                                                                                               \
+    X(PFNGLUNIFORM2FVPROC, glUniform2fv, "glUniform2fv")                                                                                               \
+    X(PFNGLUNIFORM3FVPROC, glUniform3fv, "glUniform3fv")                                                                                               \
+    X(PFNGLUNIFORM4FVPROC, glUniform4fv, "glUniform4fv")                                                                                               \
+    X(PFNGLUNIFORMMATRIX2FVPROC, glUniformMatrix2fv, "glUniformMatrix2fv")                                                                             \
+    X(PFNGLUNIFORMMATRIX2X3FVPROC, glUniformMatrix2x3fv, "glUniformMatrix2x3fv")                                                                       \
+    X(PFNGLUNIFORMMATRIX2X4FVPROC, glUniformMatrix2x4fv, "glUniformMatrix2x4fv")                                                                       \
+    X(PFNGLUNIFORMMATRIX3X2FVPROC, glUniformMatrix3x2fv, "glUniformMatrix3x2fv")                                                                       \
+    X(PFNGLUNIFORMMATRIX3FVPROC, glUniformMatrix3fv, "glUniformMatrix3fv")                                                                             \
+    X(PFNGLUNIFORMMATRIX3X4FVPROC, glUniformMatrix3x4fv, "glUniformMatrix3x4fv")                                                                       \
+    X(PFNGLUNIFORMMATRIX4X2FVPROC, glUniformMatrix4x2fv, "glUniformMatrix4x2fv")                                                                       \
+    X(PFNGLUNIFORMMATRIX4X3FVPROC, glUniformMatrix4x3fv, "glUniformMatrix4x3fv")                                                                       \
+    X(PFNGLUNIFORMMATRIX4FVPROC, glUniformMatrix4fv, "glUniformMatrix4fv")                                                                             \
+    X(PFNGLGETPROGRAMRESOURCEINDEXPROC, glGetProgramResourceIndex, "glGetProgramResourceIndex")                                                        \
+    X(PFNGLUNIFORMBLOCKBINDINGPROC, glUniformBlockBinding, "glUniformBlockBinding")                                                                    \
+    X(PFNGLSHADERSTORAGEBLOCKBINDINGPROC, glShaderStorageBlockBinding, "glShaderStorageBlockBinding")                                                  \
+    X(PFNGLDRAWELEMENTSINSTANCEDPROC, glDrawElementsInstanced, "glDrawElementsInstanced")                                                              \
+    X(PFNGLDISPATCHCOMPUTEPROC, glDispatchCompute, "glDispatchCompute")                                                                                \
+    X(PFNGLMEMORYBARRIERPROC, glMemoryBarrier, "glMemoryBarrier")                                                                                      \
+    X(PFNGLGENQUERIESPROC, glGenQueries, "glGenQueries")                                                                                               \
+    X(PFNGLDELETEQUERIESPROC, glDeleteQueries, "glDeleteQueries")                                                                                      \
+    X(PFNGLISQUERYPROC, glIsQuery, "glIsQuery")                                                                                                        \
+    X(PFNGLBEGINQUERYPROC, glBeginQuery, "glBeginQuery")                                                                                               \
+    X(PFNGLENDQUERYPROC, glEndQuery, "glEndQuery")                                                                                                     \
+    X(PFNGLQUERYCOUNTERPROC, glQueryCounter, "glQueryCounter")                                                                                         \
+    X(PFNGLGETQUERYIVPROC, glGetQueryiv, "glGetQueryiv")                                                                                               \
+    X(PFNGLGETQUERYOBJECTIVPROC, glGetQueryObjectiv, "glGetQueryObjectiv")                                                                             \
+    X(PFNGLGETQUERYOBJECTUIVPROC, glGetQueryObjectuiv, "glGetQueryObjectuiv")                                                                          \
+    X(PFNGLGETQUERYOBJECTI64VPROC, glGetQueryObjecti64v, "glGetQueryObjecti64v")                                                                       \
+    X(PFNGLGETQUERYOBJECTUI64VPROC, glGetQueryObjectui64v, "glGetQueryObjectui64v")                                                                    \
+    X(PFNGLFENCESYNCPROC, glFenceSync, "glFenceSync")                                                                                                  \
+    X(PFNGLCLIENTWAITSYNCPROC, glClientWaitSync, "glClientWaitSync")                                                                                   \
+    X(PFNGLDELETESYNCPROC, glDeleteSync, "glDeleteSync")                                                                                               \
+    X(PFNGLISSYNCPROC, glIsSync, "glIsSync")                                                                                                           \
+    X(PFNGLBLENDFUNCSEPARATEPROC, glBlendFuncSeparate, "glBlendFuncSeparate")                                                                          \
+    X(PFNGLBLENDEQUATIONSEPARATEPROC, glBlendEquationSeparate, "glBlendEquationSeparate")                                                              \
+    X(PFNGLDEBUGMESSAGECONTROLPROC, glDebugMessageControl, "glDebugMessageControl")                                                                    \
+    X(PFNGLDEBUGMESSAGECALLBACKPROC, glDebugMessageCallback, "glDebugMessageCallback")
 
 #if defined(OS_WINDOWS)
-extern PFNGLACTIVETEXTUREPROC glActiveTexture;
-extern PFNGLTEXIMAGE3DPROC glTexImage3D;
-extern PFNGLCOMPRESSEDTEXIMAGE2DPROC glCompressedTexImage2D;
-extern PFNGLCOMPRESSEDTEXIMAGE3DPROC glCompressedTexImage3D;
-extern PFNGLTEXSUBIMAGE3DPROC glTexSubImage3D;
-extern PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC glCompressedTexSubImage2D;
-extern PFNGLCOMPRESSEDTEXSUBIMAGE3DPROC glCompressedTexSubImage3D;
+#define GL_ENTRY_POINTS_EXTRA(X)                                                                 \
+    X(PFNGLACTIVETEXTUREPROC, glActiveTexture, "glActiveTexture")                                \
+    X(PFNGLTEXIMAGE3DPROC, glTexImage3D, "glTexImage3D")                                         \
+    X(PFNGLCOMPRESSEDTEXIMAGE2DPROC, glCompressedTexImage2D, "glCompressedTexImage2D")           \
+    X(PFNGLCOMPRESSEDTEXIMAGE3DPROC, glCompressedTexImage3D, "glCompressedTexImage3D")           \
+    X(PFNGLTEXSUBIMAGE3DPROC, glTexSubImage3D, "glTexSubImage3D")                                \
+    X(PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC, glCompressedTexSubImage2D, "glCompressedTexSubImage2D")  \
+    X(PFNGLCOMPRESSEDTEXSUBIMAGE3DPROC, glCompressedTexSubImage3D, "glCompressedTexSubImage3D")  \
+    X(PFNGLBLENDCOLORPROC, glBlendColor, "glBlendColor")                                         \
+    X(PFNGLBLENDCOLORPROC, glBlendColor, "glBlendColor")
+#else
+#define GL_ENTRY_POINTS_EXTRA(X)
+#endif
+
+GL_ENTRY_POINTS(GL_DECLARE_ENTRY_POINT)
+GL_ENTRY_POINTS_EXTRA(GL_DECLARE_ENTRY_POINT)
+
+#define glGenFramebuffers GL_ENTRY_POINT(PFNGLGENFRAMEBUFFERSPROC, glGenFramebuffers)
+#define glDeleteFramebuffers GL_ENTRY_POINT(PFNGLDELETEFRAMEBUFFERSPROC, glDeleteFramebuffers)
+#define glBindFramebuffer GL_ENTRY_POINT(PFNGLBINDFRAMEBUFFERPROC, glBindFramebuffer)
+#define glBlitFramebuffer GL_ENTRY_POINT(PFNGLBLITFRAMEBUFFERPROC, glBlitFramebuffer)
+#define glGenRenderbuffers GL_ENTRY_POINT(PFNGLGENRENDERBUFFERSPROC, glGenRenderbuffers)
+#define glDeleteRenderbuffers GL_ENTRY_POINT(PFNGLDELETERENDERBUFFERSPROC, glDeleteRenderbuffers)
+#define glBindRenderbuffer GL_ENTRY_POINT(PFNGLBINDRENDERBUFFERPROC, glBindRenderbuffer)
+#define glIsRenderbuffer GL_ENTRY_POINT(PFNGLISRENDERBUFFERPROC, glIsRenderbuffer)
+#define glRenderbufferStorage GL_ENTRY_POINT(PFNGLRENDERBUFFERSTORAGEPROC, glRenderbufferStorage)
+#define glRenderbufferStorageMultisample GL_ENTRY_POINT(PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC, glRenderbufferStorageMultisample)
+#define glRenderbufferStorageMultisampleEXT GL_ENTRY_POINT(PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC, glRenderbufferStorageMultisampleEXT)
+#define glFramebufferRenderbuffer GL_ENTRY_POINT(PFNGLFRAMEBUFFERRENDERBUFFERPROC, glFramebufferRenderbuffer)
+#define glFramebufferTexture2D GL_ENTRY_POINT(PFNGLFRAMEBUFFERTEXTURE2DPROC, glFramebufferTexture2D)
+#define glFramebufferTextureLayer GL_ENTRY_POINT(PFNGLFRAMEBUFFERTEXTURELAYERPROC, glFramebufferTextureLayer)
+#define glFramebufferTexture2DMultisampleEXT GL_ENTRY_POINT(PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC, glFramebufferTexture2DMultisampleEXT)
+#define glFramebufferTextureMultiviewOVR GL_ENTRY_POINT(PFNGLFRAMEBUFFERTEXTUREMULTIVIEWOVRPROC, glFramebufferTextureMultiviewOVR)
+#define glFramebufferTextureMultisampleMultiviewOVR GL_ENTRY_POINT(PFNGLFRAMEBUFFERTEXTUREMULTISAMPLEMULTIVIEWOVRPROC, glFramebufferTextureMultisampleMultiviewOVR)
+#define glCheckFramebufferStatus GL_ENTRY_POINT(PFNGLCHECKFRAMEBUFFERSTATUSPROC, glCheckFramebufferStatus)
+#define glGenBuffers GL_ENTRY_POINT(PFNGLGENBUFFERSPROC, glGenBuffers)
+#define glDeleteBuffers GL_ENTRY_POINT(PFNGLDELETEBUFFERSPROC, glDeleteBuffers)
+#define glBindBuffer GL_ENTRY_POINT(PFNGLBINDBUFFERPROC, glBindBuffer)
+#define glBindBufferBase GL_ENTRY_POINT(PFNGLBINDBUFFERBASEPROC, glBindBufferBase)
+#define glBufferData GL_ENTRY_POINT(PFNGLBUFFERDATAPROC, glBufferData)
+#define glBufferSubData GL_ENTRY_POINT(PFNGLBUFFERSUBDATAPROC, glBufferSubData)
+#define glBufferStorage GL_ENTRY_POINT(PFNGLBUFFERSTORAGEPROC, glBufferStorage)
+#define glMapBuffer GL_ENTRY_POINT(PFNGLMAPBUFFERPROC, glMapBuffer)
+#define glMapBufferRange GL_ENTRY_POINT(PFNGLMAPBUFFERRANGEPROC, glMapBufferRange)
+#define glUnmapBuffer GL_ENTRY_POINT(PFNGLUNMAPBUFFERPROC, glUnmapBuffer)
+#define glGenVertexArrays GL_ENTRY_POINT(PFNGLGENVERTEXARRAYSPROC, glGenVertexArrays)
+#define glDeleteVertexArrays GL_ENTRY_POINT(PFNGLDELETEVERTEXARRAYSPROC, glDeleteVertexArrays)
+#define glBindVertexArray GL_ENTRY_POINT(PFNGLBINDVERTEXARRAYPROC, glBindVertexArray)
+#define glVertexAttribPointer GL_ENTRY_POINT(PFNGLVERTEXATTRIBPOINTERPROC, glVertexAttribPointer)
+#define glVertexAttribDivisor GL_ENTRY_POINT(PFNGLVERTEXATTRIBDIVISORPROC, glVertexAttribDivisor)
+#define glDisableVertexAttribArray GL_ENTRY_POINT(PFNGLDISABLEVERTEXATTRIBARRAYPROC, glDisableVertexAttribArray)
+#define glEnableVertexAttribArray GL_ENTRY_POINT(PFNGLENABLEVERTEXATTRIBARRAYPROC, glEnableVertexAttribArray)
+#define glTexStorage2D GL_ENTRY_POINT(PFNGLTEXSTORAGE2DPROC, glTexStorage2D)
+#define glTexStorage3D GL_ENTRY_POINT(PFNGLTEXSTORAGE3DPROC, glTexStorage3D)
+#define glTexImage2DMultisample GL_ENTRY_POINT(PFNGLTEXIMAGE2DMULTISAMPLEPROC, glTexImage2DMultisample)
+#define glTexImage3DMultisample GL_ENTRY_POINT(PFNGLTEXIMAGE3DMULTISAMPLEPROC, glTexImage3DMultisample)
+#define glTexStorage2DMultisample GL_ENTRY_POINT(PFNGLTEXSTORAGE2DMULTISAMPLEPROC, glTexStorage2DMultisample)
+#define glTexStorage3DMultisample GL_ENTRY_POINT(PFNGLTEXSTORAGE3DMULTISAMPLEPROC, glTexStorage3DMultisample)
+#define glGenerateMipmap GL_ENTRY_POINT(PFNGLGENERATEMIPMAPPROC, glGenerateMipmap)
+#define glBindImageTexture GL_ENTRY_POINT(PFNGLBINDIMAGETEXTUREPROC, glBindImageTexture)
+#define glCreateProgram GL_ENTRY_POINT(PFNGLCREATEPROGRAMPROC, glCreateProgram)
+#define glDeleteProgram GL_ENTRY_POINT(PFNGLDELETEPROGRAMPROC, glDeleteProgram)
+#define glCreateShader GL_ENTRY_POINT(PFNGLCREATESHADERPROC, glCreateShader)
+#define glDeleteShader GL_ENTRY_POINT(PFNGLDELETESHADERPROC, glDeleteShader)
+#define glShaderSource GL_ENTRY_POINT(PFNGLSHADERSOURCEPROC, glShaderSource)
+#define glCompileShader GL_ENTRY_POINT(PFNGLCOMPILESHADERPROC, glCompileShader)
+#define glGetShaderiv GL_ENTRY_POINT(PFNGLGETSHADERIVPROC, glGetShaderiv)
+#define glGetShaderInfoLog GL_ENTRY_POINT(PFNGLGETSHADERINFOLOGPROC, glGetShaderInfoLog)
+#define glUseProgram GL_ENTRY_POINT(PFNGLUSEPROGRAMPROC, glUseProgram)
+#define glAttachShader GL_ENTRY_POINT(PFNGLATTACHSHADERPROC, glAttachShader)
+#define glLinkProgram GL_ENTRY_POINT(PFNGLLINKPROGRAMPROC, glLinkProgram)
+#define glGetProgramiv GL_ENTRY_POINT(PFNGLGETPROGRAMIVPROC, glGetProgramiv)
+#define glGetProgramInfoLog GL_ENTRY_POINT(PFNGLGETPROGRAMINFOLOGPROC, glGetProgramInfoLog)
+#define glGetProgramBinary GL_ENTRY_POINT(PFNGLGETPROGRAMBINARYPROC, glGetProgramBinary)
+#define glProgramBinary GL_ENTRY_POINT(PFNGLPROGRAMBINARYPROC, glProgramBinary)
+#define glProgramParameteri GL_ENTRY_POINT(PFNGLPROGRAMPARAMETERIPROC, glProgramParameteri)
+#define glGetAttribLocation GL_ENTRY_POINT(PFNGLGETATTRIBLOCATIONPROC, glGetAttribLocation)
+#define glBindAttribLocation GL_ENTRY_POINT(PFNGLBINDATTRIBLOCATIONPROC, glBindAttribLocation)
+#define glGetUniformLocation GL_ENTRY_POINT(PFNGLGETUNIFORMLOCATIONPROC, glGetUniformLocation)
+#define glGetUniformBlockIndex GL_ENTRY_POINT(PFNGLGETUNIFORMBLOCKINDEXPROC, glGetUniformBlockIndex)
+#define glProgramUniform1i GL_ENTRY_POINT(PFNGLPROGRAMUNIFORM1IPROC, glProgramUniform1i)
+#define glUniform1i GL_ENTRY_POINT(PFNGLUNIFORM1IPROC, glUniform1i)
+#define glUniform1iv GL_ENTRY_POINT(PFNGLUNIFORM1IVPROC, glUniform1iv)
+#define glUniform2iv GL_ENTRY_POINT(PFNGLUNIFORM2IVPROC, glUniform2iv)
+#define glUniform3iv GL_ENTRY_POINT(PFNGLUNIFORM3IVPROC, glUniform3iv)
+#define glUniform4iv GL_ENTRY_POINT(PFNGLUNIFORM4IVPROC, glUniform4iv)
+#define glUniform1f GL_ENTRY_POINT(PFNGLUNIFORM1FPROC, glUniform1f)
+#define glUniform1fv GL_ENTRY_POINT(PFNGLUNIFORM1FVPROC, glUniform1fv)
+#define glUniform2fv GL_ENTRY_POINT(PFNGLUNIFORM2FVPROC, glUniform2fv)
+#define glUniform3fv GL_ENTRY_POINT(PFNGLUNIFORM3FVPROC, glUniform3fv)
+#define glUniform4fv GL_ENTRY_POINT(PFNGLUNIFORM4FVPROC, glUniform4fv)
+#define glUniformMatrix2fv GL_ENTRY_POINT(PFNGLUNIFORMMATRIX2FVPROC, glUniformMatrix2fv)
+#define glUniformMatrix2x3fv GL_ENTRY_POINT(PFNGLUNIFORMMATRIX2X3FVPROC, glUniformMatrix2x3fv)
+#define glUniformMatrix2x4fv GL_ENTRY_POINT(PFNGLUNIFORMMATRIX2X4FVPROC, glUniformMatrix2x4fv)
+#define glUniformMatrix3x2fv GL_ENTRY_POINT(PFNGLUNIFORMMATRIX3X2FVPROC, glUniformMatrix3x2fv)
+#define glUniformMatrix3fv GL_ENTRY_POINT(PFNGLUNIFORMMATRIX3FVPROC, glUniformMatrix3fv)
+#define glUniformMatrix3x4fv GL_ENTRY_POINT(PFNGLUNIFORMMATRIX3X4FVPROC, glUniformMatrix3x4fv)
+#define glUniformMatrix4x2fv GL_ENTRY_POINT(PFNGLUNIFORMMATRIX4X2FVPROC, glUniformMatrix4x2fv)
+#define glUniformMatrix4x3fv GL_ENTRY_POINT(PFNGLUNIFORMMATRIX4X3FVPROC, glUniformMatrix4x3fv)
+#define glUniformMatrix4fv GL_ENTRY_POINT(PFNGLUNIFORMMATRIX4FVPROC, glUniformMatrix4fv)
+#define glGetProgramResourceIndex GL_ENTRY_POINT(PFNGLGETPROGRAMRESOURCEINDEXPROC, glGetProgramResourceIndex)
+#define glUniformBlockBinding GL_ENTRY_POINT(PFNGLUNIFORMBLOCKBINDINGPROC, glUniformBlockBinding)
+#define glShaderStorageBlockBinding GL_ENTRY_POINT(PFNGLSHADERSTORAGEBLOCKBINDINGPROC, glShaderStorageBlockBinding)
+#define glDrawElementsInstanced GL_ENTRY_POINT(PFNGLDRAWELEMENTSINSTANCEDPROC, glDrawElementsInstanced)
+#define glDispatchCompute GL_ENTRY_POINT(PFNGLDISPATCHCOMPUTEPROC, glDispatchCompute)
+#define glMemoryBarrier GL_ENTRY_POINT(PFNGLMEMORYBARRIERPROC, glMemoryBarrier)
+#define glGenQueries GL_ENTRY_POINT(PFNGLGENQUERIESPROC, glGenQueries)
+#define glDeleteQueries GL_ENTRY_POINT(PFNGLDELETEQUERIESPROC, glDeleteQueries)
+#define glIsQuery GL_ENTRY_POINT(PFNGLISQUERYPROC, glIsQuery)
+#define glBeginQuery GL_ENTRY_POINT(PFNGLBEGINQUERYPROC, glBeginQuery)
+#define glEndQuery GL_ENTRY_POINT(PFNGLENDQUERYPROC, glEndQuery)
+#define glQueryCounter GL_ENTRY_POINT(PFNGLQUERYCOUNTERPROC, glQueryCounter)
+#define glGetQueryiv GL_ENTRY_POINT(PFNGLGETQUERYIVPROC, glGetQueryiv)
+#define glGetQueryObjectiv GL_ENTRY_POINT(PFNGLGETQUERYOBJECTIVPROC, glGetQueryObjectiv)
+#define glGetQueryObjectuiv GL_ENTRY_POINT(PFNGLGETQUERYOBJECTUIVPROC, glGetQueryObjectuiv)
+#define glGetQueryObjecti64v GL_ENTRY_POINT(PFNGLGETQUERYOBJECTI64VPROC, glGetQueryObjecti64v)
+#define glGetQueryObjectui64v GL_ENTRY_POINT(PFNGLGETQUERYOBJECTUI64VPROC, glGetQueryObjectui64v)
+#define glFenceSync GL_ENTRY_POINT(PFNGLFENCESYNCPROC, glFenceSync)
+#define glClientWaitSync GL_ENTRY_POINT(PFNGLCLIENTWAITSYNCPROC, glClientWaitSync)
+#define glDeleteSync GL_ENTRY_POINT(PFNGLDELETESYNCPROC, glDeleteSync)
+#define glIsSync GL_ENTRY_POINT(PFNGLISSYNCPROC, glIsSync)
+#define glBlendFuncSeparate GL_ENTRY_POINT(PFNGLBLENDFUNCSEPARATEPROC, glBlendFuncSeparate)
+#define glBlendEquationSeparate GL_ENTRY_POINT(PFNGLBLENDEQUATIONSEPARATEPROC, glBlendEquationSeparate)
+#define glDebugMessageControl GL_ENTRY_POINT(PFNGLDEBUGMESSAGECONTROLPROC, glDebugMessageControl)
+#define glDebugMessageCallback GL_ENTRY_POINT(PFNGLDEBUGMESSAGECALLBACKPROC, glDebugMessageCallback)
+
+#if defined(OS_WINDOWS)
+#define glActiveTexture GL_ENTRY_POINT(PFNGLACTIVETEXTUREPROC, glActiveTexture)
+#define glTexImage3D GL_ENTRY_POINT(PFNGLTEXIMAGE3DPROC, glTexImage3D)
+#define glCompressedTexImage2D GL_ENTRY_POINT(PFNGLCOMPRESSEDTEXIMAGE2DPROC, glCompressedTexImage2D)
+#define glCompressedTexImage3D GL_ENTRY_POINT(PFNGLCOMPRESSEDTEXIMAGE3DPROC, glCompressedTexImage3D)
+#define glTexSubImage3D GL_ENTRY_POINT(PFNGLTEXSUBIMAGE3DPROC, glTexSubImage3D)
+#define glCompressedTexSubImage2D GL_ENTRY_POINT(PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC, glCompressedTexSubImage2D)
+#define glCompressedTexSubImage3D GL_ENTRY_POINT(PFNGLCOMPRESSEDTEXSUBIMAGE3DPROC, glCompressedTexSubImage3D)
+#define glBlendColor GL_ENTRY_POINT(PFNGLBLENDCOLORPROC, glBlendColor)
+#define glBlendColor GL_ENTRY_POINT(PFNGLBLENDCOLORPROC, glBlendColor)
 #endif
-extern PFNGLTEXSTORAGE2DPROC glTexStorage2D;
-extern PFNGLTEXSTORAGE3DPROC glTexStorage3D;
-extern PFNGLTEXIMAGE2DMULTISAMPLEPROC glTexImage2DMultisample;
-extern PFNGLTEXIMAGE3DMULTISAMPLEPROC glTexImage3DMultisample;
-extern PFNGLTEXSTORAGE2DMULTISAMPLEPROC glTexStorage2DMultisample;
-extern PFNGLTEXSTORAGE3DMULTISAMPLEPROC glTexStorage3DMultisample;
-extern PFNGLGENERATEMIPMAPPROC glGenerateMipmap;
-extern PFNGLBINDIMAGETEXTUREPROC glBindImageTexture;
-
-extern PFNGLCREATEPROGRAMPROC glCreateProgram;
-extern PFNGLDELETEPROGRAMPROC glDeleteProgram;
-extern PFNGLCREATESHADERPROC glCreateShader;
-extern PFNGLDELETESHADERPROC glDeleteShader;
-extern PFNGLSHADERSOURCEPROC glShaderSource;
-extern PFNGLCOMPILESHADERPROC glCompileShader;
-extern PFNGLGETSHADERIVPROC glGetShaderiv;
-extern PFNGLGETSHADERINFOLOGPROC glGetShaderInfoLog;
-extern PFNGLUSEPROGRAMPROC glUseProgram;
-extern PFNGLATTACHSHADERPROC glAttachShader;
-extern PFNGLLINKPROGRAMPROC glLinkProgram;
-extern PFNGLGETPROGRAMIVPROC glGetProgramiv;
-extern PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog;
-extern PFNGLGETATTRIBLOCATIONPROC glGetAttribLocation;
-extern PFNGLBINDATTRIBLOCATIONPROC glBindAttribLocation;
-extern PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation;
-extern PFNGLGETUNIFORMBLOCKINDEXPROC glGetUniformBlockIndex;
-extern PFNGLGETPROGRAMRESOURCEINDEXPROC glGetProgramResourceIndex;
-extern PFNGLUNIFORMBLOCKBINDINGPROC glUniformBlockBinding;
-extern PFNGLSHADERSTORAGEBLOCKBINDINGPROC glShaderStorageBlockBinding;
-extern PFNGLPROGRAMUNIFORM1IPROC glProgramUniform1i;
-extern PFNGLUNIFORM1IPROC glUniform1i;
-extern PFNGLUNIFORM1IVPROC glUniform1iv;
-extern PFNGLUNIFORM2IVPROC glUniform2iv;
-extern PFNGLUNIFORM3IVPROC glUniform3iv;
-extern PFNGLUNIFORM4IVPROC glUniform4iv;
-extern PFNGLUNIFORM1FPROC glUniform1f;
-extern PFNGLUNIFORM1FVPROC glUniform1fv;
-extern PFNGLUNIFORM2FVPROC glUniform2fv;
-extern PFNGLUNIFORM3FVPROC glUniform3fv;
-extern PFNGLUNIFORM4FVPROC glUniform4fv;
-extern PFNGLUNIFORMMATRIX2FVPROC glUniformMatrix2fv;
-extern PFNGLUNIFORMMATRIX2X3FVPROC glUniformMatrix2x3fv;
-extern PFNGLUNIFORMMATRIX2X4FVPROC glUniformMatrix2x4fv;
-extern PFNGLUNIFORMMATRIX3X2FVPROC glUniformMatrix3x2fv;
-extern PFNGLUNIFORMMATRIX3FVPROC glUniformMatrix3fv;
-extern PFNGLUNIFORMMATRIX3X4FVPROC glUniformMatrix3x4fv;
-extern PFNGLUNIFORMMATRIX4X2FVPROC glUniformMatrix4x2fv;
-extern PFNGLUNIFORMMATRIX4X3FVPROC glUniformMatrix4x3fv;
-extern PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv;
-
-extern PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstanced;
-extern PFNGLDISPATCHCOMPUTEPROC glDispatchCompute;
-extern PFNGLMEMORYBARRIERPROC glMemoryBarrier;
-
-extern PFNGLGENQUERIESPROC glGenQueries;
-extern PFNGLDELETEQUERIESPROC glDeleteQueries;
-extern PFNGLISQUERYPROC glIsQuery;
-extern PFNGLBEGINQUERYPROC glBeginQuery;
-extern PFNGLENDQUERYPROC glEndQuery;
-extern PFNGLQUERYCOUNTERPROC glQueryCounter;
-extern PFNGLGETQUERYIVPROC glGetQueryiv;
-extern PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectiv;
-extern PFNGLGETQUERYOBJECTUIVPROC glGetQueryObjectuiv;
-extern PFNGLGETQUERYOBJECTI64VPROC glGetQueryObjecti64v;
-extern PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v;
-
-extern PFNGLFENCESYNCPROC glFenceSync;
-extern PFNGLCLIENTWAITSYNCPROC glClientWaitSync;
-extern PFNGLDELETESYNCPROC glDeleteSync;
-extern PFNGLISSYNCPROC glIsSync;
-
-extern PFNGLBLENDFUNCSEPARATEPROC glBlendFuncSeparate;
-extern PFNGLBLENDEQUATIONSEPARATEPROC glBlendEquationSeparate;
-
-extern PFNGLDEBUGMESSAGECONTROLPROC glDebugMessageControl;
-extern PFNGLDEBUGMESSAGECALLBACKPROC glDebugMessageCallback;
 
 #if defined(OS_WINDOWS)
-extern PFNGLBLENDCOLORPROC glBlendColor;
 extern PFNWGLCHOOSEPIXELFORMATARBPROC wglChoosePixelFormatARB;
 extern PFNWGLCREATECONTEXTATTRIBSARBPROC wglCreateContextAttribsARB;
 extern PFNWGLSWAPINTERVALEXTPROC wglSwapIntervalEXT;
@@ -641,32 +784,47 @@ typedef void(GL_APIENTRY *PFNGLBUFFERSTORAGEEXTPROC)(GLenum target, GLsizeiptr s
 typedef void(GL_APIENTRY *PFNGLTEXSTORAGE3DMULTISAMPLEPROC)(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width,
                                                             GLsizei height, GLsizei depth, GLboolean fixedsamplelocations);
 
-// EGL_KHR_fence_sync, GL_OES_EGL_sync, VG_KHR_EGL_sync
-extern PFNEGLCREATESYNCKHRPROC eglCreateSyncKHR_000;
-extern PFNEGLDESTROYSYNCKHRPROC eglDestroySyncKHR_000;
-extern PFNEGLCLIENTWAITSYNCKHRPROC eglClientWaitSyncKHR_000;
-extern PFNEGLGETSYNCATTRIBKHRPROC eglGetSyncAttribKHR_000;
-
-// GL_EXT_disjoint_timer_query
-extern PFNGLQUERYCOUNTEREXTPROC glQueryCounter;
-extern PFNGLGETQUERYOBJECTI64VEXTPROC glGetQueryObjecti64v;
-extern PFNGLGETQUERYOBJECTUI64VEXTPROC glGetQueryObjectui64v;
-
-// GL_EXT_buffer_storage
-extern PFNGLBUFFERSTORAGEEXTPROC glBufferStorage;
-
-// GL_OVR_multiview
-extern PFNGLFRAMEBUFFERTEXTUREMULTIVIEWOVRPROC glFramebufferTextureMultiviewOVR;
+// EGL_KHR_fence_sync, GL_OES_EGL_sync, VG_KHR_EGL_sync, GL_EXT_disjoint_timer_query, GL_EXT_buffer_storage, GL_OVR_multiview,
+// GL_EXT_multisampled_render_to_texture and GL_OVR_multiview_multisampled_render_to_texture.
+#define GL_ENTRY_POINTS(X)                                                                                                                             \
+    X(PFNEGLCREATESYNCKHRPROC, eglCreateSyncKHR_000, "eglCreateSyncKHR")                                                                               \
+    X(PFNEGLDESTROYSYNCKHRPROC, eglDestroySyncKHR_000, "eglDestroySyncKHR")                                                                            \
+    X(PFNEGLCLIENTWAITSYNCKHRPROC, eglClientWaitSyncKHR_000, "eglClientWaitSyncKHR")                                                                   \
+    X(PFNEGLGETSYNCATTRIBKHRPROC, eglGetSyncAttribKHR_000, "eglGetSyncAttribKHR")                                                                      \
+    X(PFNGLQUERYCOUNTEREXTPROC, glQueryCounter, "glQueryCounterEXT")                                                                                   \
+    X(PFNGLGETQUERYOBJECTI64VEXTPROC, glGetQueryObjecti64v, "glGetQueryObjecti64vEXT")                                                                 \
+    X(PFNGLGETQUERYOBJECTUI64VEXTPROC, glGetQueryObjectui64v, "glGetQueryObjectui64vEXT")                                                              \
+    X(PFNGLBUFFERSTORAGEEXTPROC, glBufferStorage, "glBufferStorageEXT")                                                                                \
+    X(PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC, glRenderbufferStorageMultisampleEXT, "glRenderbufferStorageMultisampleEXT")                          \
+    X(PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC, glFramebufferTexture2DMultisampleEXT, "glFramebufferTexture2DMultisampleEXT")                       \
+    X(PFNGLFRAMEBUFFERTEXTUREMULTIVIEWOVRPROC, glFramebufferTextureMultiviewOVR, "glFramebufferTextureMultiviewOVR")                                   \
+    X(PFNGLFRAMEBUFFERTEXTUREMULTISAMPLEMULTIVIEWOVRPROC, glFramebufferTextureMultisampleMultiviewOVR, "glFramebufferTextureMultisampleMultiviewOVR")
 
-// GL_EXT_multisampled_render_to_texture
-extern PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC glRenderbufferStorageMultisampleEXT;
-extern PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC glFramebufferTexture2DMultisampleEXT;
+#ifndef GL_ES_VERSION_3_2
+#define GL_ENTRY_POINTS_EXTRA(X)                                                                 \
+    X(PFNGLTEXSTORAGE3DMULTISAMPLEPROC, glTexStorage3DMultisample, "glTexStorage3DMultisample")
+#else
+#define GL_ENTRY_POINTS_EXTRA(X)
+#endif
 
-// GL_OVR_multiview_multisampled_render_to_texture
-extern PFNGLFRAMEBUFFERTEXTUREMULTISAMPLEMULTIVIEWOVRPROC glFramebufferTextureMultisampleMultiviewOVR;
+GL_ENTRY_POINTS(GL_DECLARE_ENTRY_POINT)
+GL_ENTRY_POINTS_EXTRA(GL_DECLARE_ENTRY_POINT)
+
+#define eglCreateSyncKHR_000 GL_ENTRY_POINT(PFNEGLCREATESYNCKHRPROC, eglCreateSyncKHR_000)
+#define eglDestroySyncKHR_000 GL_ENTRY_POINT(PFNEGLDESTROYSYNCKHRPROC, eglDestroySyncKHR_000)
+#define eglClientWaitSyncKHR_000 GL_ENTRY_POINT(PFNEGLCLIENTWAITSYNCKHRPROC, eglClientWaitSyncKHR_000)
+#define eglGetSyncAttribKHR_000 GL_ENTRY_POINT(PFNEGLGETSYNCATTRIBKHRPROC, eglGetSyncAttribKHR_000)
+#define glQueryCounter GL_ENTRY_POINT(PFNGLQUERYCOUNTEREXTPROC, glQueryCounter)
+#define glGetQueryObjecti64v GL_ENTRY_POINT(PFNGLGETQUERYOBJECTI64VEXTPROC, glGetQueryObjecti64v)
+#define glGetQueryObjectui64v GL_ENTRY_POINT(PFNGLGETQUERYOBJECTUI64VEXTPROC, glGetQueryObjectui64v)
+#define glBufferStorage GL_ENTRY_POINT(PFNGLBUFFERSTORAGEEXTPROC, glBufferStorage)
+#define glRenderbufferStorageMultisampleEXT GL_ENTRY_POINT(PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC, glRenderbufferStorageMultisampleEXT)
+#define glFramebufferTexture2DMultisampleEXT GL_ENTRY_POINT(PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC, glFramebufferTexture2DMultisampleEXT)
+#define glFramebufferTextureMultiviewOVR GL_ENTRY_POINT(PFNGLFRAMEBUFFERTEXTUREMULTIVIEWOVRPROC, glFramebufferTextureMultiviewOVR)
+#define glFramebufferTextureMultisampleMultiviewOVR GL_ENTRY_POINT(PFNGLFRAMEBUFFERTEXTUREMULTISAMPLEMULTIVIEWOVRPROC, glFramebufferTextureMultisampleMultiviewOVR)
 
 #ifndef GL_ES_VERSION_3_2
-extern PFNGLTEXSTORAGE3DMULTISAMPLEPROC glTexStorage3DMultisample;
+#define glTexStorage3DMultisample GL_ENTRY_POINT(PFNGLTEXSTORAGE3DMULTISAMPLEPROC, glTexStorage3DMultisample)
 #endif
 
 #if !defined(EGL_OPENGL_ES3_BIT)
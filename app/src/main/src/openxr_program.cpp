@@ -14,6 +14,18 @@
 #include <cmath>
 #include <math.h>
 #include "cloudXRClient.h"
+#include "metrics.h"
+#include "frame_pacer.h"
+#include "view_resolution.h"
+#include "swapchain_policy.h"
+#include "foveation.h"
+#include "latch_scheduler.h"
+#include "hitch_monitor.h"
+#include "memory_monitor.h"
+#include "click_to_photon.h"
+#include "mirror_window.h"
+#include "session_export.h"
+#include "stream_throttle.h"
 
 #define LOG_MATRICES 0
 
@@ -105,6 +117,8 @@ struct OpenXrProgram : IOpenXrProgram {
         : m_options(*options), m_platformPlugin(platformPlugin), m_graphicsPlugin(graphicsPlugin), m_isSupport_epic_view_configuration_fov_extention(false) {}
 
     ~OpenXrProgram() override {
+        m_framePacer.Stop();
+        m_memoryMonitor.Stop();
         if (m_input.actionSet != XR_NULL_HANDLE) {
             for (auto hand : {Side::LEFT, Side::RIGHT}) {
                 xrDestroySpace(m_input.handSpace[hand]);
@@ -116,6 +130,7 @@ struct OpenXrProgram : IOpenXrProgram {
         for (Swapchain swapchain : m_swapchains) {
             xrDestroySwapchain(swapchain.handle);
         }
+        GpuMemory::Add(GpuMemory::Category::Swapchain, -(int64_t)m_swapchainBytes, -(int32_t)m_swapchains.size());
 
         if (m_appSpace != XR_NULL_HANDLE) {
             xrDestroySpace(m_appSpace);
@@ -147,6 +162,9 @@ struct OpenXrProgram : IOpenXrProgram {
             Log::Write(Log::Level::Info, Fmt("%sAvailable Extensions: (%d)", indentStr.c_str(), instanceExtensionCount));
             for (const XrExtensionProperties& extension : extensions) {
                 Log::Write(Log::Level::Info, Fmt("%sAvailable Extensions:  Name=%s version=%d", indentStr.c_str(), extension.extensionName, extension.extensionVersion));
+                if (layerName == nullptr) {
+                    m_runtimeExtensions.insert(extension.extensionName);
+                }
                 if (strstr(extension.extensionName, XR_EPIC_VIEW_CONFIGURATION_FOV_EXTENSION_NAME)) {
                     m_isSupport_epic_view_configuration_fov_extention = true;
                 }
@@ -188,6 +206,22 @@ struct OpenXrProgram : IOpenXrProgram {
                                          GetXrVersionString(instanceProperties.runtimeVersion).c_str()));
     }
 
+    std::map<std::string, std::string> SessionExportMeta() const {
+        std::map<std::string, std::string> meta = SessionExport::DeviceProfile();
+        XrInstanceProperties instanceProperties{XR_TYPE_INSTANCE_PROPERTIES};
+        if (XR_SUCCEEDED(xrGetInstanceProperties(m_instance, &instanceProperties))) {
+            meta["runtime.name"] = instanceProperties.runtimeName;
+            meta["runtime.version"] = GetXrVersionString(instanceProperties.runtimeVersion);
+        }
+        meta["display.refresh_hz"] = Fmt("%.2f", m_displayRefreshRate);
+        if (!m_swapchains.empty()) {
+            meta["eye.width"] = std::to_string(m_swapchains[0].width);
+            meta["eye.height"] = std::to_string(m_swapchains[0].height);
+        }
+        meta["graphics.plugin"] = m_options.GraphicsPlugin;
+        return meta;
+    }
+
     void CreateInstanceInternal() {
         CHECK(m_instance == XR_NULL_HANDLE);
 
@@ -207,6 +241,21 @@ struct OpenXrProgram : IOpenXrProgram {
             extensions.push_back(XR_EPIC_VIEW_CONFIGURATION_FOV_EXTENSION_NAME);
         }
 
+        m_foveationSupported = std::all_of(Foveation::Extensions().begin(), Foveation::Extensions().end(),
+                                           [this](const char* name) { return m_runtimeExtensions.count(name) != 0; });
+        if (m_foveationSupported && m_options.Foveation != "off") {
+            extensions.insert(extensions.end(), Foveation::Extensions().begin(), Foveation::Extensions().end());
+        }
+
+        m_convertTimeSupported = m_runtimeExtensions.count(LatchScheduler::Extension()) != 0;
+        if (m_convertTimeSupported) {
+            extensions.push_back(LatchScheduler::Extension());
+        }
+
+        if (m_runtimeExtensions.count(StreamThrottle::Extension())) {
+            extensions.push_back(StreamThrottle::Extension());
+        }
+
         XrInstanceCreateInfo createInfo{XR_TYPE_INSTANCE_CREATE_INFO};
         createInfo.next = m_platformPlugin->GetInstanceCreateExtension();
         createInfo.enabledExtensionCount = (uint32_t)extensions.size();
@@ -309,6 +358,7 @@ struct OpenXrProgram : IOpenXrProgram {
 
         // The graphics API can initialize the graphics device now that the systemId and instance
         // handle are available.
+        m_graphicsInitStart = std::chrono::steady_clock::now();
         m_graphicsPlugin->InitializeDevice(m_instance, m_systemId);
     }
 
@@ -726,6 +776,15 @@ struct OpenXrProgram : IOpenXrProgram {
         CHECK_XRCMD(xrGetInstanceProcAddr(m_instance, "xrGetDisplayRefreshRateFB", (PFN_xrVoidFunction*)&m_pfnXrGetDisplayRefreshRateFB));
         m_pfnXrGetDisplayRefreshRateFB(m_session, &m_displayRefreshRate);
         Log::Write(Log::Level::Info, Fmt("device fps:%0.3f", m_displayRefreshRate));
+
+        // Pico 4 panels have the most pixels to save in the periphery.
+        const XrFoveationLevelFB deviceLevel =
+            m_deviceType == DeviceTypePico4 || m_deviceType == DeviceTypePico4Pro ? XR_FOVEATION_LEVEL_MEDIUM_FB : XR_FOVEATION_LEVEL_LOW_FB;
+        m_foveation.Initialize(m_instance, m_foveationSupported && m_options.Foveation != "off", m_options.Foveation, deviceLevel);
+        m_latchScheduler.Initialize(m_instance, m_convertTimeSupported, m_options.JitLatch, m_options.LatchLeadMs);
+        m_hitchMonitor.Start(m_options.HitchPeriods);
+        m_memoryMonitor.Start(m_options.MemoryBudgetMb);
+        m_streamThrottle.Initialize(m_options.Throttle, m_options.ThrottleDelayMs);
     }
 
     void CreateSwapchains() override {
@@ -805,21 +864,24 @@ struct OpenXrProgram : IOpenXrProgram {
             for (uint32_t i = 0; i < viewCount; i++)
             {
                 const XrViewConfigurationView& vp = m_configViews[i];
+                const XrExtent2Di allocated = ViewResolution::AllocationExtent(vp, m_options.MaxResolutionScale);
+                const uint32_t supportedSampleCount = m_graphicsPlugin->GetSupportedSwapchainSampleCount(vp);
+                const SwapchainConfig config = SwapchainPolicy::Select(SwapchainUse::StreamedProjection, m_colorSwapchainFormat, supportedSampleCount);
 
                 Log::Write(Log::Level::Info,
                            Fmt("Creating swapchain for view %d with dimensions Width=%d Height=%d SampleCount=%d", i,
-                               vp.recommendedImageRectWidth, vp.recommendedImageRectHeight, vp.recommendedSwapchainSampleCount));
+                               allocated.width, allocated.height, config.sampleCount));
 
                 // Create the swapchain.
                 XrSwapchainCreateInfo swapchainCreateInfo{XR_TYPE_SWAPCHAIN_CREATE_INFO};
                 swapchainCreateInfo.arraySize = 1;
-                swapchainCreateInfo.format = m_colorSwapchainFormat;
-                swapchainCreateInfo.width = vp.recommendedImageRectWidth;
-                swapchainCreateInfo.height = vp.recommendedImageRectHeight;
+                swapchainCreateInfo.format = config.format;
+                swapchainCreateInfo.width = allocated.width;
+                swapchainCreateInfo.height = allocated.height;
                 swapchainCreateInfo.mipCount = 1;
                 swapchainCreateInfo.faceCount = 1;
-                swapchainCreateInfo.sampleCount = m_graphicsPlugin->GetSupportedSwapchainSampleCount(vp);
-                swapchainCreateInfo.usageFlags = XR_SWAPCHAIN_USAGE_SAMPLED_BIT | XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT;
+                swapchainCreateInfo.sampleCount = config.sampleCount;
+                swapchainCreateInfo.usageFlags = config.usageFlags;
 
                 Swapchain swapchain;
                 swapchain.width = swapchainCreateInfo.width;
@@ -828,12 +890,34 @@ struct OpenXrProgram : IOpenXrProgram {
 
                 m_swapchains.push_back(swapchain);
 
+                // Until the first frame arrives the stream runs at the recommended size.
+                ViewResolution resolution;
+                resolution.Reset(allocated, {(int32_t)vp.recommendedImageRectWidth, (int32_t)vp.recommendedImageRectHeight});
+                m_viewResolutions.push_back(resolution);
+
                 uint32_t imageCount;
                 CHECK_XRCMD(xrEnumerateSwapchainImages(swapchain.handle, 0, &imageCount, nullptr));
                 // XXX This should really just return XrSwapchainImageBaseHeader*
-                std::vector<XrSwapchainImageBaseHeader*> swapchainImages = m_graphicsPlugin->AllocateSwapchainImageStructs(imageCount, swapchainCreateInfo);
+                std::vector<XrSwapchainImageBaseHeader*> swapchainImages =
+                    m_graphicsPlugin->AllocateSwapchainImageStructs(imageCount, swapchainCreateInfo, config.depth);
                 CHECK_XRCMD(xrEnumerateSwapchainImages(swapchain.handle, imageCount, &imageCount, swapchainImages[0]));
 
+                const uint64_t bytes = SwapchainPolicy::EstimateBytes(config, allocated.width, allocated.height, imageCount);
+                const uint64_t unoptimizedBytes = SwapchainPolicy::EstimateBytes(
+                    SwapchainPolicy::Unoptimized(m_colorSwapchainFormat, supportedSampleCount), allocated.width, allocated.height, imageCount);
+                Log::Write(Log::Level::Info, Fmt("Swapchain %d: %s, %u images, usage 0x%llx, %s depth, ~%.1f MB, saves ~%.1f MB", i,
+                                                 SwapchainPolicy::ToString(SwapchainUse::StreamedProjection), imageCount,
+                                                 (unsigned long long)config.usageFlags, config.depth ? "with" : "no", bytes / 1048576.0,
+                                                 (unoptimizedBytes - bytes) / 1048576.0));
+                Metrics::Add("startup.swapchain_mb", bytes / 1048576.0);
+                // Color only: a depth buffer is counted where the graphics plugin allocates it.
+                SwapchainConfig colorOnly = config;
+                colorOnly.depth = false;
+                const uint64_t colorBytes = SwapchainPolicy::EstimateBytes(colorOnly, allocated.width, allocated.height, imageCount);
+                GpuMemory::Add(GpuMemory::Category::Swapchain, (int64_t)colorBytes);
+                m_swapchainBytes += colorBytes;
+                Metrics::Add("startup.swapchain_saved_mb", (unoptimizedBytes - bytes) / 1048576.0);
+
                 m_swapchainImages.insert(std::make_pair(swapchain.handle, std::move(swapchainImages)));
             }
         }
@@ -845,7 +929,7 @@ struct OpenXrProgram : IOpenXrProgram {
         // XR_TYPE_EVENT_DATA_BUFFER
         XrEventDataBaseHeader* baseHeader = reinterpret_cast<XrEventDataBaseHeader*>(&m_eventDataBuffer);
         *baseHeader = {XR_TYPE_EVENT_DATA_BUFFER};
-        const XrResult xr = xrPollEvent(m_instance, &m_eventDataBuffer);
+        const XrResult xr = XR_CALL(xrPollEvent(m_instance, &m_eventDataBuffer));
         if (xr == XR_SUCCESS) {
             if (baseHeader->type == XR_TYPE_EVENT_DATA_EVENTS_LOST) {
                 const XrEventDataEventsLost* const eventsLost = reinterpret_cast<const XrEventDataEventsLost*>(baseHeader);
@@ -862,9 +946,16 @@ struct OpenXrProgram : IOpenXrProgram {
 
     void PollEvents(bool* exitRenderLoop, bool* requestRestart) override {
         *exitRenderLoop = *requestRestart = false;
+        XrCallBudget::SetPhase(XrCallPhase::Events);
 
         // Process all pending messages.
         while (const XrEventDataBaseHeader* event = TryReadNextEvent()) {
+            // Not a case below: the bundled headers' XrStructureType has no value for it.
+            if (event->type == XR_TYPE_EVENT_DATA_USER_PRESENCE_CHANGED_EXT) {
+                const auto& presence = *reinterpret_cast<const XrEventDataUserPresenceChangedEXT*>(event);
+                m_streamThrottle.UserPresence(presence.isUserPresent == XR_TRUE);
+                continue;
+            }
             switch (event->type) {
                 case XR_TYPE_EVENT_DATA_INSTANCE_LOSS_PENDING: {
                     const auto& instanceLossPending = *reinterpret_cast<const XrEventDataInstanceLossPending*>(event);
@@ -889,6 +980,14 @@ struct OpenXrProgram : IOpenXrProgram {
                 }
             }
         }
+
+        if (m_cloudxr.get()) {
+            m_cloudxr->ServiceReceiver();
+        }
+
+        if (m_streamThrottle.Update(std::chrono::steady_clock::now()) && m_cloudxr.get()) {
+            m_cloudxr->SetStreamThrottled(m_streamThrottle.Throttled());
+        }
     }
 
     void HandleSessionStateChangedEvent(const XrEventDataSessionStateChanged& stateChangedEvent, bool* exitRenderLoop, bool* requestRestart) {
@@ -903,6 +1002,8 @@ struct OpenXrProgram : IOpenXrProgram {
             return;
         }
 
+        m_streamThrottle.SessionState(m_sessionState);
+
         switch (m_sessionState) {
             case XR_SESSION_STATE_READY: {
                 CHECK(m_session != XR_NULL_HANDLE);
@@ -910,11 +1011,29 @@ struct OpenXrProgram : IOpenXrProgram {
                 sessionBeginInfo.primaryViewConfigurationType = m_options.Parsed.ViewConfigType;
                 CHECK_XRCMD(xrBeginSession(m_session, &sessionBeginInfo));
                 m_sessionRunning = true;
+                m_hitchMonitor.Reset();
+                if (m_options.ClickToPhoton) {
+                    m_clickToPhoton.Start();
+                }
+                if (m_options.Mirror != 0 && !m_swapchains.empty()) {
+                    m_mirror.Start(m_swapchains[0].width, m_swapchains[0].height, m_options.Mirror == 2);
+                }
+                if (m_options.SessionExport) {
+                    m_sessionExport.Start(SessionExportMeta());
+                }
+                if (m_options.Pipelined) {
+                    m_framePacer.Start(m_session);
+                }
                 break;
             }
             case XR_SESSION_STATE_STOPPING: {
                 CHECK(m_session != XR_NULL_HANDLE);
                 m_sessionRunning = false;
+                m_framePacer.Stop();
+                m_hitchMonitor.Reset();
+                m_clickToPhoton.Stop();
+                m_mirror.Stop();
+                m_sessionExport.Stop();
                 CHECK_XRCMD(xrEndSession(m_session))
                 break;
             }
@@ -977,6 +1096,19 @@ struct OpenXrProgram : IOpenXrProgram {
     bool IsSessionFocused() const override { return m_sessionState == XR_SESSION_STATE_FOCUSED; }
 
     void PollActions() override {
+        XrCallBudget::SetPhase(XrCallPhase::Input);
+
+        // Input is inactive until the session is focused again: release everything once and skip the action calls.
+        if (!IsSessionFocused()) {
+            if (!m_inputReleased && m_cloudxr.get()) {
+                cxrVRTrackingState released{};
+                m_cloudxr->SetTrackingState(released);
+            }
+            m_inputReleased = true;
+            return;
+        }
+        m_inputReleased = false;
+
         // Sync actions
         const XrActiveActionSet activeActionSet{m_input.actionSet, XR_NULL_PATH};
         XrActionsSyncInfo syncInfo{XR_TYPE_ACTIONS_SYNC_INFO};
@@ -1119,6 +1251,12 @@ struct OpenXrProgram : IOpenXrProgram {
             }
         }
 
+        if (m_clickToPhoton.IsRunning()) {
+            const float trigger = std::max(trackingState.controller[Side::LEFT].scalarComps[cxrAnalog_Trigger],
+                                           trackingState.controller[Side::RIGHT].scalarComps[cxrAnalog_Trigger]);
+            m_clickToPhoton.Input(trigger > 0.5f, std::chrono::steady_clock::now());
+        }
+
         if (m_cloudxr.get()) {
             m_cloudxr->SetTrackingState(trackingState);
         }
@@ -1129,21 +1267,33 @@ struct OpenXrProgram : IOpenXrProgram {
 
         XrFrameWaitInfo frameWaitInfo{XR_TYPE_FRAME_WAIT_INFO};
         XrFrameState frameState{XR_TYPE_FRAME_STATE};
-        CHECK_XRCMD(xrWaitFrame(m_session, &frameWaitInfo, &frameState));
+        XrCallBudget::SetPhase(XrCallPhase::Wait);
+        const auto waitStart = std::chrono::steady_clock::now();
+        // Falls back to waiting here if the pacing thread gave up.
+        if (!m_framePacer.IsRunning() || !m_framePacer.Next(&frameState)) {
+            CHECK_XRCMD(xrWaitFrame(m_session, &frameWaitInfo, &frameState));
+        }
+        const auto workStart = std::chrono::steady_clock::now();
+        XrCallBudget::SetPhase(XrCallPhase::Render);
 
         XrFrameBeginInfo frameBeginInfo{XR_TYPE_FRAME_BEGIN_INFO};
         CHECK_XRCMD(xrBeginFrame(m_session, &frameBeginInfo));
 
+        m_latchAttempted = false;
+        m_latched = false;
+
         std::vector<XrCompositionLayerBaseHeader*> layers;
         XrCompositionLayerProjection layer{XR_TYPE_COMPOSITION_LAYER_PROJECTION};
         std::vector<XrCompositionLayerProjectionView> projectionLayerViews;
         if (frameState.shouldRender == XR_TRUE)
         {
-            if (RenderLayer(frameState.predictedDisplayTime, projectionLayerViews, layer)) {
+            if (RenderLayer(frameState.predictedDisplayTime, frameState.predictedDisplayPeriod, projectionLayerViews, layer)) {
 
                 //Log::Write(Log::Level::Info, "BK: RenderFrame ADDING LAYER");
                 layers.push_back(reinterpret_cast<XrCompositionLayerBaseHeader*>(&layer));
             }
+        } else if (m_cloudxr.get()) {
+            m_cloudxr->DrainFrames();
         }
 
         XrFrameEndInfo frameEndInfo{XR_TYPE_FRAME_END_INFO};
@@ -1152,9 +1302,41 @@ struct OpenXrProgram : IOpenXrProgram {
         frameEndInfo.layerCount = (uint32_t)layers.size();
         frameEndInfo.layers = layers.data();
         CHECK_XRCMD(xrEndFrame(m_session, &frameEndInfo));
+        m_latchScheduler.Submitted();
+        XrCallBudget::EndFrame();
+        m_frameTiming.Record(waitStart, workStart, std::chrono::steady_clock::now(), frameState.predictedDisplayPeriod);
+        m_hitchMonitor.FrameEnd(frameState.predictedDisplayPeriod, workStart - waitStart, m_latchAttempted, m_latched, m_latchedPoseID);
+        if (m_sessionExport.IsRunning()) {
+            const auto end = std::chrono::steady_clock::now();
+            SessionExport::Frame frame;
+            frame.end = end;
+            frame.waitUs = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(workStart - waitStart).count();
+            frame.workUs = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(end - workStart).count();
+            frame.displayPeriodUs = (uint32_t)(frameState.predictedDisplayPeriod / 1000);
+            frame.latch = !m_latchAttempted ? SessionExport::LatchNone : m_latched ? SessionExport::LatchLatched : SessionExport::LatchMissed;
+            frame.latchWaitUs = m_latchAttempted ? m_cloudxr->LastLatchUs() : 0;
+            frame.poseID = m_latched ? m_latchedPoseID : 0;
+            m_sessionExport.PushFrame(frame);
+        }
+        m_memoryMonitor.Update();
+        if (m_clickToPhoton.IsRunning()) {
+            m_clickToPhoton.FrameEnd(std::chrono::steady_clock::now());
+        }
+
+        if (!m_firstFrameReported) {
+            // Includes program compilation (or the program cache loads), swapchain creation and session start.
+            m_firstFrameReported = true;
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_graphicsInitStart).count();
+            const std::map<std::string, double> metrics = Metrics::Snapshot();
+            auto metric = [&metrics](const char* name) { return metrics.count(name) ? metrics.at(name) : 0.0; };
+            Metrics::Set("startup.first_frame_ms", ms);
+            Log::Write(Log::Level::Info, Fmt("first frame %.1f ms after graphics init, programs: %.0f cached, %.0f compiled, %.2f ms", ms,
+                                             metric("startup.program_cache_hits"), metric("startup.program_cache_misses"),
+                                             metric("startup.program_build_ms")));
+        }
     }
 
-    bool RenderLayer(XrTime predictedDisplayTime, std::vector<XrCompositionLayerProjectionView>& projectionLayerViews,
+    bool RenderLayer(XrTime predictedDisplayTime, XrDuration predictedDisplayPeriod, std::vector<XrCompositionLayerProjectionView>& projectionLayerViews,
                      XrCompositionLayerProjection& layer) {
         XrResult res;
         XrViewState viewState{XR_TYPE_VIEW_STATE};
@@ -1165,10 +1347,11 @@ struct OpenXrProgram : IOpenXrProgram {
         viewLocateInfo.displayTime = predictedDisplayTime;
         viewLocateInfo.space = m_appSpace;
 
-        res = xrLocateViews(m_session, &viewLocateInfo, &viewState, viewCapacityInput, &viewCountOutput, m_views.data());
+        res = XR_CALL(xrLocateViews(m_session, &viewLocateInfo, &viewState, viewCapacityInput, &viewCountOutput, m_views.data()));
         CHECK_XRRESULT(res, "xrLocateViews");
         if ((viewState.viewStateFlags & XR_VIEW_STATE_POSITION_VALID_BIT) == 0 ||
             (viewState.viewStateFlags & XR_VIEW_STATE_ORIENTATION_VALID_BIT) == 0) {
+            m_cloudxr->DrainFrames();
             return false;  // There is no valid tracking poses for the views.
         }
 
@@ -1184,7 +1367,7 @@ struct OpenXrProgram : IOpenXrProgram {
         std::vector<XrPosef> handPose;
         for (auto hand : {Side::LEFT, Side::RIGHT}) {
             XrSpaceLocation spaceLocation{XR_TYPE_SPACE_LOCATION};
-            res = xrLocateSpace(m_input.handSpace[hand], m_appSpace, predictedDisplayTime, &spaceLocation);
+            res = XR_CALL(xrLocateSpace(m_input.handSpace[hand], m_appSpace, predictedDisplayTime, &spaceLocation));
             CHECK_XRRESULT(res, "xrLocateSpace");
             if (XR_UNQUALIFIED_SUCCESS(res)) {
                 if ((spaceLocation.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) != 0 &&
@@ -1196,13 +1379,20 @@ struct OpenXrProgram : IOpenXrProgram {
 
         XrSpaceVelocity velocity{XR_TYPE_SPACE_VELOCITY};
         XrSpaceLocation spaceLocation{XR_TYPE_SPACE_LOCATION, &velocity};
-        res = xrLocateSpace(m_ViewSpace, m_appSpace, predictedDisplayTime, &spaceLocation);
+        res = XR_CALL(xrLocateSpace(m_ViewSpace, m_appSpace, predictedDisplayTime, &spaceLocation));
         CHECK_XRRESULT(res, "xrLocateSpace");
 
         m_cloudxr->SetSenserPoseState(spaceLocation.pose, velocity.linearVelocity, velocity.angularVelocity, handPose, ipd);
 
         cxrFramesLatched framesLatched{};
+        m_latchScheduler.WaitToLatch(predictedDisplayTime, predictedDisplayPeriod);
         bool framevaild = m_cloudxr->LatchFrame(&framesLatched);
+        m_latchScheduler.Latched(framevaild, m_cloudxr->LastFrameWaitMs());
+        m_latchAttempted = true;
+        m_latched = framevaild;
+        if (framevaild) {
+            m_latchedPoseID = framesLatched.poseID;
+        }
 
         XrPosef pose[Side::COUNT];
         for (uint32_t i = 0; i < viewCountOutput; i++) {
@@ -1219,10 +1409,26 @@ struct OpenXrProgram : IOpenXrProgram {
                 pose[i].position = position;
                 pose[i].orientation = orientation;
             }
+            for (uint32_t i = 0; i < viewCountOutput; i++) {
+                const cxrVideoFrame& frame = framesLatched.frames[i];
+                if (m_viewResolutions[i].Update(frame.widthFinal, frame.heightFinal)) {
+                    const XrRect2Di& rect = m_viewResolutions[i].ActiveRect();
+                    Log::Write(Log::Level::Info, Fmt("view %d: streaming %ux%u into %dx%d of a %dx%d swapchain", i, frame.widthFinal, frame.heightFinal,
+                                                     rect.extent.width, rect.extent.height, m_swapchains[i].width, m_swapchains[i].height));
+                    if (i == 0) {
+                        Metrics::Set("frame.active_width", rect.extent.width);
+                        Metrics::Set("frame.active_height", rect.extent.height);
+                    }
+                }
+            }
         } else {
             Log::Write(Log::Level::Info, Fmt("not get framesLatched"));
         }
 
+        m_foveation.Update(m_session, m_swapchains);
+
+        const bool mirror = framevaild && m_mirror.BeginFrame();
+
         // Render view to the appropriate part of the swapchain image.
         for (uint32_t i = 0; i < viewCountOutput; i++)
         {
@@ -1241,8 +1447,7 @@ struct OpenXrProgram : IOpenXrProgram {
             projectionLayerViews[i].pose = pose[i];
             projectionLayerViews[i].fov = m_views[i].fov;
             projectionLayerViews[i].subImage.swapchain = viewSwapchain.handle;
-            projectionLayerViews[i].subImage.imageRect.offset = {0, 0};
-            projectionLayerViews[i].subImage.imageRect.extent = {viewSwapchain.width, viewSwapchain.height};
+            projectionLayerViews[i].subImage.imageRect = m_viewResolutions[i].ActiveRect();
 
 #if LOG_MATRICES
             static bool log_projection_matrices = true;
@@ -1278,16 +1483,26 @@ struct OpenXrProgram : IOpenXrProgram {
 
             const uint32_t colorTexture = reinterpret_cast<const XrSwapchainImageOpenGLESKHR*>(swapchainImage)->image;
 
-            if (m_cloudxr->SetupFramebuffer(colorTexture, i, projectionLayerViews[i].subImage.imageRect.extent.width, projectionLayerViews[i].subImage.imageRect.extent.height))
+            if (m_cloudxr->SetupFramebuffer(colorTexture, i, projectionLayerViews[i].subImage.imageRect))
             {
                 cxrVideoFrame &videoFrame = framesLatched.frames[i];
                 m_cloudxr->BlitFrame(&framesLatched, framevaild, i);
+                if (i == 0 && framevaild && m_clickToPhoton.IsRunning()) {
+                    const XrRect2Di& rect = projectionLayerViews[i].subImage.imageRect;
+                    m_clickToPhoton.Readback(rect.offset.x + rect.extent.width / 2, rect.offset.y + rect.extent.height / 2);
+                }
+                if (mirror) {
+                    m_mirror.CopyEye(i, colorTexture, projectionLayerViews[i].subImage.imageRect);
+                }
             }
 
             XrSwapchainImageReleaseInfo releaseInfo{XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO};
             CHECK_XRCMD(xrReleaseSwapchainImage(viewSwapchain.handle, &releaseInfo));
         }
 
+        if (mirror) {
+            m_mirror.EndFrame();
+        }
         if (framevaild) {
             m_cloudxr->ReleaseFrame(&framesLatched);
         }
@@ -1305,9 +1520,15 @@ struct OpenXrProgram : IOpenXrProgram {
     bool CreateCloudxrClient() override {
         Log::Write(Log::Level::Info, "BK: CreateCloudxrClient");
         m_cloudxr = std::make_shared<CloudXRClient>();
+        // Shed in this order: the mirror only serves whoever watches the window, the blit worker's three
+        // slots of both eyes at the stream size are the largest allocation the client can do without.
+        m_memoryMonitor.AddShedder("mirror", [this]() { m_mirror.Stop(); });
+        m_memoryMonitor.AddShedder("blit worker", [this]() { m_cloudxr->ShedBlitWorker(); });
         return true;
     }
 
+    void SetMirrorWindow(EGLNativeWindowType window) override { m_mirror.SetNativeWindow(window); }
+
     void SetCloudxrClientPaused(bool pause) override {
         if (m_cloudxr.get()) {
             m_cloudxr->SetPaused(pause);
@@ -1319,6 +1540,7 @@ struct OpenXrProgram : IOpenXrProgram {
         Log::Write(Log::Level::Info, "BK: StartCloudxrClient");
 
         if (m_cloudxr.get()) {
+            m_cloudxr->SetMaxResolutionFactor(m_options.MaxResolutionScale);
             m_cloudxr->Initialize(m_instance, m_systemId, m_session, m_displayRefreshRate, m_isSupport_epic_view_configuration_fov_extention, (void*)this, [](void *arg, int controllerIdx, float amplitude, float seconds, float frequency) {
                 Log::Write(Log::Level::Error, Fmt("this:%p, index:%d, amplitude:%f, seconds:%f, frequency:%f", arg, controllerIdx, amplitude, seconds, frequency));
                 OpenXrProgram* thiz = (OpenXrProgram*)arg;
@@ -1329,7 +1551,11 @@ struct OpenXrProgram : IOpenXrProgram {
                 XrHapticActionInfo hapticActionInfo{XR_TYPE_HAPTIC_ACTION_INFO};
                 hapticActionInfo.action = thiz->m_input.hapticAction;
                 hapticActionInfo.subactionPath = thiz->m_input.handSubactionPath[controllerIdx];
-                CHECK_XRCMD(xrApplyHapticFeedback(thiz->m_session, &hapticActionInfo, (XrHapticBaseHeader*)&vibration));
+                // Not CHECK_XRCMD: this is CloudXR's haptic thread, and the call budget belongs to the render thread.
+                const XrResult result = xrApplyHapticFeedback(thiz->m_session, &hapticActionInfo, (XrHapticBaseHeader*)&vibration);
+                if (XR_FAILED(result)) {
+                    Log::Write(Log::Level::Error, Fmt("xrApplyHapticFeedback failed: %s", to_string(result)));
+                }
             });
         }
     }
@@ -1345,6 +1571,7 @@ struct OpenXrProgram : IOpenXrProgram {
 
     std::vector<XrViewConfigurationView> m_configViews;
     std::vector<Swapchain> m_swapchains;
+    std::vector<ViewResolution> m_viewResolutions;
     std::map<XrSwapchain, std::vector<XrSwapchainImageBaseHeader*>> m_swapchainImages;
     std::vector<XrView> m_views;
     int64_t m_colorSwapchainFormat{-1};
@@ -1361,8 +1588,32 @@ struct OpenXrProgram : IOpenXrProgram {
     PFN_xrGetDisplayRefreshRateFB m_pfnXrGetDisplayRefreshRateFB;
     float m_displayRefreshRate;
     bool m_isSupport_epic_view_configuration_fov_extention;
-    DeviceType m_deviceType;
+    DeviceType m_deviceType{DeviceTypeNone};
     uint32_t m_deviceROM;
+    std::chrono::steady_clock::time_point m_graphicsInitStart;
+    bool m_firstFrameReported{false};
+    FramePacer m_framePacer;
+    FrameTiming m_frameTiming;
+    // Capability snapshot: instance extensions the runtime offered, taken before the instance is created.
+    std::set<std::string> m_runtimeExtensions;
+    bool m_foveationSupported{false};
+    Foveation m_foveation;
+    bool m_convertTimeSupported{false};
+    LatchScheduler m_latchScheduler;
+    HitchMonitor m_hitchMonitor;
+    MemoryMonitor m_memoryMonitor;
+    ClickToPhoton m_clickToPhoton;
+    MirrorWindow m_mirror;
+    SessionExport m_sessionExport;
+    StreamThrottle m_streamThrottle;
+    // PollActions sent the released state since the session lost focus.
+    bool m_inputReleased{false};
+    // What the swapchains were accounted with, for the memory monitor.
+    uint64_t m_swapchainBytes{0};
+    // This frame's latch, for the hitch monitor.
+    bool m_latchAttempted{false};
+    bool m_latched{false};
+    uint64_t m_latchedPoseID{0};
 };
 }  // namespace
 
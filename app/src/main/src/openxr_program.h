@@ -41,6 +41,9 @@ struct IOpenXrProgram {
     virtual void StartCloudxrClient() = 0;
     
     virtual void SetCloudxrClientPaused(bool pause) = 0;
+
+    // The window the mirror presents into, nullptr when it is gone, see mirror_window.h.
+    virtual void SetMirrorWindow(EGLNativeWindowType window) = 0;
 };
 
 struct Swapchain {
@@ -15,6 +15,39 @@ struct Options {
 
     std::string AppSpace{"Local"};
 
+    // xrWaitFrame on a separate pacing thread, see frame_pacer.h.
+    bool Pipelined{false};
+
+    // Swapchains are allocated at up to this multiple of the recommended size, see view_resolution.h.
+    float MaxResolutionScale{1.0f};
+
+    // auto|off|low|medium|high, see foveation.h.
+    std::string Foveation{"auto"};
+
+    // Latch CloudXR frames as late as the display time allows, see latch_scheduler.h. 0 lead: one display period.
+    bool JitLatch{false};
+    float LatchLeadMs{0.0f};
+
+    // Frame interval, in display periods, that writes a hitch snapshot, see hitch_monitor.h. 0 turns it off.
+    float HitchPeriods{0.0f};
+
+    // PSS plus swapped PSS in MB past which optional features are shed, see memory_monitor.h. 0 only monitors.
+    float MemoryBudgetMb{0.0f};
+
+    // Time scripted trigger presses to the stand-in frames that show them, see click_to_photon.h.
+    bool ClickToPhoton{false};
+
+    // Mirror the eyes from a thread of its own, see mirror_window.h: 0 off, 1 into the activity's window,
+    // 2 into a desktop window on the linux simulator (desktop_mirror.h).
+    int Mirror{0};
+
+    // Write per-frame and per-second records of every session to a columnar file, see session_export.h.
+    bool SessionExport{false};
+
+    // Reconnect at a reduced rate while unfocused or the user is away, after the delay, see stream_throttle.h.
+    bool Throttle{true};
+    float ThrottleDelayMs{3000.0f};
+
     struct {
         XrFormFactor FormFactor{XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY};
 
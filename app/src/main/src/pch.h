@@ -50,6 +50,10 @@
 #include <android/native_window.h>
 #include <jni.h>
 #include <sys/system_properties.h>
+// XrTime to CLOCK_MONOTONIC, see latch_scheduler.h.
+#ifndef XR_USE_TIMESPEC
+#define XR_USE_TIMESPEC
+#endif
 #endif
 
 #ifdef XR_USE_PLATFORM_WAYLAND
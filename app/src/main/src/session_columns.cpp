@@ -0,0 +1,400 @@
+/*
+    columnar file format of the session export.
+*/
+#include "session_columns.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace SessionColumns {
+
+namespace {
+
+enum ChunkType : uint8_t {
+    Chunk_Strings = 1,
+    Chunk_Session = 2,
+    Chunk_Table = 3,
+};
+
+enum Encoding : uint8_t {
+    Encoding_Delta = 1,
+    Encoding_Dictionary = 2,
+    Encoding_Float = 3,
+};
+
+void PutVarint(std::string* out, uint64_t value) {
+    while (value >= 0x80) {
+        out->push_back((char)(value | 0x80));
+        value >>= 7;
+    }
+    out->push_back((char)value);
+}
+
+uint64_t ZigZag(int64_t value) { return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63); }
+
+int64_t UnZigZag(uint64_t value) { return (int64_t)(value >> 1) ^ -(int64_t)(value & 1); }
+
+void PutChunk(std::string* out, ChunkType type, const std::string& payload) {
+    out->push_back((char)type);
+    PutVarint(out, payload.size());
+    out->append(payload);
+}
+
+std::string EncodeDelta(const std::vector<int64_t>& values) {
+    std::string out;
+    int64_t previous = 0;
+    for (int64_t value : values) {
+        PutVarint(&out, ZigZag((int64_t)((uint64_t)value - (uint64_t)previous)));
+        previous = value;
+    }
+    return out;
+}
+
+// Empty when there are more distinct values than fit a byte.
+std::string EncodeDictionary(const std::vector<int64_t>& values) {
+    std::vector<int64_t> distinct;
+    std::string indices;
+    indices.reserve(values.size());
+    for (int64_t value : values) {
+        size_t index = std::find(distinct.begin(), distinct.end(), value) - distinct.begin();
+        if (index == distinct.size()) {
+            if (distinct.size() == 256) {
+                return std::string();
+            }
+            distinct.push_back(value);
+        }
+        indices.push_back((char)index);
+    }
+    std::string out;
+    PutVarint(&out, distinct.size());
+    for (int64_t value : distinct) {
+        PutVarint(&out, ZigZag(value));
+    }
+    return out + indices;
+}
+
+class Reader {
+public:
+    Reader(const uint8_t* data, size_t size) : mData(data), mEnd(data + size) {}
+
+    bool Varint(uint64_t* value) {
+        *value = 0;
+        for (int shift = 0; shift < 64 && mData < mEnd; shift += 7) {
+            const uint8_t byte = *mData++;
+            *value |= (uint64_t)(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Bytes(size_t size, const uint8_t** bytes) {
+        if ((size_t)(mEnd - mData) < size) {
+            return false;
+        }
+        *bytes = mData;
+        mData += size;
+        return true;
+    }
+
+    bool AtEnd() const { return mData == mEnd; }
+
+private:
+    const uint8_t* mData;
+    const uint8_t* mEnd;
+};
+
+bool DecodeColumn(uint8_t encoding, const uint8_t* data, size_t size, size_t rows, Column* column) {
+    Reader reader(data, size);
+    uint64_t value = 0;
+    switch (encoding) {
+        case Encoding_Delta: {
+            int64_t previous = 0;
+            for (size_t row = 0; row < rows; row++) {
+                if (!reader.Varint(&value)) {
+                    return false;
+                }
+                previous = (int64_t)((uint64_t)previous + (uint64_t)UnZigZag(value));
+                column->ints.push_back(previous);
+            }
+            return true;
+        }
+        case Encoding_Dictionary: {
+            std::vector<int64_t> distinct;
+            if (!reader.Varint(&value) || value > 256) {
+                return false;
+            }
+            distinct.resize(value);
+            for (int64_t& entry : distinct) {
+                if (!reader.Varint(&value)) {
+                    return false;
+                }
+                entry = UnZigZag(value);
+            }
+            const uint8_t* indices = nullptr;
+            if (!reader.Bytes(rows, &indices)) {
+                return false;
+            }
+            for (size_t row = 0; row < rows; row++) {
+                if (indices[row] >= distinct.size()) {
+                    return false;
+                }
+                column->ints.push_back(distinct[indices[row]]);
+            }
+            return true;
+        }
+        case Encoding_Float: {
+            const uint8_t* floats = nullptr;
+            if (!reader.Bytes(rows * sizeof(float), &floats)) {
+                return false;
+            }
+            column->isFloat = true;
+            column->floats.resize(rows);
+            memcpy(column->floats.data(), floats, rows * sizeof(float));
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+bool DecodeTable(Reader& reader, const std::vector<std::string>& strings, Table* table) {
+    uint64_t name = 0;
+    uint64_t rows = 0;
+    uint64_t columns = 0;
+    if (!reader.Varint(&name) || name >= strings.size() || !reader.Varint(&rows) || !reader.Varint(&columns)) {
+        return false;
+    }
+    table->name = strings[name];
+    for (uint64_t i = 0; i < columns; i++) {
+        uint64_t columnName = 0;
+        uint64_t size = 0;
+        const uint8_t* encoding = nullptr;
+        const uint8_t* payload = nullptr;
+        if (!reader.Varint(&columnName) || columnName >= strings.size() || !reader.Bytes(1, &encoding) || !reader.Varint(&size) ||
+            !reader.Bytes(size, &payload)) {
+            return false;
+        }
+        Column column;
+        column.name = strings[columnName];
+        if (!DecodeColumn(*encoding, payload, size, rows, &column)) {
+            return false;
+        }
+        table->columns.push_back(std::move(column));
+    }
+    return true;
+}
+
+}  // namespace
+
+const Column* Table::Find(const std::string& column) const {
+    for (const Column& entry : columns) {
+        if (entry.name == column) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<Table> Session::Tables() const {
+    std::vector<Table> tables;
+    for (const Table& chunk : chunks) {
+        auto table = std::find_if(tables.begin(), tables.end(), [&chunk](const Table& entry) { return entry.name == chunk.name; });
+        if (table == tables.end()) {
+            tables.push_back(Table{chunk.name, {}});
+            table = tables.end() - 1;
+        }
+        const size_t rows = table->Rows();
+        // Columns missing from a chunk read as NaN, or 0 for integer columns.
+        for (const Column& column : chunk.columns) {
+            if (table->Find(column.name) == nullptr) {
+                Column added;
+                added.name = column.name;
+                added.isFloat = column.isFloat;
+                added.ints.resize(column.isFloat ? 0 : rows, 0);
+                added.floats.resize(column.isFloat ? rows : 0, std::numeric_limits<float>::quiet_NaN());
+                table->columns.push_back(std::move(added));
+            }
+        }
+        for (Column& column : table->columns) {
+            const Column* source = chunk.Find(column.name);
+            if (column.isFloat) {
+                for (size_t row = 0; row < chunk.Rows(); row++) {
+                    column.floats.push_back(source != nullptr ? (float)source->Value(row) : std::numeric_limits<float>::quiet_NaN());
+                }
+            } else if (source != nullptr && !source->isFloat) {
+                column.ints.insert(column.ints.end(), source->ints.begin(), source->ints.end());
+            } else {
+                column.ints.resize(column.ints.size() + chunk.Rows(), 0);
+            }
+        }
+    }
+    return tables;
+}
+
+std::string Encoder::Header() const {
+    std::string out(8, '\0');
+    memcpy(&out[0], &kMagic, 4);
+    memcpy(&out[4], &kVersion, 4);
+    return out;
+}
+
+uint32_t Encoder::Id(const std::string& value) {
+    const auto found = mIds.find(value);
+    if (found != mIds.end()) {
+        return found->second;
+    }
+    const uint32_t id = (uint32_t)mIds.size();
+    mIds.emplace(value, id);
+    mAdded.push_back(value);
+    return id;
+}
+
+std::string Encoder::TakeStrings() {
+    std::string out;
+    if (mAdded.empty()) {
+        return out;
+    }
+    std::string payload;
+    PutVarint(&payload, mAdded.size());
+    for (const std::string& value : mAdded) {
+        PutVarint(&payload, value.size());
+        payload.append(value);
+    }
+    mAdded.clear();
+    PutChunk(&out, Chunk_Strings, payload);
+    return out;
+}
+
+std::string Encoder::SessionChunk(const std::map<std::string, std::string>& meta) {
+    std::string payload;
+    PutVarint(&payload, meta.size());
+    for (const auto& entry : meta) {
+        PutVarint(&payload, Id(entry.first));
+        PutVarint(&payload, Id(entry.second));
+    }
+    std::string out = TakeStrings();
+    PutChunk(&out, Chunk_Session, payload);
+    return out;
+}
+
+std::string Encoder::TableChunk(const Table& table) {
+    std::string payload;
+    PutVarint(&payload, Id(table.name));
+    PutVarint(&payload, table.Rows());
+    PutVarint(&payload, table.columns.size());
+    for (const Column& column : table.columns) {
+        std::string encoded;
+        Encoding encoding = Encoding_Float;
+        if (column.isFloat) {
+            encoded.assign((const char*)column.floats.data(), column.floats.size() * sizeof(float));
+        } else {
+            encoded = EncodeDelta(column.ints);
+            encoding = Encoding_Delta;
+            const std::string dictionary = EncodeDictionary(column.ints);
+            if (!dictionary.empty() && dictionary.size() < encoded.size()) {
+                encoded = dictionary;
+                encoding = Encoding_Dictionary;
+            }
+        }
+        PutVarint(&payload, Id(column.name));
+        payload.push_back((char)encoding);
+        PutVarint(&payload, encoded.size());
+        payload.append(encoded);
+    }
+    std::string out = TakeStrings();
+    PutChunk(&out, Chunk_Table, payload);
+    return out;
+}
+
+bool Load(const std::string& path, std::vector<Session>* sessions, std::string* error) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        *error = "cannot open " + path;
+        return false;
+    }
+    std::vector<uint8_t> data;
+    uint8_t buffer[65536];
+    size_t read = 0;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.insert(data.end(), buffer, buffer + read);
+    }
+    fclose(file);
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    if (data.size() >= 8) {
+        memcpy(&magic, &data[0], 4);
+        memcpy(&version, &data[4], 4);
+    }
+    if (magic != kMagic) {
+        *error = path + " is not a session export";
+        return false;
+    }
+    if (version != kVersion) {
+        *error = path + " has unsupported version " + std::to_string(version);
+        return false;
+    }
+
+    std::vector<std::string> strings;
+    Reader reader(data.data() + 8, data.size() - 8);
+    while (!reader.AtEnd()) {
+        const uint8_t* type = nullptr;
+        uint64_t size = 0;
+        const uint8_t* payload = nullptr;
+        if (!reader.Bytes(1, &type) || !reader.Varint(&size) || !reader.Bytes(size, &payload)) {
+            break;  // cut short while writing
+        }
+        Reader chunk(payload, size);
+        bool valid = true;
+        uint64_t count = 0;
+        switch (*type) {
+            case Chunk_Strings:
+                valid = chunk.Varint(&count);
+                for (uint64_t i = 0; valid && i < count; i++) {
+                    uint64_t length = 0;
+                    const uint8_t* bytes = nullptr;
+                    valid = chunk.Varint(&length) && chunk.Bytes(length, &bytes);
+                    if (valid) {
+                        strings.emplace_back((const char*)bytes, length);
+                    }
+                }
+                break;
+            case Chunk_Session:
+                sessions->emplace_back();
+                valid = chunk.Varint(&count);
+                for (uint64_t i = 0; valid && i < count; i++) {
+                    uint64_t key = 0;
+                    uint64_t value = 0;
+                    valid = chunk.Varint(&key) && chunk.Varint(&value) && key < strings.size() && value < strings.size();
+                    if (valid) {
+                        sessions->back().meta[strings[key]] = strings[value];
+                    }
+                }
+                break;
+            case Chunk_Table: {
+                if (sessions->empty()) {
+                    sessions->emplace_back();
+                }
+                Table table;
+                valid = DecodeTable(chunk, strings, &table);
+                if (valid) {
+                    sessions->back().chunks.push_back(std::move(table));
+                }
+                break;
+            }
+            default:
+                break;  // unknown chunk types are skipped
+        }
+        if (!valid) {
+            *error = path + " has a corrupt chunk";
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace SessionColumns
@@ -0,0 +1,74 @@
+/*
+    columnar file format of the session export (session_export.h), standard C++ only so the host tool
+    (session_tool/session_tool.cpp) builds it as well.
+
+    a file is the header, "CXCS" and a version, followed by chunks: a type byte, the payload length as a
+    varint, the payload. there are three chunk types:
+      strings   appends names to the file's string dictionary, ids counting up from 0 across the file.
+      session   starts a session: key/value pairs (string ids) of device profile and config; every table
+                chunk up to the next session chunk belongs to it. merged files are several sessions.
+      table     a block of rows of one table (name id, row count, column count), then per column its
+                name id, encoding, payload length and payload.
+    integer columns are stored as zigzag varints of the deltas to the previous row, or as a dictionary of
+    distinct values plus one byte per row, whichever is smaller. float columns are raw little endian
+    floats, NaN where a row has no value. all varints are LEB128.
+*/
+#pragma once
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace SessionColumns {
+
+const uint32_t kMagic = 0x53435843;  // "CXCS"
+const uint32_t kVersion = 1;
+
+struct Column {
+    std::string name;
+    bool isFloat = false;
+    std::vector<int64_t> ints;
+    std::vector<float> floats;
+
+    size_t Rows() const { return isFloat ? floats.size() : ints.size(); }
+    double Value(size_t row) const { return isFloat ? floats[row] : (double)ints[row]; }
+};
+
+struct Table {
+    std::string name;
+    std::vector<Column> columns;
+
+    size_t Rows() const { return columns.empty() ? 0 : columns[0].Rows(); }
+    const Column* Find(const std::string& column) const;
+};
+
+struct Session {
+    std::map<std::string, std::string> meta;
+    // One entry per table chunk, in file order; Tables() concatenates the chunks of one table.
+    std::vector<Table> chunks;
+
+    std::vector<Table> Tables() const;
+};
+
+// Encodes a file chunk by chunk, keeping the string dictionary across chunks. Not thread safe.
+class Encoder {
+public:
+    std::string Header() const;
+    std::string SessionChunk(const std::map<std::string, std::string>& meta);
+    // All columns must have the same number of rows.
+    std::string TableChunk(const Table& table);
+
+private:
+    uint32_t Id(const std::string& value);
+    std::string TakeStrings();
+
+    std::unordered_map<std::string, uint32_t> mIds;
+    std::vector<std::string> mAdded;  // since the last strings chunk
+};
+
+// Reads a whole file. A file cut short, e.g. by the app being killed, loads up to its last complete chunk.
+bool Load(const std::string& path, std::vector<Session>* sessions, std::string* error);
+
+}  // namespace SessionColumns
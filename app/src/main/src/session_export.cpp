@@ -0,0 +1,216 @@
+/*
+    per-session export for fleet analytics.
+*/
+#include "pch.h"
+#include "common.h"
+#include "session_export.h"
+#include "metrics.h"
+
+#include <limits>
+
+namespace {
+
+const char* const kFrameColumns[] = {"time_us", "interval_us", "wait_us", "work_us", "display_period_us", "latch", "latch_wait_us", "pose_id"};
+const size_t kFrameColumnCount = sizeof(kFrameColumns) / sizeof(kFrameColumns[0]);
+
+int64_t Us(std::chrono::steady_clock::duration duration) { return std::chrono::duration_cast<std::chrono::microseconds>(duration).count(); }
+
+void CollectConfigProperty(const prop_info* info, void* cookie) {
+    __system_property_read_callback(
+        info,
+        [](void* cookie, const char* name, const char* value, uint32_t) {
+            const std::string key(name);
+            if (key.compare(0, 9, "debug.xr.") == 0 || key.compare(0, 10, "debug.cxr.") == 0) {
+                (*static_cast<std::map<std::string, std::string>*>(cookie))[key] = value;
+            }
+        },
+        cookie);
+}
+
+}  // namespace
+
+std::map<std::string, std::string> SessionExport::DeviceProfile() {
+    std::map<std::string, std::string> profile;
+    const char* const properties[][2] = {{"device.manufacturer", "ro.product.manufacturer"},
+                                         {"device.model", "ro.product.model"},
+                                         {"device.product", "sys.pxr.product.name"},
+                                         {"device.build", "ro.build.id"},
+                                         {"device.sdk", "ro.build.version.sdk"}};
+    for (const auto& property : properties) {
+        char value[PROP_VALUE_MAX] = {};
+        __system_property_get(property[1], value);
+        profile[property[0]] = value;
+    }
+
+    // Sorted by name, so the hash does not depend on the order the properties were set in.
+    std::map<std::string, std::string> config;
+    __system_property_foreach(CollectConfigProperty, &config);
+    uint64_t hash = 14695981039346656037ull;  // FNV-1a
+    for (const auto& entry : config) {
+        for (const char c : entry.first + "=" + entry.second + "\n") {
+            hash = (hash ^ (uint8_t)c) * 1099511628211ull;
+        }
+        profile["config." + entry.first] = entry.second;
+    }
+    profile["config.hash"] = Fmt("%016llx", (unsigned long long)hash);
+    return profile;
+}
+
+bool SessionExport::Start(const std::map<std::string, std::string>& meta) {
+    Stop();
+    const time_t wall = time(nullptr);
+    struct tm local = {};
+    localtime_r(&wall, &local);
+    char stamp[32] = {};
+    strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &local);
+    mPath = Fmt("/sdcard/CloudXRSession_%s.cxcs", stamp);
+    mFile = fopen(mPath.c_str(), "wb");
+    if (mFile == nullptr) {
+        Log::Write(Log::Level::Error, Fmt("session export: cannot open %s", mPath.c_str()));
+        return false;
+    }
+
+    std::map<std::string, std::string> sessionMeta = meta;
+    sessionMeta["session.start"] = stamp;
+    mEncoder = SessionColumns::Encoder();
+    const std::string header = mEncoder.Header() + mEncoder.SessionChunk(sessionMeta);
+    fwrite(header.data(), 1, header.size(), mFile);
+    mBytes = header.size();
+
+    mFrames = SessionColumns::Table{"frame", {}};
+    for (const char* name : kFrameColumns) {
+        SessionColumns::Column column;
+        column.name = name;
+        column.ints.reserve(kChunkFrames);
+        mFrames.columns.push_back(std::move(column));
+    }
+    mSeconds.clear();
+    mHead = 0;
+    mTail = 0;
+    mDropped = 0;
+    mStart = Clock::now();
+    mLastFrameEnd = Clock::time_point{};
+    mStopping = false;
+    mRunning = true;
+    mThread = std::thread(&SessionExport::Run, this);
+    Log::Write(Log::Level::Info, Fmt("session export: writing %s", mPath.c_str()));
+    return true;
+}
+
+void SessionExport::Stop() {
+    if (!mRunning) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWake.notify_all();
+    mThread.join();
+    mRunning = false;
+}
+
+void SessionExport::PushFrame(const Frame& frame) {
+    const uint32_t head = mHead.load(std::memory_order_relaxed);
+    if (head - mTail.load(std::memory_order_acquire) == kRingSize) {
+        mDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    mRing[head % kRingSize] = frame;
+    mHead.store(head + 1, std::memory_order_release);
+}
+
+void SessionExport::Run() {
+    auto nextSecond = Clock::now() + std::chrono::seconds(1);
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (!mStopping) {
+        mWake.wait_for(lock, std::chrono::milliseconds(100), [this]() { return mStopping; });
+        lock.unlock();
+        Drain();
+        if (Clock::now() >= nextSecond) {
+            nextSecond += std::chrono::seconds(1);
+            AddSecond();
+        }
+        lock.lock();
+    }
+    lock.unlock();
+
+    Drain();
+    WriteChunks();
+    fclose(mFile);
+    mFile = nullptr;
+    Log::Write(Log::Level::Info, Fmt("session export: %.1f KB written to %s, %llu frames dropped", mBytes / 1024.0, mPath.c_str(),
+                                     (unsigned long long)mDropped.load()));
+}
+
+void SessionExport::Drain() {
+    uint32_t tail = mTail.load(std::memory_order_relaxed);
+    const uint32_t head = mHead.load(std::memory_order_acquire);
+    for (; tail != head; tail++) {
+        const Frame& frame = mRing[tail % kRingSize];
+        const int64_t values[kFrameColumnCount] = {Us(frame.end - mStart),
+                                                   mLastFrameEnd == Clock::time_point{} ? 0 : Us(frame.end - mLastFrameEnd),
+                                                   frame.waitUs,
+                                                   frame.workUs,
+                                                   frame.displayPeriodUs,
+                                                   frame.latch,
+                                                   frame.latchWaitUs,
+                                                   (int64_t)frame.poseID};
+        mLastFrameEnd = frame.end;
+        for (size_t i = 0; i < kFrameColumnCount; i++) {
+            mFrames.columns[i].ints.push_back(values[i]);
+        }
+        mTail.store(tail + 1, std::memory_order_release);
+        if (mFrames.Rows() == kChunkFrames) {
+            WriteChunks();
+        }
+    }
+}
+
+void SessionExport::AddSecond() {
+    Metrics::Set("export.dropped_frames", (double)mDropped.load(std::memory_order_relaxed));
+    mSeconds.emplace_back(Us(Clock::now() - mStart), Metrics::Snapshot());
+    if (mSeconds.size() == kChunkSeconds) {
+        WriteChunks();
+    }
+}
+
+void SessionExport::WriteChunks() {
+    std::string out;
+    if (mFrames.Rows() > 0) {
+        out += mEncoder.TableChunk(mFrames);
+        for (SessionColumns::Column& column : mFrames.columns) {
+            column.ints.clear();
+        }
+    }
+    if (!mSeconds.empty()) {
+        SessionColumns::Table seconds{"second", {}};
+        SessionColumns::Column time;
+        time.name = "time_us";
+        std::map<std::string, size_t> columns;
+        for (const auto& second : mSeconds) {
+            time.ints.push_back(second.first);
+            for (const auto& metric : second.second) {
+                columns.emplace(metric.first, columns.size() + 1);
+            }
+        }
+        seconds.columns.resize(columns.size() + 1);
+        seconds.columns[0] = std::move(time);
+        for (const auto& column : columns) {
+            SessionColumns::Column& values = seconds.columns[column.second];
+            values.name = column.first;
+            values.isFloat = true;
+            for (const auto& second : mSeconds) {
+                const auto metric = second.second.find(column.first);
+                values.floats.push_back(metric != second.second.end() ? (float)metric->second : std::numeric_limits<float>::quiet_NaN());
+            }
+        }
+        out += mEncoder.TableChunk(seconds);
+        mSeconds.clear();
+    }
+    if (!out.empty()) {
+        fwrite(out.data(), 1, out.size(), mFile);
+        fflush(mFile);
+        mBytes += out.size();
+    }
+}
@@ -0,0 +1,84 @@
+/*
+    per-session export for fleet analytics, adb shell setprop debug.xr.sessionExport 1. every session
+    (begin to end) writes /sdcard/CloudXRSession_<time>.cxcs in the columnar format of session_columns.h,
+    with the device profile and a hash of the debug.xr.* / debug.cxr.* properties as session metadata.
+
+    two tables: "frame", one row per frame with its timings and latch result, and "second", one row per
+    second with every Metrics value (connection stats, pacing, memory, callbacks...), one column each.
+    the render thread only pushes a fixed size record into a ring, and drops it when the ring is full; a
+    writer thread drains the ring every 100 ms and encodes and appends a chunk every 1024 frames or 10
+    seconds, so the memory used stays bounded and a killed app loses at most the last chunk.
+    session_tool/session_tool.cpp reads, queries and merges the files on the host.
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "session_columns.h"
+
+class SessionExport {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum Latch : uint8_t { LatchNone, LatchMissed, LatchLatched };
+
+    struct Frame {
+        Clock::time_point end;  // after xrEndFrame
+        uint32_t waitUs;        // in xrWaitFrame, or waiting for the frame pacer
+        uint32_t workUs;        // from the wait to the end
+        uint32_t displayPeriodUs;
+        Latch latch;
+        uint32_t latchWaitUs;   // blocked in cxrLatchFrame this frame, a miss included
+        uint64_t poseID;
+    };
+
+    // Device profile plus "config.hash", a hash of every debug.xr.* and debug.cxr.* property.
+    static std::map<std::string, std::string> DeviceProfile();
+
+    ~SessionExport() { Stop(); }
+
+    // Render thread, when the session begins and ends.
+    bool Start(const std::map<std::string, std::string>& meta);
+    void Stop();
+    bool IsRunning() const { return mRunning; }
+
+    // Render thread, once per frame: never blocks.
+    void PushFrame(const Frame& frame);
+
+private:
+    static const uint32_t kRingSize = 1024;
+    static const size_t kChunkFrames = 1024;
+    static const size_t kChunkSeconds = 10;
+
+    void Run();
+    void Drain();
+    void AddSecond();
+    void WriteChunks();
+
+    bool mRunning = false;
+    std::thread mThread;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    bool mStopping = false;
+
+    // Single producer (render thread), single consumer (writer thread).
+    Frame mRing[kRingSize];
+    std::atomic<uint32_t> mHead{0};
+    std::atomic<uint32_t> mTail{0};
+    std::atomic<uint64_t> mDropped{0};
+
+    // Writer thread only.
+    FILE* mFile = nullptr;
+    std::string mPath;
+    SessionColumns::Encoder mEncoder;
+    Clock::time_point mStart;
+    Clock::time_point mLastFrameEnd;
+    SessionColumns::Table mFrames;
+    std::vector<std::pair<int64_t, std::map<std::string, double>>> mSeconds;
+    uint64_t mBytes = 0;
+};
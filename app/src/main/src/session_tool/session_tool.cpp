@@ -0,0 +1,241 @@
+/*
+    host tool for the session export files (session_export.h), standard C++ only:
+    g++ -std=c++17 -O2 -I.. session_tool.cpp ../session_columns.cpp -o session_tool
+
+    usage: session_tool info <file>...
+               sessions with their metadata, tables with rows and columns
+           session_tool csv <file> <table> [column,...]
+               the rows of a table as CSV, prefixed with the session index, all columns by default
+           session_tool stats <table> <column> [-by <meta key>] <file>...
+               count, mean, min, p50, p90, p99 and max of a column across files, per value of a metadata
+               key when given, e.g. -by config.hash or -by device.model
+           session_tool merge <out> <in>...
+               one file with the sessions of all inputs, in order
+*/
+#include "session_columns.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace SessionColumns;
+
+namespace {
+
+int Usage() {
+    fprintf(stderr,
+            "usage: session_tool info <file>...\n"
+            "       session_tool csv <file> <table> [column,...]\n"
+            "       session_tool stats <table> <column> [-by <meta key>] <file>...\n"
+            "       session_tool merge <out> <in>...\n");
+    return 1;
+}
+
+bool LoadOrReport(const std::string& path, std::vector<Session>* sessions) {
+    std::string error;
+    if (!Load(path, sessions, &error)) {
+        fprintf(stderr, "%s\n", error.c_str());
+        return false;
+    }
+    return true;
+}
+
+double Percentile(std::vector<double> samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    const size_t index = std::min(samples.size() - 1, (size_t)(p / 100.0 * (double)(samples.size() - 1) + 0.5));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+int Info(int argc, char** argv) {
+    for (int i = 0; i < argc; i++) {
+        std::vector<Session> sessions;
+        if (!LoadOrReport(argv[i], &sessions)) {
+            return 1;
+        }
+        printf("%s: %zu sessions\n", argv[i], sessions.size());
+        for (size_t s = 0; s < sessions.size(); s++) {
+            printf("  session %zu\n", s);
+            for (const auto& entry : sessions[s].meta) {
+                printf("    %s = %s\n", entry.first.c_str(), entry.second.c_str());
+            }
+            for (const Table& table : sessions[s].Tables()) {
+                printf("    table %s: %zu rows, %zu columns\n", table.name.c_str(), table.Rows(), table.columns.size());
+                for (const Column& column : table.columns) {
+                    printf("      %s%s\n", column.name.c_str(), column.isFloat ? " (float)" : "");
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+int Csv(int argc, char** argv) {
+    if (argc < 2) {
+        return Usage();
+    }
+    std::vector<Session> sessions;
+    if (!LoadOrReport(argv[0], &sessions)) {
+        return 1;
+    }
+    std::vector<std::string> wanted;
+    if (argc > 2) {
+        std::istringstream names(argv[2]);
+        std::string name;
+        while (std::getline(names, name, ',')) {
+            wanted.push_back(name);
+        }
+    }
+
+    bool headerWritten = false;
+    for (size_t s = 0; s < sessions.size(); s++) {
+        for (const Table& table : sessions[s].Tables()) {
+            if (table.name != argv[1]) {
+                continue;
+            }
+            std::vector<const Column*> columns;
+            if (wanted.empty()) {
+                for (const Column& column : table.columns) {
+                    wanted.push_back(column.name);
+                }
+            }
+            for (const std::string& name : wanted) {
+                columns.push_back(table.Find(name));
+            }
+            if (!headerWritten) {
+                headerWritten = true;
+                printf("session");
+                for (const std::string& name : wanted) {
+                    printf(",%s", name.c_str());
+                }
+                printf("\n");
+            }
+            for (size_t row = 0; row < table.Rows(); row++) {
+                printf("%zu", s);
+                for (const Column* column : columns) {
+                    if (column == nullptr || (column->isFloat && std::isnan(column->floats[row]))) {
+                        printf(",");
+                    } else if (column->isFloat) {
+                        printf(",%g", column->floats[row]);
+                    } else {
+                        printf(",%lld", (long long)column->ints[row]);
+                    }
+                }
+                printf("\n");
+            }
+        }
+    }
+    return 0;
+}
+
+int Stats(int argc, char** argv) {
+    if (argc < 3) {
+        return Usage();
+    }
+    const std::string tableName = argv[0];
+    const std::string columnName = argv[1];
+    std::string by;
+    int first = 2;
+    if (strcmp(argv[2], "-by") == 0) {
+        if (argc < 5) {
+            return Usage();
+        }
+        by = argv[3];
+        first = 4;
+    }
+
+    std::map<std::string, std::vector<double>> groups;
+    for (int i = first; i < argc; i++) {
+        std::vector<Session> sessions;
+        if (!LoadOrReport(argv[i], &sessions)) {
+            return 1;
+        }
+        for (const Session& session : sessions) {
+            const auto group = session.meta.find(by);
+            std::vector<double>& samples = groups[by.empty() ? "all" : group != session.meta.end() ? group->second : "(none)"];
+            for (const Table& table : session.Tables()) {
+                const Column* column = table.name == tableName ? table.Find(columnName) : nullptr;
+                for (size_t row = 0; column != nullptr && row < column->Rows(); row++) {
+                    const double value = column->Value(row);
+                    if (!std::isnan(value)) {
+                        samples.push_back(value);
+                    }
+                }
+            }
+        }
+    }
+
+    printf("%-24s %10s %12s %12s %12s %12s %12s %12s\n", by.empty() ? "group" : by.c_str(), "count", "mean", "min", "p50", "p90", "p99", "max");
+    for (const auto& group : groups) {
+        const std::vector<double>& samples = group.second;
+        if (samples.empty()) {
+            continue;
+        }
+        const double mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+        printf("%-24s %10zu %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f\n", group.first.c_str(), samples.size(), mean,
+               *std::min_element(samples.begin(), samples.end()), Percentile(samples, 50), Percentile(samples, 90), Percentile(samples, 99),
+               *std::max_element(samples.begin(), samples.end()));
+    }
+    return 0;
+}
+
+int Merge(int argc, char** argv) {
+    if (argc < 2) {
+        return Usage();
+    }
+    FILE* out = fopen(argv[0], "wb");
+    if (out == nullptr) {
+        fprintf(stderr, "cannot open %s\n", argv[0]);
+        return 1;
+    }
+    // The inputs are read one at a time, the string dictionary is rebuilt for the merged file.
+    Encoder encoder;
+    std::string data = encoder.Header();
+    size_t merged = 0;
+    for (int i = 1; i < argc; i++) {
+        std::vector<Session> sessions;
+        if (!LoadOrReport(argv[i], &sessions)) {
+            fclose(out);
+            return 1;
+        }
+        for (const Session& session : sessions) {
+            data += encoder.SessionChunk(session.meta);
+            for (const Table& chunk : session.chunks) {
+                data += encoder.TableChunk(chunk);
+            }
+            fwrite(data.data(), 1, data.size(), out);
+            data.clear();
+            merged++;
+        }
+    }
+    fclose(out);
+    printf("%zu sessions merged into %s\n", merged, argv[0]);
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        return Usage();
+    }
+    const std::string command = argv[1];
+    if (command == "info") {
+        return Info(argc - 2, argv + 2);
+    } else if (command == "csv") {
+        return Csv(argc - 2, argv + 2);
+    } else if (command == "stats") {
+        return Stats(argc - 2, argv + 2);
+    } else if (command == "merge") {
+        return Merge(argc - 2, argv + 2);
+    }
+    return Usage();
+}
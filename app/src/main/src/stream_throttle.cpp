@@ -0,0 +1,43 @@
+/*
+    focus and presence aware stream throttling.
+*/
+#include "pch.h"
+#include "common.h"
+#include "stream_throttle.h"
+#include "metrics.h"
+
+void StreamThrottle::Initialize(bool enabled, float delayMs) {
+    m_enabled = enabled;
+    m_delay = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float, std::milli>(std::max(delayMs, 0.0f)));
+    Log::Write(Log::Level::Info, Fmt("stream throttle: %s, %.0f ms delay", enabled ? "on" : "off", delayMs));
+}
+
+void StreamThrottle::SessionState(XrSessionState state) {
+    m_running = state == XR_SESSION_STATE_SYNCHRONIZED || state == XR_SESSION_STATE_VISIBLE || state == XR_SESSION_STATE_FOCUSED;
+    m_focused = state == XR_SESSION_STATE_FOCUSED;
+}
+
+void StreamThrottle::UserPresence(bool present) {
+    Log::Write(Log::Level::Info, Fmt("stream throttle: user %s", present ? "present" : "not present"));
+    m_present = present;
+}
+
+bool StreamThrottle::Update(Clock::time_point now) {
+    // A stopped session has no stream to throttle; the next one starts at full rate.
+    const bool idle = m_enabled && m_running && (!m_focused || !m_present);
+    if (idle && !m_idle) {
+        m_idleSince = now;
+    }
+    m_idle = idle;
+
+    const bool throttled = idle && now - m_idleSince >= m_delay;
+    if (throttled == m_throttled) {
+        return false;
+    }
+    m_throttled = throttled;
+    m_changes++;
+    Log::Write(Log::Level::Info, Fmt("stream throttle: %s", throttled ? "reduced rate" : "full rate"));
+    Metrics::Set("stream.throttled", throttled ? 1.0 : 0.0);
+    Metrics::Set("stream.throttle_changes", m_changes);
+    return true;
+}
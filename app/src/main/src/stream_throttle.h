@@ -0,0 +1,56 @@
+/*
+    focus and presence aware stream throttling, adb shell setprop debug.xr.throttle 0 to turn it off (default on).
+    while the session is running but not FOCUSED, i.e. a system overlay is up (VISIBLE) or the headset is
+    idle or off-head (SYNCHRONIZED), or XR_EXT_user_presence reports the user gone, nobody needs the full
+    stream. once that has lasted debug.xr.throttleDelayMs (default 3000, so a glance at the system menu
+    costs nothing), the CloudXR client reconnects at half the frame rate and a quarter of the bitrate,
+    and reconnects at full rate as soon as the session is focused with the user present again. CloudXR
+    only takes the frame rate and bitrate at connect, hence the reconnects; they run on the render thread
+    between frames, like the other receiver recreations (CloudXRClient::ServiceReceiver).
+    input polling does not wait for the delay: PollActions skips the action calls while not focused.
+    stream.throttled (0|1) and stream.throttle_changes go to Metrics.
+*/
+#pragma once
+
+#include <chrono>
+
+// XR_EXT_user_presence, newer than the bundled headers.
+#ifndef XR_EXT_user_presence
+#define XR_EXT_user_presence 1
+#define XR_EXT_USER_PRESENCE_EXTENSION_NAME "XR_EXT_user_presence"
+#define XR_TYPE_EVENT_DATA_USER_PRESENCE_CHANGED_EXT ((XrStructureType)1000470000)
+typedef struct XrEventDataUserPresenceChangedEXT {
+    XrStructureType type;
+    const void* XR_MAY_ALIAS next;
+    XrSession session;
+    XrBool32 isUserPresent;
+} XrEventDataUserPresenceChangedEXT;
+#endif
+
+class StreamThrottle {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static const char* Extension() { return XR_EXT_USER_PRESENCE_EXTENSION_NAME; }
+
+    void Initialize(bool enabled, float delayMs);
+
+    // Render thread, from the session state and user presence events.
+    void SessionState(XrSessionState state);
+    void UserPresence(bool present);
+
+    // Render thread, once per loop: true when Throttled() changed.
+    bool Update(Clock::time_point now);
+    bool Throttled() const { return m_throttled; }
+
+private:
+    bool m_enabled{false};
+    Clock::duration m_delay{};
+    bool m_running{false};
+    bool m_focused{false};
+    bool m_present{true};
+    bool m_idle{false};
+    Clock::time_point m_idleSince;
+    bool m_throttled{false};
+    uint32_t m_changes{0};
+};
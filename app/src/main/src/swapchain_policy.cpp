@@ -0,0 +1,56 @@
+/*
+    swapchain configuration per use.
+*/
+#include "pch.h"
+#include "common.h"
+#include "swapchain_policy.h"
+
+namespace SwapchainPolicy {
+
+const char* ToString(SwapchainUse use) {
+    switch (use) {
+        case SwapchainUse::StreamedProjection:
+            return "streamed projection";
+        case SwapchainUse::HudQuad:
+            return "HUD quad";
+        case SwapchainUse::DebugOverlay:
+            return "debug overlay";
+    }
+    return "unknown";
+}
+
+SwapchainConfig Select(SwapchainUse use, int64_t format, uint32_t sampleCount) {
+    SwapchainConfig config;
+    config.format = format;
+    switch (use) {
+        case SwapchainUse::StreamedProjection:
+            config.usageFlags = XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT;
+            break;
+        case SwapchainUse::HudQuad:
+            config.usageFlags = XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT | XR_SWAPCHAIN_USAGE_TRANSFER_DST_BIT;
+            break;
+        case SwapchainUse::DebugOverlay:
+            config.sampleCount = std::max(sampleCount, 1u);
+            config.usageFlags = XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT;
+            config.depth = true;
+            break;
+    }
+    return config;
+}
+
+SwapchainConfig Unoptimized(int64_t format, uint32_t sampleCount) {
+    SwapchainConfig config;
+    config.format = format;
+    config.sampleCount = std::max(sampleCount, 1u);
+    config.usageFlags = XR_SWAPCHAIN_USAGE_SAMPLED_BIT | XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT;
+    config.depth = true;
+    return config;
+}
+
+uint64_t EstimateBytes(const SwapchainConfig& config, uint32_t width, uint32_t height, uint32_t imageCount, uint32_t colorBytesPerPixel) {
+    const uint64_t pixels = (uint64_t)width * height * config.sampleCount;
+    const uint64_t depthBytesPerPixel = 4;
+    return pixels * colorBytesPerPixel * imageCount + (config.depth ? pixels * depthBytesPerPixel : 0);
+}
+
+}  // namespace SwapchainPolicy
@@ -0,0 +1,31 @@
+/*
+    swapchain configuration per use.
+    a streamed projection layer only ever receives a decoded video frame through a blit: a single sample
+    is all the video has, nothing samples the image but the compositor, and nothing is depth tested.
+    a HUD quad is drawn or uploaded once per change, a debug overlay renders geometry and keeps MSAA and
+    depth. the image count is always the runtime's, OpenXR does not let the application choose it.
+*/
+#pragma once
+
+enum class SwapchainUse { StreamedProjection, HudQuad, DebugOverlay };
+
+struct SwapchainConfig {
+    int64_t format{-1};
+    uint32_t sampleCount{1};
+    XrSwapchainUsageFlags usageFlags{0};
+    // Whether the graphics plugin allocates a depth buffer for the swapchain.
+    bool depth{false};
+};
+
+namespace SwapchainPolicy {
+const char* ToString(SwapchainUse use);
+
+// format is the graphics plugin's choice from the runtime's formats, sampleCount what the plugin supports for the view.
+SwapchainConfig Select(SwapchainUse use, int64_t format, uint32_t sampleCount);
+
+// What every swapchain was created with before: the plugin's sample count, sampled and color attachment usage, depth.
+SwapchainConfig Unoptimized(int64_t format, uint32_t sampleCount);
+
+// Estimated memory of a width x height swapchain of imageCount color images plus one D24S8 depth buffer if config.depth.
+uint64_t EstimateBytes(const SwapchainConfig& config, uint32_t width, uint32_t height, uint32_t imageCount, uint32_t colorBytesPerPixel = 4);
+}  // namespace SwapchainPolicy
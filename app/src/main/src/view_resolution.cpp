@@ -0,0 +1,36 @@
+/*
+    dynamic resolution through imageRect.
+*/
+#include "pch.h"
+#include "common.h"
+#include "view_resolution.h"
+
+XrExtent2Di ViewResolution::AllocationExtent(const XrViewConfigurationView& view, float maxScale) {
+    const float scale = std::max(maxScale, 1.0f);
+    auto scaled = [scale](uint32_t recommended, uint32_t maximum) {
+        const uint32_t size = (uint32_t)std::lround(recommended * scale);
+        return (int32_t)std::max<uint32_t>(std::min(size, maximum != 0 ? maximum : size), 1);
+    };
+    return {scaled(view.recommendedImageRectWidth, view.maxImageRectWidth), scaled(view.recommendedImageRectHeight, view.maxImageRectHeight)};
+}
+
+void ViewResolution::Reset(XrExtent2Di allocated, XrExtent2Di initial) {
+    m_allocated = allocated;
+    m_active = {{0, 0}, {0, 0}};
+    Update((uint32_t)std::max(initial.width, 0), (uint32_t)std::max(initial.height, 0));
+}
+
+bool ViewResolution::Update(uint32_t width, uint32_t height) {
+    if (width == 0 || height == 0) {
+        return false;
+    }
+    // The stream and the compositor both map the whole rect onto the whole field of view, so clamping one
+    // dimension alone lowers resolution but never stretches the image.
+    const XrExtent2Di extent{(int32_t)std::min<uint32_t>(width, (uint32_t)m_allocated.width),
+                             (int32_t)std::min<uint32_t>(height, (uint32_t)m_allocated.height)};
+    if (extent.width == m_active.extent.width && extent.height == m_active.extent.height) {
+        return false;
+    }
+    m_active.extent = extent;
+    return true;
+}
@@ -0,0 +1,28 @@
+/*
+    dynamic resolution through imageRect, adb shell setprop debug.xr.maxResScale 1.0-2.0.
+    each view's swapchain is allocated once at the largest size the stream may use: the recommended
+    size scaled by maxResScale, within the runtime's maximum. the resolution actually streamed is only
+    a sub-rectangle of it, used for the FBO viewport and the projection view's imageRect, so a
+    renegotiated stream resolution takes effect on the next frame without recreating swapchains or FBOs.
+*/
+#pragma once
+
+class ViewResolution {
+public:
+    // Swapchain size for a view, at least 1x1.
+    static XrExtent2Di AllocationExtent(const XrViewConfigurationView& view, float maxScale);
+
+    // Starts with the active rect at initial, clamped to allocated.
+    void Reset(XrExtent2Di allocated, XrExtent2Di initial);
+
+    // Streamed size of the latest frame. Each dimension is clamped to the allocation, an empty size keeps
+    // the current rect. True if the active rect changed.
+    bool Update(uint32_t width, uint32_t height);
+
+    const XrRect2Di& ActiveRect() const { return m_active; }
+    XrExtent2Di Allocated() const { return m_allocated; }
+
+private:
+    XrExtent2Di m_allocated{0, 0};
+    XrRect2Di m_active{{0, 0}, {0, 0}};
+};
@@ -0,0 +1,183 @@
+/*
+    per-frame accounting of OpenXR runtime calls.
+*/
+#include "pch.h"
+#include "common.h"
+#include "metrics.h"
+
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+const char* const kPhaseNames[] = {"setup", "events", "input", "wait", "render"};
+const size_t kPhaseCount = (size_t)XrCallPhase::Count;
+static_assert(sizeof(kPhaseNames) / sizeof(kPhaseNames[0]) == kPhaseCount, "phase names out of sync");
+
+struct PhaseBudget {
+    uint32_t maxCalls = 0;
+    uint32_t maxUs = 0;
+};
+
+struct PhaseTotals {
+    uint64_t calls = 0;
+    int64_t ns = 0;
+    int64_t maxFrameNs = 0;
+    uint64_t overBudget = 0;
+};
+
+struct FrameTotals {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<int64_t> ns{0};
+};
+
+struct CallSite {
+    uint64_t calls = 0;
+    int64_t ns = 0;
+};
+
+// Budgets from Configure; the rest only the render thread touches, in EndFrame.
+struct BudgetState {
+    PhaseBudget budgets[kPhaseCount];
+    PhaseTotals window[kPhaseCount];
+    uint64_t windowFrames = 0;
+    std::chrono::steady_clock::time_point windowStart;
+};
+
+BudgetState g_budget;
+// Any thread adds, EndFrame takes.
+FrameTotals g_frame[kPhaseCount];
+thread_local XrCallPhase t_phase = XrCallPhase::Setup;
+
+// Keyed by the stringified call of CHECK_XRCMD / XR_CALL, i.e. one entry per call site.
+std::mutex g_sitesMutex;
+std::unordered_map<const char*, CallSite> g_sites;
+
+std::string FunctionName(const char* call) {
+    std::string name(call);
+    name = name.substr(0, name.find('('));
+    name.erase(std::remove_if(name.begin(), name.end(), ::isspace), name.end());
+    return name;
+}
+
+void Publish() {
+    const double frames = (double)g_budget.windowFrames;
+    for (size_t i = 0; i < kPhaseCount; i++) {
+        const PhaseTotals& totals = g_budget.window[i];
+        const std::string prefix = std::string("xr.") + kPhaseNames[i];
+        Metrics::Set(prefix + ".calls_per_frame", totals.calls / frames);
+        Metrics::Set(prefix + ".us_per_frame", totals.ns / 1000.0 / frames);
+        Metrics::Set(prefix + ".us_max", totals.maxFrameNs / 1000.0);
+        Metrics::Set(prefix + ".over_budget", (double)totals.overBudget);
+        g_budget.window[i] = PhaseTotals{};
+    }
+
+    std::map<std::string, CallSite> functions;
+    {
+        std::lock_guard<std::mutex> lock(g_sitesMutex);
+        for (auto& site : g_sites) {
+            CallSite& function = functions[FunctionName(site.first)];
+            function.calls += site.second.calls;
+            function.ns += site.second.ns;
+            site.second = CallSite{};
+        }
+    }
+    for (const auto& function : functions) {
+        Metrics::Set("xrcall." + function.first + ".per_frame", function.second.calls / frames);
+        Metrics::Set("xrcall." + function.first + ".us_avg", function.second.calls ? function.second.ns / 1000.0 / function.second.calls : 0.0);
+    }
+    g_budget.windowFrames = 0;
+}
+
+}  // namespace
+
+namespace XrCallBudget {
+bool g_enabled = false;
+
+void Configure(const std::string& spec) {
+    g_budget = BudgetState{};
+    for (FrameTotals& frame : g_frame) {
+        frame.calls.store(0, std::memory_order_relaxed);
+        frame.ns.store(0, std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_sitesMutex);
+        g_sites.clear();
+    }
+    g_enabled = !spec.empty();
+    if (!g_enabled) {
+        return;
+    }
+
+    std::istringstream entries(spec);
+    std::string entry;
+    while (std::getline(entries, entry, ',')) {
+        const size_t eq = entry.find('=');
+        const std::string phase = entry.substr(0, eq);
+        size_t index = 0;
+        while (index < kPhaseCount && phase != kPhaseNames[index]) {
+            index++;
+        }
+        if (eq == std::string::npos || index == kPhaseCount) {
+            Log::Write(Log::Level::Warning, Fmt("xr call budget: ignoring '%s'", entry.c_str()));
+            continue;
+        }
+        PhaseBudget& budget = g_budget.budgets[index];
+        if (sscanf(entry.c_str() + eq + 1, "%u:%u", &budget.maxCalls, &budget.maxUs) < 1) {
+            Log::Write(Log::Level::Warning, Fmt("xr call budget: ignoring '%s'", entry.c_str()));
+        }
+    }
+    g_budget.windowStart = std::chrono::steady_clock::now();
+    Log::Write(Log::Level::Info, Fmt("xr call budget tracking enabled: %s", spec.c_str()));
+}
+
+void SetPhase(XrCallPhase phase) { t_phase = phase; }
+
+void Record(const char* call, std::chrono::steady_clock::duration elapsed) {
+    const int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    FrameTotals& frame = g_frame[(size_t)t_phase];
+    frame.calls.fetch_add(1, std::memory_order_relaxed);
+    frame.ns.fetch_add(ns, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(g_sitesMutex);
+    CallSite& site = g_sites[call];
+    site.calls++;
+    site.ns += ns;
+}
+
+void EndFrame() {
+    if (!g_enabled) {
+        return;
+    }
+
+    for (size_t i = 0; i < kPhaseCount; i++) {
+        PhaseTotals frame;
+        frame.calls = g_frame[i].calls.exchange(0, std::memory_order_relaxed);
+        frame.ns = g_frame[i].ns.exchange(0, std::memory_order_relaxed);
+        PhaseTotals& window = g_budget.window[i];
+        const PhaseBudget& budget = g_budget.budgets[i];
+        const bool overCalls = budget.maxCalls != 0 && frame.calls > budget.maxCalls;
+        const bool overTime = budget.maxUs != 0 && frame.ns / 1000 > budget.maxUs;
+        if (overCalls || overTime) {
+            // Only the first violation of each phase per window is logged, the rest show up in the metrics.
+            if (window.overBudget == 0) {
+                Log::Write(Log::Level::Warning, Fmt("xr call budget exceeded in %s: %llu calls (budget %u), %.0f us (budget %u)", kPhaseNames[i],
+                                                    (unsigned long long)frame.calls, budget.maxCalls, frame.ns / 1000.0, budget.maxUs));
+            }
+            window.overBudget++;
+        }
+        window.calls += frame.calls;
+        window.ns += frame.ns;
+        window.maxFrameNs = std::max(window.maxFrameNs, frame.ns);
+    }
+    g_budget.windowFrames++;
+    t_phase = XrCallPhase::Setup;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - g_budget.windowStart >= std::chrono::seconds(1)) {
+        Publish();
+        g_budget.windowStart = now;
+    }
+}
+}  // namespace XrCallBudget
@@ -0,0 +1,50 @@
+/*
+    per-frame accounting of OpenXR runtime calls, in the spirit of an api layer but inside the client:
+    every call made through CHECK_XRCMD or XR_CALL is counted and timed against the current frame
+    phase. at the end of each frame the phase totals are checked against the configured budgets,
+    and once a second the averages are published to Metrics under "xr.".
+
+    disabled by default, when disabled the only cost per call is one branch on a global flag.
+    adb shell setprop debug.xr.callBudget "events=4:500,input=32:1500,wait=1:20000,render=8:3000"
+    (per phase: max calls per frame : max microseconds per frame, 0 for no limit)
+
+    any thread may make measured calls: the phase is per thread, the frame totals are atomic, and a
+    call lands in the frame the render thread closes next. the frame pacer's thread is always in the
+    wait phase, so its xrWaitFrame counts there as it would on the render thread.
+*/
+#pragma once
+
+#include <chrono>
+#include <string>
+
+enum class XrCallPhase { Setup, Events, Input, Wait, Render, Count };
+
+namespace XrCallBudget {
+extern bool g_enabled;
+
+// Enables tracking with the given budgets, an empty spec disables it. Before any thread makes OpenXR calls.
+void Configure(const std::string& spec);
+
+// The calling thread's phase, from now on.
+void SetPhase(XrCallPhase phase);
+
+// Any thread.
+void Record(const char* call, std::chrono::steady_clock::duration elapsed);
+
+// Render thread: closes the current frame, checks the budgets and publishes the per-second averages.
+void EndFrame();
+
+template <typename Call>
+inline XrResult Measure(const char* call, Call&& invoke) {
+    if (!g_enabled) {
+        return invoke();
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const XrResult result = invoke();
+    Record(call, std::chrono::steady_clock::now() - start);
+    return result;
+}
+}  // namespace XrCallBudget
+
+// For runtime calls whose result is inspected rather than checked.
+#define XR_CALL(cmd) XrCallBudget::Measure(#cmd, [&]() { return (cmd); })